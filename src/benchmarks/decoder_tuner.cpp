@@ -0,0 +1,312 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Sweeps the decoder settings over labelled samples and reports how fast and how accurately each
+ * setting aligns them, to choose a decoder profile for a kind of audio.
+ *
+ * Usage : decoder_tuner samples.txt [profiles|grid] [ccaligner parameters...]
+ *
+ * Every line of samples.txt names an audio file (wave, or FLAC by its extension), its subtitles and
+ * the reference word timings : an SRT with one entry per word, such as the output of ccaligner with
+ * -oFormat srt --print-aligned no, checked by hand. Lines beginning with # are skipped.
+ *
+ * "profiles" (default) tries the stock decoder and the named profiles. "grid" tries every combination
+ * of two values of each argument the profiles set, 128 runs per sample. The ccaligner parameters are
+ * passed on to every run, e.g. the model, -lm and -dict; -profile is replaced by the swept settings.
+ *
+ * The grammar of every sample is generated once, before its first run. The real time factor is the
+ * time taken to align, decoder initialisation included, over the duration of the audio. The timing
+ * error is the mean distance of the start and end of the words found in the reference from their
+ * reference times, over every reference word : a word which is missing, or more than 5 s away from its
+ * reference, counts as 1 s off, so that a setting can't look accurate by matching few words. Settings
+ * which no other one beats on both speed and error are marked on the Pareto frontier.
+ */
+
+#include "recognize_using_pocketsphinx.h"
+#include <chrono>
+#include <sstream>
+
+static const double missedWordError = 1000;     //ms, counted for every reference word not found
+
+class Sample
+{
+public:
+    std::string audioFileName, subtitleFileName, referenceFileName;
+};
+
+class Candidate     //settings tried, with the results summed over the samples
+{
+public:
+    std::string name;
+    decoderProfiles profile;
+    DecoderSettings settings;
+
+    double audioSeconds, alignSeconds, errorSum;
+    long int referenceWords, matchedWords, wordsWithin100ms;
+
+    Candidate(const std::string& candidateName, decoderProfiles candidateProfile, const DecoderSettings& candidateSettings)
+        : name(candidateName), profile(candidateProfile), settings(candidateSettings),
+          audioSeconds(0), alignSeconds(0), errorSum(0), referenceWords(0), matchedWords(0), wordsWithin100ms(0)
+    {}
+
+    double getRealTimeFactor() const { return alignSeconds / std::max(audioSeconds, 1e-9); }
+    double getMeanError() const { return matchedWords > 0 ? errorSum / matchedWords : 0; }     //of the matched words only
+
+    double getError() const     //of all the reference words, the missed ones included
+    {
+        return (errorSum + (referenceWords - matchedWords) * missedWordError) / std::max(1L, referenceWords);
+    }
+};
+
+class WordTiming
+{
+public:
+    std::string word;
+    long int startTime, endTime;
+};
+
+static std::vector<Sample> readSamples(const std::string& fileName)
+{
+    std::ifstream in(fileName);
+    std::vector<Sample> samples;
+    std::string line;
+
+    if (!in)
+    {
+        FATAL(FileNotFound) << "Unable to open sample list : " << fileName;
+    }
+
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        Sample sample;
+
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        if (!(fields >> sample.audioFileName >> sample.subtitleFileName >> sample.referenceFileName))
+        {
+            FATAL(InvalidFile) << "Expected audio, subtitle and reference file names : " << line;
+        }
+
+        samples.push_back(sample);
+    }
+
+    return samples;
+}
+
+static std::vector<WordTiming> readWordTimings(const std::string& fileName)
+{
+    SubtitleParserFactory parserFactory(fileName);
+    std::vector<WordTiming> words;
+
+    for (SubtitleItem *item : parserFactory.getParser()->getSubtitles())
+    {
+        std::string word = normaliseWord(item->getText());
+
+        if (!word.empty())
+            words.push_back({word, item->getStartTime(), item->getEndTime()});
+    }
+
+    return words;
+}
+
+static void scoreAlignment(const std::vector<WordTiming>& reference, const std::vector<WordTiming>& aligned, Candidate& candidate)
+{
+    //the words are the same in both and in the same order, but either may have words the other doesn't
+    const size_t lookAhead = 10;
+    const long int maximumDistance = 5000;      //a word found this far away is another occurrence of it
+    size_t next = 0;
+
+    for (const WordTiming& word : reference)
+    {
+        candidate.referenceWords++;
+
+        for (size_t i = next; i < aligned.size() && i < next + lookAhead; i++)
+        {
+            if (aligned[i].word != word.word || std::labs(aligned[i].startTime - word.startTime) > maximumDistance)
+                continue;
+
+            double error = (std::labs(aligned[i].startTime - word.startTime) + std::labs(aligned[i].endTime - word.endTime)) / 2.0;
+
+            candidate.errorSum += error;
+            candidate.matchedWords++;
+            candidate.wordsWithin100ms += error <= 100;
+            next = i + 1;
+            break;
+        }
+    }
+}
+
+static std::vector<Candidate> getCandidates(const std::string& sweep)
+{
+    std::vector<Candidate> candidates;
+
+    if (sweep == "profiles")
+    {
+        for (decoderProfiles profile : {stockProfile, fastProfile, balancedProfile, accurateProfile})
+            candidates.emplace_back(getDecoderProfileName(profile), profile, getDecoderProfile(profile));
+    }
+
+    else if (sweep == "grid")
+    {
+        const DecoderSettings values[] = {{{"-ds", "1"}, {"-ds", "2"}},
+                                          {{"-topn", "2"}, {"-topn", "4"}},
+                                          {{"-maxhmmpf", "3000"}, {"-maxhmmpf", "30000"}},
+                                          {{"-maxwpf", "5"}, {"-maxwpf", "-1"}},
+                                          {{"-pl_window", "0"}, {"-pl_window", "10"}},
+                                          {{"-fwdflat", "no"}, {"-fwdflat", "yes"}},
+                                          {{"-bestpath", "no"}, {"-bestpath", "yes"}}};
+        const int numberOfArguments = sizeof(values) / sizeof(values[0]);
+
+        for (int combination = 0; combination < (1 << numberOfArguments); combination++)
+        {
+            Candidate candidate("grid-" + std::to_string(combination + 1), stockProfile, DecoderSettings());
+
+            for (int argument = 0; argument < numberOfArguments; argument++)
+                candidate.settings.push_back(values[argument][(combination >> argument) & 1]);
+
+            candidates.push_back(candidate);
+        }
+    }
+
+    else
+    {
+        FATAL(InvalidParameters) << "Unknown sweep : " << sweep << ", expected profiles or grid";
+    }
+
+    return candidates;
+}
+
+static Params getSampleParams(const Sample& sample, const std::string& outputFileName, const std::vector<std::string>& extraArguments)
+{
+    const std::string& audioFileName = sample.audioFileName;
+    const bool isFlac = audioFileName.size() > 5 && stringToLower(audioFileName.substr(audioFileName.size() - 5)) == ".flac";
+
+    std::vector<std::string> arguments = {"decoder_tuner", isFlac ? "-flac" : "-wav", audioFileName, "-srt", sample.subtitleFileName,
+                                          "-out", outputFileName, "-oFormat", "srt", "--print-aligned", "no", "--display-recognised", "no"};
+    arguments.insert(arguments.end(), extraArguments.begin(), extraArguments.end());
+
+    std::vector<char *> argv;
+
+    for (std::string& argument : arguments)
+        argv.push_back(&argument[0]);
+
+    Params parameters;
+    errno = 0;
+    parameters.inputParams(argv.size(), argv.data());
+
+    return parameters;
+}
+
+static void printResults(const std::vector<Candidate>& candidates)
+{
+    std::vector<const Candidate *> sorted;
+
+    for (const Candidate& candidate : candidates)
+        sorted.push_back(&candidate);
+
+    std::sort(sorted.begin(), sorted.end(), [](const Candidate *a, const Candidate *b) {
+        return a->getRealTimeFactor() < b->getRealTimeFactor();
+    });
+
+    std::cout << "\nPareto   RTF      Error (ms)  Matched error  Within 100 ms  Matched  Name         Settings\n";
+
+    //sorted by speed, a setting is on the frontier if it is more accurate than every faster one
+    double bestError = -1;
+    char line[256];
+
+    for (const Candidate *candidate : sorted)
+    {
+        const bool isOnFrontier = bestError < 0 || candidate->getError() < bestError;
+
+        if (isOnFrontier)
+            bestError = candidate->getError();
+
+        snprintf(line, sizeof(line), "%-8s %-8.4f %-11.1f %-14.1f %-14.1f %-8.1f %-12s ", isOnFrontier ? "*" : "",
+                 candidate->getRealTimeFactor(), candidate->getError(), candidate->getMeanError(),
+                 100.0 * candidate->wordsWithin100ms / std::max(1L, candidate->matchedWords),
+                 100.0 * candidate->matchedWords / std::max(1L, candidate->referenceWords), candidate->name.c_str());
+
+        std::cout << line << printDecoderSettings(candidate->settings) << "\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage : decoder_tuner samples.txt [profiles|grid] [ccaligner parameters...]\n";
+        return 1;
+    }
+
+    int firstExtraArgument = 2;
+    std::string sweep = "profiles";
+
+    if (argc > 2 && argv[2][0] != '-')
+    {
+        sweep = argv[2];
+        firstExtraArgument = 3;
+    }
+
+    const std::vector<std::string> extraArguments(argv + firstExtraArgument, argv + argc);
+    const std::string outputFileName = "tempFiles/decoder_tuner.srt";
+
+    getLogger().setMinimumOutputLevel(Logger::Level::warning);
+
+    try {
+        std::vector<Sample> samples = readSamples(argv[1]);
+        std::vector<Candidate> candidates = getCandidates(sweep);
+
+        CreateTempDirectories();
+
+        for (const Sample& sample : samples)
+        {
+            std::vector<WordTiming> reference = readWordTimings(sample.referenceFileName);
+            Params parameters = getSampleParams(sample, outputFileName, extraArguments);
+
+            std::cout << sample.audioFileName << " : " << reference.size() << " reference words\n";
+
+            if (parameters.grammarType != no_grammar)
+            {
+                PocketsphinxAligner(&parameters).generateGrammar(parameters.grammarType);
+                parameters.grammarType = no_grammar;
+            }
+
+            const DecoderSettings settings = parameters.decoderSettings;
+            const double audioSeconds = (double) openAudioSource(&parameters)->getNumberOfSamples() / audioSampleRate;
+
+            for (Candidate& candidate : candidates)
+            {
+                parameters.decoderProfile = candidate.profile;
+                parameters.decoderSettings = settings;
+                setDecoderSettings(parameters.decoderSettings, candidate.settings);
+
+                PocketsphinxAligner aligner(&parameters);
+                const auto startedAt = std::chrono::steady_clock::now();
+
+                aligner.align();
+
+                const double took = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+
+                candidate.alignSeconds += took;
+                candidate.audioSeconds += audioSeconds;
+                scoreAlignment(reference, readWordTimings(outputFileName), candidate);
+
+                std::cout << "  " << candidate.name << " : " << took / audioSeconds << " x real time\n";
+            }
+        }
+
+        printResults(candidates);
+    }
+    catch (std::exception& e) {
+        std::cerr << "Tuning aborted : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
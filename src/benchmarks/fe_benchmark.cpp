@@ -0,0 +1,154 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Throughput of the MFCC front end, with each instruction set the CPU supports.
+ *
+ * Usage : fe_benchmark /path/to/file.wav [front end arguments...]
+ *
+ * The whole file is turned into features by the sphinxbase front end, once with the portable code and
+ * once with every SIMD instruction set available, and the frames per second of each are compared, best
+ * of three passes. The front end arguments default to the ones of the en-us model (-lowerf 130
+ * -upperf 6800 -nfilt 25 -transform dct -lifter 22); any given are added after those.
+ */
+
+#include "audio_source.h"
+#include <sphinxbase/fe.h>
+#include <sphinxbase/cmd_ln.h>
+#include <sphinxbase/ckd_alloc.h>
+#include <sphinxbase/err.h>
+#include <chrono>
+#include <cmath>
+
+static const arg_t feArguments[] = {
+    waveform_to_cepstral_command_line_macro(),
+    {nullptr, 0, nullptr, nullptr}
+};
+
+static const char *getSimdName(fe_simd_t simd)
+{
+    switch (simd)
+    {
+        case FE_SIMD_AVX2: return "AVX2";
+        case FE_SIMD_SSE2: return "SSE2";
+        default:           return "portable C";
+    }
+}
+
+//processes the samples as the decoders do, a block at a time; returns the number of frames
+static long int processSamples(cmd_ln_t *config, const std::vector<int16_t>& samples, std::vector<mfcc_t>& lastFrame)
+{
+    fe_t *fe = fe_init_auto_r(config);
+    const int32 blockFrames = 256;
+    mfcc_t **features = (mfcc_t **) ckd_calloc_2d(blockFrames, fe_get_output_size(fe), sizeof(mfcc_t));
+    const int16 *next = samples.data();
+    size_t remaining = samples.size();
+    long int numberOfFrames = 0;
+
+    fe_start_utt(fe);
+
+    while (remaining > 0)
+    {
+        int32 frames = blockFrames;
+        fe_process_frames(fe, &next, &remaining, features, &frames, nullptr);
+        numberOfFrames += frames;
+
+        if (frames > 0)
+            lastFrame.assign(features[frames - 1], features[frames - 1] + fe_get_output_size(fe));
+    }
+
+    int32 frames = 0;
+    fe_end_utt(fe, features[0], &frames);
+    numberOfFrames += frames;
+
+    ckd_free_2d(features);
+    fe_free(fe);
+
+    return numberOfFrames;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage : fe_benchmark /path/to/file.wav [front end arguments...]\n";
+        return 1;
+    }
+
+    const std::string fileName(argv[1]);
+    std::vector<char *> arguments = {argv[0], (char *) "-lowerf", (char *) "130", (char *) "-upperf", (char *) "6800",
+                                     (char *) "-nfilt", (char *) "25", (char *) "-transform", (char *) "dct",
+                                     (char *) "-lifter", (char *) "22", (char *) "-remove_silence", (char *) "no"};
+    arguments.insert(arguments.end(), argv + 2, argv + argc);
+
+    getLogger().setMinimumOutputLevel(Logger::Level::warning);
+    err_set_logfp(nullptr);
+
+    try {
+        FileAudioSource source(fileName);
+        std::vector<int16_t> samples(source.getNumberOfSamples());
+        source.read(0, samples.size(), samples.data());
+
+        cmd_ln_t *config = cmd_ln_parse_r(nullptr, feArguments, arguments.size(), arguments.data(), FALSE);
+
+        if (config == nullptr)
+        {
+            FATAL(InvalidParameters) << "Invalid front end arguments";
+        }
+
+        std::cout << fileName << " : " << (double) samples.size() / audioSampleRate << " s of audio\n";
+
+        const fe_simd_t best = fe_set_simd(FE_SIMD_AVX2);
+        const int numberOfPasses = 3;
+        std::vector<mfcc_t> portableFrame, frame;
+        double portableSpeed = 0;
+
+        for (int simd = FE_SIMD_NONE; simd <= best; simd++)
+        {
+            fe_set_simd((fe_simd_t) simd);
+
+            //best of a few passes, the first one also warms up the caches
+            long int numberOfFrames = 0;
+            double took = 0;
+
+            for (int pass = 0; pass < numberOfPasses; pass++)
+            {
+                const auto startedAt = std::chrono::steady_clock::now();
+                numberOfFrames = processSamples(config, samples, simd == FE_SIMD_NONE ? portableFrame : frame);
+                const double passTook = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+
+                took = pass == 0 ? passTook : std::min(took, passTook);
+            }
+
+            const double speed = numberOfFrames / std::max(took, 1e-9);
+
+            if (simd == FE_SIMD_NONE)
+                portableSpeed = speed;
+
+            std::cout << getSimdName((fe_simd_t) simd) << " : " << numberOfFrames << " frames in " << took << " s, "
+                      << (long int) speed << " frames/s (x" << speed / portableSpeed << ")";
+
+            //the sums are rounded differently, the features should still agree to the last few bits
+            double difference = 0;
+
+            for (size_t i = 0; i < frame.size() && i < portableFrame.size(); i++)
+                difference = std::max(difference, (double) std::fabs(frame[i] - portableFrame[i]));
+
+            if (simd != FE_SIMD_NONE)
+                std::cout << ", last frame differs by " << difference;
+
+            std::cout << "\n";
+        }
+
+        cmd_ln_free_r(config);
+    }
+    catch (std::exception& e) {
+        std::cerr << "Benchmark aborted : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
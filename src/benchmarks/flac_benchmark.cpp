@@ -0,0 +1,97 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Decoding throughput of the FLAC input.
+ *
+ * Usage : flac_benchmark /path/to/file.flac [windowSeconds]
+ *
+ * Three passes are timed : decoding every frame without resampling, reading the whole file at 16KHz
+ * as the aligners do when they scan it, and reading random windows of the given length (5 s default)
+ * as they do when aligning cues.
+ */
+
+#include "flac_decoder.h"
+#include <chrono>
+#include <random>
+
+static double secondsSince(std::chrono::steady_clock::time_point startedAt)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+}
+
+static void printThroughput(const std::string& pass, double audioSeconds, double tookSeconds)
+{
+    std::cout << pass << " : " << audioSeconds << " s of audio in " << tookSeconds << " s ("
+              << audioSeconds / std::max(tookSeconds, 1e-9) << " x real time)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage : flac_benchmark /path/to/file.flac [windowSeconds]\n";
+        return 1;
+    }
+
+    const std::string fileName(argv[1]);
+    const long int windowSamples = (argc > 2 ? std::atof(argv[2]) : 5.0) * audioSampleRate;
+
+    getLogger().setMinimumOutputLevel(Logger::Level::warning);
+
+    try {
+        FlacDecoder decoder(fileName);
+        const FlacStreamInfo& streamInfo = decoder.getStreamInfo();
+
+        std::cout << fileName << " : " << streamInfo.sampleRate << " Hz, " << streamInfo.channels << " channels, "
+                  << streamInfo.bitsPerSample << " bits, " << decoder.getFileSize() / 1048576.0 << " MB\n";
+
+        //frames only
+        std::vector<float> frameSamples;
+        long int inputSamples = 0;
+        auto startedAt = std::chrono::steady_clock::now();
+
+        for (long int offset = decoder.getFirstFrameOffset(); offset < decoder.getFileSize(); )
+        {
+            offset = decoder.decodeFrame(offset, frameSamples);
+            inputSamples += frameSamples.size();
+        }
+
+        double took = secondsSince(startedAt);
+        printThroughput("Frame decoding", (double) inputSamples / streamInfo.sampleRate, took);
+        std::cout << "Frame decoding : " << decoder.getFileSize() / 1048576.0 / std::max(took, 1e-9) << " MB/s\n";
+
+        //whole file at 16KHz, the frames are indexed on the way
+        FlacAudioSource source(fileName);
+        std::vector<int16_t> samples(std::max(audioBlockSize, windowSamples));
+        startedAt = std::chrono::steady_clock::now();
+
+        for (long int startSample = 0; startSample < source.getNumberOfSamples(); startSample += audioBlockSize)
+            source.read(startSample, audioBlockSize, samples.data());
+
+        printThroughput("Sequential read", (double) source.getNumberOfSamples() / audioSampleRate, secondsSince(startedAt));
+
+        //random windows, using the index
+        const int numberOfWindows = 200;
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<long int> windowStart(0, std::max(0L, source.getNumberOfSamples() - windowSamples));
+        long int samplesRead = 0;
+        startedAt = std::chrono::steady_clock::now();
+
+        for (int window = 0; window < numberOfWindows; window++)
+            samplesRead += source.read(windowStart(generator), windowSamples, samples.data());
+
+        took = secondsSince(startedAt);
+        printThroughput("Random windows", (double) samplesRead / audioSampleRate, took);
+        std::cout << "Random windows : " << took * 1000 / numberOfWindows << " ms per window\n";
+    }
+    catch (std::exception& e) {
+        std::cerr << "Benchmark aborted : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
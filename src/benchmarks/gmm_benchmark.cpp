@@ -0,0 +1,165 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Throughput of the Gaussian mixture evaluation, with each instruction set the CPU supports.
+ *
+ * Usage : gmm_benchmark /path/to/file.wav [/path/to/acoustic/model] [decoder arguments...]
+ *
+ * The features of the whole file are computed once, then the senone scores of every frame are computed
+ * with the portable code and with every SIMD instruction set available (-gmm_simd), best of three passes.
+ * All the senones are scored in every frame, as with -compallsen yes, which is the most the decoder
+ * ever evaluates. The model defaults to the en-us one bundled with pocketsphinx. The SIMD code evaluates
+ * the same sums in the same order, so the scores of all the instruction sets must be identical. The
+ * decoder arguments are passed on to every run, e.g. -frame_block 8 to compute the densities of blocks
+ * of frames or -score_threads 4 to share them between threads.
+ */
+
+#include "commons.h"
+#include <pocketsphinx.h>
+#include <chrono>
+
+extern "C" {
+#include "pocketsphinx_internal.h"
+#include "mgau_simd.h"
+}
+
+#include "audio_source.h"
+
+//scores every frame of the utterance already in the acoustic model; returns a hash of the scores
+static uint64_t scoreFrames(acmod_t *acmod, long int& numberOfFrames)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    numberOfFrames = 0;
+
+    acmod_rewind(acmod);
+
+    while (acmod->n_feat_frame > 0)
+    {
+        const int16 *scores = acmod_score(acmod, nullptr);
+
+        for (int32 senone = 0; senone < bin_mdef_n_sen(acmod->mdef); senone++)
+        {
+            hash ^= (uint16_t) scores[senone];
+            hash *= 1099511628211ULL;
+        }
+
+        acmod_advance(acmod);
+        numberOfFrames++;
+    }
+
+    return hash;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage : gmm_benchmark /path/to/file.wav [/path/to/acoustic/model] [decoder arguments...]\n";
+        return 1;
+    }
+
+    const std::string fileName(argv[1]);
+    const bool hasModelPath = argc > 2 && argv[2][0] != '-';
+    const std::string modelPath = hasModelPath ? argv[2] : "lib_ext/pocketsphinx/model/en-us/en-us";
+    const std::vector<std::string> decoderArguments(argv + (hasModelPath ? 3 : 2), argv + argc);
+    const char *levels[] = {"none", "sse4", "avx2", "avx512"};
+
+    getLogger().setMinimumOutputLevel(Logger::Level::warning);
+    err_set_logfp(nullptr);
+
+    try {
+        FileAudioSource source(fileName);
+        std::vector<int16_t> samples(source.getNumberOfSamples());
+        source.read(0, samples.size(), samples.data());
+
+        std::cout << fileName << " : " << (double) samples.size() / audioSampleRate << " s of audio\n";
+
+        const int numberOfPasses = 3;
+        double portableSpeed = 0;
+        uint64_t portableHash = 0;
+
+        for (int level = MGAU_SIMD_NONE; level <= MGAU_SIMD_AVX512; level++)
+        {
+            std::vector<std::string> arguments = {argv[0], "-hmm", modelPath, "-gmm_simd", levels[level],
+                                                  "-compallsen", "yes", "-remove_silence", "no"};
+            arguments.insert(arguments.end(), decoderArguments.begin(), decoderArguments.end());
+
+            std::vector<char *> parameters;
+
+            for (std::string& argument : arguments)
+                parameters.push_back(&argument[0]);
+
+            cmd_ln_t *config = cmd_ln_parse_r(nullptr, ps_args(), parameters.size(), parameters.data(), FALSE);
+
+            if (config == nullptr)
+            {
+                FATAL(InvalidParameters) << "Invalid decoder arguments";
+            }
+
+            mgau_simd_t simd;
+            mgau_simd_init(config, &simd);
+
+            if ((int) simd != level)
+            {
+                std::cout << levels[level] << " : not supported\n";
+                cmd_ln_free_r(config);
+                continue;
+            }
+
+            ps_decoder_t *decoder = ps_init(config);
+
+            if (decoder == nullptr)
+            {
+                FATAL(FileNotFound) << "Unable to load the acoustic model : " << modelPath;
+            }
+
+            //the features are kept in memory to score them again on every pass
+            acmod_t *acmod = decoder->acmod;
+            const int16 *next = samples.data();
+            size_t remaining = samples.size();
+
+            acmod_set_grow(acmod, TRUE);
+            acmod_start_utt(acmod);
+            acmod_process_raw(acmod, &next, &remaining, TRUE);
+            acmod_end_utt(acmod);
+
+            long int numberOfFrames = 0;
+            uint64_t hash = 0;
+            double took = 0;
+
+            for (int pass = 0; pass < numberOfPasses; pass++)
+            {
+                const auto startedAt = std::chrono::steady_clock::now();
+                hash = scoreFrames(acmod, numberOfFrames);
+                const double passTook = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+
+                took = pass == 0 ? passTook : std::min(took, passTook);
+            }
+
+            const double speed = numberOfFrames / std::max(took, 1e-9);
+
+            if (level == MGAU_SIMD_NONE)
+            {
+                portableSpeed = speed;
+                portableHash = hash;
+            }
+
+            std::cout << levels[level] << " : " << numberOfFrames << " frames in " << took << " s, "
+                      << (long int) speed << " frames/s (x" << speed / portableSpeed << ")"
+                      << (hash == portableHash ? "" : ", SCORES DIFFER from the portable code") << "\n";
+
+            ps_free(decoder);
+            cmd_ln_free_r(config);
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Benchmark aborted : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
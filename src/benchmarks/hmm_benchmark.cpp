@@ -0,0 +1,129 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Real time factor of the decoder with the HMMs evaluated one at a time and in batches with every SIMD
+ * instruction set the CPU supports (-hmm_simd).
+ *
+ * Usage : hmm_benchmark /path/to/file.wav [decoder arguments...]
+ *
+ * The whole file is decoded as one utterance with every instruction set, best of three passes. The batches
+ * are used by the lexicon tree search of a language model and by the grammar search, so the decoder
+ * arguments must choose one of them, e.g. -lm words.lm or -jsgf words.jsgf; the acoustic model and the
+ * dictionary default to the en-us ones bundled with pocketsphinx. Add -fwdflat no to time the tree search
+ * alone. The batches compute the same scores as one HMM at a time, so the hypothesis must be the same with
+ * all the instruction sets.
+ */
+
+#include "audio_source.h"
+#include <pocketsphinx.h>
+#include <sphinxbase/err.h>
+#include <chrono>
+
+extern "C" {
+#include "mgau_simd.h"
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage : hmm_benchmark /path/to/file.wav [decoder arguments...]\n";
+        return 1;
+    }
+
+    const std::string fileName(argv[1]);
+    const std::string modelPath = "lib_ext/pocketsphinx/model/en-us/";
+    const std::vector<std::string> decoderArguments(argv + 2, argv + argc);
+    const char *levels[] = {"none", "sse4", "avx2", "avx512"};
+
+    getLogger().setMinimumOutputLevel(Logger::Level::warning);
+    err_set_logfp(nullptr);
+
+    try {
+        FileAudioSource source(fileName);
+        std::vector<int16_t> samples(source.getNumberOfSamples());
+        source.read(0, samples.size(), samples.data());
+
+        const double audioSeconds = (double) samples.size() / audioSampleRate;
+        const int numberOfPasses = 3;
+        std::string portableHypothesis;
+        double portableTook = 0;
+
+        std::cout << fileName << " : " << audioSeconds << " s of audio\n";
+
+        for (int level = MGAU_SIMD_NONE; level <= MGAU_SIMD_AVX512; level++)
+        {
+            if (!mgau_simd_supported((mgau_simd_t) level))
+            {
+                std::cout << levels[level] << " : not supported\n";
+                continue;
+            }
+
+            std::vector<std::string> arguments = {argv[0], "-hmm", modelPath + "en-us",
+                                                  "-dict", modelPath + "cmudict-en-us.dict",
+                                                  "-hmm_simd", levels[level]};
+            arguments.insert(arguments.end(), decoderArguments.begin(), decoderArguments.end());
+
+            std::vector<char *> parameters;
+
+            for (std::string& argument : arguments)
+                parameters.push_back(&argument[0]);
+
+            cmd_ln_t *config = cmd_ln_parse_r(nullptr, ps_args(), parameters.size(), parameters.data(), FALSE);
+
+            if (config == nullptr)
+            {
+                FATAL(InvalidParameters) << "Invalid decoder arguments";
+            }
+
+            ps_decoder_t *decoder = ps_init(config);
+
+            if (decoder == nullptr)
+            {
+                FATAL(FileNotFound) << "Unable to initialise the decoder";
+            }
+
+            std::string hypothesis;
+            double took = 0;
+
+            for (int pass = 0; pass < numberOfPasses; pass++)
+            {
+                const auto startedAt = std::chrono::steady_clock::now();
+
+                ps_start_utt(decoder);
+                ps_process_raw(decoder, samples.data(), samples.size(), FALSE, TRUE);
+                ps_end_utt(decoder);
+
+                const double passTook = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+                const char *passHypothesis = ps_get_hyp(decoder, nullptr);
+
+                hypothesis = passHypothesis ? passHypothesis : "";
+                took = pass == 0 ? passTook : std::min(took, passTook);
+            }
+
+            if (level == MGAU_SIMD_NONE)
+            {
+                portableHypothesis = hypothesis;
+                portableTook = took;
+            }
+
+            std::cout << levels[level] << " : " << took / audioSeconds << " x real time (x"
+                      << portableTook / std::max(took, 1e-9) << ")"
+                      << (hypothesis == portableHypothesis ? "" : ", HYPOTHESIS DIFFERS from one HMM at a time")
+                      << "\n";
+
+            ps_free(decoder);
+            cmd_ln_free_r(config);
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Benchmark aborted : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Speed and accuracy of the compact log-add table (-logadd compact) against the full one.
+ *
+ * Usage : logmath_benchmark /path/to/file.wav [tolerance in frames] [decoder arguments...]
+ *
+ * First, sums of random pairs of log probabilities one at a time with both tables, and eight at a time with
+ * logmath_add_array(). Then the whole file is decoded as one utterance with both tables, best of three passes,
+ * timing the lattice pass (best path and posterior probabilities) apart from the search. The words must be
+ * the same and their start and end frames within the tolerance (default 1 frame, 10 ms) of those found with
+ * the full table; the largest difference of their posterior probabilities is printed too. The decoder
+ * arguments must choose a language model, e.g. -lm words.lm; the acoustic model and the dictionary default to
+ * the en-us ones bundled with pocketsphinx.
+ */
+
+#include "audio_source.h"
+#include <pocketsphinx.h>
+#include <sphinxbase/err.h>
+#include <sphinxbase/logmath.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(const Clock::time_point& startedAt)
+{
+    return std::chrono::duration<double>(Clock::now() - startedAt).count();
+}
+
+struct Word
+{
+    std::string word;
+    int startFrame, endFrame;
+    double posterior;
+};
+
+struct Decoding
+{
+    std::vector<Word> words;
+    double searchTook, latticeTook;
+};
+
+//best of three passes over the pairs, in nanoseconds per sum
+static double timeSums(logmath_t *lmath, const std::vector<int>& x, const std::vector<int>& y, bool array,
+                       std::vector<int>& sums)
+{
+    const int numberOfPasses = 3;
+    double took = 0;
+
+    for (int pass = 0; pass < numberOfPasses; pass++)
+    {
+        sums = x;
+
+        const auto startedAt = Clock::now();
+
+        if (array)
+            logmath_add_array(lmath, sums.data(), y.data(), sums.size());
+        else
+            for (size_t i = 0; i < sums.size(); i++)
+                sums[i] = logmath_add(lmath, sums[i], y[i]);
+
+        const double passTook = secondsSince(startedAt);
+        took = pass == 0 ? passTook : std::min(took, passTook);
+    }
+
+    return took * 1e9 / x.size();
+}
+
+static Decoding decode(const std::vector<std::string>& baseArguments, const std::string& logadd,
+                       const std::vector<int16_t>& samples)
+{
+    std::vector<std::string> arguments = baseArguments;
+    arguments.insert(arguments.begin() + 1, {"-logadd", logadd});
+
+    std::vector<char *> parameters;
+
+    for (std::string& argument : arguments)
+        parameters.push_back(&argument[0]);
+
+    cmd_ln_t *config = cmd_ln_parse_r(nullptr, ps_args(), parameters.size(), parameters.data(), FALSE);
+
+    if (config == nullptr)
+    {
+        FATAL(InvalidParameters) << "Invalid decoder arguments";
+    }
+
+    ps_decoder_t *decoder = ps_init(config);
+
+    if (decoder == nullptr)
+    {
+        FATAL(FileNotFound) << "Unable to initialise the decoder";
+    }
+
+    const int numberOfPasses = 3;
+    Decoding decoding;
+
+    for (int pass = 0; pass < numberOfPasses; pass++)
+    {
+        auto startedAt = Clock::now();
+
+        ps_start_utt(decoder);
+        ps_process_raw(decoder, samples.data(), samples.size(), FALSE, TRUE);
+        ps_end_utt(decoder);
+
+        const double searchTook = secondsSince(startedAt);
+
+        //the best path and the posterior probabilities are computed with the first hypothesis
+        startedAt = Clock::now();
+        ps_get_hyp(decoder, nullptr);
+
+        const double latticeTook = secondsSince(startedAt);
+
+        decoding.searchTook = pass == 0 ? searchTook : std::min(decoding.searchTook, searchTook);
+        decoding.latticeTook = pass == 0 ? latticeTook : std::min(decoding.latticeTook, latticeTook);
+    }
+
+    logmath_t *lmath = ps_get_logmath(decoder);
+
+    for (ps_seg_t *iter = ps_seg_iter(decoder); iter != nullptr; iter = ps_seg_next(iter))
+    {
+        Word word;
+
+        word.word = ps_seg_word(iter);
+        ps_seg_frames(iter, &word.startFrame, &word.endFrame);
+        word.posterior = logmath_exp(lmath, ps_seg_prob(iter, nullptr, nullptr, nullptr));
+        decoding.words.push_back(word);
+    }
+
+    ps_free(decoder);
+    cmd_ln_free_r(config);
+
+    return decoding;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage : logmath_benchmark /path/to/file.wav [tolerance in frames] [decoder arguments...]\n";
+        return 1;
+    }
+
+    const std::string fileName(argv[1]);
+    const std::string modelPath = "lib_ext/pocketsphinx/model/en-us/";
+    const bool hasTolerance = argc > 2 && argv[2][0] != '-';
+    const int tolerance = hasTolerance ? std::stoi(argv[2]) : 1;
+    std::vector<std::string> arguments = {argv[0], "-hmm", modelPath + "en-us", "-dict", modelPath + "cmudict-en-us.dict"};
+
+    arguments.insert(arguments.end(), argv + (hasTolerance ? 3 : 2), argv + argc);
+
+    getLogger().setMinimumOutputLevel(Logger::Level::warning);
+    err_set_logfp(nullptr);
+
+    try {
+        //differences spread over the whole full table, a few beyond it, and some additions of zero
+        logmath_t *full = logmath_init(1.0001, 0, TRUE);
+        logmath_t *compact = logmath_init_compact(1.0001, 0);
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> score(-5000000, 0), difference(0, 120000);
+        std::vector<int> x(1 << 20), y(x.size());
+
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            x[i] = random() % 64 == 0 ? logmath_get_zero(full) : score(random);
+            y[i] = x[i] - difference(random);
+        }
+
+        std::vector<int> fullSums, compactSums, arraySums;
+        const double fullSpeed = timeSums(full, x, y, false, fullSums);
+        const double compactSpeed = timeSums(compact, x, y, false, compactSums);
+        const double arraySpeed = timeSums(compact, x, y, true, arraySums);
+        int worst = 0;
+
+        for (size_t i = 0; i < x.size(); i++)
+            worst = std::max(worst, std::abs(compactSums[i] - fullSums[i]));
+
+        std::cout << "full table    : " << logmath_get_table_shape(full, nullptr, nullptr, nullptr) << " bytes, "
+                  << fullSpeed << " ns/sum\n";
+        std::cout << "compact table : " << logmath_get_table_shape(compact, nullptr, nullptr, nullptr) << " bytes, "
+                  << compactSpeed << " ns/sum (x" << fullSpeed / std::max(compactSpeed, 1e-9) << "), "
+                  << arraySpeed << " ns/sum of arrays (x" << fullSpeed / std::max(arraySpeed, 1e-9) << "), "
+                  << "off by " << worst << " at most"
+                  << (arraySums == compactSums ? "" : ", ARRAYS DIFFER from one sum at a time") << "\n";
+
+        logmath_free(full);
+        logmath_free(compact);
+
+        //word timings of a decoding
+        FileAudioSource source(fileName);
+        std::vector<int16_t> samples(source.getNumberOfSamples());
+        source.read(0, samples.size(), samples.data());
+
+        std::cout << fileName << " : " << (double) samples.size() / audioSampleRate << " s of audio\n";
+
+        const Decoding table = decode(arguments, "table", samples);
+        const Decoding interpolated = decode(arguments, "compact", samples);
+        bool sameWords = table.words.size() == interpolated.words.size();
+        int worstFrames = 0;
+        double worstPosterior = 0;
+
+        for (size_t i = 0; sameWords && i < table.words.size(); i++)
+        {
+            const Word& a = table.words[i];
+            const Word& b = interpolated.words[i];
+
+            sameWords = a.word == b.word;
+            worstFrames = std::max({worstFrames, std::abs(a.startFrame - b.startFrame), std::abs(a.endFrame - b.endFrame)});
+            worstPosterior = std::max(worstPosterior, std::fabs(a.posterior - b.posterior));
+        }
+
+        std::cout << "table   : search " << table.searchTook << " s, lattice " << table.latticeTook << " s, "
+                  << table.words.size() << " words\n";
+        std::cout << "compact : search " << interpolated.searchTook << " s, lattice " << interpolated.latticeTook
+                  << " s (x" << table.latticeTook / std::max(interpolated.latticeTook, 1e-9) << "), ";
+
+        if (!sameWords)
+            std::cout << "WORDS DIFFER from the full table\n";
+        else
+            std::cout << "word timings within " << worstFrames << " frames"
+                      << (worstFrames <= tolerance ? "" : ", OUT OF TOLERANCE") << ", posteriors within "
+                      << worstPosterior << "\n";
+
+        return sameWords && worstFrames <= tolerance ? 0 : 1;
+    }
+    catch (std::exception& e) {
+        std::cerr << "Benchmark aborted : " << e.what() << std::endl;
+        return 1;
+    }
+}
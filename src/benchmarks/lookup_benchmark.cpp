@@ -0,0 +1,206 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Word lookups of the chained hash table of sphinxbase against the open addressing one the dictionary and
+ * the language models use.
+ *
+ * Usage : lookup_benchmark [/path/to/dictionary] [/path/to/acoustic/model]
+ *
+ * Every word of the dictionary (default, the cmudict bundled with pocketsphinx, about 135k words) is entered
+ * in both tables, then looked up in a shuffled order along with as many words which aren't there, best of
+ * three passes. Both tables must find the same ids. Last, the dictionary itself is read with the acoustic
+ * model (default, the bundled en-us one) and every word looked up with dict_wordid(). Run from src to use the
+ * bundled models.
+ */
+
+#include "commons.h"
+#include <pocketsphinx.h>
+#include <sphinxbase/hash_table.h>
+#include <sphinxbase/word_hash.h>
+#include <sphinxbase/err.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+extern "C" {
+#include "dict.h"
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(const Clock::time_point& startedAt)
+{
+    return std::chrono::duration<double>(Clock::now() - startedAt).count();
+}
+
+//first word of every line, as the dictionary reader takes it
+static std::vector<std::string> readWords(const std::string& fileName)
+{
+    std::ifstream in(fileName);
+    std::vector<std::string> words;
+    std::string line;
+
+    if (!in)
+    {
+        FATAL(FileNotFound) << "Unable to open dictionary : " << fileName;
+    }
+
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        std::string word;
+
+        if (fields >> word && word.compare(0, 2, "##") != 0)
+            words.push_back(word);
+    }
+
+    return words;
+}
+
+//best time of three passes over the queries, in nanoseconds per lookup; found receives the id of every query
+template <typename Lookup>
+static double timeLookups(const std::vector<const char *>& queries, std::vector<int32>& found, Lookup lookup)
+{
+    const int numberOfPasses = 3;
+    double took = 0;
+
+    found.assign(queries.size(), -1);
+
+    for (int pass = 0; pass < numberOfPasses; pass++)
+    {
+        const auto startedAt = Clock::now();
+
+        for (size_t i = 0; i < queries.size(); i++)
+            found[i] = lookup(queries[i]);
+
+        const double passTook = secondsSince(startedAt);
+        took = pass == 0 ? passTook : std::min(took, passTook);
+    }
+
+    return took * 1e9 / queries.size();
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string modelPath = "lib_ext/pocketsphinx/model/en-us/";
+    const std::string dictionaryPath = argc > 1 ? argv[1] : modelPath + "cmudict-en-us.dict";
+    const std::string acousticModelPath = argc > 2 ? argv[2] : modelPath + "en-us";
+
+    err_set_logfp(nullptr);
+
+    try {
+        const std::vector<std::string> words = readWords(dictionaryPath);
+        std::vector<std::string> missing;
+        std::vector<const char *> queries;
+
+        for (const std::string& word : words)
+        {
+            missing.push_back(word + "#");
+            queries.push_back(word.c_str());
+        }
+
+        for (const std::string& word : missing)
+            queries.push_back(word.c_str());
+
+        std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+
+        //a few thousand words looked up again and again, as those of the subtitles, stay in the caches
+        std::vector<const char *> frequentQueries;
+
+        for (int repeat = 0; repeat < 64; repeat++)
+            frequentQueries.insert(frequentQueries.end(), queries.begin(), queries.begin() + std::min<size_t>(4096, queries.size()));
+
+        std::cout << dictionaryPath << " : " << words.size() << " words, " << queries.size()
+                  << " lookups, half of them missing\n";
+
+        //the chained table, as before
+        auto startedAt = Clock::now();
+        hash_table_t *chained = hash_table_new(words.size(), HASH_CASE_YES);
+
+        for (size_t i = 0; i < words.size(); i++)
+            hash_table_enter_int32(chained, words[i].c_str(), i);
+
+        const double chainedBuild = secondsSince(startedAt);
+        auto chainedLookup = [chained](const char *word) {
+            int32 id;
+            return hash_table_lookup_int32(chained, word, &id) < 0 ? -1 : id;
+        };
+        std::vector<int32> chainedFound, unused;
+        const double chainedSpeed = timeLookups(queries, chainedFound, chainedLookup);
+        const double chainedFrequentSpeed = timeLookups(frequentQueries, unused, chainedLookup);
+
+        //the open addressing table
+        startedAt = Clock::now();
+        word_hash_t *open = word_hash_new(words.size(), HASH_CASE_YES);
+
+        for (size_t i = 0; i < words.size(); i++)
+            word_hash_enter(open, words[i].c_str(), i);
+
+        const double openBuild = secondsSince(startedAt);
+        auto openLookup = [open](const char *word) {
+            int32 id;
+            return word_hash_lookup(open, word, &id) < 0 ? -1 : id;
+        };
+        std::vector<int32> openFound;
+        const double openSpeed = timeLookups(queries, openFound, openLookup);
+        const double openFrequentSpeed = timeLookups(frequentQueries, unused, openLookup);
+
+        std::cout << "hash_table : built in " << chainedBuild << " s, " << chainedSpeed << " ns/lookup, "
+                  << chainedFrequentSpeed << " ns/lookup of frequent words\n";
+        std::cout << "word_hash  : built in " << openBuild << " s, " << openSpeed << " ns/lookup (x"
+                  << chainedSpeed / std::max(openSpeed, 1e-9) << "), " << openFrequentSpeed
+                  << " ns/lookup of frequent words (x" << chainedFrequentSpeed / std::max(openFrequentSpeed, 1e-9) << ")"
+                  << (openFound == chainedFound ? "" : ", IDS DIFFER from hash_table") << "\n";
+
+        hash_table_free(chained);
+        word_hash_free(open);
+
+        //the dictionary of the decoder
+        std::vector<std::string> arguments = {argv[0], "-hmm", acousticModelPath, "-dict", dictionaryPath};
+        std::vector<char *> parameters;
+
+        for (std::string& argument : arguments)
+            parameters.push_back(&argument[0]);
+
+        cmd_ln_t *config = cmd_ln_parse_r(nullptr, ps_args(), parameters.size(), parameters.data(), FALSE);
+        bin_mdef_t *mdef = bin_mdef_read(config, (acousticModelPath + "/mdef").c_str());
+
+        if (mdef == nullptr)
+        {
+            FATAL(FileNotFound) << "Unable to read the acoustic model : " << acousticModelPath;
+        }
+
+        startedAt = Clock::now();
+        dict_t *dict = dict_init(config, mdef);
+        const double dictRead = secondsSince(startedAt);
+
+        if (dict == nullptr)
+        {
+            FATAL(InvalidFile) << "Unable to read dictionary : " << dictionaryPath;
+        }
+
+        auto dictLookup = [dict](const char *word) {
+            return (int32) dict_wordid(dict, word);
+        };
+        std::vector<int32> dictFound;
+        const double dictSpeed = timeLookups(queries, dictFound, dictLookup);
+        const double dictFrequentSpeed = timeLookups(frequentQueries, dictFound, dictLookup);
+
+        std::cout << "dict_wordid : dictionary read in " << dictRead << " s, " << dictSpeed << " ns/lookup, "
+                  << dictFrequentSpeed << " ns/lookup of frequent words\n";
+
+        dict_free(dict);
+        bin_mdef_free(mdef);
+        cmd_ln_free_r(config);
+    }
+    catch (std::exception& e) {
+        std::cerr << "Benchmark aborted : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
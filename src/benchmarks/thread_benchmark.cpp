@@ -0,0 +1,119 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+/*
+ * Real time factor of a single decoder against the number of threads scoring its senones (-score_threads).
+ *
+ * Usage : thread_benchmark /path/to/file.wav [maximum threads] [decoder arguments...]
+ *
+ * The whole file is decoded as one utterance, as in transcription or with a very long cue, once with
+ * every number of threads from one to the maximum (default, the number of cores). The decoder arguments
+ * default to the phoneme decoder of ccaligner over the en-us model bundled with pocketsphinx; when given
+ * they replace it, e.g. -hmm model -lm words.lm -dict words.dict. The real time factor only counts the
+ * decoding, not the loading of the model. The threads share the work of every frame without changing it,
+ * so the hypothesis must be the same with any number of them.
+ */
+
+#include "audio_source.h"
+#include <pocketsphinx.h>
+#include <sphinxbase/err.h>
+#include <chrono>
+#include <thread>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage : thread_benchmark /path/to/file.wav [maximum threads] [decoder arguments...]\n";
+        return 1;
+    }
+
+    const std::string fileName(argv[1]);
+    const std::string modelPath = "lib_ext/pocketsphinx/model/en-us/";
+    int maximumThreads = std::max(1, (int) std::thread::hardware_concurrency());
+    int firstDecoderArgument = 2;
+
+    if (argc > 2 && argv[2][0] != '-')
+    {
+        maximumThreads = std::max(1, std::atoi(argv[2]));
+        firstDecoderArgument = 3;
+    }
+
+    std::vector<std::string> decoderArguments(argv + firstDecoderArgument, argv + argc);
+
+    if (decoderArguments.empty())
+        decoderArguments = {"-hmm", modelPath + "en-us", "-allphone", modelPath + "en-us-phone.lm.bin",
+                            "-allphone_ci", "no", "-beam", "1e-20", "-pbeam", "1e-10", "-lw", "2.0"};
+
+    getLogger().setMinimumOutputLevel(Logger::Level::warning);
+    err_set_logfp(nullptr);
+
+    try {
+        FileAudioSource source(fileName);
+        std::vector<int16_t> samples(source.getNumberOfSamples());
+        source.read(0, samples.size(), samples.data());
+
+        const double audioSeconds = (double) samples.size() / audioSampleRate;
+        std::string firstHypothesis;
+        double firstTook = 0;
+
+        std::cout << fileName << " : " << audioSeconds << " s of audio\n";
+
+        for (int threads = 1; threads <= maximumThreads; threads++)
+        {
+            std::vector<std::string> arguments = {argv[0], "-score_threads", std::to_string(threads)};
+            arguments.insert(arguments.end(), decoderArguments.begin(), decoderArguments.end());
+
+            std::vector<char *> parameters;
+
+            for (std::string& argument : arguments)
+                parameters.push_back(&argument[0]);
+
+            cmd_ln_t *config = cmd_ln_parse_r(nullptr, ps_args(), parameters.size(), parameters.data(), FALSE);
+
+            if (config == nullptr)
+            {
+                FATAL(InvalidParameters) << "Invalid decoder arguments";
+            }
+
+            ps_decoder_t *decoder = ps_init(config);
+
+            if (decoder == nullptr)
+            {
+                FATAL(FileNotFound) << "Unable to initialise the decoder";
+            }
+
+            const auto startedAt = std::chrono::steady_clock::now();
+
+            ps_start_utt(decoder);
+            ps_process_raw(decoder, samples.data(), samples.size(), FALSE, TRUE);
+            ps_end_utt(decoder);
+
+            const double took = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+            const char *hypothesis = ps_get_hyp(decoder, nullptr);
+
+            if (threads == 1)
+            {
+                firstHypothesis = hypothesis ? hypothesis : "";
+                firstTook = took;
+            }
+
+            std::cout << threads << " thread" << (threads > 1 ? "s" : "") << " : " << took / audioSeconds
+                      << " x real time (x" << firstTook / std::max(took, 1e-9) << ")"
+                      << ((hypothesis ? hypothesis : "") == firstHypothesis ? "" : ", HYPOTHESIS DIFFERS from one thread")
+                      << "\n";
+
+            ps_free(decoder);
+            cmd_ln_free_r(config);
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Benchmark aborted : " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
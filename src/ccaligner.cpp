@@ -66,6 +66,10 @@ int CCAligner::initAligner()
     {
         PocketsphinxAligner(_parameters).align();
     }
+    else if(_parameters->chosenAlignerType == syncAligner)
+    {
+        FastSyncAligner(_parameters).align();
+    }
     else
     {
         FATAL(InvalidParameters) << "Unsupported Aligner Type!";
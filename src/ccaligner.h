@@ -9,6 +9,7 @@
 
 #include "params.h"
 #include "recognize_using_pocketsphinx.h"
+#include "fast_sync.h"
 
 class CCAligner
 {
@@ -0,0 +1,365 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "audio_source.h"
+#include "flac_decoder.h"
+#include <cmath>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+static unsigned long fourBytesToInt(const unsigned char *bytes)
+{
+    return ((unsigned long) bytes[3] << 24) | (bytes[2] << 16) | (bytes[1] << 8) | bytes[0];
+}
+
+static int twoBytesToInt(const unsigned char *bytes)
+{
+    return (bytes[1] << 8) | bytes[0];
+}
+
+RandomAccessFile::RandomAccessFile(const std::string& fileName)
+    : _fileName(fileName)
+{
+    DEBUG << "Trying to read from file : " << _fileName;
+
+#ifdef _WIN32
+    _file.open(_fileName, std::ios::binary);
+
+    if (!_file)
+    {
+        FATAL(FileNotFound) << "Unable to open file : " << _fileName;
+    }
+
+    _file.seekg(0, std::ios::end);
+    _size = _file.tellg();
+#else
+    _fd = open(_fileName.c_str(), O_RDONLY);
+
+    if (_fd < 0)
+    {
+        FATAL(FileNotFound) << "Unable to open file : " << _fileName;
+    }
+
+    struct stat fileStatus;
+    fstat(_fd, &fileStatus);
+    _size = fileStatus.st_size;
+#endif
+}
+
+RandomAccessFile::~RandomAccessFile()
+{
+#ifndef _WIN32
+    close(_fd);
+#endif
+}
+
+const std::string& RandomAccessFile::getFileName() const noexcept
+{
+    return _fileName;
+}
+
+long int RandomAccessFile::getSize() const noexcept
+{
+    return _size;
+}
+
+bool RandomAccessFile::readBytes(long int offset, long int count, void *buffer) const
+{
+    return readAvailableBytes(offset, count, buffer) == count;
+}
+
+long int RandomAccessFile::readAvailableBytes(long int offset, long int count, void *buffer) const
+{
+    count = std::max(0L, std::min(count, _size - offset));
+
+#ifdef _WIN32
+    std::lock_guard<std::mutex> lock(_fileMutex);
+
+    _file.clear();
+    _file.seekg(offset);
+    _file.read(static_cast<char *>(buffer), count);
+
+    return _file.gcount();
+#else
+    char *bytes = static_cast<char *>(buffer);
+    long int bytesLeft = count;
+
+    while (bytesLeft > 0)
+    {
+        ssize_t bytesRead = pread(_fd, bytes, bytesLeft, offset);
+
+        if (bytesRead <= 0)
+            break;
+
+        bytes += bytesRead;
+        offset += bytesRead;
+        bytesLeft -= bytesRead;
+    }
+
+    return count - bytesLeft;
+#endif
+}
+
+Resampler::Resampler(long int inputRate, long int outputRate)
+{
+    /*
+     * The input is interpolated with a Blackman windowed sinc, low passed below the Nyquist frequency of
+     * the lower of the two rates. With the rates reduced to upFactor / downFactor, an output sample falls
+     * on one of upFactor positions between two input samples, each of which gets its own set of taps.
+     */
+
+    long int a = inputRate, b = outputRate;
+
+    while (b != 0)
+    {
+        long int remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+
+    _upFactor = outputRate / a;
+    _downFactor = inputRate / a;
+
+    const double pi = 3.14159265358979323846;
+    const int zeroCrossings = 16;       //of the sinc on either side
+    const double cutoff = _upFactor < _downFactor ? 0.95 * _upFactor / _downFactor : 1.0;  //relative to the input Nyquist frequency
+
+    _halfLength = (long int) std::ceil(zeroCrossings / cutoff);
+    _filter.resize(_upFactor * 2 * _halfLength);
+
+    for (long int phase = 0; phase < _upFactor; phase++)
+    {
+        for (long int tap = 0; tap < 2 * _halfLength; tap++)
+        {
+            //distance of the input sample from the output sample, in input samples
+            double t = tap - _halfLength + 1 - (double) phase / _upFactor;
+            double x = pi * cutoff * t;
+            double sinc = x == 0 ? 1.0 : std::sin(x) / x;
+            double window = 0.42 + 0.5 * std::cos(pi * t / _halfLength) + 0.08 * std::cos(2 * pi * t / _halfLength);
+
+            _filter[phase * 2 * _halfLength + tap] = (float) (cutoff * sinc * window);
+        }
+    }
+}
+
+long int Resampler::getFirstInput(long int outputSample) const noexcept
+{
+    return (long int) ((int64_t) outputSample * _downFactor / _upFactor) - _halfLength + 1;
+}
+
+long int Resampler::getLastInput(long int outputSample) const noexcept
+{
+    return (long int) ((int64_t) outputSample * _downFactor / _upFactor) + _halfLength + 1;
+}
+
+long int Resampler::getNumberOfOutputs(long int numberOfInputs) const noexcept
+{
+    return (long int) ((int64_t) numberOfInputs * _upFactor / _downFactor);
+}
+
+void Resampler::resample(const std::vector<float>& input, long int firstInput, long int startSample, long int count, int16_t *samples) const
+{
+    const long int taps = 2 * _halfLength;
+
+    if (_upFactor == _downFactor)   //same rate, samples are only converted
+    {
+        for (long int i = 0; i < count; i++)
+            samples[i] = (int16_t) std::max(-32768.0f, std::min(32767.0f, std::round(input[startSample + i - firstInput])));
+
+        return;
+    }
+
+    for (long int i = 0; i < count; i++)
+    {
+        int64_t position = (int64_t) (startSample + i) * _downFactor;
+        long int inputSample = (long int) (position / _upFactor) - _halfLength + 1 - firstInput;
+        const float *filter = _filter.data() + (position % _upFactor) * taps;
+
+        //taps reaching past either end of the input are dropped
+        long int firstTap = std::max(0L, -inputSample);
+        long int lastTap = std::min(taps, (long int) input.size() - inputSample);
+        float sum = 0;
+
+        for (long int tap = firstTap; tap < lastTap; tap++)
+            sum += filter[tap] * input[inputSample + tap];
+
+        samples[i] = (int16_t) std::max(-32768.0f, std::min(32767.0f, std::round(sum)));
+    }
+}
+
+std::vector<int16_t> AudioSource::read(long int startSample, long int count) const
+{
+    startSample = std::max(0L, std::min(startSample, getNumberOfSamples()));
+    count = std::max(0L, std::min(count, getNumberOfSamples() - startSample));
+
+    std::vector<int16_t> samples(count);
+    samples.resize(read(startSample, count, samples.data()));
+
+    return samples;
+}
+
+FileAudioSource::FileAudioSource(const std::string& fileName, bool isRawFile)
+    : _file(fileName),
+      _dataOffset(0),
+      _numberOfSamples(0)
+{
+    if (isRawFile)
+    {
+        DEBUG << "Decoding is skipped since it is raw audio file";
+        _numberOfSamples = _file.getSize() / 2;
+    }
+    else
+    {
+        readHeader();
+    }
+
+    DEBUG << "Number of samples : " << _numberOfSamples;
+}
+
+void FileAudioSource::readHeader()
+{
+    /*
+     * Same checks as WaveFileData::decode(), but only the header is read : the RIFF header is followed by
+     * subchunks, each an ID and the size of its content. Metadata like LIST INFO may be found before or
+     * between the 'fmt ' and the 'data' subchunk, thus the subchunks are walked till 'data' is found.
+     */
+
+    unsigned char riffHeader[12], chunkHeader[8], fmtChunk[16];
+    unsigned long chunkSize = 0;
+    bool fmtFound = false;
+
+    if (!_file.readBytes(0, 12, riffHeader) || std::string(riffHeader, riffHeader + 4) != "RIFF")
+    {
+        DEBUG << "Invalid WAV file";
+        FATAL(InvalidFile) << "Invalid WAV file!";
+    }
+
+    std::string format(riffHeader + 8, riffHeader + 12);
+
+    if (format != "WAVE")
+    {
+        FATAL(InvalidFile) << "Invalid WAV file format : " << format;
+    }
+
+    DEBUG << "File format is identified as WAV";
+
+    for (long int offset = 12; ; offset += 8 + chunkSize + (chunkSize & 1))  //subchunks are padded to even sizes
+    {
+        if (!_file.readBytes(offset, 8, chunkHeader))
+        {
+            FATAL(InvalidFile) << "Data subchunk not found!";
+        }
+
+        std::string chunkID(chunkHeader, chunkHeader + 4);
+        chunkSize = fourBytesToInt(chunkHeader + 4);
+
+        if (chunkID == "fmt ")
+        {
+            if (chunkSize != 16)
+            {
+                FATAL(InvalidFile) << "Not PCM, SubChunk1Size : " << chunkSize;
+            }
+
+            if (!_file.readBytes(offset + 8, 16, fmtChunk))
+            {
+                FATAL(InvalidFile) << "FMT subchunk not found!";
+            }
+
+            int audioFormat = twoBytesToInt(fmtChunk);
+            int numChannels = twoBytesToInt(fmtChunk + 2);
+            unsigned long sampleRate = fourBytesToInt(fmtChunk + 4);
+            unsigned long byteRate = fourBytesToInt(fmtChunk + 8);
+            int blockAlign = twoBytesToInt(fmtChunk + 12);
+            int bitRate = twoBytesToInt(fmtChunk + 14);
+
+            if (audioFormat != 1)
+                FATAL(InvalidFile) << "Not PCM, AudioFormat : " << audioFormat;
+
+            if (numChannels != 1)
+                FATAL(InvalidFile) << "Not Mono, NumChannels : " << numChannels;
+
+            if (sampleRate != 16000)
+                FATAL(InvalidFile) << "Not 16000Hz SampleRate, SampleRate : " << sampleRate;
+
+            if (bitRate != 16)
+                FATAL(InvalidFile) << "Not 16 bits/sec, BitRate : " << bitRate;
+
+            if ((byteRate != sampleRate * numChannels * bitRate / 8) || (blockAlign != numChannels * bitRate / 8))
+                FATAL(InvalidFile) << "Incorrect header, ByteRate and/or BlockAlign values do not match!";
+
+            fmtFound = true;
+        }
+
+        else if (chunkID == "data")
+        {
+            if (!fmtFound)
+            {
+                FATAL(InvalidFile) << "FMT subchunk not found!";
+            }
+
+            _dataOffset = offset + 8;
+
+            //recorders which were stopped abruptly leave a wrong size, the samples present in the file are used
+            _numberOfSamples = std::min<long int>(chunkSize, _file.getSize() - _dataOffset) / 2;
+            return;
+        }
+    }
+}
+
+long int FileAudioSource::getNumberOfSamples() const noexcept
+{
+    return _numberOfSamples;
+}
+
+long int FileAudioSource::read(long int startSample, long int count, int16_t *samples) const
+{
+    //samples are stored little endian, the same as in memory
+    count = std::max(0L, std::min(count, _numberOfSamples - startSample));
+
+    if (count > 0 && !_file.readBytes(_dataOffset + startSample * 2, count * 2, samples))
+    {
+        FATAL(InvalidFile) << "Unable to read from file : " << _file.getFileName();
+    }
+
+    return count;
+}
+
+MemoryAudioSource::MemoryAudioSource(std::unique_ptr<WaveFileData> file) noexcept
+    : _file(std::move(file))
+{}
+
+long int MemoryAudioSource::getNumberOfSamples() const noexcept
+{
+    return _file->getSamples().size();
+}
+
+long int MemoryAudioSource::read(long int startSample, long int count, int16_t *samples) const
+{
+    count = std::max(0L, std::min(count, getNumberOfSamples() - startSample));
+
+    if (count > 0)
+        memcpy(samples, _file->getSamples().data() + startSample, count * sizeof(int16_t));
+
+    return count;
+}
+
+std::unique_ptr<AudioSource> openAudioSource(Params *parameters)
+{
+    if (parameters->audioIsFlac)
+        return std::unique_ptr<AudioSource>(new FlacAudioSource(parameters->audioFileName));
+
+    if (!parameters->readStream)
+        return std::unique_ptr<AudioSource>(new FileAudioSource(parameters->audioFileName, parameters->audioIsRaw));
+
+    std::unique_ptr<WaveFileData> file(new WaveFileData(readStreamDirectly, parameters->audioIsRaw));
+    file->read();
+
+    return std::unique_ptr<AudioSource>(new MemoryAudioSource(std::move(file)));
+}
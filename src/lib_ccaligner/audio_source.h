@@ -0,0 +1,99 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_AUDIO_SOURCE_H
+#define CCALIGNER_AUDIO_SOURCE_H
+
+#include "commons.h"
+#include "read_wav_file.h"
+#include <mutex>
+
+/*
+ * Random access to the samples of the audio : PCM, 16 bit, sampled at 16KHz, mono. Audio on disk is
+ * never loaded as a whole, every window is read from the file when it is asked for, so the memory used
+ * doesn't grow with the length of the file. Sources can be read from several threads at once.
+ */
+
+constexpr long int audioBlockSize = 160000;   //10 s of audio, the unit in which whole audio is read
+constexpr long int audioSampleRate = 16000;
+
+class RandomAccessFile  //file on disk read at any offset, from several threads at once
+{
+    std::string _fileName;
+    long int _size;
+
+#ifdef _WIN32
+    mutable std::ifstream _file;
+    mutable std::mutex _fileMutex;              //the stream position is shared by all the readers
+#else
+    int _fd;
+#endif
+
+public:
+    explicit RandomAccessFile(const std::string& fileName);
+    ~RandomAccessFile();
+
+    const std::string& getFileName() const noexcept;
+    long int getSize() const noexcept;
+    bool readBytes(long int offset, long int count, void *buffer) const;    //exactly count bytes at offset
+    long int readAvailableBytes(long int offset, long int count, void *buffer) const;    //up to count bytes, fewer at the end of the file
+};
+
+class Resampler     //windowed sinc interpolation, every output sample is computed from the input around it alone
+{
+    long int _upFactor, _downFactor;    //output rate / input rate, reduced
+    long int _halfLength;               //input samples used on either side of an output sample
+    std::vector<float> _filter;         //_upFactor phases of 2 * _halfLength taps each
+
+public:
+    Resampler(long int inputRate, long int outputRate);
+
+    long int getFirstInput(long int outputSample) const noexcept;  //first input sample the output sample is computed from
+    long int getLastInput(long int outputSample) const noexcept;   //one past the last one
+    long int getNumberOfOutputs(long int numberOfInputs) const noexcept;
+
+    //input holds the samples from firstInput on, samples outside it are taken as silence
+    void resample(const std::vector<float>& input, long int firstInput, long int startSample, long int count, int16_t *samples) const;
+};
+
+class AudioSource
+{
+public:
+    virtual ~AudioSource() = default;
+
+    virtual long int getNumberOfSamples() const noexcept = 0;
+    virtual long int read(long int startSample, long int count, int16_t *samples) const = 0;  //copies up to count samples, returns the number copied
+    std::vector<int16_t> read(long int startSample, long int count) const;                     //window of up to count samples
+};
+
+class FileAudioSource : public AudioSource  //wave or raw file on disk, only the position of the samples is kept
+{
+    RandomAccessFile _file;
+    long int _dataOffset, _numberOfSamples;     //where the samples begin in the file and their number
+
+    void readHeader();      //find and validate the 'fmt ' and 'data' subchunks
+
+public:
+    FileAudioSource(const std::string& fileName, bool isRawFile = false);
+
+    long int getNumberOfSamples() const noexcept override;
+    long int read(long int startSample, long int count, int16_t *samples) const override;
+};
+
+class MemoryAudioSource : public AudioSource    //audio from a stream, which can't be read again, is kept in memory
+{
+    std::unique_ptr<WaveFileData> _file;
+
+public:
+    explicit MemoryAudioSource(std::unique_ptr<WaveFileData> file) noexcept;
+
+    long int getNumberOfSamples() const noexcept override;
+    long int read(long int startSample, long int count, int16_t *samples) const override;
+};
+
+std::unique_ptr<AudioSource> openAudioSource(Params *parameters);   //source for the audio file (wave, raw or FLAC) or stream chosen in the parameters
+
+#endif //CCALIGNER_AUDIO_SOURCE_H
@@ -0,0 +1,229 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "checkpoint.h"
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
+
+CmnState::CmnState() noexcept
+    : numberOfFrames(0)
+{}
+
+CmnState::CmnState(const cmn_t *cmn)
+    : numberOfFrames(cmn->nframe),
+      mean(cmn->cmn_mean, cmn->cmn_mean + cmn->veclen),
+      sum(cmn->sum, cmn->sum + cmn->veclen)
+{}
+
+void CmnState::restore(cmn_t *cmn) const
+{
+    //cmn_live_set() would reset the frame count, the state is copied as it is to decode exactly as before
+    if (mean.size() != (size_t) cmn->veclen || sum.size() != (size_t) cmn->veclen)
+        return;
+
+    std::copy(mean.begin(), mean.end(), cmn->cmn_mean);
+    std::copy(sum.begin(), sum.end(), cmn->sum);
+    cmn->nframe = numberOfFrames;
+}
+
+static std::string printCmn(const CmnState& state)
+{
+    //hexadecimal floats are read back exactly
+    std::string line = std::to_string(state.numberOfFrames) + " " + std::to_string(state.mean.size());
+    char value[32];
+
+    for (const std::vector<mfcc_t> *values : {&state.mean, &state.sum})
+    {
+        for (mfcc_t x : *values)
+        {
+            snprintf(value, sizeof(value), " %a", (double) x);
+            line += value;
+        }
+    }
+
+    return line;
+}
+
+static bool readCmn(const std::string& line, CmnState& state)
+{
+    std::istringstream values(line);
+    std::string value;
+    size_t size = 0;
+
+    if (!(values >> state.numberOfFrames >> size))
+        return false;
+
+    state.mean.clear();
+    state.sum.clear();
+
+    while (values >> value)
+    {
+        std::vector<mfcc_t>& target = state.mean.size() < size ? state.mean : state.sum;
+        target.push_back((mfcc_t) std::strtod(value.c_str(), nullptr));
+    }
+
+    return state.mean.size() == size && state.sum.size() == size;
+}
+
+Checkpoint::Checkpoint() noexcept
+    : lastCue(-1),
+      subCount(1),
+      outputSize(0)
+{}
+
+bool Checkpoint::load(const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+
+    if (!in)
+        return false;
+
+    DEBUG << "Reading checkpoint : " << fileName;
+
+    std::string line;
+    bool hasJob = false, hasOutput = false, isValid = true;
+
+    artifacts.clear();
+
+    while (std::getline(in, line) && isValid)
+    {
+        size_t separator = line.find(' ');
+        std::string key = line.substr(0, separator);
+        std::string value = separator == std::string::npos ? "" : line.substr(separator + 1);
+
+        if (key == "job")
+        {
+            job = value;
+            hasJob = true;
+        }
+
+        else if (key == "artifact")
+        {
+            separator = value.find(' ');
+            isValid = separator != std::string::npos;
+            artifacts.emplace_back(value.substr(separator + 1), value.substr(0, separator));
+        }
+
+        else if (key == "lastCue")
+            lastCue = std::stoi(value);
+
+        else if (key == "subCount")
+            subCount = std::stoi(value);
+
+        else if (key == "outputSize")
+        {
+            outputSize = std::stol(value);
+            hasOutput = true;
+        }
+
+        else if (key == "wordCmn")
+            isValid = readCmn(value, wordCmn);
+
+        else if (key == "phonemeCmn")
+            isValid = readCmn(value, phonemeCmn);
+    }
+
+    if (!isValid || !hasJob || !hasOutput)
+    {
+        WARNING << "Ignoring invalid checkpoint : " << fileName;
+        return false;
+    }
+
+    return true;
+}
+
+void Checkpoint::save(const std::string& fileName) const
+{
+    const std::string temporaryFileName = fileName + ".tmp";
+    std::ofstream out(temporaryFileName, std::ios::binary);
+
+    out << "job " << job << "\n";
+
+    for (const auto& artifact : artifacts)
+        out << "artifact " << artifact.second << " " << artifact.first << "\n";
+
+    out << "lastCue " << lastCue << "\n";
+    out << "subCount " << subCount << "\n";
+    out << "outputSize " << outputSize << "\n";
+    out << "wordCmn " << printCmn(wordCmn) << "\n";
+    out << "phonemeCmn " << printCmn(phonemeCmn) << "\n";
+    out.close();
+
+    if (!out)
+    {
+        FATAL(FileNotFound) << "Unable to write checkpoint : " << temporaryFileName;
+    }
+
+#ifdef _WIN32
+    std::remove(fileName.c_str());     //rename() doesn't replace an existing file on Windows
+#endif
+
+    if (std::rename(temporaryFileName.c_str(), fileName.c_str()) != 0)
+    {
+        FATAL(FileNotFound) << "Unable to write checkpoint : " << fileName;
+    }
+
+    DEBUG << "Checkpoint saved at cue " << lastCue;
+}
+
+std::string hashFile(const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+
+    if (!in)
+        return "";
+
+    uint64_t hash = 14695981039346656037ULL;
+    char buffer[65536];
+
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+    {
+        for (std::streamsize i = 0; i < in.gcount(); i++)
+        {
+            hash ^= (unsigned char) buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) hash);
+
+    return hex;
+}
+
+long int getFileSize(const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary | std::ios::ate);
+
+    if (!in)
+        return -1;
+
+    return in.tellg();
+}
+
+void truncateFile(const std::string& fileName, long int size)
+{
+#ifdef _WIN32
+    int fd = _open(fileName.c_str(), _O_WRONLY | _O_BINARY);
+    bool isTruncated = fd >= 0 && _chsize(fd, size) == 0;
+
+    if (fd >= 0)
+        _close(fd);
+#else
+    bool isTruncated = truncate(fileName.c_str(), size) == 0;
+#endif
+
+    if (!isTruncated)
+    {
+        FATAL(FileNotFound) << "Unable to truncate file : " << fileName;
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_CHECKPOINT_H
+#define CCALIGNER_CHECKPOINT_H
+
+#include "commons.h"
+#include <sphinxbase/cmn.h>
+
+/*
+ * Progress of a long alignment is saved every now and then, so that a job which was stopped carries on
+ * from the cue after the last one saved instead of starting over. The output written after the checkpoint
+ * is cut off when resuming, as those cues are aligned again.
+ */
+
+class CmnState      //live cepstral mean of a decoder, carried from one dialogue to the next
+{
+public:
+    int32 numberOfFrames;
+    std::vector<mfcc_t> mean, sum;
+
+    CmnState() noexcept;
+    explicit CmnState(const cmn_t *cmn);
+    void restore(cmn_t *cmn) const;
+};
+
+class Checkpoint
+{
+public:
+    std::string job;                //what is aligned and how, a checkpoint of another job is never resumed
+    std::vector<std::pair<std::string, std::string>> artifacts;     //grammar files used and the hash of each
+    int lastCue;                    //index of the last cue written to the output, -1 before the first
+    int subCount;                   //number of the next SRT entry
+    long int outputSize;            //bytes of output written up to the last cue
+    CmnState wordCmn, phonemeCmn;
+
+    Checkpoint() noexcept;
+    bool load(const std::string& fileName);         //false if there is no checkpoint to resume from
+    void save(const std::string& fileName) const;   //the previous checkpoint is replaced only once the new one is written
+};
+
+std::string hashFile(const std::string& fileName);      //FNV-1a hash of the contents in hex, empty if the file can't be read
+long int getFileSize(const std::string& fileName);      //-1 if the file can't be read
+void truncateFile(const std::string& fileName, long int size);
+
+#endif //CCALIGNER_CHECKPOINT_H
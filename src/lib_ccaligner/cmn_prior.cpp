@@ -0,0 +1,175 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "cmn_prior.h"
+#include <sphinxbase/ckd_alloc.h>
+#include <sstream>
+
+CmnPrior::CmnPrior() noexcept
+    : numberOfFrames(0)
+{}
+
+bool CmnPrior::load(const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+
+    if (!in)
+        return false;
+
+    DEBUG << "Reading cepstral mean : " << fileName;
+
+    std::string line;
+    bool hasSource = false, hasMean = false;
+
+    while (std::getline(in, line))
+    {
+        size_t separator = line.find(' ');
+        std::string key = line.substr(0, separator);
+        std::string value = separator == std::string::npos ? "" : line.substr(separator + 1);
+
+        if (key == "source")
+        {
+            source = value;
+            hasSource = true;
+        }
+
+        else if (key == "frames")
+            numberOfFrames = std::stoi(value);
+
+        else if (key == "mean")
+        {
+            std::istringstream values(value);
+            std::string x;
+
+            mean.clear();
+
+            while (values >> x)
+                mean.push_back((mfcc_t) std::strtod(x.c_str(), nullptr));
+
+            hasMean = !mean.empty();
+        }
+    }
+
+    if (!hasSource || !hasMean)
+    {
+        WARNING << "Ignoring invalid cepstral mean : " << fileName;
+        return false;
+    }
+
+    return true;
+}
+
+void CmnPrior::save(const std::string& fileName) const
+{
+    std::ofstream out(fileName, std::ios::binary);
+    char value[32];
+
+    out << "source " << source << "\n";
+    out << "frames " << numberOfFrames << "\n";
+    out << "mean";
+
+    //hexadecimal floats are read back exactly
+    for (mfcc_t x : mean)
+    {
+        snprintf(value, sizeof(value), " %a", (double) x);
+        out << value;
+    }
+
+    out << "\n";
+    out.close();
+
+    if (!out)
+    {
+        FATAL(FileNotFound) << "Unable to write cepstral mean : " << fileName;
+    }
+
+    DEBUG << "Cepstral mean saved : " << fileName;
+}
+
+void CmnPrior::apply(ps_decoder_t *ps) const
+{
+    feat_t *feat = ps_get_feat(ps);
+
+    if (feat->cmn_struct == nullptr || mean.size() != (size_t) feat->cmn_struct->veclen)
+    {
+        WARNING << "Cepstral mean doesn't fit the acoustic model, using live normalisation";
+        return;
+    }
+
+    //set on the feature computation itself, the -cmn of feat.params in the acoustic model replaces the one of the config
+    feat->cmn = CMN_FIXED;
+    cmn_live_set(feat->cmn_struct, mean.data());
+}
+
+CmnPrior computeCmnPrior(ps_decoder_t *ps, const AudioSource& audio, const std::vector<char>& speechActivity)
+{
+    INFO << "Computing cepstral mean of the speech in the audio..";
+
+    //the front end drops silence itself unless -remove_silence is off, only then its frames are all those of the audio
+    const bool isSilenceRemoved = cmd_ln_boolean_r(ps_get_config(ps), "-remove_silence");
+    //a front end of its own, the one of the decoder would carry the noise estimate of the end of the audio to the first window
+    fe_t *fe = fe_init_auto_r(ps_get_config(ps));
+
+    if (fe == nullptr)
+    {
+        FATAL(UnknownError) << "Failed to create front end, see log for details";
+    }
+
+    cmn_t *cmn = cmn_init(fe_get_output_size(fe));
+    std::vector<int16_t> block(audioBlockSize);
+    std::vector<mfcc_t *> speechFrames;
+    int32 frame = 0;
+
+    fe_start_utt(fe);
+
+    //the front end keeps the samples of an incomplete frame for the next block
+    for (long int blockStartsAt = 0; blockStartsAt < audio.getNumberOfSamples(); blockStartsAt += audioBlockSize)
+    {
+        const int16_t *sample = block.data();
+        size_t samplesLeft = audio.read(blockStartsAt, audioBlockSize, block.data());
+
+        //it stops once the frames asked for are written, as in acmod the rest of the block is processed again
+        while (samplesLeft > 0)
+        {
+            int32 numberOfFrames;
+
+            fe_process_frames(fe, nullptr, &samplesLeft, nullptr, &numberOfFrames, nullptr);
+            mfcc_t **features = (mfcc_t **) ckd_calloc_2d(numberOfFrames + 1, fe_get_output_size(fe), sizeof(mfcc_t));
+            fe_process_frames(fe, &sample, &samplesLeft, features, &numberOfFrames, nullptr);
+
+            speechFrames.clear();
+
+            for (int32 i = 0; i < numberOfFrames; i++, frame++)
+            {
+                if (isSilenceRemoved || ((size_t) frame < speechActivity.size() && speechActivity[frame]))
+                    speechFrames.push_back(features[i]);
+            }
+
+            cmn_accum(cmn, speechFrames.data(), speechFrames.size());
+            ckd_free_2d(features);
+        }
+    }
+
+    std::vector<mfcc_t> finalFrame(fe_get_output_size(fe));
+    int32 finalFrames;
+    fe_end_utt(fe, finalFrame.data(), &finalFrames);
+
+    CmnPrior prior;
+    prior.numberOfFrames = cmn->nframe;
+
+    if (cmn->nframe > 0)
+    {
+        cmn_live_update(cmn);
+        prior.mean.assign(cmn->cmn_mean, cmn->cmn_mean + cmn->veclen);
+    }
+
+    cmn_free(cmn);
+    fe_free(fe);
+
+    DEBUG << "Cepstral mean of " << prior.numberOfFrames << " speech frames out of " << frame << " computed";
+
+    return prior;
+}
@@ -0,0 +1,40 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_CMN_PRIOR_H
+#define CCALIGNER_CMN_PRIOR_H
+
+#include "commons.h"
+#include "audio_source.h"
+#include <pocketsphinx.h>
+#include <sphinxbase/cmn.h>
+
+/*
+ * Cepstral mean of the speech in the whole audio, computed once before aligning it. Every window is then
+ * normalised with the same mean instead of the live one, which is only as good as the few seconds of
+ * audio decoded before the window and costs an update at the end of every utterance. Computing it takes
+ * one pass of the front end over the file, so it can be saved and read back by later runs on the same
+ * audio.
+ */
+
+class CmnPrior
+{
+public:
+    std::string source;             //audio and acoustic model the mean was computed for, a prior of another source is never used
+    int32 numberOfFrames;           //speech frames averaged
+    std::vector<mfcc_t> mean;
+
+    CmnPrior() noexcept;
+    bool load(const std::string& fileName);         //false if there is no prior to read
+    void save(const std::string& fileName) const;
+    void apply(ps_decoder_t *ps) const;             //normalise everything the decoder decodes from now on with the mean
+};
+
+//mean of the cepstra of the speech computed with a front end set up as the one of the decoder, which removes silence itself by default;
+//with -remove_silence no, the frames with speech activity (one entry per 10 ms frame) are averaged
+CmnPrior computeCmnPrior(ps_decoder_t *ps, const AudioSource& audio, const std::vector<char>& speechActivity);
+
+#endif //CCALIGNER_CMN_PRIOR_H
@@ -5,6 +5,8 @@
 */
 
 #include "commons.h"
+#include <atomic>
+#include <thread>
 
 void ms_to_srt_time(long int ms, int *hours, int *minutes, int *seconds, int *milliseconds)
 {
@@ -37,6 +39,47 @@ std::string stringToLower(std::string strToConvert)
     return strToConvert;
 }
 
+std::string normaliseWord(const std::string& word)
+{
+    std::string normalised;
+
+    for (char c : word)
+    {
+        if (std::isalnum((unsigned char) c) || c == '\'')
+            normalised += (char) std::tolower((unsigned char) c);
+    }
+
+    return normalised;
+}
+
+size_t getThreadCount(size_t numberOfTasks)
+{
+    return std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), numberOfTasks);
+}
+
+void parallelFor(size_t count, size_t threadCount, const std::function<void(size_t worker, size_t i)>& task)
+{
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads;
+
+    for (size_t worker = 0; worker < threadCount; worker++)
+    {
+        threads.emplace_back([&, worker]()
+        {
+            for (size_t i = next++; i < count; i = next++)
+                task(worker, i);
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+void parallelFor(size_t count, const std::function<void(size_t i)>& task)
+{
+    parallelFor(count, getThreadCount(count), [&task](size_t, size_t i) { task(i); });
+}
+
 bool AlignedData::addNewWord(const std::string& word, long int startTime, long int endTime, float conf)
 {
     _words.push_back(word);
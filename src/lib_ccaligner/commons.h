@@ -16,13 +16,17 @@
 #include <algorithm>
 #include <regex>
 #include <cstdarg>
+#include <cstring>
+#include <cctype>
 #include <memory>
+#include <functional>
 #include "logger.h"
 
 enum alignerType
 {
     approxAligner,          //approximation based alignment
     asrAligner,             //using pocketsphinx as ASR
+    syncAligner,            //cue level offset and drift correction using voice activity
     alignerUnassigned       //no aligner is specified
 };
 
@@ -50,6 +54,14 @@ enum grammarName      //various possible output formats
     no_grammar
 };
 
+enum decoderProfiles    //speed and accuracy of the word decoder, see decoder_profiles.h
+{
+    stockProfile,           //PocketSphinx defaults
+    fastProfile,
+    balancedProfile,
+    accurateProfile
+};
+
 enum outputOptions
 {
     printOnlyRecognised,
@@ -63,6 +75,15 @@ enum outputOptions
 void ms_to_srt_time(long int ms, int *hours, int *minutes, int *seconds, int *milliseconds); //converts ms to SRT time
 std::string extractFileName(const std::string& fileName);  //extract path/to/filename from path/to/filename.extension
 std::string stringToLower(std::string strToConvert);
+std::string normaliseWord(const std::string& word);   //lowercase word without punctuation, as found in the dictionary
+
+size_t getThreadCount(size_t numberOfTasks);    //a thread per core, but no more than there are tasks
+
+//runs task(worker, i) for every i below count, shared between threadCount threads which take the next i as soon as
+//they are free, so tasks start in order and the longest should come first. worker, below threadCount, picks the
+//state of the thread, e.g. a decoder, which has to be created beforehand as its initialisation isn't thread safe
+void parallelFor(size_t count, size_t threadCount, const std::function<void(size_t worker, size_t i)>& task);
+void parallelFor(size_t count, const std::function<void(size_t i)>& task);     //on getThreadCount(count) threads
 
 class AlignedData
 {
@@ -0,0 +1,178 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "cue_language_model.h"
+#include <cmath>
+#include <iomanip>
+#include <map>
+
+void writeArpaModel(const Sentences& sentences, const std::string& fileName)
+{
+    typedef std::vector<std::string> Ngram;
+
+    std::map<Ngram, long int> counts[3];                //unigrams, bigrams and trigrams
+    std::map<Ngram, long int> followers[2], distinct[2];    //words following every unigram and bigram history
+    long int numberOfWords = 0;
+
+    counts[0][{"<s>"}] = 0;
+
+    for (const std::vector<std::string>& sentence : sentences)
+    {
+        Ngram words = {"<s>"};
+        words.insert(words.end(), sentence.begin(), sentence.end());
+        words.push_back("</s>");
+
+        for (size_t i = 1; i < words.size(); i++)
+        {
+            counts[0][{words[i]}]++;
+            numberOfWords++;
+
+            for (size_t order = 2; order <= 3 && order <= i + 1; order++)
+            {
+                Ngram ngram(words.begin() + i + 1 - order, words.begin() + i + 1);
+                Ngram history(ngram.begin(), ngram.end() - 1);
+
+                if (counts[order - 1][ngram]++ == 0)
+                    distinct[order - 2][history]++;
+
+                followers[order - 2][history]++;
+            }
+        }
+    }
+
+    auto getProbability = [&](const Ngram& ngram) {
+        if (ngram.size() == 1)
+            return (double) counts[0].at(ngram) / numberOfWords;
+
+        Ngram history(ngram.begin(), ngram.end() - 1);
+        return (counts[ngram.size() - 1].at(ngram) - cueDiscount) / followers[ngram.size() - 2].at(history);
+    };
+
+    //probability the lower order model gives to the words seen after every history
+    std::map<Ngram, double> seenLowerProbability[2];
+
+    for (size_t order = 2; order <= 3; order++)
+    {
+        for (const auto& ngram : counts[order - 1])
+        {
+            Ngram history(ngram.first.begin(), ngram.first.end() - 1);
+            Ngram lower(ngram.first.begin() + 1, ngram.first.end());
+
+            seenLowerProbability[order - 2][history] += getProbability(lower);
+        }
+    }
+
+    //the discounted mass is spread over the unseen words by the lower order model
+    auto getBackoff = [&](const Ngram& history) {
+        auto found = followers[history.size() - 1].find(history);
+
+        if (found == followers[history.size() - 1].end())
+            return 1.0;
+
+        return cueDiscount * distinct[history.size() - 1].at(history) / found->second
+               / std::max(1e-6, 1 - seenLowerProbability[history.size() - 1].at(history));
+    };
+
+    std::ofstream out(fileName, std::ios::binary);
+
+    out << std::fixed << std::setprecision(4);
+    out << "\\data\\\n";
+
+    for (size_t order = 1; order <= 3; order++)
+        out << "ngram " << order << "=" << counts[order - 1].size() << "\n";
+
+    for (size_t order = 1; order <= 3; order++)
+    {
+        out << "\n\\" << order << "-grams:\n";
+
+        for (const auto& ngram : counts[order - 1])
+        {
+            const bool isStart = order == 1 && ngram.first[0] == "<s>";
+
+            out << (isStart ? -99.0 : std::log10(getProbability(ngram.first)));
+
+            for (const std::string& word : ngram.first)
+                out << " " << word;
+
+            if (order < 3 && ngram.first.back() != "</s>")
+                out << " " << std::log10(getBackoff(ngram.first));
+
+            out << "\n";
+        }
+    }
+
+    out << "\n\\end\\\n";
+    out.close();
+
+    if (!out)
+    {
+        FATAL(FileNotFound) << "Unable to write language model : " << fileName;
+    }
+}
+
+CueLanguageModel::CueLanguageModel(ps_decoder_t *ps, const std::string& lmPath, const Sentences& allSentences, float cueWeight)
+    : _ps(ps),
+      _set(nullptr),
+      _fileName("tempFiles/lm/cue.lm"),
+      _cueWeight(cueWeight)
+{
+    const char *names[] = {"global", "cue"};
+    const float32 weights[] = {1 - cueWeight, cueWeight};
+    ngram_model_t *models[2];
+
+    //read as the decoder reads its own, the language weight and word insertion penalty are applied to every model
+    models[0] = ngram_model_read(ps_get_config(ps), lmPath.c_str(), NGRAM_AUTO, ps_get_logmath(ps));
+
+    if (models[0] == nullptr)
+    {
+        FATAL(FileNotFound) << "Unable to read language model : " << lmPath;
+    }
+
+    models[1] = readCueModel(allSentences);
+
+    _set = ngram_model_set_init(ps_get_config(ps), models, (char **) names, weights, 2);
+
+    //the set holds its own references
+    ngram_model_free(models[0]);
+    ngram_model_free(models[1]);
+
+    if (_set == nullptr || ps_set_lm(ps, cueSearchName, _set) < 0 || ps_set_search(ps, cueSearchName) < 0)
+    {
+        FATAL(UnknownError) << "Unable to set the cue language models, see log for details";
+    }
+
+    DEBUG << "Cue language models interpolated with " << lmPath << ", cue weight " << cueWeight;
+}
+
+ngram_model_t *CueLanguageModel::readCueModel(const Sentences& sentences)
+{
+    writeArpaModel(sentences, _fileName);
+
+    ngram_model_t *model = ngram_model_read(ps_get_config(_ps), _fileName.c_str(), NGRAM_ARPA, ps_get_logmath(_ps));
+
+    if (model == nullptr)
+    {
+        FATAL(InvalidFile) << "Unable to read cue language model : " << _fileName;
+    }
+
+    return model;
+}
+
+void CueLanguageModel::select(const Sentences& windowSentences)
+{
+    const char *names[] = {"global", "cue"};
+    const float32 weights[] = {1 - _cueWeight, _cueWeight};
+
+    //word IDs of the set stay as they are, so the search built on it is still valid
+    ngram_model_free(ngram_model_set_remove(_set, "cue", TRUE));
+    ngram_model_set_add(_set, readCueModel(windowSentences), "cue", _cueWeight, TRUE);
+    ngram_model_set_interp(_set, names, weights);
+}
+
+CueLanguageModel::~CueLanguageModel()
+{
+    ngram_model_free(_set);
+}
@@ -0,0 +1,43 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_CUE_LANGUAGE_MODEL_H
+#define CCALIGNER_CUE_LANGUAGE_MODEL_H
+
+#include "commons.h"
+#include "pocketsphinx.h"
+
+/*
+ * Every cue is recognised with the language model of all the subtitles interpolated with a small one
+ * of the cue window : its own dialogue and that of its neighbours. Both are members of one ngram model
+ * set, searched as "cue_lm". Moving to another cue only replaces the small model in the set and sets
+ * the weights again, the set keeps its vocabulary and so the decoder keeps its search tree.
+ */
+
+constexpr auto cueSearchName = "cue_lm";
+constexpr double cueDiscount = 0.5;     //absolute discount of the bigram and trigram counts, as quick_lm
+
+typedef std::vector<std::vector<std::string>> Sentences;       //normalised words of every dialogue
+
+void writeArpaModel(const Sentences& sentences, const std::string& fileName);   //trigram model of the sentences
+
+class CueLanguageModel
+{
+    ps_decoder_t *_ps;
+    ngram_model_t *_set;                //the global model, then the model of the cue window
+    std::string _fileName;
+    float _cueWeight;
+
+    ngram_model_t *readCueModel(const Sentences& sentences);
+
+public:
+    //allSentences give the vocabulary of the set, every cue window must be a part of them
+    CueLanguageModel(ps_decoder_t *ps, const std::string& lmPath, const Sentences& allSentences, float cueWeight);
+    void select(const Sentences& windowSentences);     //interpolate the global model with the one of this window
+    ~CueLanguageModel();
+};
+
+#endif //CCALIGNER_CUE_LANGUAGE_MODEL_H
@@ -0,0 +1,83 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "decoder_profiles.h"
+
+void setDecoderSetting(DecoderSettings& settings, const std::string& name, const std::string& value)
+{
+    for (auto& setting : settings)
+    {
+        if (setting.first == name)
+        {
+            setting.second = value;
+            return;
+        }
+    }
+
+    settings.emplace_back(name, value);
+}
+
+void setDecoderSettings(DecoderSettings& settings, const DecoderSettings& overrides)
+{
+    for (const auto& setting : overrides)
+        setDecoderSetting(settings, setting.first, setting.second);
+}
+
+DecoderSettings getDecoderProfile(decoderProfiles profile)
+{
+    switch (profile)
+    {
+    case fastProfile:       //roughly half the stock decoding time; the lattice pass is kept, without it whole dialogues go unrecognised
+        return {{"-ds", "2"}, {"-topn", "2"}, {"-maxhmmpf", "3000"}, {"-maxwpf", "5"}, {"-pl_window", "10"},
+                {"-fwdflat", "no"}, {"-bestpath", "yes"}};
+
+    case balancedProfile:   //drops the flat lexicon pass, which rarely changes the words found in short windows
+        return {{"-ds", "1"}, {"-topn", "3"}, {"-maxhmmpf", "10000"}, {"-maxwpf", "10"}, {"-pl_window", "5"},
+                {"-fwdflat", "no"}, {"-bestpath", "yes"}};
+
+    case accurateProfile:   //nothing is pruned besides the beams
+        return {{"-ds", "1"}, {"-topn", "4"}, {"-maxhmmpf", "-1"}, {"-maxwpf", "-1"}, {"-pl_window", "0"},
+                {"-fwdflat", "yes"}, {"-bestpath", "yes"}};
+
+    default:
+        return {};
+    }
+}
+
+std::string getDecoderProfileName(decoderProfiles profile)
+{
+    switch (profile)
+    {
+    case fastProfile:       return "fast";
+    case balancedProfile:   return "balanced";
+    case accurateProfile:   return "accurate";
+    default:                return "stock";
+    }
+}
+
+std::string printDecoderSettings(const DecoderSettings& settings)
+{
+    std::string arguments;
+
+    for (const auto& setting : settings)
+        arguments += (arguments.empty() ? "" : " ") + setting.first + " " + setting.second;
+
+    return arguments;
+}
+
+cmd_ln_t *createDecoderConfig(const DecoderSettings& settings)
+{
+    //parsed at once, since cmd_ln_parse_r() can't safely replace a value in an existing configuration
+    std::vector<char *> arguments;
+
+    for (const auto& setting : settings)
+    {
+        arguments.push_back(const_cast<char *>(setting.first.c_str()));
+        arguments.push_back(const_cast<char *>(setting.second.c_str()));
+    }
+
+    return cmd_ln_parse_r(nullptr, ps_args(), arguments.size(), arguments.data(), TRUE);
+}
@@ -0,0 +1,29 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_DECODER_PROFILES_H
+#define CCALIGNER_DECODER_PROFILES_H
+
+#include "commons.h"
+#include "pocketsphinx.h"
+
+/*
+ * The word decoder is configured as a list of PocketSphinx arguments and their values. Profiles set the
+ * arguments which trade accuracy for speed together : GMM downsampling (-ds), Gaussians scored per
+ * frame (-topn), the HMM and word exit limits (-maxhmmpf, -maxwpf), the phone lookahead window
+ * (-pl_window) and the second and third search passes (-fwdflat, -bestpath).
+ */
+
+typedef std::vector<std::pair<std::string, std::string>> DecoderSettings;   //argument, value
+
+void setDecoderSetting(DecoderSettings& settings, const std::string& name, const std::string& value);   //replaces the value if it is set already
+void setDecoderSettings(DecoderSettings& settings, const DecoderSettings& overrides);
+DecoderSettings getDecoderProfile(decoderProfiles profile);
+std::string getDecoderProfileName(decoderProfiles profile);
+std::string printDecoderSettings(const DecoderSettings& settings);     //as passed on the command line
+cmd_ln_t *createDecoderConfig(const DecoderSettings& settings);         //nullptr if an argument or its value is invalid
+
+#endif //CCALIGNER_DECODER_PROFILES_H
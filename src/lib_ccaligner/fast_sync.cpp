@@ -0,0 +1,84 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "fast_sync.h"
+#include <chrono>
+
+FastSyncAligner::FastSyncAligner(Params * parameters) noexcept
+    : _parameters(parameters),
+      _audioFileName(parameters->audioFileName),
+      _subtitleFileName(parameters->subtitleFileName),
+      _outputFileName(parameters->outputFileName),
+      _outputFormat(parameters->outputFormat),
+      _subParserFactory(_subtitleFileName),
+      _parser(_subParserFactory.getParser())
+{
+    DEBUG << "Initialising fast sync aligner";
+    DEBUG << "Audio Filename: " << _audioFileName << " Subtitle filename: " << _subtitleFileName;
+
+    _subtitles = _parser->getSubtitles();
+
+    INFO << "Reading and decoding audio samples...";
+
+    _audio = openAudioSource(parameters);
+}
+
+std::vector<SubtitleItem *> FastSyncAligner::align()
+{
+    INFO << "Estimating subtitle offset and drift..";
+
+    const auto syncStartedAt = std::chrono::steady_clock::now();
+
+    std::vector<char> speechActivity = getSpeechActivity(*_audio);
+    std::vector<char> occupancy = getSubtitleOccupancy(_subtitles, speechActivity.size());
+    OffsetMap offsets = estimateOffsets(speechActivity, occupancy, defaultSegmentFrames, defaultMaxShiftFrames);
+
+    const std::chrono::duration<double> syncTook = std::chrono::steady_clock::now() - syncStartedAt;
+    const double audioDuration = _audio->getNumberOfSamples() / 16000.0;
+
+    INFO << "Synchronised " << audioDuration << " s of audio in " << syncTook.count() << " s ("
+         << audioDuration / std::max(syncTook.count(), 1e-6) << " x real time)";
+
+    int subCount = 1;
+    initFile(_outputFileName, _outputFormat);
+
+    for (SubtitleItem *sub : _subtitles)
+    {
+        long int offset = offsets.getOffset(sub->getStartTime());
+        sub->setStartTime(std::max(0L, sub->getStartTime() + offset));
+        sub->setEndTime(std::max(sub->getStartTime(), sub->getEndTime() + offset));
+
+        //word timings are only approximated within the shifted cue
+        CurrentSub currSub(sub);
+        currSub.run();
+
+        switch (_outputFormat)  //decide on basis of set output format
+        {
+            case srt:       subCount = printCueSRTContinuous(_outputFileName, subCount, sub);
+                break;
+
+            case xml:       printXMLContinuous(_outputFileName, sub);
+                break;
+
+            case json:      printJSONContinuous(_outputFileName, sub);
+                break;
+
+            case karaoke:   subCount = printKaraokeContinuous(_outputFileName, subCount, sub, printBothWithoutColors);
+                break;
+
+            case console:   currSub.printToConsole(_outputFileName);
+                break;
+
+            default:        FATAL(UnknownError) << "An error occurred while choosing output format!";
+        }
+    }
+
+    printFileEnd(_outputFileName, _outputFormat);
+
+    INFO << "Finished synchronisation.";
+
+    return _subtitles;
+}
@@ -0,0 +1,36 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_FAST_SYNC_H
+#define CCALIGNER_FAST_SYNC_H
+
+#include "srtparser.h"
+#include "audio_source.h"
+#include "voice_activity_detection.h"
+#include "offset_estimation.h"
+#include "generate_approx_timestamp.h"
+#include "commons.h"
+#include "params.h"
+#include "output_handler.h"
+
+class FastSyncAligner   //cue level resynchronisation using voice activity only, no ASR involved
+{
+private:
+    Params * _parameters;
+    std::string _audioFileName, _subtitleFileName, _outputFileName;    //input and output filenames
+    outputFormats _outputFormat;                                        //output format (xml/json/srt/karaoke/stdout)
+
+    std::unique_ptr<AudioSource> _audio;
+    SubtitleParserFactory _subParserFactory;
+    SubtitleParser * _parser;
+    std::vector <SubtitleItem*> _subtitles;
+
+public:
+    FastSyncAligner(Params * parameters) noexcept;
+    std::vector<SubtitleItem *> align();    //shift every cue by the estimated offset and print it
+};
+
+#endif //CCALIGNER_FAST_SYNC_H
@@ -0,0 +1,698 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "flac_decoder.h"
+#include <array>
+#include <cmath>
+
+class FlacBitReader     //reads a frame bit by bit, most significant bit first
+{
+    const unsigned char *_data;
+    long int _size, _position;      //_position : next byte to be moved into the cache
+    uint64_t _cache;                //bits not read yet, from the most significant one; the rest are 0
+    int _cachedBits;
+
+    void refill()
+    {
+        //past the end of the data 0 bits are read, hasOverrun() tells if they were used
+        while (_cachedBits <= 56)
+        {
+            uint64_t byte = _position < _size ? _data[_position] : 0;
+            _cache |= byte << (56 - _cachedBits);
+            _cachedBits += 8;
+            _position++;
+        }
+    }
+
+public:
+    FlacBitReader(const unsigned char *data, long int size)
+        : _data(data), _size(size), _position(0), _cache(0), _cachedBits(0)
+    {}
+
+    long int getBitPosition() const { return _position * 8 - _cachedBits; }
+    bool hasOverrun() const { return getBitPosition() > _size * 8; }
+
+    uint32_t readBits(int count)    //up to 32 bits
+    {
+        if (count == 0)
+            return 0;
+
+        if (_cachedBits < count)
+            refill();
+
+        uint32_t value = (uint32_t) (_cache >> (64 - count));
+        _cache <<= count;
+        _cachedBits -= count;
+
+        return value;
+    }
+
+    int32_t readSignedBits(int count)
+    {
+        if (count == 0)
+            return 0;
+
+        return (int32_t) (readBits(count) << (32 - count)) >> (32 - count);
+    }
+
+    uint32_t readUnary()    //number of 0 bits before the next 1 bit
+    {
+        uint32_t zeros = 0;
+
+        while (_cache == 0)
+        {
+            zeros += _cachedBits;
+            _cachedBits = 0;
+
+            if (getBitPosition() >= _size * 8)
+            {
+                _position++;    //marks the overrun
+                return zeros;
+            }
+
+            refill();
+        }
+
+        int leadingZeros = 0;
+#if defined(__GNUC__) || defined(__clang__)
+        leadingZeros = __builtin_clzll(_cache);
+#else
+        while (!(_cache & (1ULL << (63 - leadingZeros))))
+            leadingZeros++;
+#endif
+
+        _cache = leadingZeros == 63 ? 0 : _cache << (leadingZeros + 1);
+        _cachedBits -= leadingZeros + 1;
+
+        return zeros + leadingZeros;
+    }
+
+    void alignToByte()
+    {
+        readBits(_cachedBits % 8);
+    }
+};
+
+static uint8_t crc8(const unsigned char *data, long int size)
+{
+    uint8_t crc = 0;
+
+    for (long int i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t) ((crc << 1) ^ 0x07) : (uint8_t) (crc << 1);
+    }
+
+    return crc;
+}
+
+static std::array<uint16_t, 256> makeCrc16Table()
+{
+    std::array<uint16_t, 256> table;
+
+    for (int byte = 0; byte < 256; byte++)
+    {
+        uint16_t crc = byte << 8;
+
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x8005) : (uint16_t) (crc << 1);
+
+        table[byte] = crc;
+    }
+
+    return table;
+}
+
+static uint16_t crc16(const unsigned char *data, long int size)
+{
+    static const std::array<uint16_t, 256> table = makeCrc16Table();
+    uint16_t crc = 0;
+
+    for (long int i = 0; i < size; i++)
+        crc = (uint16_t) ((crc << 8) ^ table[(crc >> 8) ^ data[i]]);
+
+    return crc;
+}
+
+/*
+ * Frames are decoded from a buffer which may end before the frame does, as the size of a frame is only
+ * known once it is decoded. The functions below return false when they ran past the end of the buffer,
+ * an invalid frame is only reported when the buffer held all of it.
+ */
+
+static bool isValid(bool condition, const FlacBitReader& reader, const char *error)
+{
+    if (!condition && !reader.hasOverrun())
+    {
+        FATAL(InvalidFile) << "Invalid FLAC file : " << error;
+    }
+
+    return condition;
+}
+
+static bool decodeResidual(FlacBitReader& reader, long int blockSize, int order, int32_t *residual)
+{
+    int method = reader.readBits(2);
+
+    if (!isValid(method <= 1, reader, "reserved residual coding method"))
+        return false;
+
+    const int parameterBits = method == 0 ? 4 : 5;
+    const uint32_t escapeCode = method == 0 ? 15 : 31;
+
+    int partitionOrder = reader.readBits(4);
+    long int partitionSize = blockSize >> partitionOrder;
+
+    if (!isValid((partitionSize << partitionOrder) == blockSize && partitionSize >= order, reader, "invalid residual partition order"))
+        return false;
+
+    for (long int partition = 0; partition < (1L << partitionOrder); partition++)
+    {
+        long int count = partition == 0 ? partitionSize - order : partitionSize;
+        uint32_t parameter = reader.readBits(parameterBits);
+
+        if (parameter == escapeCode)
+        {
+            int bits = reader.readBits(5);
+
+            for (long int i = 0; i < count; i++)
+                *residual++ = reader.readSignedBits(bits);
+        }
+
+        else
+        {
+            for (long int i = 0; i < count; i++)
+            {
+                uint32_t value = (reader.readUnary() << parameter) | reader.readBits(parameter);
+                *residual++ = (int32_t) (value >> 1) ^ -(int32_t) (value & 1);   //zigzag coded
+            }
+        }
+    }
+
+    return !reader.hasOverrun();
+}
+
+static bool decodeSubframe(FlacBitReader& reader, int bitsPerSample, long int blockSize, int32_t *samples)
+{
+    if (!isValid(reader.readBits(1) == 0, reader, "subframe padding isn't zero"))
+        return false;
+
+    int type = reader.readBits(6);
+    int wastedBits = 0;
+
+    if (reader.readBits(1))
+        wastedBits = reader.readUnary() + 1;
+
+    bitsPerSample -= wastedBits;
+
+    if (!isValid(bitsPerSample > 0, reader, "too many wasted bits"))
+        return false;
+
+    if (type == 0)  //constant
+    {
+        std::fill(samples, samples + blockSize, reader.readSignedBits(bitsPerSample));
+    }
+
+    else if (type == 1)     //verbatim
+    {
+        for (long int i = 0; i < blockSize; i++)
+            samples[i] = reader.readSignedBits(bitsPerSample);
+    }
+
+    else if (type >= 8 && type <= 12)   //fixed predictor
+    {
+        int order = type - 8;
+
+        if (!isValid(order <= blockSize, reader, "predictor order exceeds block size"))
+            return false;
+
+        for (int i = 0; i < order; i++)
+            samples[i] = reader.readSignedBits(bitsPerSample);
+
+        if (!decodeResidual(reader, blockSize, order, samples + order))
+            return false;
+
+        switch (order)
+        {
+            case 1: for (long int i = 1; i < blockSize; i++) samples[i] += samples[i - 1];
+                    break;
+            case 2: for (long int i = 2; i < blockSize; i++) samples[i] += 2 * samples[i - 1] - samples[i - 2];
+                    break;
+            case 3: for (long int i = 3; i < blockSize; i++) samples[i] += 3 * (samples[i - 1] - samples[i - 2]) + samples[i - 3];
+                    break;
+            case 4: for (long int i = 4; i < blockSize; i++) samples[i] += 4 * (samples[i - 1] + samples[i - 3]) - 6 * samples[i - 2] - samples[i - 4];
+                    break;
+            default: break;
+        }
+    }
+
+    else if (type >= 32)    //linear predictor
+    {
+        int order = type - 31;
+
+        if (!isValid(order <= blockSize, reader, "predictor order exceeds block size"))
+            return false;
+
+        for (int i = 0; i < order; i++)
+            samples[i] = reader.readSignedBits(bitsPerSample);
+
+        int precision = reader.readBits(4) + 1;
+        int shift = reader.readSignedBits(5);
+
+        if (!isValid(precision < 16 && shift >= 0, reader, "invalid linear predictor precision or shift"))
+            return false;
+
+        int32_t coefficients[32];
+
+        for (int i = 0; i < order; i++)
+            coefficients[i] = reader.readSignedBits(precision);
+
+        if (!decodeResidual(reader, blockSize, order, samples + order))
+            return false;
+
+        for (long int i = order; i < blockSize; i++)
+        {
+            int64_t prediction = 0;
+
+            for (int j = 0; j < order; j++)
+                prediction += (int64_t) coefficients[j] * samples[i - 1 - j];
+
+            samples[i] += (int32_t) (prediction >> shift);
+        }
+    }
+
+    else
+    {
+        isValid(false, reader, "reserved subframe type");
+        return false;
+    }
+
+    if (wastedBits > 0)
+    {
+        for (long int i = 0; i < blockSize; i++)
+            samples[i] = (int32_t) ((uint32_t) samples[i] << wastedBits);
+    }
+
+    return !reader.hasOverrun();
+}
+
+//decodes a frame held at the beginning of data; returns its size in bytes, 0 if data ends before it does
+static long int decodeFrameData(const unsigned char *data, long int size, const FlacStreamInfo& streamInfo, std::vector<float>& samples)
+{
+    FlacBitReader reader(data, size);
+
+    if (!isValid(reader.readBits(14) == 0x3FFE, reader, "frame sync code not found"))
+        return 0;
+
+    reader.readBits(2);     //reserved bit and blocking strategy, frames are located by the index
+
+    int blockSizeCode = reader.readBits(4);
+    int sampleRateCode = reader.readBits(4);
+    int channelAssignment = reader.readBits(4);
+    int sampleSizeCode = reader.readBits(3);
+    reader.readBits(1);
+
+    //frame or sample number, coded like UTF-8 characters; only skipped
+    uint32_t firstByte = reader.readBits(8);
+    int extraBytes = 0;
+
+    while (extraBytes < 7 && (firstByte & (0x80 >> extraBytes)))
+        extraBytes++;
+
+    if (!isValid(extraBytes != 1 && extraBytes < 7, reader, "invalid frame number"))
+        return 0;
+
+    for (int i = 1; i < extraBytes; i++)
+    {
+        if (!isValid((reader.readBits(8) & 0xC0) == 0x80, reader, "invalid frame number"))
+            return 0;
+    }
+
+    long int blockSize;
+
+    if (blockSizeCode == 1)
+        blockSize = 192;
+    else if (blockSizeCode >= 2 && blockSizeCode <= 5)
+        blockSize = 576L << (blockSizeCode - 2);
+    else if (blockSizeCode == 6)
+        blockSize = reader.readBits(8) + 1;
+    else if (blockSizeCode == 7)
+        blockSize = reader.readBits(16) + 1;
+    else if (blockSizeCode >= 8)
+        blockSize = 256L << (blockSizeCode - 8);
+    else
+        return isValid(false, reader, "reserved block size");
+
+    static const long int sampleRates[] = { 0, 88200, 176400, 192000, 8000, 16000, 22050, 24000, 32000, 44100, 48000, 96000 };
+    long int sampleRate;
+
+    if (sampleRateCode == 0)
+        sampleRate = streamInfo.sampleRate;
+    else if (sampleRateCode < 12)
+        sampleRate = sampleRates[sampleRateCode];
+    else if (sampleRateCode == 12)
+        sampleRate = reader.readBits(8) * 1000;
+    else if (sampleRateCode == 13)
+        sampleRate = reader.readBits(16);
+    else if (sampleRateCode == 14)
+        sampleRate = reader.readBits(16) * 10;
+    else
+        return isValid(false, reader, "invalid sample rate");
+
+    static const int sampleSizes[] = { 0, 8, 12, -1, 16, 20, 24, 32 };
+    int bitsPerSample = sampleSizeCode == 0 ? streamInfo.bitsPerSample : sampleSizes[sampleSizeCode];
+    int channels = channelAssignment < 8 ? channelAssignment + 1 : 2;
+
+    if (!isValid(channelAssignment <= 10, reader, "reserved channel assignment"))
+        return 0;
+
+    if (!isValid(sampleRate == streamInfo.sampleRate && bitsPerSample == streamInfo.bitsPerSample && channels == streamInfo.channels,
+                 reader, "the format changes within the stream"))
+        return 0;
+
+    long int headerSize = reader.getBitPosition() / 8;
+    uint32_t headerCrc = reader.readBits(8);
+
+    if (!isValid(headerCrc == crc8(data, headerSize), reader, "frame header CRC mismatch"))
+        return 0;
+
+    if (!isValid(blockSize <= streamInfo.maxBlockSize, reader, "block size exceeds the maximum"))
+        return 0;
+
+    std::vector<std::vector<int32_t>> channelSamples(channels, std::vector<int32_t>(blockSize));
+
+    for (int channel = 0; channel < channels; channel++)
+    {
+        //the side channel needs one more bit
+        bool isSide = (channelAssignment == 8 && channel == 1) || (channelAssignment == 9 && channel == 0) || (channelAssignment == 10 && channel == 1);
+
+        if (!decodeSubframe(reader, bitsPerSample + isSide, blockSize, channelSamples[channel].data()))
+            return 0;
+    }
+
+    reader.alignToByte();
+    long int frameSize = reader.getBitPosition() / 8;
+    uint32_t frameCrc = reader.readBits(16);
+
+    if (reader.hasOverrun())
+        return 0;
+
+    isValid(frameCrc == crc16(data, frameSize), reader, "frame CRC mismatch");
+
+    //undoing the stereo decorrelation
+    if (channelAssignment >= 8)
+    {
+        int32_t *first = channelSamples[0].data(), *second = channelSamples[1].data();
+
+        for (long int i = 0; i < blockSize; i++)
+        {
+            if (channelAssignment == 8)         //left, side
+                second[i] = first[i] - second[i];
+
+            else if (channelAssignment == 9)    //side, right
+                first[i] += second[i];
+
+            else                                //mid, side
+            {
+                int32_t mid = (int32_t) ((uint32_t) first[i] << 1) | (second[i] & 1);
+                first[i] = (mid + second[i]) >> 1;
+                second[i] = (mid - second[i]) >> 1;
+            }
+        }
+    }
+
+    const float scale = (float) (std::ldexp(1.0, 16 - bitsPerSample) / channels);
+    samples.assign(blockSize, 0);
+
+    for (const std::vector<int32_t>& channel : channelSamples)
+    {
+        for (long int i = 0; i < blockSize; i++)
+            samples[i] += channel[i] * scale;
+    }
+
+    return frameSize + 2;
+}
+
+static long int findStreamMarker(const RandomAccessFile& file)
+{
+    //an ID3v2 tag may come before the stream
+    unsigned char header[10];
+    long int offset = 0;
+
+    if (file.readBytes(0, 10, header) && std::string(header, header + 3) == "ID3")
+    {
+        offset = 10 + ((header[6] & 0x7F) << 21 | (header[7] & 0x7F) << 14 | (header[8] & 0x7F) << 7 | (header[9] & 0x7F));
+
+        if (header[5] & 0x10)   //footer present
+            offset += 10;
+    }
+
+    if (!file.readBytes(offset, 4, header) || std::string(header, header + 4) != "fLaC")
+        return -1;
+
+    return offset + 4;
+}
+
+FlacDecoder::FlacDecoder(const std::string& fileName)
+    : _file(fileName),
+      _streamInfo(),
+      _firstFrameOffset(0)
+{
+    readMetadata();
+}
+
+void FlacDecoder::readMetadata()
+{
+    long int offset = findStreamMarker(_file);
+    bool streamInfoFound = false, isLastBlock = false;
+
+    if (offset < 0)
+    {
+        FATAL(InvalidFile) << "Invalid FLAC file : 'fLaC' stream marker not found in " << _file.getFileName();
+    }
+
+    while (!isLastBlock)
+    {
+        unsigned char blockHeader[4], streamInfo[34];
+
+        if (!_file.readBytes(offset, 4, blockHeader))
+        {
+            FATAL(InvalidFile) << "Invalid FLAC file : metadata ends abruptly";
+        }
+
+        isLastBlock = blockHeader[0] & 0x80;
+        int blockType = blockHeader[0] & 0x7F;
+        long int blockLength = blockHeader[1] << 16 | blockHeader[2] << 8 | blockHeader[3];
+
+        if (blockType == 0)
+        {
+            if (blockLength != 34 || !_file.readBytes(offset + 4, 34, streamInfo))
+            {
+                FATAL(InvalidFile) << "Invalid FLAC file : invalid STREAMINFO block";
+            }
+
+            FlacBitReader reader(streamInfo, 34);
+            _streamInfo.minBlockSize = reader.readBits(16);
+            _streamInfo.maxBlockSize = reader.readBits(16);
+            _streamInfo.minFrameSize = reader.readBits(24);
+            _streamInfo.maxFrameSize = reader.readBits(24);
+            _streamInfo.sampleRate = reader.readBits(20);
+            _streamInfo.channels = reader.readBits(3) + 1;
+            _streamInfo.bitsPerSample = reader.readBits(5) + 1;
+            _streamInfo.totalSamples = (long int) reader.readBits(4) << 32;
+            _streamInfo.totalSamples |= reader.readBits(32);
+
+            streamInfoFound = true;
+        }
+
+        offset += 4 + blockLength;
+    }
+
+    if (!streamInfoFound)
+    {
+        FATAL(InvalidFile) << "Invalid FLAC file : STREAMINFO block not found";
+    }
+
+    if (_streamInfo.sampleRate == 0 || _streamInfo.maxBlockSize < 16)
+    {
+        FATAL(InvalidFile) << "Invalid FLAC file : invalid STREAMINFO block";
+    }
+
+    if (_streamInfo.bitsPerSample > 24)
+    {
+        FATAL(InvalidFile) << "Unsupported FLAC file : " << _streamInfo.bitsPerSample << " bits per sample, up to 24 are supported";
+    }
+
+    _firstFrameOffset = offset;
+}
+
+const FlacStreamInfo& FlacDecoder::getStreamInfo() const noexcept
+{
+    return _streamInfo;
+}
+
+long int FlacDecoder::getFirstFrameOffset() const noexcept
+{
+    return _firstFrameOffset;
+}
+
+long int FlacDecoder::getFileSize() const noexcept
+{
+    return _file.getSize();
+}
+
+bool FlacDecoder::isFrameAt(long int offset) const
+{
+    unsigned char syncCode[2];
+
+    return _file.readAvailableBytes(offset, 2, syncCode) == 2 && syncCode[0] == 0xFF && (syncCode[1] & 0xFC) == 0xF8;
+}
+
+long int FlacDecoder::decodeFrame(long int offset, std::vector<float>& samples) const
+{
+    //the largest frame is known from the stream info, else a frame is assumed to be no larger than uncompressed
+    long int bufferSize = _streamInfo.maxFrameSize > 0 ? _streamInfo.maxFrameSize
+                        : 64 + _streamInfo.maxBlockSize * _streamInfo.channels * (_streamInfo.bitsPerSample + 1) / 8;
+    std::vector<unsigned char> buffer;
+
+    for (;;)
+    {
+        buffer.resize(bufferSize);
+        long int bytesRead = _file.readAvailableBytes(offset, bufferSize, buffer.data());
+        long int frameSize = decodeFrameData(buffer.data(), bytesRead, _streamInfo, samples);
+
+        if (frameSize > 0)
+            return offset + frameSize;
+
+        if (bytesRead < bufferSize)
+        {
+            FATAL(InvalidFile) << "Invalid FLAC file : the last frame ends abruptly";
+        }
+
+        bufferSize *= 2;
+    }
+}
+
+FlacAudioSource::FlacAudioSource(const std::string& fileName)
+    : _decoder(fileName),
+      _resampler(_decoder.getStreamInfo().sampleRate, audioSampleRate),
+      _numberOfInputs(_decoder.getStreamInfo().totalSamples),
+      _nextFrameOffset(_decoder.getFirstFrameOffset())
+{
+    const FlacStreamInfo& streamInfo = _decoder.getStreamInfo();
+
+    DEBUG << "FLAC stream : " << streamInfo.sampleRate << " Hz, " << streamInfo.channels << " channels, "
+          << streamInfo.bitsPerSample << " bits per sample";
+
+    if (_numberOfInputs == 0)   //not known to the encoder, found by indexing the whole file
+    {
+        indexAllFrames();
+        _numberOfInputs = _frames.empty() ? 0 : _frames.back().firstSample + _frames.back().numberOfSamples;
+    }
+
+    _numberOfSamples = _resampler.getNumberOfOutputs(_numberOfInputs);
+
+    if (streamInfo.sampleRate != audioSampleRate || streamInfo.channels != 1)
+        INFO << "Audio is resampled from " << streamInfo.sampleRate << " Hz, " << streamInfo.channels << " channels to 16000 Hz mono";
+
+    DEBUG << "Number of samples : " << _numberOfSamples;
+}
+
+void FlacAudioSource::indexAllFrames()
+{
+    std::vector<float> frameSamples;
+    long int firstSample = 0;
+
+    while (_nextFrameOffset < _decoder.getFileSize())
+    {
+        //anything after the last frame, such as an ID3v1 tag appended by a tagger, isn't audio
+        if (!_decoder.isFrameAt(_nextFrameOffset))
+        {
+            WARNING << "Ignoring " << _decoder.getFileSize() - _nextFrameOffset << " bytes after the last FLAC frame";
+            break;
+        }
+
+        long int nextFrameOffset = _decoder.decodeFrame(_nextFrameOffset, frameSamples);
+        _frames.push_back(FlacFrame{ _nextFrameOffset, firstSample, (long int) frameSamples.size() });
+
+        firstSample += frameSamples.size();
+        _nextFrameOffset = nextFrameOffset;
+    }
+}
+
+void FlacAudioSource::decodeInput(long int firstInput, std::vector<float>& input) const
+{
+    /*
+     * Frames are indexed when they are decoded for the first time, later reads start right at the frame
+     * holding their first sample. Reading past the indexed frames decodes all the frames up to there.
+     * Reads are serialised, they are fast compared to what is done with the audio read.
+     */
+
+    std::lock_guard<std::mutex> lock(_framesMutex);
+
+    const long int lastInput = std::min(firstInput + (long int) input.size(), _numberOfInputs);
+    std::fill(input.begin(), input.end(), 0.0f);
+
+    long int start = std::max(0L, firstInput);
+    auto frame = std::upper_bound(_frames.begin(), _frames.end(), start, [](long int sample, const FlacFrame& frame) {
+        return sample < frame.firstSample;
+    });
+
+    size_t frameIndex = _frames.size();
+    long int offset = _nextFrameOffset;
+    long int firstSample = _frames.empty() ? 0 : _frames.back().firstSample + _frames.back().numberOfSamples;
+
+    if (frame != _frames.begin() && start < firstSample)
+    {
+        frameIndex = frame - _frames.begin() - 1;
+        offset = _frames[frameIndex].offset;
+        firstSample = _frames[frameIndex].firstSample;
+    }
+
+    std::vector<float> frameSamples;
+
+    while (firstSample < lastInput && offset < _decoder.getFileSize())
+    {
+        long int nextOffset = _decoder.decodeFrame(offset, frameSamples);
+        long int numberOfSamples = frameSamples.size();
+
+        if (frameIndex == _frames.size())
+        {
+            _frames.push_back(FlacFrame{ offset, firstSample, numberOfSamples });
+            _nextFrameOffset = nextOffset;
+        }
+
+        for (long int sample = std::max(firstSample, start); sample < std::min(firstSample + numberOfSamples, lastInput); sample++)
+            input[sample - firstInput] = frameSamples[sample - firstSample];
+
+        firstSample += numberOfSamples;
+        offset = nextOffset;
+        frameIndex++;
+    }
+}
+
+long int FlacAudioSource::getNumberOfSamples() const noexcept
+{
+    return _numberOfSamples;
+}
+
+long int FlacAudioSource::read(long int startSample, long int count, int16_t *samples) const
+{
+    count = std::max(0L, std::min(count, _numberOfSamples - startSample));
+
+    if (count == 0)
+        return 0;
+
+    long int firstInput = _resampler.getFirstInput(startSample);
+    std::vector<float> input(_resampler.getLastInput(startSample + count - 1) - firstInput);
+
+    decodeInput(firstInput, input);
+    _resampler.resample(input, firstInput, startSample, count, samples);
+
+    return count;
+}
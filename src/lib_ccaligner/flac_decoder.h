@@ -0,0 +1,76 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_FLAC_DECODER_H
+#define CCALIGNER_FLAC_DECODER_H
+
+#include "commons.h"
+#include "audio_source.h"
+#include <mutex>
+
+/*
+ * FLAC files are decoded frame by frame. Every frame starts with its own header and doesn't depend on
+ * the frames before it, thus any part of the audio can be decoded alone once it is known where its
+ * frames begin. See https://xiph.org/flac/format.html for the format.
+ */
+
+class FlacStreamInfo    //the STREAMINFO metadata block
+{
+public:
+    long int minBlockSize, maxBlockSize;    //in samples
+    long int minFrameSize, maxFrameSize;    //in bytes, 0 if unknown
+    long int sampleRate;
+    int channels, bitsPerSample;
+    long int totalSamples;                  //per channel, 0 if unknown
+};
+
+class FlacFrame     //where a frame is found in the file and the samples it holds
+{
+public:
+    long int offset, firstSample, numberOfSamples;
+};
+
+class FlacDecoder
+{
+    RandomAccessFile _file;
+    FlacStreamInfo _streamInfo;
+    long int _firstFrameOffset;     //end of the metadata
+
+    void readMetadata();
+
+public:
+    explicit FlacDecoder(const std::string& fileName);
+
+    const FlacStreamInfo& getStreamInfo() const noexcept;
+    long int getFirstFrameOffset() const noexcept;
+    long int getFileSize() const noexcept;
+
+    bool isFrameAt(long int offset) const;     //the frame sync code is found at offset
+    //decodes the frame at offset, channels are mixed down and scaled to 16 bit; returns the offset of the next frame
+    long int decodeFrame(long int offset, std::vector<float>& samples) const;
+};
+
+class FlacAudioSource : public AudioSource  //FLAC file on disk, resampled to 16KHz mono
+{
+    FlacDecoder _decoder;
+    Resampler _resampler;
+    long int _numberOfInputs, _numberOfSamples;     //before and after resampling
+
+    mutable std::vector<FlacFrame> _frames;     //frames found so far, the file is indexed as far as it is read
+    mutable long int _nextFrameOffset;          //where the first frame which isn't indexed yet begins
+    mutable std::mutex _framesMutex;
+
+    void decodeInput(long int firstInput, std::vector<float>& input) const;    //input samples from firstInput on, as many as fit
+    void indexAllFrames();
+
+public:
+    explicit FlacAudioSource(const std::string& fileName);
+
+    long int getNumberOfSamples() const noexcept override;
+    long int read(long int startSample, long int count, int16_t *samples) const override;
+};
+
+#endif //CCALIGNER_FLAC_DECODER_H
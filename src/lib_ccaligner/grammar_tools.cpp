@@ -5,6 +5,9 @@
 */
 
 #include "grammar_tools.h"
+#include <sys/stat.h>
+#include <memory>
+#include <unordered_map>
 
 static int systemGetStatus(const char* command) {
     int rv = std::system(command);
@@ -38,9 +41,9 @@ void CreateTempDirectories() // Create temporary directories
     DEBUG << "Creating temporary directories at tempFiles/";
 
 #ifndef WIN32
-    int rv = systemGetStatus("mkdir -p tempFiles/corpus tempFiles/dict tempFiles/vocab tempFiles/fsg tempFiles/lm");
+    int rv = systemGetStatus("mkdir -p tempFiles/corpus tempFiles/dict tempFiles/vocab tempFiles/fsg tempFiles/lm tempFiles/pronunciations");
 #else
-    int rv = systemGetStatus("if not exist tempFiles\\ mkdir tempFiles\\corpus tempFiles\\dict tempFiles\\vocab tempFiles\\fsg tempFiles\\lm");
+    int rv = systemGetStatus("if not exist tempFiles\\ mkdir tempFiles\\corpus tempFiles\\dict tempFiles\\vocab tempFiles\\fsg tempFiles\\lm tempFiles\\pronunciations");
 #endif
 
     if (rv != 0)
@@ -137,61 +140,219 @@ void CreateBiasedLM(grammarName name, bool generateQuickLM) //Create biased lang
             if (rv != 0)
                 FATAL(UnknownError) << "Something went wrong while creating biased language model!";
         }
+
+        ConvertLMToBinary("tempFiles/lm/complete.lm");
     }
 }
 
-void GenerateDict(bool generateQuickDict) // Generate dictionary from tensor flow (or not if making quick dict)
+bool ConvertLMToBinary(const std::string& lmPath)
 {
-    if (generateQuickDict)
+    const std::string binaryPath = lmPath + ".bin";
+    const std::string temporaryPath = binaryPath + ".tmp";
+
+    INFO << "Converting Language Model to binary : " << binaryPath;
+
+    //no decoder log to write to yet, the messages of the reader would end up on the console
+    FILE *logFile = err_get_logfp();
+    err_set_logfp(nullptr);
+
+    //the probabilities are stored in the log base of the decoder default, as it maps the file without converting them
+    logmath_t *lmath = logmath_init(1.0001, 0, 0);
+    ngram_model_t *model = ngram_model_read(nullptr, lmPath.c_str(), NGRAM_AUTO, lmath);
+    const int rv = model == nullptr ? -1 : ngram_model_write(model, temporaryPath.c_str(), NGRAM_BIN);
+
+    ngram_model_free(model);
+    logmath_free(lmath);
+    err_set_logfp(logFile);
+
+    if (model == nullptr)
     {
-        std::ifstream vocabInput("tempFiles/vocab/complete.vocab");
-        std::ofstream dictDump;
+        WARNING << "Unable to read language model : " << lmPath;
+        return false;
+    }
 
-        try
+    if (rv != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        WARNING << "Unable to write language model : " << temporaryPath;
+        return false;
+    }
+
+    //a new file rather than the old one rewritten, decoders which mapped the old one keep it intact
+#ifdef _WIN32
+    std::remove(binaryPath.c_str());     //rename() doesn't replace an existing file on Windows
+#endif
+
+    if (std::rename(temporaryPath.c_str(), binaryPath.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        WARNING << "Unable to write language model : " << binaryPath;
+        return false;
+    }
+
+    return true;
+}
+
+std::string getBinaryLMPath(const std::string& lmPath)
+{
+    const std::string binaryPath = lmPath + ".bin";
+    struct stat lmStatus, binaryStatus;
+
+    if (stat(lmPath.c_str(), &lmStatus) != 0 || stat(binaryPath.c_str(), &binaryStatus) != 0)
+        return lmPath;
+
+    //an older binary was left by another job, the text model was changed since
+    if (binaryStatus.st_mtime < lmStatus.st_mtime)
+        return lmPath;
+
+    return binaryPath;
+}
+
+//words of the vocabulary to be given a pronunciation, in its order
+static std::vector<std::string> readVocabulary(const std::string& fileName, bool generateQuickDict)
+{
+    std::ifstream vocabInput(fileName);
+    std::vector<std::string> words;
+    std::string word;
+    bool beginWriting = !generateQuickDict;
+
+    while (std::getline(vocabInput, word))
+    {
+        //the quick dictionary starts after the sentence start, g2p-seq2seq is given every word but the comments
+        if (beginWriting && word.compare(0, 2, "##") != 0)
+            words.push_back(word);
+
+        if (word == "<s>")
+            beginWriting = true;
+    }
+
+    return words;
+}
+
+//pronunciations of the words, spread over as many threads as there are cores
+static void GenerateQuickPronunciations(const std::vector<std::string>& words, std::vector<std::string>& pronunciations)
+{
+    parallelFor(words.size(), [&](size_t i)
+    {
+        for (const Phoneme& ph : stringToPhoneme(words[i]))
+            pronunciations[i] += ph + " ";
+    });
+}
+
+//pronunciations of the words by g2p-seq2seq, left empty for those it doesn't return
+static void GenerateSeq2SeqPronunciations(const std::vector<std::string>& words, std::vector<std::string>& pronunciations,
+                                          std::vector<char>& isGenerated)
+{
+    std::ofstream vocabDump("tempFiles/vocab/unseen.vocab", std::ios::binary);
+
+    for (const std::string& word : words)
+        vocabDump << word << "\n";
+
+    vocabDump.close();
+
+    INFO << "Creating the Dictionary, this might take a little time depending "
+        "on your TensorFlow configuration : tempFiles/dict/complete.dict";
+    int rv = systemGetStatus("g2p-seq2seq --decode tempFiles/vocab/unseen.vocab --model g2p-seq2seq-cmudict/ > tempFiles/dict/unseen.dict");
+
+    if (rv != 0)
+    {
+        FATAL(UnknownError) << "Something went wrong while creating dictionary!";
+    }
+
+    std::unordered_map<std::string, size_t> indices;
+
+    for (size_t i = 0; i < words.size(); i++)
+        indices.emplace(words[i], i);
+
+    std::ifstream dictInput("tempFiles/dict/unseen.dict");
+    std::string line;
+
+    while (std::getline(dictInput, line))
+    {
+        const size_t separator = line.find_first_of(" \t");
+
+        if (separator == 0 || separator == std::string::npos)
+            continue;
+
+        auto index = indices.find(line.substr(0, separator));
+
+        if (index != indices.end())
         {
-            dictDump.open("tempFiles/dict/complete.dict", std::ios::binary);
+            const size_t pronunciation = line.find_first_not_of(" \t", separator);
+
+            pronunciations[index->second] = pronunciation == std::string::npos ? "" : line.substr(pronunciation);
+            isGenerated[index->second] = true;
         }
-        catch (std::system_error& e)
+    }
+}
+
+void GenerateDict(bool generateQuickDict, const std::string& pronunciationDirectory) // Generate dictionary from tensor flow (or not if making quick dict)
+{
+    const std::vector<std::string> words = readVocabulary("tempFiles/vocab/complete.vocab", generateQuickDict);
+    std::vector<std::string> pronunciations(words.size()), unseenWords;
+    std::vector<size_t> unseen;
+    std::unique_ptr<PronunciationStore> store;
+
+    //pronunciations of the two generators are kept apart, they differ
+    if (!pronunciationDirectory.empty())
+        store.reset(new PronunciationStore(pronunciationDirectory + "/" + (generateQuickDict ? "quick.dict" : "g2p-seq2seq.dict")));
+
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        if (store == nullptr || !store->find(words[i], pronunciations[i]))
         {
-            FATAL(UnknownError) << e.code().message();
+            unseen.push_back(i);
+            unseenWords.push_back(words[i]);
         }
+    }
 
-        std::string word;
-        std::vector<std::string> phonemes;
-        bool beginWriting = false;
+    DEBUG << "Dictionary : " << words.size() - unseen.size() << " of " << words.size() << " words already pronounced";
 
-        while (std::getline(vocabInput, word))
-        {
-            if (beginWriting)
-            {
-                phonemes = stringToPhoneme(word);
+    std::vector<std::string> unseenPronunciations(unseen.size());
+    std::vector<char> isGenerated(unseen.size(), true);
 
-                dictDump << word << " ";
+    if (generateQuickDict && !unseen.empty())
+        GenerateQuickPronunciations(unseenWords, unseenPronunciations);
 
-                for (std::string ph : phonemes)
-                    dictDump << ph << " ";
-                dictDump << "\n";
-            }
+    else if (!unseen.empty())
+    {
+        std::fill(isGenerated.begin(), isGenerated.end(), false);
+        GenerateSeq2SeqPronunciations(unseenWords, unseenPronunciations, isGenerated);
+    }
 
-            if (word == "<s>")
-                beginWriting = true;
-        }
+    std::vector<std::pair<std::string, std::string>> generated;
+    std::vector<char> isPronounced(words.size(), true);
+
+    for (size_t i = 0; i < unseen.size(); i++)
+    {
+        pronunciations[unseen[i]] = unseenPronunciations[i];
+        isPronounced[unseen[i]] = isGenerated[i];
+
+        if (isGenerated[i])
+            generated.emplace_back(unseenWords[i], unseenPronunciations[i]);
+    }
+
+    if (store != nullptr)
+        store->add(generated);
 
-        vocabInput.close();
-        dictDump.close();
+    std::ofstream dictDump;
+
+    try
+    {
+        dictDump.open("tempFiles/dict/complete.dict", std::ios::binary);
     }
-    else
+    catch (std::system_error& e)
     {
-        INFO << "Creating the Dictionary, this might take a little time depending "
-            "on your TensorFlow configuration : tempFiles/dict/complete.dict";
-        int rv = systemGetStatus("g2p-seq2seq --decode tempFiles/vocab/complete.vocab --model g2p-seq2seq-cmudict/ > tempFiles/dict/complete.dict");
+        FATAL(UnknownError) << e.code().message();
+    }
 
-        if (rv != 0)
-        {
-            FATAL(UnknownError) << "Something went wrong while creating dictionary!";
-        }
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        if (isPronounced[i])
+            dictDump << words[i] << " " << pronunciations[i] << "\n";
     }
 
+    dictDump.close();
 }
 
 
@@ -208,7 +369,7 @@ std::string getFileData(std::string _fileName)           //returns whole read fi
     return allData;
 }
 
-bool generate(std::string transcriptFileName, grammarName name) //Generate Grammar from text files.
+bool generate(std::string transcriptFileName, grammarName name, const std::string& pronunciationDirectory) //Generate Grammar from text files.
 {
     std::string transcript = getFileData(transcriptFileName);
 
@@ -280,7 +441,7 @@ bool generate(std::string transcriptFileName, grammarName name) //Generate Gramm
 
     if (name == dict || name == complete_grammar)
     {
-        GenerateDict(generateQuickDict);
+        GenerateDict(generateQuickDict, pronunciationDirectory);
     }
 
     CreateBiasedLM(name, generateQuickLM);
@@ -289,7 +450,116 @@ bool generate(std::string transcriptFileName, grammarName name) //Generate Gramm
     return true;
 }
 
-bool generate(std::vector <SubtitleItem*> subtitles, grammarName name) //Generate grammar from subtitle (.srt) files.
+std::vector<CueGrammar> buildCueGrammars(std::vector<SubtitleItem*>& subtitles, bool withCorpus, bool withPhonemes)
+{
+    std::vector<CueGrammar> grammars(subtitles.size());
+
+    if (subtitles.empty())
+        return grammars;
+
+    DEBUG << "Building grammar of " << subtitles.size() << " dialogues using " << getThreadCount(subtitles.size()) << " threads";
+
+    parallelFor(subtitles.size(), [&](size_t cue)
+    {
+        SubtitleItem *sub = subtitles[cue];
+        CueGrammar& grammar = grammars[cue];
+        const int numberOfWords = sub->getWordCount();
+
+        for (int i = 0; i < numberOfWords; i++)
+            grammar.words.push_back(stringToLower(sub->getWordByIndex(i)));
+
+        if (withCorpus)
+            grammar.corpusLine = "<s> " + stringToLower(sub->getDialogue()) + " </s>\n";
+
+        if (withPhonemes)
+        {
+            grammar.phoneticCorpusLine = "SIL ";
+
+            for (const std::string& word : grammar.words)
+            {
+                for (const Phoneme& ph : stringToPhoneme(word))
+                    grammar.phoneticCorpusLine += ph + " ";
+            }
+
+            grammar.phoneticCorpusLine += "SIL\n";
+        }
+    });
+
+    return grammars;
+}
+
+/*
+ * Any word of the dialogue, any number of times : a null transition from the start to the first state of
+ * every word, the word to its second state, a null transition from there to the final state, and one back
+ * to the start.
+ */
+
+std::string printFSG(const std::vector<std::string>& words)
+{
+    const int numberOfWords = words.size();
+    std::ostringstream fsgDump;
+
+    fsgDump<<"FSG_BEGIN CUSTOM_FSG\n";
+    fsgDump<<"NUM_STATES "<<(numberOfWords * 2) + 2<<"\n";
+    fsgDump<<"START_STATE 0\n";
+    fsgDump<<"FINAL_STATE "<<(numberOfWords * 2) + 1<<"\n\n";
+    fsgDump<<"# Transitions\n";
+
+    for(int i=0;i<numberOfWords;i++)
+    {
+        fsgDump<<"TRANSITION "<<"0 "<<i+1<<" 0.0909\n";
+    }
+    for(int i=numberOfWords, counter = 1;counter<=numberOfWords;i++,counter++)
+    {
+        fsgDump<<"TRANSITION "<<counter<<" "<<i+1<<" 1.0 "<<words[counter-1]<<"\n";
+    }
+    for(int i=numberOfWords + 1;i<numberOfWords * 2 + 1;i++)
+    {
+        fsgDump<<"TRANSITION "<<i<<" "<<numberOfWords * 2 + 1<<" 0.0909\n";
+    }
+
+    fsgDump<<"TRANSITION "<<numberOfWords * 2 + 1<<" 0 0.0909\n";
+    fsgDump<<"FSG_END\n";
+
+    return fsgDump.str();
+}
+
+fsg_model_t *createFSG(const std::vector<std::string>& words, logmath_t *lmath, float32 lw)
+{
+    const int numberOfWords = words.size();
+
+    if (numberOfWords == 0)
+        return nullptr;
+
+    //the probabilities are converted as fsg_model_read() does, so the model is the same as the one read from printFSG()
+    const int32 nullProbability = (int32) (logmath_log(lmath, 0.0909) * lw);
+    const int32 wordProbability = (int32) (logmath_log(lmath, 1.0) * lw);
+    const int finalState = numberOfWords * 2 + 1;
+
+    fsg_model_t *fsg = fsg_model_init("CUSTOM_FSG", lmath, lw, finalState + 1);
+    fsg->start_state = 0;
+    fsg->final_state = finalState;
+
+    for (int i = 0; i < numberOfWords; i++)
+    {
+        fsg_model_null_trans_add(fsg, 0, i + 1, nullProbability);
+
+        //an empty word is read back from the file as a null transition
+        if (words[i].empty())
+            fsg_model_null_trans_add(fsg, i + 1, numberOfWords + i + 1, wordProbability);
+        else
+            fsg_model_trans_add(fsg, i + 1, numberOfWords + i + 1, wordProbability, fsg_model_word_add(fsg, words[i].c_str()));
+
+        fsg_model_null_trans_add(fsg, numberOfWords + i + 1, finalState, nullProbability);
+    }
+
+    fsg_model_null_trans_add(fsg, finalState, 0, nullProbability);
+    glist_free(fsg_model_null_trans_closure(fsg, nullptr));
+
+    return fsg;
+}
+
+bool generate(std::vector <SubtitleItem*> subtitles, grammarName name, const std::string& pronunciationDirectory) //Generate grammar from subtitle (.srt) files.
 {
     bool generateQuickDict = false, generateQuickLM = false;
     int rv;
@@ -302,94 +572,67 @@ bool generate(std::vector <SubtitleItem*> subtitles, grammarName name) //Generat
 
     CreateNewGrammarFiles(name, corpusDump, fsgDump, vocabDump, dictDump, phoneticCorpusDump, logDump);
 
-    for(SubtitleItem *sub : subtitles)
+    const bool withCorpus = name == corpus || name == complete_grammar;
+    const bool withPhonemes = name == phone_lm || name == complete_grammar;
+
+    //the FSG of every dialogue is built in memory when aligning with FSG, files are only written when asked for alone
+    const bool withFSG = name == fsg;
+
+    std::vector<CueGrammar> grammars = buildCueGrammars(subtitles, withCorpus, withPhonemes);
+
+    if (withCorpus || withPhonemes)
     {
-        if(name == corpus || name == complete_grammar)
-        {
-            try
-            {
-                corpusDump.open("tempFiles/corpus/corpus.txt", std::ios::binary | std::ios::app);
-            }
-            catch(std::system_error& e)
-            {
-                FATAL(UnknownError) << e.code().message();
-            }
+        std::string corpusText, phoneticCorpusText;
 
-            corpusDump << "<s> " << stringToLower(sub->getDialogue()) << " </s>\n";
-            corpusDump.close();
+        for (const CueGrammar& grammar : grammars)
+        {
+            corpusText += grammar.corpusLine;
+            phoneticCorpusText += grammar.phoneticCorpusLine;
         }
 
-        if(name == phone_lm || name == complete_grammar)
+        try
         {
-            try
+            if (withCorpus)
             {
-                phoneticCorpusDump.open("tempFiles/corpus/phoneticCorpus.txt", std::ios::binary | std::ios::app);
+                corpusDump.open("tempFiles/corpus/corpus.txt", std::ios::binary);
+                corpusDump << corpusText;
+                corpusDump.close();
             }
 
-            catch(std::system_error& e)
+            if (withPhonemes)
             {
-                FATAL(UnknownError) << e.code().message();
+                phoneticCorpusDump.open("tempFiles/corpus/phoneticCorpus.txt", std::ios::binary);
+                phoneticCorpusDump << phoneticCorpusText;
+                phoneticCorpusDump.close();
             }
-
-            int numberOfWords = sub->getWordCount();
-            std::string printPhoneticCourpus = "SIL ";
-
-            for(int i=0;i<numberOfWords;i++)
-            {
-                std::vector<Phoneme> phones = stringToPhoneme(stringToLower(sub->getWordByIndex(i)));
-
-                for(Phoneme ph : phones)
-                    printPhoneticCourpus += ph + " ";
-            }
-
-            printPhoneticCourpus += "SIL\n";
-
-            phoneticCorpusDump << printPhoneticCourpus;
-            phoneticCorpusDump.close();
         }
+        catch(std::system_error& e)
+        {
+            FATAL(UnknownError) << e.code().message();
+        }
+    }
 
-        if(name == fsg || name == complete_grammar)
+    if (withFSG)
+    {
+        INFO << "Writing FSG of every dialogue : tempFiles/fsg/";
+
+        for (size_t i = 0; i < subtitles.size(); i++)
         {
-            long int startTime = sub->getStartTime();
-            std::string fsgFileName("tempFiles/fsg/" + std::to_string(startTime));
+            std::string fsgFileName("tempFiles/fsg/" + std::to_string(subtitles[i]->getStartTime()));
             fsgFileName += ".fsg";
 
             try
             {
                 fsgDump.open(fsgFileName, std::ios::binary);
+                fsgDump << printFSG(grammars[i].words);
+                fsgDump.close();
             }
 
             catch(std::system_error& e)
             {
                 FATAL(UnknownError) << e.code().message();
             }
-
-            int numberOfWords = sub->getWordCount();
-
-            fsgDump<<"FSG_BEGIN CUSTOM_FSG\n";
-            fsgDump<<"NUM_STATES "<<(numberOfWords * 2) + 2<<"\n";
-            fsgDump<<"START_STATE 0\n";
-            fsgDump<<"FINAL_STATE "<<(numberOfWords * 2) + 1<<"\n\n";
-            fsgDump<<"# Transitions\n";
-
-            for(int i=0;i<numberOfWords;i++)
-            {
-                fsgDump<<"TRANSITION "<<"0 "<<i+1<<" 0.0909\n";
-            }
-            for(int i=numberOfWords, counter = 1;counter<=numberOfWords;i++,counter++)
-            {
-                fsgDump<<"TRANSITION "<<counter<<" "<<i+1<<" 1.0 "<<stringToLower(sub->getWordByIndex(counter-1))<<"\n";
-            }
-            for(int i=numberOfWords + 1;i<numberOfWords * 2 + 1;i++)
-            {
-                fsgDump<<"TRANSITION "<<i<<" "<<numberOfWords * 2 + 1<<" 0.0909\n";
-            }
-
-            fsgDump<<"TRANSITION "<<numberOfWords * 2 + 1<<" 0 0.0909\n";
-            fsgDump<<"FSG_END\n";
-            fsgDump.close();
         }
-
     }
 
     if(name == vocab || name == complete_grammar)
@@ -408,7 +651,7 @@ bool generate(std::vector <SubtitleItem*> subtitles, grammarName name) //Generat
 
     if(name == dict || name == complete_grammar)
     {
-        GenerateDict(generateQuickDict);
+        GenerateDict(generateQuickDict, pronunciationDirectory);
     }
 
     CreateBiasedLM(name, generateQuickLM);
@@ -10,15 +10,39 @@
 #include "srtparser.h"
 #include "commons.h"
 #include "phoneme_utils.h"
+#include "pronunciation_store.h"
+#include "pocketsphinx.h"
+#include <sphinxbase/err.h>
 
-bool generate(std::vector <SubtitleItem*> subtitles, grammarName name = complete_grammar);
-bool generate(std::string transcriptFileName, grammarName name = complete_grammar);
+/*
+ * The grammar of every dialogue is built in memory : its lines of the corpus and of the phonetic corpus,
+ * and the words its FSG is made of. Dialogues are converted by several threads, each into its own place,
+ * so the grammar is in the order of the subtitles whatever the number of threads. Files are only written
+ * for the parts of the grammar asked for.
+ */
+
+class CueGrammar
+{
+public:
+    std::string corpusLine, phoneticCorpusLine;     //empty when not asked for
+    std::vector<std::string> words;                 //lower case, in the order of the dialogue
+};
+
+std::vector<CueGrammar> buildCueGrammars(std::vector<SubtitleItem*>& subtitles, bool withCorpus, bool withPhonemes);
+std::string printFSG(const std::vector<std::string>& words);                         //FSG of a dialogue, in the text format of sphinx
+fsg_model_t *createFSG(const std::vector<std::string>& words, logmath_t *lmath, float32 lw);   //same FSG built in memory, nullptr if the dialogue has no words
+
+//pronunciations are looked up in and saved to the store in pronunciationDirectory, none if it is empty
+bool generate(std::vector <SubtitleItem*> subtitles, grammarName name = complete_grammar, const std::string& pronunciationDirectory = "");
+bool generate(std::string transcriptFileName, grammarName name = complete_grammar, const std::string& pronunciationDirectory = "");
 void ConfigureQuickGenerationOptions(bool &generateQuickDict, bool &generateQuickLM, grammarName &name);
 void CreateTempDirectories();
 void CreateNewGrammarFiles(grammarName name, std::ofstream &corpusDump, std::ofstream &fsgDump,
 	std::ofstream &vocabDump, std::ofstream &dictDump, std::ofstream &phoneticCorpusDump, std::ofstream &logDump);
 void CreateBiasedLM(grammarName name, bool generateQuickLM);
-void GenerateDict(bool generateQuickDict);
+bool ConvertLMToBinary(const std::string& lmPath);     //writes the model as a binary trie, lmPath + ".bin"; false if it can't
+std::string getBinaryLMPath(const std::string& lmPath); //the binary trie of the model if it is up to date, else lmPath
+void GenerateDict(bool generateQuickDict, const std::string& pronunciationDirectory);
 std::string getFileData(std::string _fileName);
 
 #endif //CCALIGNER_GRAMMAR_TOOLS_H
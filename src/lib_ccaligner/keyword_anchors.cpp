@@ -0,0 +1,145 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "keyword_anchors.h"
+#include <sstream>
+#include <unordered_map>
+
+Anchor::Anchor(int index, long int start, long int end) noexcept
+    : wordIndex(index),
+      startTime(start),
+      endTime(end)
+{}
+
+AnchorSegment::AnchorSegment(int first, int last, long int start, long int end) noexcept
+    : firstWord(first),
+      lastWord(last),
+      startTime(start),
+      endTime(end),
+      isAligned(false)
+{}
+
+void AnchorSegment::interpolate(const std::vector<std::string>& words)
+{
+    long int totalLength = 0;
+    for (int i = firstWord; i < lastWord; i++)
+        totalLength += std::max<size_t>(1, words[i].size());
+
+    wordStartTimes.clear();
+    wordEndTimes.clear();
+
+    long int elapsedLength = 0;
+    for (int i = firstWord; i < lastWord; i++)
+    {
+        wordStartTimes.push_back(startTime + (endTime - startTime) * elapsedLength / totalLength);
+        elapsedLength += std::max<size_t>(1, words[i].size());
+        wordEndTimes.push_back(startTime + (endTime - startTime) * elapsedLength / totalLength);
+    }
+
+    isAligned = false;
+}
+
+std::vector<std::string> getTranscriptWords(const std::string& transcript)
+{
+    std::istringstream stream(transcript);
+    std::vector<std::string> words;
+    std::string word;
+
+    while (stream >> word)
+        words.push_back(word);
+
+    return words;
+}
+
+std::vector<int> selectAnchorWords(const std::vector<std::string>& words, const std::vector<char>& isKnown, size_t spacing)
+{
+    //only words occurring once can be told apart when they are spotted
+    std::unordered_map<std::string, int> occurrences;
+    for (const std::string& word : words)
+        occurrences[word]++;
+
+    std::vector<int> anchorWords;
+
+    for (size_t blockStart = 0; blockStart < words.size(); blockStart += spacing)
+    {
+        int best = -1;
+
+        for (size_t i = blockStart; i < std::min(blockStart + spacing, words.size()); i++)
+        {
+            if (!isKnown[i] || words[i].size() < minimumAnchorLength || occurrences[words[i]] != 1)
+                continue;
+
+            if (best == -1 || words[i].size() > words[best].size())
+                best = i;
+        }
+
+        if (best != -1)
+            anchorWords.push_back(best);
+    }
+
+    return anchorWords;
+}
+
+std::vector<Anchor> orderAnchors(std::vector<Anchor> detections)
+{
+    /*
+     * Detections sorted by time must also be in transcript order. The longest such chain is kept, found
+     * as the longest increasing subsequence of the word indices.
+     */
+
+    std::sort(detections.begin(), detections.end(), [](const Anchor& a, const Anchor& b) {
+        return a.startTime < b.startTime;
+    });
+
+    std::vector<int> chainEnds;                             //index of the last detection of the best chain of each length
+    std::vector<int> previous(detections.size(), -1);
+
+    for (size_t i = 0; i < detections.size(); i++)
+    {
+        auto it = std::lower_bound(chainEnds.begin(), chainEnds.end(), detections[i].wordIndex, [&](int detection, int wordIndex) {
+            return detections[detection].wordIndex < wordIndex;
+        });
+
+        if (it != chainEnds.begin())
+            previous[i] = *(it - 1);
+
+        if (it == chainEnds.end())
+            chainEnds.push_back(i);
+        else
+            *it = i;
+    }
+
+    std::vector<Anchor> anchors;
+    for (int i = chainEnds.empty() ? -1 : chainEnds.back(); i != -1; i = previous[i])
+        anchors.push_back(detections[i]);
+
+    std::reverse(anchors.begin(), anchors.end());
+
+    return anchors;
+}
+
+std::vector<AnchorSegment> splitAtAnchors(const std::vector<Anchor>& anchors, int wordCount, long int audioDuration)
+{
+    std::vector<AnchorSegment> segments;
+
+    //every segment begins with an anchor, except the one before the first anchor
+    int firstWord = 0;
+    long int startTime = 0;
+
+    for (const Anchor& anchor : anchors)
+    {
+        if (anchor.wordIndex > firstWord)
+            segments.emplace_back(firstWord, anchor.wordIndex, startTime, std::min(audioDuration, anchor.startTime));
+
+        firstWord = anchor.wordIndex;
+        startTime = anchor.startTime;
+    }
+
+    if (wordCount > firstWord)
+        segments.emplace_back(firstWord, wordCount, startTime, audioDuration);
+
+    return segments;
+}
@@ -0,0 +1,49 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_KEYWORD_ANCHORS_H
+#define CCALIGNER_KEYWORD_ANCHORS_H
+
+#include "commons.h"
+
+/*
+ * A long transcript is split into short segments at anchor words : rare, long words which are spotted
+ * in the audio in a single keyword search pass. Every segment lies between two consecutive anchors and
+ * is aligned on its own. All times are in ms.
+ */
+
+constexpr size_t minimumAnchorLength = 6;           //shorter words are spotted unreliably
+constexpr long int anchorSlack = 200;               //audio added on both sides of a segment, as anchors are spotted approximately
+constexpr long int maximumSegmentDuration = 60000;  //longer segments are not aligned, the alignment grows with its duration
+constexpr double anchorThreshold = 1e-30;           //keyword spotting threshold, suits words of six or more letters
+
+class Anchor        //an anchor word spotted in the audio
+{
+public:
+    int wordIndex;                  //index of the word in the transcript
+    long int startTime, endTime;    //where it was spotted
+
+    Anchor(int index, long int start, long int end) noexcept;
+};
+
+class AnchorSegment     //transcript words between two anchors and the audio they are spoken in
+{
+public:
+    int firstWord, lastWord;                        //transcript words [firstWord, lastWord)
+    long int startTime, endTime;                    //audio the words are spoken in, from one anchor to the next
+    std::vector<long int> wordStartTimes, wordEndTimes;
+    bool isAligned;
+
+    AnchorSegment(int first, int last, long int start, long int end) noexcept;
+    void interpolate(const std::vector<std::string>& words);   //spread the words over the segment by their length
+};
+
+std::vector<std::string> getTranscriptWords(const std::string& transcript);   //words of the transcript as written
+std::vector<int> selectAnchorWords(const std::vector<std::string>& words, const std::vector<char>& isKnown, size_t spacing); //index of the best anchor candidate in every block of spacing words
+std::vector<Anchor> orderAnchors(std::vector<Anchor> detections);   //longest chain of detections in transcript order, drops false alarms
+std::vector<AnchorSegment> splitAtAnchors(const std::vector<Anchor>& anchors, int wordCount, long int audioDuration);
+
+#endif //CCALIGNER_KEYWORD_ANCHORS_H
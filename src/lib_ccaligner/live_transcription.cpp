@@ -0,0 +1,143 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "live_transcription.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+PartialWord::PartialWord(const std::string& text, int start, int end, float conf) noexcept :
+    word(text),
+    startFrame(start),
+    endFrame(end),
+    confidence(conf),
+    seenSince(0)
+{
+}
+
+WordStabiliser::WordStabiliser(int stableFrames) noexcept :
+    _stableFrames(stableFrames),
+    _lastFinalFrame(-1)
+{
+}
+
+void WordStabiliser::reset()
+{
+    _pending.clear();
+    _lastFinalFrame = -1;
+}
+
+std::vector<PartialWord> WordStabiliser::update(const std::vector<PartialWord>& words, int frame, std::vector<PartialWord>& shownWords)
+{
+    std::vector<PartialWord> pending;
+
+    shownWords.clear();
+
+    for (const PartialWord& word : words)
+    {
+        //words up to the last final one are settled, whatever the decoder thinks of them now
+        if (word.startFrame <= _lastFinalFrame)
+            continue;
+
+        const size_t i = pending.size();
+        const bool isSame = i < _pending.size() && _pending[i].word == word.word
+                            && _pending[i].startFrame == word.startFrame && _pending[i].endFrame == word.endFrame;
+        const bool wasShown = std::any_of(_pending.begin(), _pending.end(), [&word](const PartialWord& shown) {
+            return shown.word == word.word && shown.startFrame == word.startFrame;
+        });
+
+        pending.push_back(word);
+        pending.back().seenSince = isSame ? _pending[i].seenSince : frame;
+
+        if (!wasShown)
+            shownWords.push_back(word);
+    }
+
+    //the leading words which haven't changed for long enough are final; the last word keeps growing
+    //while it is being spoken, so it only becomes final once the decoder has moved past it
+    size_t numberOfFinalWords = 0;
+
+    while (numberOfFinalWords < pending.size() && frame - pending[numberOfFinalWords].seenSince >= _stableFrames)
+        numberOfFinalWords++;
+
+    std::vector<PartialWord> finalWords(pending.begin(), pending.begin() + numberOfFinalWords);
+
+    if (!finalWords.empty())
+        _lastFinalFrame = finalWords.back().endFrame;
+
+    _pending.assign(pending.begin() + numberOfFinalWords, pending.end());
+
+    return finalWords;
+}
+
+std::vector<PartialWord> WordStabiliser::finish(const std::vector<PartialWord>& words)
+{
+    std::vector<PartialWord> finalWords;
+
+    for (const PartialWord& word : words)
+    {
+        if (word.startFrame > _lastFinalFrame)
+            finalWords.push_back(word);
+    }
+
+    reset();
+
+    return finalWords;
+}
+
+void LatencyHistogram::add(double latency)
+{
+    _latencies.push_back(latency);
+}
+
+size_t LatencyHistogram::size() const noexcept
+{
+    return _latencies.size();
+}
+
+double LatencyHistogram::percentile(double p) const
+{
+    if (_latencies.empty())
+        return 0;
+
+    std::vector<double> latencies(_latencies);
+    const size_t rank = std::min(latencies.size() - 1, (size_t) (p * latencies.size()));
+
+    std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+
+    return latencies[rank];
+}
+
+void LatencyHistogram::print(const std::string& name) const
+{
+    if (_latencies.empty())
+    {
+        INFO << name << " : no words";
+        return;
+    }
+
+    INFO << name << " : " << _latencies.size() << " words, latency median " << percentile(0.5) << " ms, 90% "
+         << percentile(0.9) << " ms, 99% " << percentile(0.99) << " ms, max " << percentile(1) << " ms";
+
+    const std::vector<double> bounds = {50, 100, 200, 300, 500, 1000, 2000, 5000};
+    double lowerBound = 0;
+
+    for (size_t bucket = 0; bucket <= bounds.size(); bucket++)
+    {
+        const double upperBound = bucket < bounds.size() ? bounds[bucket] : INFINITY;
+        const long int count = std::count_if(_latencies.begin(), _latencies.end(), [&](double latency) {
+            return latency >= lowerBound && latency < upperBound;
+        });
+        std::ostringstream line;
+
+        line << "    " << std::setw(5) << lowerBound << " - " << std::setw(5)
+             << (bucket < bounds.size() ? std::to_string((int) upperBound) : std::string("")) << " ms : "
+             << std::setw(6) << count << "  " << std::string(count * 50 / _latencies.size(), '#');
+
+        INFO << line.str();
+        lowerBound = upperBound;
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_LIVE_TRANSCRIPTION_H
+#define CCALIGNER_LIVE_TRANSCRIPTION_H
+
+#include "commons.h"
+
+/*
+ * Words of a live transcription are shown as soon as they appear in the partial hypothesis of the
+ * decoder, and made final once they have stayed the same for a number of frames, rather than at the end
+ * of the utterance. A final word is never taken back, later hypotheses only add words after it.
+ */
+
+class PartialWord   //word of a partial hypothesis, in frames
+{
+public:
+    std::string word;
+    int startFrame, endFrame;
+    float confidence;
+    int seenSince;      //frame of the utterance it first appeared at with these start and end frames
+
+    PartialWord(const std::string& text, int start, int end, float conf) noexcept;
+};
+
+class WordStabiliser
+{
+    std::vector<PartialWord> _pending;      //words of the last hypothesis after the last final word
+    int _stableFrames;
+    int _lastFinalFrame;                    //end of the last final word of the utterance, -1 if none
+
+public:
+    explicit WordStabiliser(int stableFrames) noexcept;
+    void reset();       //new utterance
+
+    //words of the hypothesis at a frame of the utterance; returns the words which became final, in order,
+    //and sets shownWords to the words after them which weren't in the previous hypothesis
+    std::vector<PartialWord> update(const std::vector<PartialWord>& words, int frame, std::vector<PartialWord>& shownWords);
+    std::vector<PartialWord> finish(const std::vector<PartialWord>& words);     //words of the final hypothesis after the last final one
+};
+
+class LatencyHistogram  //latency of every word emitted, in ms
+{
+    std::vector<double> _latencies;
+
+public:
+    void add(double latency);
+    size_t size() const noexcept;
+    double percentile(double p) const;     //p between 0 and 1
+    void print(const std::string& name) const;     //percentiles and counts per bucket, in the log
+};
+
+#endif //CCALIGNER_LIVE_TRANSCRIPTION_H
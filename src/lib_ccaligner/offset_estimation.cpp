@@ -0,0 +1,243 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "offset_estimation.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr long int frameDuration = 10;          //ms per frame
+    constexpr long int decimationFactor = 10;       //global search is first done on 100 ms frames
+    constexpr long int localSearchRange = 500;      //frames a segment may drift away from the global offset
+}
+
+void OffsetMap::addAnchor(long int time, long int offset)
+{
+    _anchorTimes.push_back(time);
+    _anchorOffsets.push_back(offset);
+}
+
+long int OffsetMap::getOffset(long int time) const
+{
+    if (_anchorTimes.empty())
+        return 0;
+
+    if (time <= _anchorTimes.front())
+        return _anchorOffsets.front();
+
+    if (time >= _anchorTimes.back())
+        return _anchorOffsets.back();
+
+    auto it = std::upper_bound(_anchorTimes.begin(), _anchorTimes.end(), time);
+    size_t right = it - _anchorTimes.begin(), left = right - 1;
+
+    double ratio = static_cast<double>(time - _anchorTimes[left]) / (_anchorTimes[right] - _anchorTimes[left]);
+    return _anchorOffsets[left] + static_cast<long int>(ratio * (_anchorOffsets[right] - _anchorOffsets[left]));
+}
+
+bool OffsetMap::isEmpty() const noexcept
+{
+    return _anchorTimes.empty();
+}
+
+size_t OffsetMap::getAnchorCount() const noexcept
+{
+    return _anchorTimes.size();
+}
+
+std::vector<char> getSubtitleOccupancy(const std::vector<SubtitleItem*>& subtitles, size_t numberOfFrames)
+{
+    std::vector<char> occupancy(numberOfFrames, 0);
+
+    for (SubtitleItem *sub : subtitles)
+    {
+        if (sub->getDialogue().empty())
+            continue;
+
+        size_t startFrame = std::max(0L, sub->getStartTime() / frameDuration);
+        size_t endFrame = std::max(0L, sub->getEndTime() / frameDuration);
+
+        for (size_t frame = startFrame; frame < endFrame && frame < numberOfFrames; frame++)
+            occupancy[frame] = 1;
+    }
+
+    return occupancy;
+}
+
+static std::vector<float> centre(const std::vector<float>& signal)
+{
+    double mean = 0;
+    for (float value : signal)
+        mean += value;
+
+    if (!signal.empty())
+        mean /= signal.size();
+
+    std::vector<float> centred(signal.size());
+    for (size_t i = 0; i < signal.size(); i++)
+        centred[i] = static_cast<float>(signal[i] - mean);
+
+    return centred;
+}
+
+static std::vector<float> decimate(const std::vector<char>& signal, long int factor)
+{
+    std::vector<float> decimated(signal.size() / factor);
+
+    for (size_t i = 0; i < decimated.size(); i++)
+    {
+        int sum = 0;
+        for (long int j = 0; j < factor; j++)
+            sum += signal[i * factor + j];
+
+        decimated[i] = static_cast<float>(sum) / factor;
+    }
+
+    return decimated;
+}
+
+/*
+ * Normalised cross-correlation of the (centred) occupancy frames [beginFrame, endFrame) against the
+ * speech activity shifted by every value in [minShift, maxShift]. Speech frame = occupancy frame + shift.
+ *
+ * All shifts are evaluated at once in the frequency domain : with a = occupancy[beginFrame, endFrame) and
+ * b = speech[beginFrame + minShift, endFrame + maxShift), IFFT(conj(A) * B)[k] is the correlation at
+ * shift minShift + k. The transform is long enough for the circular correlation to never wrap around.
+ */
+
+static long int bestShift(const std::vector<float>& speech, const std::vector<float>& occupancy,
+                          long int beginFrame, long int endFrame, long int minShift, long int maxShift, double *bestScore)
+{
+    const long int speechFrames = speech.size();
+    const long int segmentLength = endFrame - beginFrame;
+    const long int shiftCount = maxShift - minShift + 1;
+
+    const int order = webrtc::RealFourier::FftOrder(segmentLength + shiftCount);
+    const size_t fftLength = webrtc::RealFourier::FftLength(order);
+    const size_t complexLength = webrtc::RealFourier::ComplexLength(order);
+
+    std::unique_ptr<webrtc::RealFourier> fft = webrtc::RealFourier::Create(order);
+    webrtc::RealFourier::fft_real_scoper realBuffer = webrtc::RealFourier::AllocRealBuffer(fftLength);
+    webrtc::RealFourier::fft_cplx_scoper occupancySpectrum = webrtc::RealFourier::AllocCplxBuffer(complexLength);
+    webrtc::RealFourier::fft_cplx_scoper speechSpectrum = webrtc::RealFourier::AllocCplxBuffer(complexLength);
+
+    std::fill(realBuffer.get(), realBuffer.get() + fftLength, 0.0f);
+    std::copy(occupancy.begin() + beginFrame, occupancy.begin() + endFrame, realBuffer.get());
+    fft->Forward(realBuffer.get(), occupancySpectrum.get());
+
+    std::fill(realBuffer.get(), realBuffer.get() + fftLength, 0.0f);
+    for (long int i = 0; i < segmentLength + shiftCount - 1; i++)
+    {
+        long int frame = beginFrame + minShift + i;
+        if (frame >= 0 && frame < speechFrames)
+            realBuffer[i] = speech[frame];
+    }
+    fft->Forward(realBuffer.get(), speechSpectrum.get());
+
+    for (size_t i = 0; i < complexLength; i++)
+        speechSpectrum[i] *= std::conj(occupancySpectrum[i]);
+
+    fft->Inverse(speechSpectrum.get(), realBuffer.get());
+
+    long int best = 0;
+    double bestValue = -std::numeric_limits<double>::infinity();
+
+    for (long int shift = minShift; shift <= maxShift; shift++)
+    {
+        //number of frames actually overlapping, used to normalise the correlation
+        long int first = std::max(beginFrame, -shift);
+        long int last = std::min(endFrame, speechFrames - shift);
+
+        if (last <= first)
+            continue;
+
+        double value = realBuffer[shift - minShift] / (last - first);
+
+        //prefer the smallest shift on ties so silent audio yields no shift at all
+        if (value > bestValue || (value == bestValue && std::abs(shift) < std::abs(best)))
+        {
+            bestValue = value;
+            best = shift;
+        }
+    }
+
+    if (bestScore != nullptr)
+        *bestScore = bestValue;
+
+    return best;
+}
+
+long int findBestShift(const std::vector<char>& speechActivity, const std::vector<char>& occupancy,
+                       long int beginFrame, long int endFrame, long int minShift, long int maxShift, double *bestScore)
+{
+    std::vector<float> speech = centre(std::vector<float>(speechActivity.begin(), speechActivity.end()));
+    std::vector<float> occupied = centre(std::vector<float>(occupancy.begin(), occupancy.end()));
+
+    return bestShift(speech, occupied, beginFrame, endFrame, minShift, maxShift, bestScore);
+}
+
+OffsetMap estimateOffsets(const std::vector<char>& speechActivity, const std::vector<char>& occupancy,
+                          long int segmentFrames, long int maxShiftFrames)
+{
+    OffsetMap offsets;
+
+    if (speechActivity.empty() || occupancy.empty())
+        return offsets;
+
+    std::vector<float> speech = centre(std::vector<float>(speechActivity.begin(), speechActivity.end()));
+    std::vector<float> occupied = centre(std::vector<float>(occupancy.begin(), occupancy.end()));
+
+    //global offset : coarse search on decimated signals, then refine at full resolution
+    std::vector<float> coarseSpeech = centre(decimate(speechActivity, decimationFactor));
+    std::vector<float> coarseOccupied = centre(decimate(occupancy, decimationFactor));
+
+    long int coarseRange = maxShiftFrames / decimationFactor;
+    long int globalShift = bestShift(coarseSpeech, coarseOccupied, 0, coarseOccupied.size(), -coarseRange, coarseRange, nullptr) * decimationFactor;
+    globalShift = bestShift(speech, occupied, 0, occupied.size(), globalShift - decimationFactor, globalShift + decimationFactor, nullptr);
+
+    DEBUG << "Estimated global offset : " << globalShift * frameDuration << " ms";
+
+    //drift : one anchor per segment which contains enough dialogue to be trusted
+    std::vector<long int> anchorTimes, anchorShifts;
+    long int localRange = std::min(maxShiftFrames, localSearchRange);
+
+    for (long int beginFrame = 0; beginFrame < (long int) occupancy.size(); beginFrame += segmentFrames)
+    {
+        long int endFrame = std::min(beginFrame + segmentFrames, (long int) occupancy.size());
+        long int occupiedFrames = std::count(occupancy.begin() + beginFrame, occupancy.begin() + endFrame, 1);
+
+        if (occupiedFrames < (endFrame - beginFrame) / 10)
+            continue;
+
+        double score;
+        long int localShift = bestShift(speech, occupied, beginFrame, endFrame, globalShift - localRange, globalShift + localRange, &score);
+
+        if (score <= 0)
+            continue;
+
+        anchorTimes.push_back((beginFrame + endFrame) / 2 * frameDuration);
+        anchorShifts.push_back(localShift);
+    }
+
+    //median of three rejects single segments locking onto music or noise
+    std::vector<long int> smoothedShifts(anchorShifts);
+    for (size_t i = 1; i + 1 < anchorShifts.size(); i++)
+    {
+        long int window[3] = {anchorShifts[i - 1], anchorShifts[i], anchorShifts[i + 1]};
+        std::sort(window, window + 3);
+        smoothedShifts[i] = window[1];
+    }
+
+    for (size_t i = 0; i < anchorTimes.size(); i++)
+        offsets.addAnchor(anchorTimes[i], smoothedShifts[i] * frameDuration);
+
+    if (offsets.isEmpty())
+        offsets.addAnchor(0, globalShift * frameDuration);
+
+    DEBUG << "Estimated drift using " << offsets.getAnchorCount() << " anchors";
+
+    return offsets;
+}
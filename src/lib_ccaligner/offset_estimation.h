@@ -0,0 +1,41 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_OFFSET_ESTIMATION_H
+#define CCALIGNER_OFFSET_ESTIMATION_H
+
+#include "srtparser.h"
+#include "commons.h"
+#include <webrtc/common_audio/real_fourier.h>
+
+/*
+ * All signals used here are sampled in 10 ms frames (see vadFrameSize), i.e. 1 frame = 10 ms.
+ * An offset is the amount of time (in ms) which has to be added to a subtitle timestamp
+ * to make it match the audio.
+ */
+
+constexpr long int defaultSegmentFrames = 6000;     //60 s of audio per drift anchor
+constexpr long int defaultMaxShiftFrames = 3000;    //subtitles may be off by up to 30 s
+
+class OffsetMap     //piecewise linear mapping from subtitle time to offset
+{
+    std::vector<long int> _anchorTimes;     //subtitle time (ms) at which the offset was measured
+    std::vector<long int> _anchorOffsets;   //measured offset (ms) at that time
+
+public:
+    void addAnchor(long int time, long int offset);    //anchors must be added in increasing order of time
+    long int getOffset(long int time) const;           //interpolated offset at time, clamped at both ends
+    bool isEmpty() const noexcept;
+    size_t getAnchorCount() const noexcept;
+};
+
+std::vector<char> getSubtitleOccupancy(const std::vector<SubtitleItem*>& subtitles, size_t numberOfFrames); //1 per frame covered by a dialogue
+long int findBestShift(const std::vector<char>& speechActivity, const std::vector<char>& occupancy,
+                       long int beginFrame, long int endFrame, long int minShift, long int maxShift, double *bestScore); //best shift in frames for the occupancy range
+OffsetMap estimateOffsets(const std::vector<char>& speechActivity, const std::vector<char>& occupancy,
+                          long int segmentFrames, long int maxShiftFrames);   //global offset + piecewise linear drift
+
+#endif //CCALIGNER_OFFSET_ESTIMATION_H
@@ -149,6 +149,29 @@ int printSRTContinuous(const std::string& fileName, int subCount, SubtitleItem *
     return subCount;
 }
 
+int printCueSRTContinuous(const std::string& fileName, int subCount, SubtitleItem *sub)
+{
+    std::ofstream out;
+    out.open(fileName, std::ofstream::binary | std::ofstream::app);
+
+    int hh1,mm1,ss1,ms1;
+    int hh2,mm2,ss2,ms2;
+    char timeline[128];
+
+    ms_to_srt_time(sub->getStartTime(),&hh1,&mm1,&ss1,&ms1);
+    ms_to_srt_time(sub->getEndTime(),&hh2,&mm2,&ss2,&ms2);
+
+    //printing in SRT format
+    sprintf(timeline, "%02d:%02d:%02d,%03d --> %02d:%02d:%02d,%03d\n", hh1, mm1, ss1, ms1, hh2, mm2, ss2, ms2);
+
+    out<<subCount++<<"\n";
+    out<<timeline;
+    out<<sub->getText()<<"\n\n";
+
+    out.close();
+    return subCount;
+}
+
 int printTranscriptionAsSRTContinuous(const std::string& fileName, AlignedData *alignedData, int printedTillIndex)
 {
     std::ofstream out;
@@ -19,6 +19,7 @@ bool printTranscriptionFooter(const std::string& fileName, outputFormats outputF
 
 bool printSRT(const std::string& fileName, std::vector <SubtitleItem*> subtitles, outputOptions printOption);          //prints the aligned result in SRT format
 int printSRTContinuous(const std::string& fileName, int subCount, SubtitleItem* sub, outputOptions printOption); //prints the aligned result in SRT format as they are generated
+int printCueSRTContinuous(const std::string& fileName, int subCount, SubtitleItem* sub);   //prints the whole dialogue as a single SRT entry, using its start and end time
 int printTranscriptionAsSRTContinuous(const std::string& fileName, AlignedData *alignedData, int printedTillIndex);        //prints the transcribed result in JSON format as they are generated
 
 bool printJSON(const std::string& fileName, std::vector <SubtitleItem*> subtitles);    //prints the aligned result in JSON format
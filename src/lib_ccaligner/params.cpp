@@ -13,6 +13,7 @@ namespace {
     constexpr auto defaultDictPath = "tempFiles/dict/complete.dict";
     constexpr auto defaultFsgPath = "tempFiles/fsg/";
     constexpr auto defaultPhoneticLmPath = "model/en-us-phone.lm.bin";
+    constexpr auto defaultPronunciationStorePath = "tempFiles/pronunciations";
 }
 
 Params::Params() noexcept
@@ -22,15 +23,26 @@ Params::Params() noexcept
     dictPath(defaultDictPath),
     fsgPath(defaultFsgPath),
     phoneticLmPath(defaultPhoneticLmPath),
+    pronunciationStorePath(defaultPronunciationStorePath),
 
     searchWindow(3),
     audioWindow(0),
     sampleWindow(0),
+    coarseWindow(300),
+    anchorSpacing(20),
+    checkpointInterval(60),
+    cueLMContext(1),
+    splitSilence(500),
+    partialInterval(100),
+    stableFrames(30),
+    cueLMWeight(0.5),
+    liveSpeed(1),
 
     chosenAlignerType(asrAligner),
     grammarType(complete_grammar),
     outputFormat(xml),
     printOption(printBothWithDistinctColors),
+    decoderProfile(stockProfile),
     useFSG(),
     transcribe(),
     useBatchMode(),
@@ -40,7 +52,15 @@ Params::Params() noexcept
     readStream(),
     quickDict(),
     quickLM(),
-    audioIsRaw() {
+    coarsePass(),
+    forcedAlign(),
+    useAnchors(),
+    useCueLM(),
+    useCmnPrior(),
+    parallelTranscription(),
+    liveTranscription(),
+    audioIsRaw(),
+    audioIsFlac() {
       
     // Using date and time for log filename.
     const auto now = std::time(nullptr);
@@ -79,6 +99,15 @@ void Params::inputParams(int argc, char *argv[]) {
             audioIsRaw = true;
             i++;
         }
+        else if (paramPrefix == "-flac") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-flac requires a path to valid FLAC file!";
+            }
+
+            audioFileName = subParam;
+            audioIsFlac = true;
+            i++;
+        }
         else if (paramPrefix == "--raw-stream") {
             audioIsRaw = true;
             readStream = true;
@@ -325,6 +354,39 @@ void Params::inputParams(int argc, char *argv[]) {
             i++;
         }
 
+        else if (paramPrefix == "--forced-align") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--forced-align requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                forcedAlign = true;
+
+            i++;
+        }
+
+        else if (paramPrefix == "--kws-anchors") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--kws-anchors requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                useAnchors = true;
+
+            i++;
+        }
+
+        else if (paramPrefix == "--cue-lm") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--cue-lm requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                useCueLM = true;
+
+            i++;
+        }
+
         else if (paramPrefix == "-transcribe") {
             if (i + 1 > argc) {
                 FATAL(IncompleteParameters) << "-transcribe requires a valid response!";
@@ -411,6 +473,277 @@ void Params::inputParams(int argc, char *argv[]) {
             i++;
         }
 
+        else if (paramPrefix == "--coarse-pass") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--coarse-pass requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                coarsePass = true;
+
+            i++;
+        }
+
+        else if (paramPrefix == "-coarseWindow") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-coarseWindow requires a valid integer value in milliseconds to determine the recognition scope!";
+            }
+
+            coarseWindow = std::strtoul(subParam.c_str(), nullptr, 10);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -coarseWindow : " << strerror(errno);
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-anchorSpacing") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-anchorSpacing requires a valid number of words!";
+            }
+
+            anchorSpacing = std::strtoul(subParam.c_str(), nullptr, 10);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -anchorSpacing : " << strerror(errno);
+            }
+
+            if (anchorSpacing == 0) {
+                FATAL(InvalidParameters) << "-anchorSpacing must be at least one word!";
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-cueLMContext") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-cueLMContext requires a valid number of cues!";
+            }
+
+            cueLMContext = std::strtoul(subParam.c_str(), nullptr, 10);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -cueLMContext : " << strerror(errno);
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-cueLMWeight") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-cueLMWeight requires a valid weight!";
+            }
+
+            cueLMWeight = std::strtof(subParam.c_str(), nullptr);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -cueLMWeight : " << strerror(errno);
+            }
+
+            if (cueLMWeight <= 0 || cueLMWeight >= 1) {
+                FATAL(InvalidParameters) << "-cueLMWeight must be between 0 and 1, both excluded!";
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "--cmn-prior") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--cmn-prior requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                useCmnPrior = true;
+
+            i++;
+        }
+
+        else if (paramPrefix == "-cmnPriorFile") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-cmnPriorFile requires a valid filename!";
+            }
+
+            cmnPriorFileName = subParam;
+            useCmnPrior = true;
+            i++;
+        }
+
+        else if (paramPrefix == "--parallel-transcription") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--parallel-transcription requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                parallelTranscription = true;
+
+            i++;
+        }
+
+        else if (paramPrefix == "-splitSilence") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-splitSilence requires a valid integer value in ms!";
+            }
+
+            splitSilence = std::strtoul(subParam.c_str(), nullptr, 10);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -splitSilence : " << strerror(errno);
+            }
+
+            if (splitSilence < 10) {
+                FATAL(InvalidParameters) << "-splitSilence must be at least 10 ms, a frame of voice activity!";
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "--live") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--live requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                liveTranscription = true;
+
+            i++;
+        }
+
+        else if (paramPrefix == "-partialInterval") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-partialInterval requires a valid integer value in ms!";
+            }
+
+            partialInterval = std::strtoul(subParam.c_str(), nullptr, 10);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -partialInterval : " << strerror(errno);
+            }
+
+            if (partialInterval < 10) {
+                FATAL(InvalidParameters) << "-partialInterval must be at least 10 ms, a frame!";
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-stableFrames") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-stableFrames requires a valid number of frames!";
+            }
+
+            stableFrames = std::strtoul(subParam.c_str(), nullptr, 10);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -stableFrames : " << strerror(errno);
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-liveSpeed") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-liveSpeed requires a valid value!";
+            }
+
+            liveSpeed = std::strtof(subParam.c_str(), nullptr);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -liveSpeed : " << strerror(errno);
+            }
+
+            if (liveSpeed < 0) {
+                FATAL(InvalidParameters) << "-liveSpeed can't be negative!";
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-partialOut") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-partialOut requires a valid filename!";
+            }
+
+            partialOutputFileName = subParam;
+            i++;
+        }
+
+        else if (paramPrefix == "--pronunciation-store") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "--pronunciation-store requires a valid response!";
+            }
+
+            if (subParam == "no")
+                pronunciationStorePath.clear();
+
+            i++;
+        }
+
+        else if (paramPrefix == "-pronunciationStore") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-pronunciationStore requires a valid directory!";
+            }
+
+            pronunciationStorePath = subParam;
+            i++;
+        }
+
+        else if (paramPrefix == "-checkpoint") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-checkpoint requires a valid checkpoint filename!";
+            }
+
+            checkpointFileName = subParam;
+            i++;
+        }
+
+        else if (paramPrefix == "-checkpointInterval") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-checkpointInterval requires a valid integer value in seconds!";
+            }
+
+            checkpointInterval = std::strtoul(subParam.c_str(), nullptr, 10);
+
+            if (errno) {
+                FATAL(UnknownError) << "Invalid value passed to -checkpointInterval : " << strerror(errno);
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-profile") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-profile requires a valid decoder profile : fast, balanced, accurate or stock!";
+            }
+
+            if (subParam == "fast")
+                decoderProfile = fastProfile;
+
+            else if (subParam == "balanced")
+                decoderProfile = balancedProfile;
+
+            else if (subParam == "accurate")
+                decoderProfile = accurateProfile;
+
+            else if (subParam == "stock")
+                decoderProfile = stockProfile;
+
+            else {
+                FATAL(InvalidParameters) << "-profile requires a valid decoder profile : fast, balanced, accurate or stock!";
+            }
+
+            i++;
+        }
+
+        else if (paramPrefix == "-decoderSetting") {
+            if (i + 2 >= argc || subParam.empty() || subParam[0] != '-') {
+                FATAL(IncompleteParameters) << "-decoderSetting requires a PocketSphinx argument and its value, e.g. -decoderSetting -beam 1e-60";
+            }
+
+            decoderSettings.emplace_back(subParam, argv[i + 2]);
+            i += 2;
+        }
+
         else if (paramPrefix == "-useBatchMode") {
             if (i + 1 > argc) {
                 FATAL(IncompleteParameters) << "-useBatchMode requires a valid response!";
@@ -444,6 +777,17 @@ void Params::inputParams(int argc, char *argv[]) {
             i++;
         }
 
+        else if (paramPrefix == "-fastSync") {
+            if (i + 1 > argc) {
+                FATAL(IncompleteParameters) << "-fastSync requires a valid response!";
+            }
+
+            if (subParam == "yes")
+                chosenAlignerType = syncAligner;
+
+            i++;
+        }
+
         else {
             FATAL(InvalidParameters) << "Parameter '" << paramPrefix << "' is not recognised!";
         }
@@ -467,6 +811,9 @@ void Params::validateParams() {
     if (usingTranscript && chosenAlignerType == approxAligner)
         FATAL(InvalidParameters) << "Approx alligner doesn't work with text files";
 
+    if (usingTranscript && chosenAlignerType == syncAligner)
+        FATAL(InvalidParameters) << "Fast sync needs subtitle timings and doesn't work with text files";
+
     if (modelPath.empty())
         DEBUG << "Using default Model Path.";
 
@@ -491,6 +838,9 @@ void Params::validateParams() {
     if (alignerLogPath.empty())
         DEBUG << "Using default Aligner Log Path.";
 
+    if (audioIsFlac && (readStream || audioIsRaw))
+        FATAL(IncompatibleParameters) << "FLAC audio can only be read from a file!";
+
     if (readStream) {
         audioFileName = "stdin";
     }
@@ -517,6 +867,10 @@ void Params::validateParams() {
         }
     }
 
+    if (liveTranscription && partialOutputFileName.empty()) {
+        partialOutputFileName = extractFileName(outputFileName) + ".partial";
+    }
+
     if (grammarType == complete_grammar && quickDict)
         grammarType = quick_dict;
 
@@ -531,6 +885,50 @@ void Params::validateParams() {
         FATAL(IncompatibleParameters) << "Sorry, currently phoneme transcribing is not supported!";
     }
 
+    if (coarsePass && (transcribe || usingTranscript || useFSG)) {
+        FATAL(IncompatibleParameters) << "Coarse pass only works with subtitle based recognition without FSG!";
+    }
+
+    if (forcedAlign && (transcribe || usingTranscript || useFSG)) {
+        FATAL(IncompatibleParameters) << "Forced alignment only works with subtitle based recognition without FSG!";
+    }
+
+    if (useAnchors && !usingTranscript) {
+        FATAL(IncompatibleParameters) << "Keyword anchors only work with a transcript, use -txt!";
+    }
+
+    if (useAnchors && searchPhonemes) {
+        FATAL(IncompatibleParameters) << "Sorry, phonemes are not supported with keyword anchors!";
+    }
+
+    if (useCueLM && (transcribe || usingTranscript || useFSG)) {
+        FATAL(IncompatibleParameters) << "Cue language models only work with subtitle based recognition without FSG!";
+    }
+
+    if (!checkpointFileName.empty() && (transcribe || usingTranscript || useFSG || readStream || chosenAlignerType != asrAligner)) {
+        FATAL(IncompatibleParameters) << "Checkpoints only work with subtitle based recognition of an audio file, without FSG!";
+    }
+
+    if (parallelTranscription && (!(transcribe || usingTranscript) || useAnchors || chosenAlignerType != asrAligner)) {
+        FATAL(IncompatibleParameters) << "Parallel transcription only works when transcribing, or with a transcript without keyword anchors!";
+    }
+
+    if (liveTranscription && (!(transcribe || usingTranscript) || useAnchors || chosenAlignerType != asrAligner)) {
+        FATAL(IncompatibleParameters) << "Live transcription only works when transcribing, or with a transcript without keyword anchors!";
+    }
+
+    if (liveTranscription && parallelTranscription) {
+        FATAL(IncompatibleParameters) << "Live transcription can't be parallel, the audio is decoded as it arrives!";
+    }
+
+    if (useCmnPrior && chosenAlignerType != asrAligner) {
+        FATAL(IncompatibleParameters) << "Cepstral mean prior only works with the recognition based aligner!";
+    }
+
+    if (!cmnPriorFileName.empty() && readStream) {
+        FATAL(IncompatibleParameters) << "Cepstral mean can only be saved for an audio file!";
+    }
+
     printParams();
 }
 
@@ -552,10 +950,24 @@ void Params::printParams() const noexcept {
     VERBOSE << "sampleWindow        : " << sampleWindow;
     VERBOSE << "audioWindow         : " << audioWindow;
     VERBOSE << "searchWindow        : " << searchWindow;
+    VERBOSE << "coarseWindow        : " << coarseWindow;
+    VERBOSE << "anchorSpacing       : " << anchorSpacing;
+    VERBOSE << "cueLMContext        : " << cueLMContext;
+    VERBOSE << "cueLMWeight         : " << cueLMWeight;
+    VERBOSE << "splitSilence        : " << splitSilence;
+    VERBOSE << "partialInterval     : " << partialInterval;
+    VERBOSE << "stableFrames        : " << stableFrames;
+    VERBOSE << "liveSpeed           : " << liveSpeed;
+    VERBOSE << "partialOutFileName  : " << partialOutputFileName;
+    VERBOSE << "checkpointFileName  : " << checkpointFileName;
+    VERBOSE << "checkpointInterval  : " << checkpointInterval;
+    VERBOSE << "cmnPriorFileName    : " << cmnPriorFileName;
+    VERBOSE << "pronunciationStore  : " << pronunciationStorePath;
     VERBOSE << "chosenAlignerType   : " << chosenAlignerType;
     VERBOSE << "grammarType         : " << grammarType;
     VERBOSE << "outputFormat        : " << outputFormat;
     VERBOSE << "printOption         : " << printOption;
+    VERBOSE << "decoderProfile      : " << decoderProfile;
     VERBOSE << "verbosity           : " << verbosity;
     VERBOSE << "useFSG              : " << useFSG;
     VERBOSE << "transcribe          : " << transcribe;
@@ -566,5 +978,12 @@ void Params::printParams() const noexcept {
     VERBOSE << "readStream          : " << readStream;
     VERBOSE << "quickDict           : " << quickDict;
     VERBOSE << "quickLM             : " << quickLM;
+    VERBOSE << "coarsePass          : " << coarsePass;
+    VERBOSE << "forcedAlign         : " << forcedAlign;
+    VERBOSE << "useAnchors          : " << useAnchors;
+    VERBOSE << "useCueLM            : " << useCueLM;
+    VERBOSE << "useCmnPrior         : " << useCmnPrior;
+    VERBOSE << "parallelTranscript  : " << parallelTranscription;
+    VERBOSE << "liveTranscription   : " << liveTranscription;
     VERBOSE << "\n\n=====================================================\n";
 }
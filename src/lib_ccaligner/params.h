@@ -15,14 +15,17 @@ class Params {
     std::string localTime;
     void validateParams();
 public:
-    std::string audioFileName, subtitleFileName, transcriptFileName, outputFileName, modelPath, lmPath, dictPath, fsgPath, logPath, phoneticLmPath, phonemeLogPath, alignerLogPath;
-    bool audioIsRaw;
-    unsigned long searchWindow, sampleWindow, audioWindow;
+    std::string audioFileName, subtitleFileName, transcriptFileName, outputFileName, modelPath, lmPath, dictPath, fsgPath, logPath, phoneticLmPath, phonemeLogPath, alignerLogPath, checkpointFileName, cmnPriorFileName, pronunciationStorePath, partialOutputFileName;
+    bool audioIsRaw, audioIsFlac;
+    unsigned long searchWindow, sampleWindow, audioWindow, coarseWindow, anchorSpacing, checkpointInterval, cueLMContext, splitSilence, partialInterval, stableFrames;
+    float cueLMWeight, liveSpeed;
     alignerType chosenAlignerType;
     grammarName grammarType;
     outputFormats outputFormat;
     outputOptions printOption;
-    bool verbosity, usingTranscript, useFSG, transcribe, useBatchMode, useExperimentalParams, searchPhonemes, displayRecognised, readStream, quickDict, quickLM;
+    decoderProfiles decoderProfile;
+    std::vector<std::pair<std::string, std::string>> decoderSettings;     //PocketSphinx arguments set explicitly, applied after the profile
+    bool verbosity, usingTranscript, useFSG, transcribe, useBatchMode, useExperimentalParams, searchPhonemes, displayRecognised, readStream, quickDict, quickLM, coarsePass, forcedAlign, useAnchors, useCueLM, useCmnPrior, parallelTranscription, liveTranscription;
 
     Params() noexcept;
     void inputParams(int argc, char *argv[]);
@@ -0,0 +1,258 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#include "pronunciation_store.h"
+#include "checkpoint.h"
+#include <cstring>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const long int minimumLogSizeToMerge = 16384;      //bytes, the first jobs merge their words at once
+
+//"word pronunciation", the pronunciation may be empty; false for an empty or broken line
+static bool splitLine(const std::string& line, std::string& word, std::string& pronunciation)
+{
+    const size_t space = line.find(' ');
+
+    if (space == 0 || space == std::string::npos)
+        return false;
+
+    word = line.substr(0, space);
+    pronunciation = line.substr(space + 1);
+    return true;
+}
+
+//complete lines of the log, a line cut off by a job which was stopped while appending is left out
+static std::vector<std::pair<std::string, std::string>> readLog(const std::string& fileName)
+{
+    std::vector<std::pair<std::string, std::string>> pronunciations;
+    std::ifstream in(fileName, std::ios::binary);
+    std::string line, word, pronunciation;
+
+    while (std::getline(in, line) && !in.eof())
+    {
+        if (splitLine(line, word, pronunciation))
+            pronunciations.emplace_back(word, pronunciation);
+    }
+
+    return pronunciations;
+}
+
+PronunciationStore::PronunciationStore(const std::string& fileName) :
+    _tableFileName(fileName),
+    _logFileName(fileName + ".log"),
+    _table(nullptr),
+    _tableSize(0),
+    _logSize(0)
+{
+#ifndef _WIN32
+    const int fd = open(_tableFileName.c_str(), O_RDONLY);
+    struct stat tableStatus;
+
+    if (fd >= 0 && fstat(fd, &tableStatus) == 0 && tableStatus.st_size > 0)
+    {
+        void *table = mmap(nullptr, tableStatus.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (table != MAP_FAILED)
+        {
+            _table = static_cast<const char *>(table);
+            _tableSize = tableStatus.st_size;
+        }
+    }
+
+    if (fd >= 0)
+        close(fd);
+#else
+    std::ifstream in(_tableFileName, std::ios::binary);
+    _tableData.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    _table = _tableData.data();
+    _tableSize = _tableData.size();
+#endif
+
+    for (auto& entry : readLog(_logFileName))
+        _log.insert(std::move(entry));
+
+    _logSize = std::max(getFileSize(_logFileName), 0L);
+
+    DEBUG << "Pronunciation store " << _tableFileName << " : " << _tableSize << " bytes of table, "
+          << _log.size() << " words in the log";
+}
+
+bool PronunciationStore::findInTable(const std::string& word, std::string& pronunciation) const
+{
+    //binary search over the bytes of the table : lo is always the start of a line, hi the end of the range
+    size_t lo = 0, hi = _tableSize;
+
+    while (lo < hi)
+    {
+        size_t start = lo + (hi - lo) / 2;
+
+        while (start > lo && _table[start - 1] != '\n')
+            start--;
+
+        const char *newline = static_cast<const char *>(std::memchr(_table + start, '\n', _tableSize - start));
+        const size_t lineEnd = newline == nullptr ? _tableSize : newline - _table;
+        const char *space = static_cast<const char *>(std::memchr(_table + start, ' ', lineEnd - start));
+        const size_t wordEnd = space == nullptr ? lineEnd : space - _table;
+        const int order = word.compare(0, std::string::npos, _table + start, wordEnd - start);
+
+        if (order == 0)
+        {
+            pronunciation.assign(_table + std::min(wordEnd + 1, lineEnd), _table + lineEnd);
+            return true;
+        }
+
+        if (order < 0)
+            hi = start;
+        else
+            lo = lineEnd + 1;
+    }
+
+    return false;
+}
+
+bool PronunciationStore::find(const std::string& word, std::string& pronunciation) const
+{
+    auto entry = _log.find(word);
+
+    if (entry != _log.end())
+    {
+        pronunciation = entry->second;
+        return true;
+    }
+
+    return findInTable(word, pronunciation);
+}
+
+void PronunciationStore::add(const std::vector<std::pair<std::string, std::string>>& pronunciations)
+{
+    if (pronunciations.empty())
+        return;
+
+    std::string lines;
+
+    for (const auto& entry : pronunciations)
+    {
+        lines += entry.first + " " + entry.second + "\n";
+        _log[entry.first] = entry.second;
+    }
+
+    //unbuffered, so that the lines are appended by a single write and those of jobs adding at the same time aren't mixed
+    FILE *log = std::fopen(_logFileName.c_str(), "ab");
+
+    if (log == nullptr)
+    {
+        WARNING << "Unable to save pronunciations : " << _logFileName << " : " << strerror(errno);
+        return;
+    }
+
+    std::setvbuf(log, nullptr, _IONBF, 0);
+    const bool isWritten = std::fwrite(lines.data(), 1, lines.size(), log) == lines.size();
+    std::fclose(log);
+
+    if (!isWritten)
+    {
+        WARNING << "Unable to save pronunciations : " << _logFileName;
+        return;
+    }
+
+    DEBUG << "Saved " << pronunciations.size() << " pronunciations to " << _logFileName;
+
+    _logSize = std::max(getFileSize(_logFileName), 0L);
+
+    if (_logSize >= std::max(minimumLogSizeToMerge, (long int) _tableSize / 4))
+        merge();
+}
+
+void PronunciationStore::merge()
+{
+    //the log read again, with the words other jobs appended since it was opened
+    std::vector<std::pair<std::string, std::string>> logged = readLog(_logFileName);
+
+    std::stable_sort(logged.begin(), logged.end(),
+                     [](const std::pair<std::string, std::string>& a, const std::pair<std::string, std::string>& b)
+                     { return a.first < b.first; });
+
+    const std::string temporaryFileName = _tableFileName + "." + std::to_string(getpid()) + ".tmp";
+    std::ofstream out(temporaryFileName, std::ios::binary);
+    size_t position = 0, numberOfWords = 0;
+    auto entry = logged.begin();
+
+    //both sorted, merged line by line; a word already in the table keeps its pronunciation
+    while (position < _tableSize || entry != logged.end())
+    {
+        if (position < _tableSize)
+        {
+            const char *newline = static_cast<const char *>(std::memchr(_table + position, '\n', _tableSize - position));
+            const size_t lineEnd = newline == nullptr ? _tableSize : newline - _table;
+            const char *space = static_cast<const char *>(std::memchr(_table + position, ' ', lineEnd - position));
+            const std::string word(_table + position, (space == nullptr ? _table + lineEnd : space));
+
+            if (entry == logged.end() || word <= entry->first)
+            {
+                while (entry != logged.end() && entry->first == word)
+                    ++entry;
+
+                out.write(_table + position, lineEnd - position);
+                out << "\n";
+                position = lineEnd + 1;
+                numberOfWords++;
+                continue;
+            }
+        }
+
+        out << entry->first << " " << entry->second << "\n";
+        numberOfWords++;
+
+        const std::string word = entry->first;
+
+        while (entry != logged.end() && entry->first == word)
+            ++entry;
+    }
+
+    out.close();
+
+    if (!out)
+    {
+        std::remove(temporaryFileName.c_str());
+        WARNING << "Unable to write pronunciations : " << temporaryFileName;
+        return;
+    }
+
+    //a new file rather than the old one rewritten, jobs which mapped the old one keep it intact
+#ifdef _WIN32
+    std::remove(_tableFileName.c_str());     //rename() doesn't replace an existing file on Windows
+#endif
+
+    if (std::rename(temporaryFileName.c_str(), _tableFileName.c_str()) != 0)
+    {
+        std::remove(temporaryFileName.c_str());
+        WARNING << "Unable to write pronunciations : " << _tableFileName;
+        return;
+    }
+
+    std::remove(_logFileName.c_str());
+    _logSize = 0;
+
+    DEBUG << "Merged " << logged.size() << " logged pronunciations into " << _tableFileName << " : "
+          << numberOfWords << " words";
+}
+
+PronunciationStore::~PronunciationStore()
+{
+#ifndef _WIN32
+    if (_table != nullptr)
+        munmap(const_cast<char *>(_table), _tableSize);
+#endif
+}
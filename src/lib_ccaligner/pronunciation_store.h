@@ -0,0 +1,43 @@
+/*
+ * Author   : Saurabh Shrivastava
+ * Email    : saurabh.shrivastava54@gmail.com
+ * Link     : https://github.com/saurabhshri
+*/
+
+#ifndef CCALIGNER_PRONUNCIATION_STORE_H
+#define CCALIGNER_PRONUNCIATION_STORE_H
+
+#include "commons.h"
+#include <unordered_map>
+
+/*
+ * Pronunciations generated by earlier jobs, so that a dictionary only has to be generated for the words
+ * never seen before. The store is a dictionary sorted by word, itself a valid pronunciation dictionary,
+ * which is memory mapped and searched in place, and a log next to it to which every job appends the words
+ * it generated. Once the log grows to a quarter of the table it is merged into it. The table is replaced
+ * by renaming a new one over it, so jobs which mapped the old one keep reading it; a word lost to two
+ * jobs merging at once is merely generated again.
+ */
+
+class PronunciationStore
+{
+    std::string _tableFileName, _logFileName;
+    const char *_table;             //sorted lines of "word pronunciation"
+    size_t _tableSize;
+#ifdef _WIN32
+    std::string _tableData;
+#endif
+    std::unordered_map<std::string, std::string> _log;      //words of the log, and those added since opening
+    long int _logSize;
+
+    bool findInTable(const std::string& word, std::string& pronunciation) const;
+    void merge();
+
+public:
+    explicit PronunciationStore(const std::string& fileName);   //table fileName and log fileName + ".log", either may not exist yet
+    bool find(const std::string& word, std::string& pronunciation) const;
+    void add(const std::vector<std::pair<std::string, std::string>>& pronunciations);  //appended to the log, merged if it has grown enough
+    ~PronunciationStore();
+};
+
+#endif //CCALIGNER_PRONUNCIATION_STORE_H
@@ -5,6 +5,10 @@
 */
 
 #include "recognize_using_pocketsphinx.h"
+#include <chrono>
+#include <numeric>
+#include <unordered_map>
+#include <sstream>
 
 PocketsphinxAligner::PocketsphinxAligner(Params* parameters) noexcept
     : _parameters(parameters),
@@ -29,8 +33,16 @@ PocketsphinxAligner::PocketsphinxAligner(Params* parameters) noexcept
 
     //processing subtitles file
     _subParserFactory(_subtitleFileName),
-    _parser(_subParserFactory.getParser())
+    _parser(_subParserFactory.getParser()),
     //_subtitles(_parser->getSubtitles())
+
+    //set by initDecoder(), the aligner may be destroyed without it, e.g. after generating the grammar alone
+    _psWordDecoder(nullptr),
+    _psPhonemeDecoder(nullptr),
+    _configWord(nullptr),
+    _configPhoneme(nullptr),
+
+    _isResuming(false)
 {
     DEBUG << "Initialising Aligner using PocketSphinx";
 
@@ -44,13 +56,7 @@ PocketsphinxAligner::PocketsphinxAligner(Params* parameters) noexcept
 
     INFO << "Reading and decoding audio samples...";
 
-    if (parameters->readStream)
-        _file = decltype(_file)(new WaveFileData(readStreamDirectly, parameters->audioIsRaw));
-    else
-        _file = decltype(_file)(new WaveFileData(_audioFileName, parameters->audioIsRaw));
-
-    _file->read();
-    _samples = _file->getSamples();
+    _audio = openAudioSource(parameters);
 }
 
 bool PocketsphinxAligner::generateGrammar(grammarName name) {
@@ -64,9 +70,9 @@ bool PocketsphinxAligner::generateGrammar(grammarName name) {
     }
     bool ret;
     if (!_parameters->usingTranscript)
-        ret = generate(_subtitles, name);
+        ret = generate(_subtitles, name, _parameters->pronunciationStorePath);
     else
-        ret = generate(_transcriptFileName, name);
+        ret = generate(_transcriptFileName, name, _parameters->pronunciationStorePath);
     return ret;
 }
 
@@ -83,60 +89,40 @@ bool PocketsphinxAligner::initDecoder(const std::string& modelPath, const std::s
         << "\n\tlmPath = " << _lmPath << "\n\tdictPath = " << _dictPath
         << "\n\tfsgPath = " << _fsgPath << "\n\tlogPath = " << _logPath;
 
-    if (_parameters->useBatchMode) {
-        if (_parameters->useExperimentalParams) {
-            _configWord = cmd_ln_init(nullptr,
-                ps_args(), TRUE,
-                "-hmm", modelPath.c_str(),
-                "-lm", lmPath.c_str(),
-                "-dict", dictPath.c_str(),
-                "-logfn", logPath.c_str(),
-                "-cmn", "batch",
-                "-lw", "1.0",
-                "-beam", "1e-80",
-                "-wbeam", "1e-60",
-                "-pbeam", "1e-80",
-                nullptr);
-        }
+    //later settings replace earlier ones : stock configuration, batch mode and experimental parameters, profile, explicit settings
+    DecoderSettings settings = {{"-hmm", modelPath}, {"-lm", lmPath}, {"-dict", dictPath}, {"-logfn", logPath}};
 
-        else {
-            _configWord = cmd_ln_init(nullptr,
-                ps_args(), TRUE,
-                "-hmm", modelPath.c_str(),
-                "-lm", lmPath.c_str(),
-                "-dict", dictPath.c_str(),
-                "-logfn", logPath.c_str(),
-                "-cmn", "batch",
-                nullptr);
-        }
+    if (_parameters->useBatchMode)
+        setDecoderSetting(settings, "-cmn", "batch");
 
-    }
+    if (_parameters->useExperimentalParams)
+        setDecoderSettings(settings, {{"-lw", "1.0"}, {"-beam", "1e-80"}, {"-wbeam", "1e-60"}, {"-pbeam", "1e-80"}});
 
-    else if (_parameters->useExperimentalParams) {
-        _configWord = cmd_ln_init(nullptr,
-            ps_args(), TRUE,
-            "-hmm", modelPath.c_str(),
-            "-lm", lmPath.c_str(),
-            "-dict", dictPath.c_str(),
-            "-logfn", logPath.c_str(),
-            "-lw", "1.0",
-            "-beam", "1e-80",
-            "-wbeam", "1e-60",
-            "-pbeam", "1e-80",
-            nullptr);
+    setDecoderSettings(settings, getDecoderProfile(_parameters->decoderProfile));
+    setDecoderSettings(settings, _parameters->decoderSettings);
 
-    }
+    //the binary trie of the model is mapped instead of parsing the text, and shared by every model read from it;
+    //a text model is converted once, later runs load the binary written next to it
+    if (!lmPath.empty() && getBinaryLMPath(lmPath) == lmPath && ngram_file_name_to_type(lmPath.c_str()) != NGRAM_BIN)
+        ConvertLMToBinary(lmPath);
 
-    else {
-        _configWord = cmd_ln_init(nullptr,
-            ps_args(), TRUE,
-            "-hmm", modelPath.c_str(),
-            "-lm", lmPath.c_str(),
-            "-dict", dictPath.c_str(),
-            "-logfn", logPath.c_str(),
-            nullptr);
+    const std::string binaryLMPath = getBinaryLMPath(lmPath);
+    const auto setting = [&settings](const std::string& name) {
+        return std::find_if(settings.begin(), settings.end(), [&name](const std::pair<std::string, std::string>& s) { return s.first == name; });
+    };
+
+    //it holds log probabilities in the default base
+    if (binaryLMPath != lmPath && setting("-lm")->second == lmPath
+        && (setting("-logbase") == settings.end() || std::stod(setting("-logbase")->second) == 1.0001))
+    {
+        DEBUG << "Using binary language model : " << binaryLMPath;
+        setDecoderSetting(settings, "-lm", binaryLMPath);
+        _lmPath = binaryLMPath;
     }
 
+    DEBUG << "Decoder profile : " << getDecoderProfileName(_parameters->decoderProfile) << ", settings : " << printDecoderSettings(settings);
+
+    _configWord = createDecoderConfig(settings);
 
     if (_configWord == nullptr) {
         FATAL(UnknownError) << "Failed to create config object, see log for details";
@@ -152,9 +138,45 @@ bool PocketsphinxAligner::initDecoder(const std::string& modelPath, const std::s
         initPhonemeDecoder(_parameters->phoneticLmPath, _parameters->phonemeLogPath);
     }
 
+    if (_parameters->useCmnPrior) {
+        initCmnPrior();
+    }
+
     return true;
 }
 
+void PocketsphinxAligner::initCmnPrior() {
+    //a saved mean is used again as long as it was computed for the same audio file and acoustic model
+    const std::string source = _audioFileName + ":" + std::to_string(getFileSize(_audioFileName)) + " " + _modelPath;
+    const std::string& fileName = _parameters->cmnPriorFileName;
+    CmnPrior prior;
+    bool isLoaded = !fileName.empty() && prior.load(fileName);
+
+    if (isLoaded && prior.source != source) {
+        WARNING << "Cepstral mean is of another audio, computing it again";
+        isLoaded = false;
+    }
+
+    if (!isLoaded) {
+        prior = computeCmnPrior(_psWordDecoder, *_audio, findSpeechActivity());
+        prior.source = source;
+
+        if (prior.mean.empty()) {
+            WARNING << "No speech to compute the cepstral mean from, using live normalisation";
+            return;
+        }
+
+        if (!fileName.empty())
+            prior.save(fileName);
+    }
+
+    _cmnPrior = prior;
+    _cmnPrior.apply(_psWordDecoder);
+
+    if (_psPhonemeDecoder)
+        _cmnPrior.apply(_psPhonemeDecoder);
+}
+
 
 bool PocketsphinxAligner::initPhonemeDecoder(const std::string& phoneticLmPath, const std::string& phonemeLogPath) {
     DEBUG << "Initialising PocketSphinx phoneme decoder..";
@@ -217,7 +239,7 @@ int levenshtein_distance(const std::string &firstWord, const std::string &second
     return previousColumn[length2];
 }
 
-bool PocketsphinxAligner::findAndSetPhonemeTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub) {
+bool PocketsphinxAligner::findAndSetPhonemeTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub, long int windowStartsAt) {
     ps_start_stream(ps);
     int frame_rate = cmd_ln_int32_r(config, "-frate");
     ps_seg_t *iter = ps_seg_iter(ps);
@@ -233,8 +255,8 @@ bool PocketsphinxAligner::findAndSetPhonemeTimes(cmd_ln_t *config, ps_decoder_t
         conf = logmath_exp(ps_get_logmath(ps), pprob);
 
         std::string recognisedPhoneme(ps_seg_word(iter));
-        //the time when utterance was marked, the times are w.r.t. to this
-        long int startTime = sub->getStartTime();
+        //the time when recognition window begins, the times are w.r.t. to this
+        long int startTime = windowStartsAt;
         long int endTime = startTime;
 
         if (recognisedPhoneme == "SIL" || recognisedPhoneme == "BREATH" || recognisedPhoneme == "SMACK" || recognisedPhoneme == "NOISE" || recognisedPhoneme[0] == '+' || recognisedPhoneme[0] == '[')
@@ -258,7 +280,7 @@ bool PocketsphinxAligner::findAndSetPhonemeTimes(cmd_ln_t *config, ps_decoder_t
     return true;
 }
 
-recognisedBlock PocketsphinxAligner::findAndSetWordTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub) {
+recognisedBlock PocketsphinxAligner::findAndSetWordTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub, long int windowStartsAt) {
     ps_start_stream(ps);
     int frame_rate = cmd_ln_int32_r(config, "-frate");
     ps_seg_t *iter = ps_seg_iter(ps);
@@ -285,8 +307,8 @@ recognisedBlock PocketsphinxAligner::findAndSetWordTimes(cmd_ln_t *config, ps_de
 
         std::string recognisedWord(ps_seg_word(iter));
 
-        //the time when utterance was marked, the times are w.r.t. to this
-        long int startTime = sub->getStartTime();
+        //the time when recognition window begins, the times are w.r.t. to this
+        long int startTime = windowStartsAt;
         long int endTime = startTime;
 
         /*
@@ -393,9 +415,25 @@ bool PocketsphinxAligner::printWordTimes(cmd_ln_t *config, ps_decoder_t *ps) {
     return true;
 }
 
+static void addDecodingTime(ps_decoder_t *ps, double &speechTime, double &decodingTime) {
+    double speech, cpu, wall;
+    ps_get_utt_time(ps, &speech, &cpu, &wall);
+
+    speechTime += speech;
+    decodingTime += wall;
+}
+
+static void printDecodingSpeed(const std::string& searchName, double speechTime, double decodingTime) {
+    if (speechTime <= 0)
+        return;
+
+    INFO << searchName << " decoded " << speechTime << " s of audio in " << decodingTime << " s ("
+         << decodingTime / speechTime << " x real time)";
+}
+
 bool PocketsphinxAligner::recognise() {
     int subCount = 1;
-    initFile(_outputFileName, _parameters->outputFormat);
+    const int firstCue = startOutput(subCount);
 
     long int recognitionWindow = 0;
 
@@ -407,12 +445,33 @@ bool PocketsphinxAligner::recognise() {
         recognitionWindow = _sampleWindow;
     }
 
+    OffsetMap offsets;
+
+    if (_parameters->coarsePass) {
+        offsets = estimateSubtitleOffsets();
+        recognitionWindow = _parameters->coarseWindow * 16;
+    }
+
+    long int decodedFrames = 0;
+    double speechTime = 0, decodingTime = 0;
+
+    initCueLanguageModel();
+
     INFO << "Recognising and aligning..";
 
-    for (SubtitleItem *sub : _subtitles) {
+    for (int cue = firstCue; cue < (int) _subtitles.size(); cue++) {
+        SubtitleItem *sub = _subtitles[cue];
+
         if (sub->getDialogue().empty())
             continue;
 
+        //re-centring the dialogue using the offset found in the coarse pass
+        if (!offsets.isEmpty()) {
+            long int offset = offsets.getOffset(sub->getStartTime());
+            sub->setStartTime(std::max(0L, sub->getStartTime() + offset));
+            sub->setEndTime(std::max(sub->getStartTime(), sub->getEndTime() + offset));
+        }
+
 
         //first assigning approx timestamps
         CurrentSub currSub(sub);
@@ -421,21 +480,8 @@ bool PocketsphinxAligner::recognise() {
         //let's correct the timestamps :)
 
         long int dialogueStartsAt = sub->getStartTime();
-        long int dialogueLastsFor = (sub->getEndTime() - dialogueStartsAt);
-
-        long int samplesAlreadyRead = dialogueStartsAt * 16;
-        long int samplesToBeRead = dialogueLastsFor * 16;
-
-        if ((samplesAlreadyRead - recognitionWindow) >= 0)
-            samplesAlreadyRead -= recognitionWindow;
-        else
-            samplesAlreadyRead = 0;
-
-        if ((samplesToBeRead + (2 * recognitionWindow)) < _samples.size())
-            samplesToBeRead += (2 * recognitionWindow);
-
-        else
-            samplesToBeRead = _samples.size() - 1;
+        long int samplesAlreadyRead, samplesToBeRead;
+        findRecognitionWindow(sub, recognitionWindow, samplesAlreadyRead, samplesToBeRead);
 
         /*
         * 00:00:19,320 --> 00:00:21,056
@@ -450,11 +496,13 @@ bool PocketsphinxAligner::recognise() {
         *
         */
 
-        const int16_t *sample = _samples.data();
+        if (_cueLanguageModel)
+            _cueLanguageModel->select(getCueSentences(cue - (int) _parameters->cueLMContext, cue + (int) _parameters->cueLMContext));
 
-        _rvWord = ps_start_utt(_psWordDecoder);
-        _rvWord = ps_process_raw(_psWordDecoder, sample + samplesAlreadyRead, samplesToBeRead, FALSE, FALSE);
-        _rvWord = ps_end_utt(_psWordDecoder);
+        _rvWord = decodeWindow(samplesAlreadyRead, samplesToBeRead, _parameters->searchPhonemes);
+
+        decodedFrames += ps_get_n_frames(_psWordDecoder);
+        addDecodingTime(_psWordDecoder, speechTime, decodingTime);
 
         _hypWord = ps_get_hyp(_psWordDecoder, &_scoreWord);
 
@@ -479,308 +527,1323 @@ bool PocketsphinxAligner::recognise() {
         }
 
         //finding and aligning words from subtitle
-        recognisedBlock currBlock = findAndSetWordTimes(_configWord, _psWordDecoder, sub);
+        recognisedBlock currBlock = findAndSetWordTimes(_configWord, _psWordDecoder, sub, samplesAlreadyRead / 16);
 
         //trying to align non recognised words
         currSub.alignNonRecognised(currBlock);
 
-        if (_parameters->searchPhonemes)
-            recognisePhonemes(sample + samplesAlreadyRead, samplesToBeRead, sub);
-
-        switch (_parameters->outputFormat)  //decide on basis of set output format
-        {
-        case srt:       subCount = printSRTContinuous(_outputFileName, subCount, sub, _parameters->printOption);
-            break;
-
-        case xml:       printXMLContinuous(_outputFileName, sub);
-            break;
-
-        case json:      printJSONContinuous(_outputFileName, sub);
-            break;
-
-        case karaoke:   subCount = printKaraokeContinuous(_outputFileName, subCount, sub, _parameters->printOption);
-            break;
+        //results of both the decoders are merged in the same order for every dialogue
+        if (_parameters->searchPhonemes) {
+            if (_parameters->displayRecognised)
+                std::cout << "Phonemes: " << (_hypPhoneme != nullptr ? _hypPhoneme : "nullptr") << "\n";
 
-        default:    FATAL(InvalidParameters) << "An error occurred while choosing output format!";
+            if (_hypPhoneme != nullptr)
+                findAndSetPhonemeTimes(_configPhoneme, _psPhonemeDecoder, sub, samplesAlreadyRead / 16);
         }
+
+        subCount = printAlignedCue(sub, subCount);
+        saveCheckpoint(cue, subCount);
     }
 
-    printFileEnd(_outputFileName, _parameters->outputFormat);
+    finishOutput();
 
+    INFO << "Decoded " << decodedFrames << " frames for " << _audio->getNumberOfSamples() / 160 << " frames of audio";
+    printDecodingSpeed("LM search", speechTime, decodingTime);
     INFO << "Finished recognition and alignment..";
 
     return true;
 }
 
-bool PocketsphinxAligner::align() {
-    if (_parameters->grammarType != no_grammar)
-        generateGrammar(_parameters->grammarType);
+std::string PocketsphinxAligner::getAlignmentText(SubtitleItem *sub, std::vector<int> &wordIndices) const {
+    /*
+     * The dictionary only has lowercase words without punctuation, thus "Why," is aligned as "why".
+     * Words left empty (e.g. a lone "-") are not aligned, wordIndices maps every aligned word back
+     * to its index in the dialogue.
+     */
 
-    initDecoder(_parameters->modelPath, _parameters->lmPath, _parameters->dictPath, _parameters->fsgPath, _parameters->alignerLogPath);
+    std::string text;
+    std::vector<std::string> words = sub->getIndividualWords();
 
-    if (_parameters->transcribe || _parameters->usingTranscript) {
-        transcribe();
-    }
-    else {
-        if (_parameters->useFSG)
-            alignWithFSG();
-        else
-            recognise();
-    }
+    for (int wordIndex = 0; wordIndex < (int) words.size(); wordIndex++) {
+        std::string word = normaliseWord(words[wordIndex]);
 
-    return true;
+        if (word.empty())
+            continue;
+
+        if (!text.empty())
+            text += " ";
+
+        text += word;
+        wordIndices.push_back(wordIndex);
+    }
 
+    return text;
 }
 
-bool PocketsphinxAligner::recognisePhonemes(const int16_t *sample, int readLimit, SubtitleItem *sub) {
-    _rvPhoneme = ps_start_utt(_psPhonemeDecoder);
-    _rvPhoneme = ps_process_raw(_psPhonemeDecoder, sample, readLimit, FALSE, FALSE);
-    _rvPhoneme = ps_end_utt(_psPhonemeDecoder);
+bool PocketsphinxAligner::findAndSetAlignedTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub, const std::vector<int> &wordIndices, long int windowStartsAt) {
+    ps_start_stream(ps);
+    int frame_rate = cmd_ln_int32_r(config, "-frate");
+    size_t alignedWord = 0;
 
-    _hypPhoneme = ps_get_hyp(_psPhonemeDecoder, &_scorePhoneme);
+    //the alignment contains exactly the words it was built from, in the same order
+    for (ps_seg_t *iter = ps_seg_iter(ps); iter != nullptr; iter = ps_seg_next(iter)) {
+        int32 sf, ef;
+        ps_seg_frames(iter, &sf, &ef);
 
-    if (_hypPhoneme == nullptr) {
-        _hypPhoneme = "nullptr";
+        std::string alignedString(ps_seg_word(iter));
 
-        if (_parameters->displayRecognised)
-            std::cout << "Phonemes: " << _hypPhoneme << "\n";
+        if (alignedString == "<s>" || alignedString == "</s>" || alignedString == "<sil>" || alignedString[0] == '[')
+            continue;
+
+        if (alignedWord >= wordIndices.size()) {
+            ps_seg_free(iter);
+            break;
+        }
+
+        int wordIndex = wordIndices[alignedWord++];
+        long int startTime = windowStartsAt + sf * 1000 / frame_rate;
+        long int endTime = windowStartsAt + ef * 1000 / frame_rate;
+
+        sub->setWordRecognisedStatusByIndex(true, wordIndex);
+        sub->setWordTimesByIndex(startTime, endTime, wordIndex);
+
+        if (_parameters->displayRecognised) {
+            std::cout << "Aligned : " << sub->getWordByIndex(wordIndex);
+            std::cout << "\t\tStart : \t\t" << startTime;
+            std::cout << "\tEnd : \t\t" << endTime;
+            std::cout << "\tDuration : \t\t" << endTime - startTime;
+            std::cout << "\n";
+        }
     }
 
-    else {
-        if (_parameters->displayRecognised)
-            std::cout << "Phonemes: " << _hypPhoneme << "\n";
+    if (_parameters->searchPhonemes) {
+        for (ps_seg_t *iter = ps_seg_phone_iter(ps); iter != nullptr; iter = ps_seg_next(iter)) {
+            int32 sf, ef;
+            ps_seg_frames(iter, &sf, &ef);
+
+            std::string alignedPhoneme(ps_seg_word(iter));
 
-        findAndSetPhonemeTimes(_configPhoneme, _psPhonemeDecoder, sub);
+            if (alignedPhoneme == "SIL")
+                continue;
+
+            sub->addPhoneme(alignedPhoneme, windowStartsAt + sf * 1000 / frame_rate, windowStartsAt + ef * 1000 / frame_rate);
+        }
     }
 
-    return true;
+    return alignedWord == wordIndices.size();
 }
 
-int PocketsphinxAligner::findTranscribedWordTimings(cmd_ln_t *config, ps_decoder_t *ps, int index) {
-    int frame_rate = cmd_ln_int32_r(config, "-frate");
-    ps_seg_t *iter = ps_seg_iter(ps);
-    int printedTillIndex = index;
+bool PocketsphinxAligner::forceAlign() {
+    /*
+     * The words of every dialogue are known, so instead of searching the language model for them
+     * they are Viterbi aligned against their dictionary pronunciations. Dialogues with a word missing
+     * from the dictionary, or which fail to align, are recognised using the language model instead.
+     */
 
-    while (iter != nullptr) {
-        index++;
-        int32 sf, ef, pprob;
-        float conf;
+    int subCount = 1;
+    const int firstCue = startOutput(subCount);
 
-        ps_seg_frames(iter, &sf, &ef);
-        pprob = ps_seg_prob(iter, nullptr, nullptr, nullptr);
-        conf = logmath_exp(ps_get_logmath(ps), pprob);
+    long int recognitionWindow = 0;
 
-        std::string recognisedWord(ps_seg_word(iter));
-        long startTime = sf * 1000 / frame_rate, endTime = ef * 1000 / frame_rate;
+    if (_audioWindow) {
+        recognitionWindow = _audioWindow * 16;
+    }
+
+    else if (_sampleWindow) {
+        recognitionWindow = _sampleWindow;
+    }
 
-        _alignedData.addNewWord(recognisedWord, startTime, endTime, conf);
+    OffsetMap offsets;
 
-        iter = ps_seg_next(iter);
+    if (_parameters->coarsePass) {
+        offsets = estimateSubtitleOffsets();
+        recognitionWindow = _parameters->coarseWindow * 16;
     }
 
-    if (_parameters->outputFormat == xml)
-        printTranscriptionAsXMLContinuous(_outputFileName, &_alignedData, printedTillIndex);
+    initCueLanguageModel();
 
-    else if (_parameters->outputFormat == json)
-        printTranscriptionAsJSONContinuous(_outputFileName, &_alignedData, printedTillIndex);
+    const std::string lmSearch(ps_get_search(_psWordDecoder));
+    int alignedSubs = 0, recognisedSubs = 0;
+    double alignedSpeechTime = 0, alignedDecodingTime = 0, recognisedSpeechTime = 0, recognisedDecodingTime = 0;
 
-    else if (_parameters->outputFormat == srt)
-        printTranscriptionAsSRTContinuous(_outputFileName, &_alignedData, printedTillIndex);
+    INFO << "Force aligning..";
 
-    return index;
-}
+    for (int cue = firstCue; cue < (int) _subtitles.size(); cue++) {
+        SubtitleItem *sub = _subtitles[cue];
 
-bool PocketsphinxAligner::transcribe() {
-    INFO << "Transcribing...";
+        if (sub->getDialogue().empty())
+            continue;
 
-    //pointer to samples
-    const int16_t *sample = _samples.data();
+        //re-centring the dialogue using the offset found in the coarse pass
+        if (!offsets.isEmpty()) {
+            long int offset = offsets.getOffset(sub->getStartTime());
+            sub->setStartTime(std::max(0L, sub->getStartTime() + offset));
+            sub->setEndTime(std::max(sub->getStartTime(), sub->getEndTime() + offset));
+        }
 
-    //creating partition of 2048 bytes
-    int numberOfPartitions = _samples.size() / 2048, remainingSamples = _samples.size() % 2048;
+        //first assigning approx timestamps
+        CurrentSub currSub(sub);
+        currSub.run();
 
-    //index of the word : used for sub and output handling
-    int index = 0;
+        long int samplesAlreadyRead, samplesToBeRead;
+        findRecognitionWindow(sub, recognitionWindow, samplesAlreadyRead, samplesToBeRead);
 
-    bool utt_started, in_speech;
+        std::vector<int> wordIndices;
+        std::string alignmentText = getAlignmentText(sub, wordIndices);
 
-    _rvWord = ps_start_utt(_psWordDecoder);
-    utt_started = FALSE;
+        if (_parameters->displayRecognised) {
+            std::cout << "\n\n-----------------------------------------\n\n";
+            std::cout << "Start time of dialogue : " << sub->getStartTime() << "\n";
+            std::cout << "End time of dialogue   : " << sub->getEndTime() << "\n\n";
+            std::cout << "Actual      : " << sub->getDialogue() << "\n\n";
+        }
 
-    printTranscriptionHeader(_outputFileName, _parameters->outputFormat);
+        bool isAligned = false;
 
-    for (int i = 0; i <= numberOfPartitions; i++) {
-        if (i == numberOfPartitions)
-            ps_process_raw(_psWordDecoder, sample, remainingSamples, FALSE, FALSE);
+        if (!alignmentText.empty() && ps_set_align(_psWordDecoder, "align", alignmentText.c_str()) >= 0) {
+            ps_set_search(_psWordDecoder, "align");
 
-        else
-            ps_process_raw(_psWordDecoder, sample, 2048, FALSE, FALSE);
+            _rvWord = decodeWindow(samplesAlreadyRead, samplesToBeRead, false);
+            addDecodingTime(_psWordDecoder, alignedSpeechTime, alignedDecodingTime);
 
-        in_speech = ps_get_in_speech(_psWordDecoder);
+            isAligned = _rvWord >= 0 && ps_get_hyp(_psWordDecoder, &_scoreWord) != nullptr
+                        && findAndSetAlignedTimes(_configWord, _psWordDecoder, sub, wordIndices, samplesAlreadyRead / 16);
+        }
 
-        if (in_speech && !utt_started) {
-            utt_started = TRUE;
+        if (isAligned) {
+            alignedSubs++;
+
+            //words which could not be looked up, e.g. a lone "-", still get approximate times
+            currSub.alignNonRecognised(recognisedBlock());
         }
 
-        if (!in_speech && utt_started) {
-            ps_end_utt(_psWordDecoder);
-            _hypWord = ps_get_hyp(_psWordDecoder, nullptr);
+        else {
+            recognisedSubs++;
 
-            if (_hypWord != nullptr) {
-                if (_parameters->displayRecognised)
-                    std::cout << "Recognised: " << _hypWord << "\n";
-                index = findTranscribedWordTimings(_configWord, _psWordDecoder, index);
-            }
+            if (_parameters->displayRecognised)
+                std::cout << "Could not force align, recognising using the language model instead\n";
 
-            ps_start_utt(_psWordDecoder);
-            utt_started = FALSE;
-        }
+            for (int i = 0; i < sub->getWordCount(); i++)
+                sub->setWordRecognisedStatusByIndex(false, i);
 
-        sample += 2048;
+            ps_set_search(_psWordDecoder, lmSearch.c_str());
 
-    }
+            if (_cueLanguageModel)
+                _cueLanguageModel->select(getCueSentences(cue - (int) _parameters->cueLMContext, cue + (int) _parameters->cueLMContext));
 
-    _rvWord = ps_end_utt(_psWordDecoder);
+            _rvWord = decodeWindow(samplesAlreadyRead, samplesToBeRead, _parameters->searchPhonemes);
+            addDecodingTime(_psWordDecoder, recognisedSpeechTime, recognisedDecodingTime);
+
+            _hypWord = ps_get_hyp(_psWordDecoder, &_scoreWord);
+
+            if (_hypWord == nullptr)
+                continue;
 
-    if (utt_started) {
-        _hypWord = ps_get_hyp(_psWordDecoder, nullptr);
-        if (_hypWord != nullptr) {
             if (_parameters->displayRecognised)
-                std::cout << "Recognised: " << _hypWord << "\n";
-            index = findTranscribedWordTimings(_configWord, _psWordDecoder, index);
+                std::cout << "Recognised  : " << _hypWord << "\n\n";
+
+            recognisedBlock currBlock = findAndSetWordTimes(_configWord, _psWordDecoder, sub, samplesAlreadyRead / 16);
+            currSub.alignNonRecognised(currBlock);
+
+            if (_parameters->searchPhonemes && _hypPhoneme != nullptr)
+                findAndSetPhonemeTimes(_configPhoneme, _psPhonemeDecoder, sub, samplesAlreadyRead / 16);
         }
+
+        subCount = printAlignedCue(sub, subCount);
+        saveCheckpoint(cue, subCount);
     }
 
-    printTranscriptionFooter(_outputFileName, _parameters->outputFormat);
+    ps_set_search(_psWordDecoder, lmSearch.c_str());
 
-    INFO << "Finished transcription.";
+    finishOutput();
 
-    return true;
-}
+    INFO << "Force aligned " << alignedSubs << " dialogues, recognised " << recognisedSubs << " using the language model";
+    printDecodingSpeed("Forced alignment", alignedSpeechTime, alignedDecodingTime);
+    printDecodingSpeed("LM search", recognisedSpeechTime, recognisedDecodingTime);
+    INFO << "Finished forced alignment..";
 
-bool PocketsphinxAligner::reInitDecoder(cmd_ln_t *config, ps_decoder_t *ps) {
-    ps_reinit(_psWordDecoder, _configWord);
     return true;
 }
 
-bool PocketsphinxAligner::alignWithFSG() {
-    int subCount = 1;
-    initFile(_outputFileName, _parameters->outputFormat);
+int PocketsphinxAligner::printAlignedCue(SubtitleItem *sub, int subCount) const {
+    switch (_parameters->outputFormat)  //decide on basis of set output format
+    {
+    case srt:       subCount = printSRTContinuous(_outputFileName, subCount, sub, _parameters->printOption);
+        break;
 
-    long int recognitionWindow = 0;
+    case xml:       printXMLContinuous(_outputFileName, sub);
+        break;
 
-    if (_audioWindow) {
-        recognitionWindow = _audioWindow * 16;
-    }
+    case json:      printJSONContinuous(_outputFileName, sub);
+        break;
 
-    else if (_sampleWindow) {
-        recognitionWindow = _sampleWindow;
+    case karaoke:   subCount = printKaraokeContinuous(_outputFileName, subCount, sub, _parameters->printOption);
+        break;
+
+    default:    FATAL(InvalidParameters) << "An error occurred while choosing output format!";
     }
 
-    for (SubtitleItem *sub : _subtitles) {
-        if (sub->getDialogue().empty())
-            continue;
+    return subCount;
+}
 
+std::string PocketsphinxAligner::describeJob() const {
+    //everything the output depends on besides the grammar files, which are hashed on their own
+    std::ostringstream job;
+
+    job << (_parameters->forcedAlign ? "forceAlign" : "recognise")
+        << " audio=" << _audioFileName << ":" << _audio->getNumberOfSamples()
+        << " subtitles=" << hashFile(_subtitleFileName)
+        << " output=" << _outputFileName << ":" << _parameters->outputFormat << ":" << _parameters->printOption
+        << " windows=" << _audioWindow << ":" << _sampleWindow << ":" << _searchWindow
+        << " coarse=" << _parameters->coarsePass << ":" << _parameters->coarseWindow
+        << " phonemes=" << _parameters->searchPhonemes
+        << " cueLM=" << _parameters->useCueLM << ":" << _parameters->cueLMContext << ":" << _parameters->cueLMWeight
+        << " decoder=" << _modelPath << ":" << _parameters->useBatchMode << ":" << _parameters->useExperimentalParams
+        << " profile=" << getDecoderProfileName(_parameters->decoderProfile) << ":" << printDecoderSettings(_parameters->decoderSettings)
+        << " cmnPrior=" << _parameters->useCmnPrior;
+
+    return job.str();
+}
 
-        //first assigning approx timestamps
-        CurrentSub currSub(sub);
-        currSub.run();
+std::vector<std::pair<std::string, std::string>> PocketsphinxAligner::hashGrammarFiles() const {
+    return {{_parameters->lmPath, hashFile(_parameters->lmPath)}, {_parameters->dictPath, hashFile(_parameters->dictPath)}};
+}
 
-        long int dialogueStartsAt = sub->getStartTime();
-        std::string fsgname(_fsgPath + std::to_string(dialogueStartsAt));
-        fsgname += ".fsg";
+int PocketsphinxAligner::startOutput(int &subCount) {
+    //returns the first cue to align, cues written after the checkpoint are cut off and aligned again
+    _checkpointSavedAt = std::chrono::steady_clock::now();
 
-        cmd_ln_t *subConfig;
-        subConfig = cmd_ln_init(nullptr,
-            ps_args(), TRUE,
-            "-hmm", _modelPath.c_str(),
-            "-lm", _lmPath.c_str(),
-            "-dict", _dictPath.c_str(),
-            "-logfn", _logPath.c_str(),
-            "-fsg", fsgname.c_str(),
-            //                          "-lw", "1.0",
-            //                          "-beam", "1e-80",
-            //                          "-wbeam", "1e-60",
-            //                          "-pbeam", "1e-80",
-            nullptr);
+    if (!_isResuming) {
+        initFile(_outputFileName, _parameters->outputFormat);
+        return 0;
+    }
 
-        if (subConfig == nullptr) {
-            fprintf(stderr, "Failed to create config object, see log for details\n");
-            return -1;
-        }
+    truncateFile(_outputFileName, _checkpoint.outputSize);
+    subCount = _checkpoint.subCount;
 
-        ps_reinit(_psWordDecoder, subConfig);
+    //the live CMN carries over from one dialogue to the next, thus the cues decode the same as without a restart
+    _checkpoint.wordCmn.restore(ps_get_feat(_psWordDecoder)->cmn_struct);
 
-        if (_psWordDecoder == nullptr) {
-            fprintf(stderr, "Failed to create recognizer, see log for details\n");
-            return -1;
-        }
+    if (_parameters->searchPhonemes)
+        _checkpoint.phonemeCmn.restore(ps_get_feat(_psPhonemeDecoder)->cmn_struct);
 
-        long int dialogueLastsFor = (sub->getEndTime() - dialogueStartsAt);
+    INFO << "Resuming from dialogue " << _checkpoint.lastCue + 2 << " of " << _subtitles.size();
 
-        long int samplesAlreadyRead = dialogueStartsAt * 16;
-        long int samplesToBeRead = dialogueLastsFor * 16;
+    return _checkpoint.lastCue + 1;
+}
 
-        if ((samplesAlreadyRead - recognitionWindow) >= 0)
-            samplesAlreadyRead -= recognitionWindow;
-        else
-            samplesAlreadyRead = 0;
+void PocketsphinxAligner::saveCheckpoint(int cue, int subCount) {
+    if (_parameters->checkpointFileName.empty())
+        return;
 
-        if ((samplesToBeRead + (2 * recognitionWindow)) < _samples.size())
-            samplesToBeRead += (2 * recognitionWindow);
+    const auto now = std::chrono::steady_clock::now();
 
-        else
-            samplesToBeRead = _samples.size() - 1;
+    if (now - _checkpointSavedAt < std::chrono::seconds(_parameters->checkpointInterval))
+        return;
 
-        const int16_t *sample = _samples.data();
+    _checkpoint.lastCue = cue;
+    _checkpoint.subCount = subCount;
+    _checkpoint.outputSize = getFileSize(_outputFileName);
+    _checkpoint.wordCmn = CmnState(ps_get_feat(_psWordDecoder)->cmn_struct);
 
-        _rvWord = ps_start_utt(_psWordDecoder);
-        _rvWord = ps_process_raw(_psWordDecoder, sample + samplesAlreadyRead, samplesToBeRead, FALSE, FALSE);
-        _rvWord = ps_end_utt(_psWordDecoder);
+    if (_parameters->searchPhonemes)
+        _checkpoint.phonemeCmn = CmnState(ps_get_feat(_psPhonemeDecoder)->cmn_struct);
 
-        _hypWord = ps_get_hyp(_psWordDecoder, &_scoreWord);
+    _checkpoint.save(_parameters->checkpointFileName);
+    _checkpointSavedAt = now;
+}
 
-        if (_hypWord == nullptr) {
-            _hypWord = "nullptr";
+void PocketsphinxAligner::finishOutput() {
+    printFileEnd(_outputFileName, _parameters->outputFormat);
 
-            if (_parameters->displayRecognised) {
-                std::cout << "\n\n-----------------------------------------\n\n";
-                std::cout << "Recognised: " << _hypWord << "\n";
-            }
+    //a finished job has nothing to resume
+    if (!_parameters->checkpointFileName.empty())
+        std::remove(_parameters->checkpointFileName.c_str());
+}
 
-            continue;
+Sentences PocketsphinxAligner::getCueSentences(int firstCue, int lastCue) const {
+    //dialogues of the cues [firstCue, lastCue], as the dictionary has their words
+    Sentences sentences;
 
-        }
+    for (int cue = std::max(0, firstCue); cue <= lastCue && cue < (int) _subtitles.size(); cue++) {
+        std::vector<std::string> words;
 
-        if (_parameters->displayRecognised) {
-            std::cout << "\n\n-----------------------------------------\n\n";
-            std::cout << "Start time of dialogue : " << dialogueStartsAt << "\n";
-            std::cout << "End time of dialogue   : " << sub->getEndTime() << "\n\n";
-            std::cout << "Recognised  : " << _hypWord << "\n";
-            std::cout << "Actual      : " << sub->getDialogue() << "\n\n";
+        for (const std::string& word : _subtitles[cue]->getIndividualWords()) {
+            std::string normalised = normaliseWord(word);
+
+            if (!normalised.empty())
+                words.push_back(normalised);
         }
 
-        recognisedBlock currBlock = findAndSetWordTimes(subConfig, _psWordDecoder, sub);
+        if (!words.empty())
+            sentences.push_back(words);
+    }
 
-        switch (_parameters->outputFormat)  //decide on basis of set output format
-        {
-        case srt:       subCount = printSRTContinuous(_outputFileName, subCount, sub, _parameters->printOption);
-            break;
+    return sentences;
+}
 
-        case xml:       printXMLContinuous(_outputFileName, sub);
-            break;
+void PocketsphinxAligner::initCueLanguageModel() {
+    if (!_parameters->useCueLM)
+        return;
 
-        case json:      printJSONContinuous(_outputFileName, sub);
-            break;
+    INFO << "Interpolating the language model with one of every cue window..";
 
-        case karaoke:   subCount = printKaraokeContinuous(_outputFileName, subCount, sub, _parameters->printOption);
-            break;
+    //all the dialogues give the vocabulary of the set, any window is a part of them
+    _cueLanguageModel.reset(new CueLanguageModel(_psWordDecoder, _lmPath, getCueSentences(0, _subtitles.size() - 1), _parameters->cueLMWeight));
+}
 
-        default:        FATAL(UnknownError) << "An error occurred while choosing output format!";
-        }
+void PocketsphinxAligner::findRecognitionWindow(SubtitleItem *sub, long int recognitionWindow, long int &samplesAlreadyRead, long int &samplesToBeRead) const {
+    long int dialogueStartsAt = sub->getStartTime();
+    long int dialogueLastsFor = (sub->getEndTime() - dialogueStartsAt);
+    const long int totalSamples = _audio->getNumberOfSamples();
 
+    samplesAlreadyRead = dialogueStartsAt * 16;
+    samplesToBeRead = dialogueLastsFor * 16;
 
-        cmd_ln_free_r(subConfig);
+    if ((samplesAlreadyRead - recognitionWindow) >= 0) {
+        samplesAlreadyRead -= recognitionWindow;
+        samplesToBeRead += recognitionWindow;
+    }
+    else {
+        samplesToBeRead += samplesAlreadyRead;
+        samplesAlreadyRead = 0;
+    }
+
+    samplesToBeRead += recognitionWindow;
+
+    //never read past the last sample
+    if (samplesAlreadyRead > totalSamples)
+        samplesAlreadyRead = totalSamples;
+
+    if (samplesAlreadyRead + samplesToBeRead > totalSamples)
+        samplesToBeRead = totalSamples - samplesAlreadyRead;
+}
+
+const std::vector<char>& PocketsphinxAligner::findSpeechActivity() {
+    if (_speechActivity.empty())
+        _speechActivity = getSpeechActivity(*_audio);
+
+    return _speechActivity;
+}
+
+OffsetMap PocketsphinxAligner::estimateSubtitleOffsets() {
+    INFO << "Estimating subtitle offset and drift from voice activity..";
+
+    const std::vector<char>& speechActivity = findSpeechActivity();
+    std::vector<char> occupancy = getSubtitleOccupancy(_subtitles, speechActivity.size());
+
+    return estimateOffsets(speechActivity, occupancy, defaultSegmentFrames, defaultMaxShiftFrames);
+}
+
+bool PocketsphinxAligner::align() {
+    const bool useCheckpoint = !_parameters->checkpointFileName.empty();
+    bool hasCheckpoint = false;
+
+    if (useCheckpoint && _checkpoint.load(_parameters->checkpointFileName)) {
+        if (_checkpoint.job != describeJob())
+            WARNING << "Checkpoint is of another job, starting over";
+
+        else if (getFileSize(_outputFileName) < _checkpoint.outputSize)
+            WARNING << "Output is shorter than at the checkpoint, starting over";
+
+        else
+            hasCheckpoint = true;
+    }
+
+    //the grammar of the checkpointed run is used again as long as none of its files changed
+    if (_parameters->grammarType != no_grammar && !(hasCheckpoint && hashGrammarFiles() == _checkpoint.artifacts))
+        generateGrammar(_parameters->grammarType);
+
+    if (useCheckpoint) {
+        std::vector<std::pair<std::string, std::string>> artifacts = hashGrammarFiles();
+
+        //a grammar generated again from the same subtitles is the same, so the alignment can still carry on
+        _isResuming = hasCheckpoint && artifacts == _checkpoint.artifacts;
+
+        if (hasCheckpoint && !_isResuming)
+            WARNING << "Grammar files changed since the checkpoint, starting over";
+
+        _checkpoint.job = describeJob();
+        _checkpoint.artifacts = artifacts;
+    }
+
+    initDecoder(_parameters->modelPath, _parameters->lmPath, _parameters->dictPath, _parameters->fsgPath, _parameters->alignerLogPath);
+
+    if (_parameters->usingTranscript && _parameters->useAnchors) {
+        alignWithAnchors();
+    }
+    else if (_parameters->transcribe || _parameters->usingTranscript) {
+        transcribe();
+    }
+    else {
+        if (_parameters->useFSG)
+            alignWithFSG();
+        else if (_parameters->forcedAlign)
+            forceAlign();
+        else
+            recognise();
+    }
+
+    return true;
+
+}
+
+bool PocketsphinxAligner::recognisePhonemes(mfcc_t **features, int32 numberOfFrames, bool hasFinalFrame) {
+    _rvPhoneme = decodeFeatures(_psPhonemeDecoder, features, numberOfFrames, hasFinalFrame);
+
+    _hypPhoneme = ps_get_hyp(_psPhonemeDecoder, &_scorePhoneme);
+
+    return _hypPhoneme != nullptr;
+}
+
+int32 PocketsphinxAligner::computeFeatures(const int16_t *sample, long int readLimit, mfcc_t ***features, bool &hasFinalFrame) {
+    /*
+     * Same processing as ps_process_raw() does internally, using the front end of the word decoder.
+     * The frame made of the samples left over at the end of the window is kept after the others, it
+     * must be handed to ps_end_utt_cep() rather than decoded with them.
+     */
+
+    fe_t *fe = ps_get_fe(_psWordDecoder);
+    size_t samplesLeft = readLimit;
+    int32 numberOfFrames, finalFrames;
+
+    fe_start_utt(fe);
+    fe_process_frames(fe, nullptr, &samplesLeft, nullptr, &numberOfFrames, nullptr);
+    *features = (mfcc_t **) ckd_calloc_2d(numberOfFrames + 1, fe_get_output_size(fe), sizeof(mfcc_t));
+
+    fe_process_frames(fe, &sample, &samplesLeft, *features, &numberOfFrames, nullptr);
+    fe_end_utt(fe, (*features)[numberOfFrames], &finalFrames);
+
+    hasFinalFrame = finalFrames > 0;
+    return numberOfFrames;
+}
+
+int PocketsphinxAligner::decodeFeatures(ps_decoder_t *ps, mfcc_t **features, int32 numberOfFrames, bool hasFinalFrame) {
+    /*
+     * The cepstra are fed in blocks of the size ps_process_raw() fills its cepstral buffer with, larger
+     * blocks make the acoustic model drop frames near the edges of its feature buffer.
+     */
+
+    const int32 blockSize = feat_window_size(ps_get_feat(ps)) * 2 + 1;
+    int rv = ps_start_utt(ps);
+
+    for (int32 frame = 0; frame < numberOfFrames && rv >= 0; frame += blockSize)
+        rv = ps_process_cep(ps, features + frame, std::min(blockSize, numberOfFrames - frame), FALSE, FALSE);
+
+    if (rv >= 0)
+        rv = ps_end_utt_cep(ps, hasFinalFrame ? features[numberOfFrames] : nullptr);
+
+    return rv;
+}
+
+int PocketsphinxAligner::decodeWindow(long int samplesAlreadyRead, long int samplesToBeRead, bool withPhonemes) {
+    std::vector<int16_t> samples = _audio->read(samplesAlreadyRead, samplesToBeRead);
+
+    //the cepstra are computed once and decoded by both the decoders at the same time
+    mfcc_t **features, **phonemeFeatures = nullptr;
+    bool hasFinalFrame;
+    int32 numberOfFrames = computeFeatures(samples.data(), samples.size(), &features, hasFinalFrame);
+    std::thread phonemeThread;
+
+    if (withPhonemes) {
+        //CMN is applied in place by the decoder, thus the phoneme decoder gets its own copy
+        const int featureSize = fe_get_output_size(ps_get_fe(_psWordDecoder));
+        phonemeFeatures = (mfcc_t **) ckd_calloc_2d(numberOfFrames + 1, featureSize, sizeof(mfcc_t));
+        memcpy(phonemeFeatures[0], features[0], (numberOfFrames + 1) * featureSize * sizeof(mfcc_t));
+
+        phonemeThread = std::thread(&PocketsphinxAligner::recognisePhonemes, this, phonemeFeatures, numberOfFrames, hasFinalFrame);
+    }
+
+    int rv = decodeFeatures(_psWordDecoder, features, numberOfFrames, hasFinalFrame);
+
+    if (phonemeThread.joinable())
+        phonemeThread.join();
+
+    ckd_free_2d(features);
+    ckd_free_2d(phonemeFeatures);
+
+    return rv;
+}
+
+int PocketsphinxAligner::addTranscribedWords(cmd_ln_t *config, ps_decoder_t *ps, long int offset, AlignedData& transcription) const {
+    int frame_rate = cmd_ln_int32_r(config, "-frate");
+    ps_seg_t *iter = ps_seg_iter(ps);
+    int numberOfWords = 0;
+
+    while (iter != nullptr) {
+        numberOfWords++;
+        int32 sf, ef, pprob;
+        float conf;
+
+        ps_seg_frames(iter, &sf, &ef);
+        pprob = ps_seg_prob(iter, nullptr, nullptr, nullptr);
+        conf = logmath_exp(ps_get_logmath(ps), pprob);
+
+        std::string recognisedWord(ps_seg_word(iter));
+        long startTime = offset + sf * 1000 / frame_rate, endTime = offset + ef * 1000 / frame_rate;
+
+        transcription.addNewWord(recognisedWord, startTime, endTime, conf);
+
+        iter = ps_seg_next(iter);
+    }
+
+    return numberOfWords;
+}
+
+int PocketsphinxAligner::findTranscribedWordTimings(cmd_ln_t *config, ps_decoder_t *ps, int index) {
+    int printedTillIndex = index;
+
+    index += addTranscribedWords(config, ps, 0, _alignedData);
+
+    if (_parameters->outputFormat == xml)
+        printTranscriptionAsXMLContinuous(_outputFileName, &_alignedData, printedTillIndex);
+
+    else if (_parameters->outputFormat == json)
+        printTranscriptionAsJSONContinuous(_outputFileName, &_alignedData, printedTillIndex);
+
+    else if (_parameters->outputFormat == srt)
+        printTranscriptionAsSRTContinuous(_outputFileName, &_alignedData, printedTillIndex);
+
+    return index;
+}
+
+bool PocketsphinxAligner::transcribe() {
+    if (_parameters->parallelTranscription)
+        return transcribeInParallel();
+
+    if (_parameters->liveTranscription)
+        return transcribeLive();
+
+    INFO << "Transcribing...";
+
+    //the audio is read and decoded in partitions of 2048 samples
+    std::vector<int16_t> partition(2048);
+    long int numberOfPartitions = _audio->getNumberOfSamples() / 2048;
+
+    //index of the word : used for sub and output handling
+    int index = 0;
+
+    bool utt_started, in_speech;
+
+    _rvWord = ps_start_utt(_psWordDecoder);
+    utt_started = FALSE;
+
+    printTranscriptionHeader(_outputFileName, _parameters->outputFormat);
+
+    for (long int i = 0; i <= numberOfPartitions; i++) {
+        long int samplesRead = _audio->read(i * 2048, 2048, partition.data());
+        ps_process_raw(_psWordDecoder, partition.data(), samplesRead, FALSE, FALSE);
+
+        in_speech = ps_get_in_speech(_psWordDecoder);
+
+        if (in_speech && !utt_started) {
+            utt_started = TRUE;
+        }
+
+        if (!in_speech && utt_started) {
+            ps_end_utt(_psWordDecoder);
+            _hypWord = ps_get_hyp(_psWordDecoder, nullptr);
+
+            if (_hypWord != nullptr) {
+                if (_parameters->displayRecognised)
+                    std::cout << "Recognised: " << _hypWord << "\n";
+                index = findTranscribedWordTimings(_configWord, _psWordDecoder, index);
+            }
+
+            ps_start_utt(_psWordDecoder);
+            utt_started = FALSE;
+        }
+    }
+
+    _rvWord = ps_end_utt(_psWordDecoder);
+
+    if (utt_started) {
+        _hypWord = ps_get_hyp(_psWordDecoder, nullptr);
+        if (_hypWord != nullptr) {
+            if (_parameters->displayRecognised)
+                std::cout << "Recognised: " << _hypWord << "\n";
+            index = findTranscribedWordTimings(_configWord, _psWordDecoder, index);
+        }
+    }
+
+    printTranscriptionFooter(_outputFileName, _parameters->outputFormat);
+
+    INFO << "Finished transcription.";
+
+    return true;
+}
+
+bool PocketsphinxAligner::transcribeInParallel() {
+    /*
+     * The audio is cut in the middle of every long silence the voice activity detector finds. No utterance
+     * spans such a silence, so the segments are transcribed independently of each other, in parallel, and
+     * their words are put back in order once all are done.
+     */
+
+    INFO << "Transcribing in parallel...";
+
+    std::vector<SpeechSegment> segments = splitAtSilences(findSpeechActivity(), _parameters->splitSilence);
+    std::vector<AlignedData> transcriptions(segments.size());
+    std::vector<std::vector<std::string>> hypotheses(segments.size());
+
+    //longest first, see parallelFor()
+    std::vector<size_t> order(segments.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&segments](size_t a, size_t b) {
+        return segments[a].endTime - segments[a].startTime > segments[b].endTime - segments[b].startTime;
+    });
+
+    const size_t threadCount = getThreadCount(segments.size());
+
+    //a decoder per thread, set up as the word decoder
+    std::vector<ps_decoder_t *> decoders;
+
+    for (size_t i = 0; i < threadCount; i++) {
+        ps_decoder_t *ps = ps_init(_configWord);
+
+        if (ps == nullptr) {
+            FATAL(UnknownError) << "Failed to create recognizer, see log for details";
+        }
+
+        if (!_cmnPrior.mean.empty())
+            _cmnPrior.apply(ps);
+
+        decoders.push_back(ps);
+    }
+
+    //every segment starts from the same cepstral mean, whichever decoder transcribes it and whatever it transcribed before
+    const CmnState initialCmn(ps_get_feat(decoders.front())->cmn_struct);
+
+    INFO << "Transcribing " << segments.size() << " segments using " << threadCount << " threads..";
+
+    const auto startedAt = std::chrono::steady_clock::now();
+
+    parallelFor(segments.size(), threadCount, [&](size_t worker, size_t i) {
+        const size_t segment = order[i];
+        initialCmn.restore(ps_get_feat(decoders[worker])->cmn_struct);
+        transcribeSegment(decoders[worker], segments[segment], segment + 1 == segments.size(), transcriptions[segment], hypotheses[segment]);
+    });
+
+    for (ps_decoder_t *ps : decoders)
+        ps_free(ps);
+
+    const std::chrono::duration<double> took = std::chrono::steady_clock::now() - startedAt;
+    INFO << "Transcribed " << segments.size() << " segments in " << took.count() << " s";
+
+    for (size_t segment = 0; segment < segments.size(); segment++) {
+        if (_parameters->displayRecognised) {
+            for (const std::string& hypothesis : hypotheses[segment])
+                std::cout << "Recognised: " << hypothesis << "\n";
+        }
+
+        const AlignedData& transcription = transcriptions[segment];
+
+        for (size_t i = 0; i < transcription._words.size(); i++)
+            _alignedData.addNewWord(transcription._words[i], transcription._wordStartTimes[i], transcription._wordEndTimes[i], transcription._wordConf[i]);
+    }
+
+    printTranscriptionHeader(_outputFileName, _parameters->outputFormat);
+
+    if (_parameters->outputFormat == xml)
+        printTranscriptionAsXMLContinuous(_outputFileName, &_alignedData, 0);
+
+    else if (_parameters->outputFormat == json)
+        printTranscriptionAsJSONContinuous(_outputFileName, &_alignedData, 0);
+
+    else if (_parameters->outputFormat == srt)
+        printTranscriptionAsSRTContinuous(_outputFileName, &_alignedData, 0);
+
+    printTranscriptionFooter(_outputFileName, _parameters->outputFormat);
+
+    INFO << "Finished transcription.";
+
+    return true;
+}
+
+void PocketsphinxAligner::transcribeSegment(ps_decoder_t *ps, const SpeechSegment& segment, bool isLast, AlignedData& transcription, std::vector<std::string>& hypotheses) const {
+    //the last segment runs to the last sample, not only to the last whole frame of voice activity
+    const long int startSample = segment.startTime * 16;
+    const long int endSample = isLast ? _audio->getNumberOfSamples() : segment.endTime * 16;
+    std::vector<int16_t> samples = _audio->read(startSample, endSample - startSample);
+    cmd_ln_t *config = ps_get_config(ps);
+
+    const auto addUtterance = [&]() {
+        char const *hypothesis = ps_get_hyp(ps, nullptr);
+
+        if (hypothesis != nullptr) {
+            hypotheses.push_back(hypothesis);
+            addTranscribedWords(config, ps, segment.startTime, transcription);
+        }
+    };
+
+    //as in transcribe(), utterances are split where the decoder finds the end of speech;
+    //frames are counted from the start of the stream, the start of the segment
+    bool isInUtterance = false;
+
+    ps_start_stream(ps);
+    ps_start_utt(ps);
+
+    for (size_t i = 0; i < samples.size(); i += 2048) {
+        ps_process_raw(ps, samples.data() + i, std::min<size_t>(2048, samples.size() - i), FALSE, FALSE);
+
+        const bool isInSpeech = ps_get_in_speech(ps);
+
+        if (isInSpeech && !isInUtterance)
+            isInUtterance = true;
+
+        if (!isInSpeech && isInUtterance) {
+            ps_end_utt(ps);
+            addUtterance();
+            ps_start_utt(ps);
+            isInUtterance = false;
+        }
+    }
+
+    ps_end_utt(ps);
+
+    if (isInUtterance)
+        addUtterance();
+}
+
+//words of the current hypothesis, partial during the utterance and final after it
+static std::vector<PartialWord> getPartialWords(ps_decoder_t *ps) {
+    std::vector<PartialWord> words;
+
+    for (ps_seg_t *iter = ps_seg_iter(ps); iter != nullptr; iter = ps_seg_next(iter)) {
+        int32 sf, ef;
+
+        ps_seg_frames(iter, &sf, &ef);
+        words.emplace_back(ps_seg_word(iter), sf, ef, logmath_exp(ps_get_logmath(ps), ps_seg_prob(iter, nullptr, nullptr, nullptr)));
+    }
+
+    return words;
+}
+
+bool PocketsphinxAligner::transcribeLive() {
+    /*
+     * The audio is handed to the decoder as it would arrive from a live source, a chunk every
+     * -partialInterval ms. After every chunk the partial hypothesis is read : its new words are written to
+     * the partial output as provisional, and the words which stay the same for -stableFrames frames are final
+     * and written out at once, to both outputs, instead of waiting for the end of the utterance. At the end
+     * of the utterance, the words of the final hypothesis after the last final word are written.
+     */
+
+    INFO << "Transcribing live...";
+
+    typedef std::chrono::steady_clock Clock;
+
+    const long int chunkSize = _parameters->partialInterval * 16;
+    const long int numberOfSamples = _audio->getNumberOfSamples();
+    const int frameRate = cmd_ln_int32_r(_configWord, "-frate");
+    std::vector<int16_t> chunk(chunkSize);
+    std::vector<Clock::time_point> arrivedAt;      //when every chunk fed to the decoder arrived
+    WordStabiliser stabiliser(_parameters->stableFrames);
+    LatencyHistogram provisionalLatency, finalLatency;
+    std::ofstream partialOutput(_parameters->partialOutputFileName, std::ios::binary);
+    int index = 0;
+
+    if (!partialOutput.is_open()) {
+        FATAL(FileNotFound) << "Unable to create partial output file : " << _parameters->partialOutputFileName;
+    }
+
+    //from the arrival of the chunk holding the last sample of a word to now, in ms
+    const auto latency = [&](const PartialWord& word) {
+        const long int endSample = (long int) word.endFrame * audioSampleRate / frameRate;
+        const size_t arrival = std::min<size_t>(endSample / chunkSize, arrivedAt.size() - 1);
+        return std::chrono::duration<double, std::milli>(Clock::now() - arrivedAt[arrival]).count();
+    };
+
+    const auto isFiller = [](const PartialWord& word) {
+        return word.word.empty() || word.word[0] == '<' || word.word[0] == '[';
+    };
+
+    //a line per word, "provisional" or "final", start and end in ms, and the word; flushed at once for a reader following the file
+    const auto writePartialOutput = [&](const char *state, const std::vector<PartialWord>& words) {
+        for (const PartialWord& word : words) {
+            if (!isFiller(word))
+                partialOutput << state << "\t" << word.startFrame * 1000 / frameRate << "\t" << word.endFrame * 1000 / frameRate << "\t" << word.word << "\n";
+        }
+
+        partialOutput.flush();
+    };
+
+    const auto writeFinalWords = [&](const std::vector<PartialWord>& words) {
+        if (words.empty())
+            return;
+
+        writePartialOutput("final", words);
+
+        for (const PartialWord& word : words)
+            _alignedData.addNewWord(word.word, word.startFrame * 1000 / frameRate, word.endFrame * 1000 / frameRate, word.confidence);
+
+        if (_parameters->outputFormat == xml)
+            printTranscriptionAsXMLContinuous(_outputFileName, &_alignedData, index);
+
+        else if (_parameters->outputFormat == json)
+            printTranscriptionAsJSONContinuous(_outputFileName, &_alignedData, index);
+
+        else if (_parameters->outputFormat == srt)
+            printTranscriptionAsSRTContinuous(_outputFileName, &_alignedData, index);
+
+        index += words.size();
+
+        for (const PartialWord& word : words) {
+            if (!isFiller(word))
+                finalLatency.add(latency(word));
+        }
+    };
+
+    const auto finishUtterance = [&]() {
+        _hypWord = ps_get_hyp(_psWordDecoder, nullptr);
+
+        if (_hypWord != nullptr && _parameters->displayRecognised)
+            std::cout << "Recognised: " << _hypWord << "\n";
+
+        writeFinalWords(stabiliser.finish(_hypWord != nullptr ? getPartialWords(_psWordDecoder) : std::vector<PartialWord>()));
+    };
+
+    printTranscriptionHeader(_outputFileName, _parameters->outputFormat);
+
+    bool isInUtterance = false;
+    const Clock::time_point startedAt = Clock::now();
+
+    _rvWord = ps_start_utt(_psWordDecoder);
+
+    for (long int sample = 0; sample < numberOfSamples; sample += chunkSize) {
+        const long int samplesRead = _audio->read(sample, chunkSize, chunk.data());
+
+        //the chunk arrives once its last sample is captured; at speed 0 the audio is fed as fast as it is decoded
+        if (_parameters->liveSpeed > 0) {
+            const std::chrono::duration<double> arrival((double) (sample + samplesRead) / audioSampleRate / _parameters->liveSpeed);
+            arrivedAt.push_back(startedAt + std::chrono::duration_cast<Clock::duration>(arrival));
+            std::this_thread::sleep_until(arrivedAt.back());
+        }
+        else {
+            arrivedAt.push_back(Clock::now());
+        }
+
+        ps_process_raw(_psWordDecoder, chunk.data(), samplesRead, FALSE, FALSE);
+
+        const bool isInSpeech = ps_get_in_speech(_psWordDecoder);
+
+        if (isInSpeech && !isInUtterance)
+            isInUtterance = true;
+
+        if (!isInSpeech && isInUtterance) {
+            ps_end_utt(_psWordDecoder);
+            finishUtterance();
+            ps_start_utt(_psWordDecoder);
+            isInUtterance = false;
+            continue;
+        }
+
+        if (!isInUtterance)
+            continue;
+
+        std::vector<PartialWord> shownWords;
+        std::vector<PartialWord> finalWords = stabiliser.update(getPartialWords(_psWordDecoder), ps_get_n_frames(_psWordDecoder), shownWords);
+
+        writePartialOutput("provisional", shownWords);
+
+        bool isChanged = false;
+
+        for (const PartialWord& word : shownWords) {
+            if (!isFiller(word)) {
+                provisionalLatency.add(latency(word));
+                isChanged = true;
+            }
+        }
+
+        const char *partialHyp = ps_get_hyp(_psWordDecoder, nullptr);
+
+        if (isChanged && partialHyp != nullptr && _parameters->displayRecognised)
+            std::cout << "Partial: " << partialHyp << "\n";
+
+        writeFinalWords(finalWords);
+    }
+
+    _rvWord = ps_end_utt(_psWordDecoder);
+
+    if (isInUtterance)
+        finishUtterance();
+
+    printTranscriptionFooter(_outputFileName, _parameters->outputFormat);
+
+    INFO << "Latency from the arrival of the last sample of a word to its output :";
+    provisionalLatency.print("Provisional words");
+    finalLatency.print("Final words");
+
+    INFO << "Finished transcription.";
+
+    return true;
+}
+
+bool PocketsphinxAligner::alignWithAnchors() {
+    /*
+     * Instead of transcribing the whole audio, rare words of the transcript are spotted in a single
+     * keyword search pass. They split the transcript and the audio into short segments, which are
+     * force aligned independently of each other, in parallel.
+     */
+
+    INFO << "Aligning transcript using keyword anchors..";
+
+    std::vector<std::string> transcriptWords = getTranscriptWords(getFileData(_transcriptFileName));
+    std::vector<std::string> words;
+    std::vector<char> isKnown;
+
+    for (const std::string& transcriptWord : transcriptWords) {
+        std::string word = normaliseWord(transcriptWord);
+        char *pronunciation = word.empty() ? nullptr : ps_lookup_word(_psWordDecoder, word.c_str());
+
+        words.push_back(word);
+        isKnown.push_back(pronunciation != nullptr);
+        ckd_free(pronunciation);
+    }
+
+    const auto spottingStartedAt = std::chrono::steady_clock::now();
+
+    std::vector<int> anchorWords = selectAnchorWords(words, isKnown, _parameters->anchorSpacing);
+    std::vector<Anchor> detections = spotAnchors(words, anchorWords);
+    std::vector<Anchor> anchors = orderAnchors(detections);
+
+    const std::chrono::duration<double> spottingTook = std::chrono::steady_clock::now() - spottingStartedAt;
+    INFO << "Spotted " << detections.size() << " of " << anchorWords.size() << " anchor words, kept " << anchors.size()
+         << " in transcript order in " << spottingTook.count() << " s";
+
+    std::vector<AnchorSegment> segments = splitAtAnchors(anchors, words.size(), _audio->getNumberOfSamples() / 16);
+
+    const auto aligningStartedAt = std::chrono::steady_clock::now();
+    alignAnchorSegments(words, isKnown, segments);
+    const std::chrono::duration<double> aligningTook = std::chrono::steady_clock::now() - aligningStartedAt;
+
+    long int alignedSegments = std::count_if(segments.begin(), segments.end(), [](const AnchorSegment& segment) {
+        return segment.isAligned;
+    });
+
+    INFO << "Aligned " << alignedSegments << " of " << segments.size() << " segments in " << aligningTook.count() << " s";
+
+    if (alignedSegments < (long int) segments.size())
+        WARNING << "Words of segments which could not be aligned are spread over the segment";
+
+    for (const AnchorSegment& segment : segments) {
+        for (int i = segment.firstWord; i < segment.lastWord; i++) {
+            long int startTime = segment.wordStartTimes[i - segment.firstWord];
+
+            //segments overlap by the slack around them, the word ending a segment must not run into the next one
+            if (!_alignedData._wordEndTimes.empty() && _alignedData._wordEndTimes.back() > startTime)
+                _alignedData._wordEndTimes.back() = std::max(_alignedData._wordStartTimes.back(), startTime);
+
+            _alignedData.addNewWord(transcriptWords[i], startTime, segment.wordEndTimes[i - segment.firstWord], segment.isAligned ? 1 : 0);
+        }
+    }
+
+    printTranscriptionHeader(_outputFileName, _parameters->outputFormat);
+
+    if (_parameters->outputFormat == xml)
+        printTranscriptionAsXMLContinuous(_outputFileName, &_alignedData, 0);
+
+    else if (_parameters->outputFormat == json)
+        printTranscriptionAsJSONContinuous(_outputFileName, &_alignedData, 0);
+
+    else if (_parameters->outputFormat == srt)
+        printTranscriptionAsSRTContinuous(_outputFileName, &_alignedData, 0);
+
+    printTranscriptionFooter(_outputFileName, _parameters->outputFormat);
+
+    INFO << "Finished alignment.";
+
+    return true;
+}
+
+std::vector<Anchor> PocketsphinxAligner::spotAnchors(const std::vector<std::string>& words, const std::vector<int>& anchorWords) {
+    std::vector<Anchor> detections;
+
+    if (anchorWords.empty())
+        return detections;
+
+    const std::string keywordFileName("tempFiles/anchors.kws");
+    std::ofstream keywordFile(keywordFileName, std::ios::binary);
+
+    if (!keywordFile.is_open())
+        FATAL(UnknownError) << "Unable to create keyword file " << keywordFileName;
+
+    std::unordered_map<std::string, int> anchorIndex;
+
+    for (int wordIndex : anchorWords) {
+        keywordFile << words[wordIndex] << " /" << anchorThreshold << "/\n";
+        anchorIndex[words[wordIndex]] = wordIndex;
+    }
+
+    keywordFile.close();
+
+    const std::string lmSearch(ps_get_search(_psWordDecoder));
+
+    if (ps_set_kws(_psWordDecoder, "anchors", keywordFileName.c_str()) < 0 || ps_set_search(_psWordDecoder, "anchors") < 0)
+        FATAL(UnknownError) << "Failed to create keyword search, see log for details";
+
+    //the whole audio is searched as a single utterance, detections are kept till it ends
+    std::vector<int16_t> block(audioBlockSize);
+
+    ps_start_stream(_psWordDecoder);
+    _rvWord = ps_start_utt(_psWordDecoder);
+
+    for (long int blockStart = 0; blockStart < _audio->getNumberOfSamples(); blockStart += audioBlockSize)
+        _rvWord = ps_process_raw(_psWordDecoder, block.data(), _audio->read(blockStart, audioBlockSize, block.data()), FALSE, FALSE);
+
+    _rvWord = ps_end_utt(_psWordDecoder);
+
+    int frame_rate = cmd_ln_int32_r(_configWord, "-frate");
+
+    for (ps_seg_t *iter = ps_seg_iter(_psWordDecoder); iter != nullptr; iter = ps_seg_next(iter)) {
+        int32 sf, ef;
+        ps_seg_frames(iter, &sf, &ef);
+
+        //keyphrases keep the whitespace before their threshold
+        std::string keyphrase(ps_seg_word(iter));
+        keyphrase.erase(keyphrase.find_last_not_of(' ') + 1);
+
+        auto anchor = anchorIndex.find(keyphrase);
+
+        if (anchor != anchorIndex.end())
+            detections.emplace_back(anchor->second, sf * 1000 / frame_rate, ef * 1000 / frame_rate);
+    }
+
+    ps_set_search(_psWordDecoder, lmSearch.c_str());
+
+    return detections;
+}
+
+void PocketsphinxAligner::alignAnchorSegments(const std::vector<std::string>& words, const std::vector<char>& isKnown, std::vector<AnchorSegment>& segments) {
+    if (segments.empty())
+        return;
+
+    const size_t threadCount = getThreadCount(segments.size());
+
+    //a decoder per thread
+    cmd_ln_t *config = cmd_ln_init(nullptr,
+        ps_args(), TRUE,
+        "-hmm", _modelPath.c_str(),
+        "-dict", _dictPath.c_str(),
+        "-logfn", _logPath.c_str(),
+        nullptr);
+
+    if (config == nullptr) {
+        FATAL(UnknownError) << "Failed to create config object, see log for details";
+    }
+
+    std::vector<ps_decoder_t *> decoders;
+
+    for (size_t i = 0; i < threadCount; i++) {
+        ps_decoder_t *ps = ps_init(config);
+
+        if (ps == nullptr) {
+            FATAL(UnknownError) << "Failed to create recognizer, see log for details";
+        }
+
+        if (!_cmnPrior.mean.empty())
+            _cmnPrior.apply(ps);
+
+        decoders.push_back(ps);
+    }
+
+    INFO << "Aligning " << segments.size() << " segments using " << threadCount << " threads..";
+
+    parallelFor(segments.size(), threadCount, [&](size_t worker, size_t segment) {
+        alignAnchorSegment(decoders[worker], words, isKnown, segments[segment]);
+    });
+
+    for (ps_decoder_t *ps : decoders)
+        ps_free(ps);
+
+    cmd_ln_free_r(config);
+}
+
+bool PocketsphinxAligner::alignAnchorSegment(ps_decoder_t *ps, const std::vector<std::string>& words, const std::vector<char>& isKnown, AnchorSegment& segment) const {
+    //approximate times are kept if the segment can't be aligned
+    segment.interpolate(words);
+
+    if (segment.endTime - segment.startTime > maximumSegmentDuration)
+        return false;
+
+    std::string text;
+    std::vector<int> alignedWords;  //index in the segment of every aligned word
+
+    for (int i = segment.firstWord; i < segment.lastWord; i++) {
+        if (words[i].empty())
+            continue;
+
+        if (!isKnown[i])
+            return false;
+
+        if (!text.empty())
+            text += " ";
+
+        text += words[i];
+        alignedWords.push_back(i - segment.firstWord);
+    }
+
+    if (text.empty() || ps_set_align(ps, "align", text.c_str()) < 0 || ps_set_search(ps, "align") < 0)
+        return false;
+
+    //anchors are spotted approximately, thus a little more audio is searched
+    long int audioStartsAt = std::max(0L, segment.startTime - anchorSlack);
+    long int audioEndsAt = std::min(_audio->getNumberOfSamples() / 16, segment.endTime + anchorSlack);
+    std::vector<int16_t> samples = _audio->read(audioStartsAt * 16, (audioEndsAt - audioStartsAt) * 16);
+
+    ps_start_stream(ps);
+    ps_start_utt(ps);
+    ps_process_raw(ps, samples.data(), samples.size(), FALSE, FALSE);
+
+    if (ps_end_utt(ps) < 0 || ps_get_hyp(ps, nullptr) == nullptr)
+        return false;
+
+    int frame_rate = cmd_ln_int32_r(ps_get_config(ps), "-frate");
+    size_t alignedWord = 0;
+
+    for (ps_seg_t *iter = ps_seg_iter(ps); iter != nullptr; iter = ps_seg_next(iter)) {
+        int32 sf, ef;
+        ps_seg_frames(iter, &sf, &ef);
+
+        std::string alignedString(ps_seg_word(iter));
+
+        if (alignedString == "<s>" || alignedString == "</s>" || alignedString == "<sil>" || alignedString[0] == '[')
+            continue;
+
+        if (alignedWord >= alignedWords.size()) {
+            ps_seg_free(iter);
+            break;
+        }
+
+        int wordIndex = alignedWords[alignedWord++];
+        segment.wordStartTimes[wordIndex] = audioStartsAt + sf * 1000 / frame_rate;
+        segment.wordEndTimes[wordIndex] = audioStartsAt + ef * 1000 / frame_rate;
+    }
+
+    //words which are only punctuation take the time where the word before them ends
+    for (int i = 0; i < segment.lastWord - segment.firstWord; i++) {
+        if (words[segment.firstWord + i].empty()) {
+            long int time = i > 0 ? segment.wordEndTimes[i - 1] : audioStartsAt;
+            segment.wordStartTimes[i] = segment.wordEndTimes[i] = time;
+        }
+    }
+
+    segment.isAligned = true;
+
+    return true;
+}
+
+bool PocketsphinxAligner::reInitDecoder(cmd_ln_t *config, ps_decoder_t *ps) {
+    ps_reinit(_psWordDecoder, _configWord);
+    return true;
+}
+
+bool PocketsphinxAligner::alignWithFSG() {
+    int subCount = 1;
+    initFile(_outputFileName, _parameters->outputFormat);
+
+    long int recognitionWindow = 0;
+
+    if (_audioWindow) {
+        recognitionWindow = _audioWindow * 16;
+    }
+
+    else if (_sampleWindow) {
+        recognitionWindow = _sampleWindow;
+    }
+
+    //the FSG of every dialogue is built in memory and set on the word decoder, instead of reading a file and
+    //initialising the decoder again for every dialogue; FSG files are only read when no grammar was generated
+    std::vector<CueGrammar> grammars = buildCueGrammars(_subtitles, false, false);
+    const std::string lmSearch(ps_get_search(_psWordDecoder));
+    const float32 lw = cmd_ln_float32_r(_configWord, "-lw");
+
+    //the decoder goes back to the language model however this returns, a FATAL in the loop throws
+    struct SearchRestorer {
+        ps_decoder_t *ps;
+        const std::string& search;
+        ~SearchRestorer() { ps_set_search(ps, search.c_str()); }
+    } restoreSearch{_psWordDecoder, lmSearch};
+
+    for (size_t cue = 0; cue < _subtitles.size(); cue++) {
+        SubtitleItem *sub = _subtitles[cue];
+
+        if (sub->getDialogue().empty())
+            continue;
+
+
+        //first assigning approx timestamps
+        CurrentSub currSub(sub);
+        currSub.run();
+
+        long int dialogueStartsAt = sub->getStartTime();
+        std::string fsgname(_fsgPath + std::to_string(dialogueStartsAt));
+        fsgname += ".fsg";
+
+        fsg_model_t *fsg;
+
+        if (_parameters->grammarType == no_grammar && std::ifstream(fsgname))
+            fsg = fsg_model_readfile(fsgname.c_str(), ps_get_logmath(_psWordDecoder), lw);
+        else
+            fsg = createFSG(grammars[cue].words, ps_get_logmath(_psWordDecoder), lw);
+
+        //replaces the FSG of the previous dialogue
+        if (fsg == nullptr || ps_set_fsg(_psWordDecoder, "cue", fsg) < 0 || ps_set_search(_psWordDecoder, "cue") < 0) {
+            WARNING << "Unable to create FSG of dialogue at " << dialogueStartsAt << ", see log for details";
+            fsg_model_free(fsg);
+            continue;
+        }
+
+        fsg_model_free(fsg);
+
+        long int samplesAlreadyRead, samplesToBeRead;
+        findRecognitionWindow(sub, recognitionWindow, samplesAlreadyRead, samplesToBeRead);
+
+        std::vector<int16_t> samples = _audio->read(samplesAlreadyRead, samplesToBeRead);
+
+        _rvWord = ps_start_utt(_psWordDecoder);
+        _rvWord = ps_process_raw(_psWordDecoder, samples.data(), samples.size(), FALSE, FALSE);
+        _rvWord = ps_end_utt(_psWordDecoder);
+
+        _hypWord = ps_get_hyp(_psWordDecoder, &_scoreWord);
+
+        if (_hypWord == nullptr) {
+            _hypWord = "nullptr";
+
+            if (_parameters->displayRecognised) {
+                std::cout << "\n\n-----------------------------------------\n\n";
+                std::cout << "Recognised: " << _hypWord << "\n";
+            }
+
+            continue;
+
+        }
+
+        if (_parameters->displayRecognised) {
+            std::cout << "\n\n-----------------------------------------\n\n";
+            std::cout << "Start time of dialogue : " << dialogueStartsAt << "\n";
+            std::cout << "End time of dialogue   : " << sub->getEndTime() << "\n\n";
+            std::cout << "Recognised  : " << _hypWord << "\n";
+            std::cout << "Actual      : " << sub->getDialogue() << "\n\n";
+        }
+
+        recognisedBlock currBlock = findAndSetWordTimes(_configWord, _psWordDecoder, sub, samplesAlreadyRead / 16);
+
+        switch (_parameters->outputFormat)  //decide on basis of set output format
+        {
+        case srt:       subCount = printSRTContinuous(_outputFileName, subCount, sub, _parameters->printOption);
+            break;
+
+        case xml:       printXMLContinuous(_outputFileName, sub);
+            break;
+
+        case json:      printJSONContinuous(_outputFileName, sub);
+            break;
+
+        case karaoke:   subCount = printKaraokeContinuous(_outputFileName, subCount, sub, _parameters->printOption);
+            break;
+
+        default:        FATAL(UnknownError) << "An error occurred while choosing output format!";
+        }
     }
 
     printFileEnd(_outputFileName, _parameters->outputFormat);
@@ -812,6 +1875,7 @@ bool PocketsphinxAligner::printAligned(const std::string& outputFileName, output
 
 PocketsphinxAligner::~PocketsphinxAligner() {
 
+    _cueLanguageModel.reset();
     ps_free(_psWordDecoder);
     cmd_ln_free_r(_configWord);
 
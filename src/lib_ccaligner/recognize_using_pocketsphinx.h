@@ -8,13 +8,24 @@
 #define CCALIGNER_RECOGNIZE_USING_POCKETSPHINX_H
 
 #include "srtparser.h"
-#include "read_wav_file.h"
+#include "audio_source.h"
 #include "pocketsphinx.h"
+#include <sphinxbase/ckd_alloc.h>
 #include "grammar_tools.h"
 #include "generate_approx_timestamp.h"
 #include "commons.h"
 #include "params.h"
 #include "output_handler.h"
+#include "voice_activity_detection.h"
+#include "offset_estimation.h"
+#include "keyword_anchors.h"
+#include "checkpoint.h"
+#include "decoder_profiles.h"
+#include "cue_language_model.h"
+#include "cmn_prior.h"
+#include "live_transcription.h"
+#include <thread>
+#include <chrono>
 
 int levenshtein_distance(const std::string& firstWord, const std::string& secondWord);
 
@@ -23,11 +34,10 @@ class PocketsphinxAligner
 private:
     std::string _audioFileName, _subtitleFileName, _transcriptFileName, _outputFileName;          //input and output filenames
 
-    std::unique_ptr<WaveFileData> _file;
+    std::unique_ptr<AudioSource> _audio;       //only the window being aligned is read from it
     SubtitleParserFactory _subParserFactory;
     SubtitleParser * _parser;
     std::vector <SubtitleItem*> _subtitles;
-    std::vector<int16_t> _samples;
 
     AlignedData _alignedData;
     Params* _parameters;
@@ -41,10 +51,43 @@ private:
     int _rvWord, _rvPhoneme;
     int32 _scoreWord, _scorePhoneme;
 
+    std::unique_ptr<CueLanguageModel> _cueLanguageModel;     //set when every cue is recognised with its own language model
+
+    std::vector<char> _speechActivity;      //of the whole audio, found once for everything that needs it
+    CmnPrior _cmnPrior;                     //set with --cmn-prior yes, applied to every decoder
+
+    Checkpoint _checkpoint;
+    bool _isResuming;
+    std::chrono::steady_clock::time_point _checkpointSavedAt;
+
     bool printWordTimes(cmd_ln_t *config, ps_decoder_t *ps);
+    int addTranscribedWords(cmd_ln_t *config, ps_decoder_t *ps, long int offset, AlignedData& transcription) const;
     int findTranscribedWordTimings(cmd_ln_t *config, ps_decoder_t *ps, int index);
-    recognisedBlock findAndSetWordTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub);
-    bool findAndSetPhonemeTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub);
+    bool transcribeInParallel();
+    bool transcribeLive();
+    void transcribeSegment(ps_decoder_t *ps, const SpeechSegment& segment, bool isLast, AlignedData& transcription, std::vector<std::string>& hypotheses) const;
+    recognisedBlock findAndSetWordTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub, long int windowStartsAt);
+    bool findAndSetPhonemeTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub, long int windowStartsAt);
+    Sentences getCueSentences(int firstCue, int lastCue) const;
+    void initCueLanguageModel();
+    void findRecognitionWindow(SubtitleItem *sub, long int recognitionWindow, long int &samplesAlreadyRead, long int &samplesToBeRead) const;
+    const std::vector<char>& findSpeechActivity();
+    void initCmnPrior();
+    OffsetMap estimateSubtitleOffsets();
+    int32 computeFeatures(const int16_t *sample, long int readLimit, mfcc_t ***features, bool &hasFinalFrame);
+    int decodeFeatures(ps_decoder_t *ps, mfcc_t **features, int32 numberOfFrames, bool hasFinalFrame);
+    int decodeWindow(long int samplesAlreadyRead, long int samplesToBeRead, bool withPhonemes);
+    std::string getAlignmentText(SubtitleItem *sub, std::vector<int> &wordIndices) const;
+    bool findAndSetAlignedTimes(cmd_ln_t *config, ps_decoder_t *ps, SubtitleItem *sub, const std::vector<int> &wordIndices, long int windowStartsAt);
+    int printAlignedCue(SubtitleItem *sub, int subCount) const;
+    std::vector<Anchor> spotAnchors(const std::vector<std::string>& words, const std::vector<int>& anchorWords);
+    void alignAnchorSegments(const std::vector<std::string>& words, const std::vector<char>& isKnown, std::vector<AnchorSegment>& segments);
+    bool alignAnchorSegment(ps_decoder_t *ps, const std::vector<std::string>& words, const std::vector<char>& isKnown, AnchorSegment& segment) const;
+    std::string describeJob() const;
+    std::vector<std::pair<std::string, std::string>> hashGrammarFiles() const;
+    int startOutput(int &subCount);
+    void saveCheckpoint(int cue, int subCount);
+    void finishOutput();
     bool reInitDecoder(cmd_ln_t *config, ps_decoder_t *ps);
     bool initPhonemeDecoder(const std::string& phoneticLmPath, const std::string& phonemeLogPath);
 
@@ -54,9 +97,11 @@ public:
     bool generateGrammar(grammarName name);
     bool recognise();
     bool alignWithFSG();
+    bool forceAlign();
     bool align();
-    bool recognisePhonemes(const int16_t *sample, int readLimit, SubtitleItem *sub);
+    bool recognisePhonemes(mfcc_t **features, int32 numberOfFrames, bool hasFinalFrame);
     bool transcribe();
+    bool alignWithAnchors();
     bool printAligned(const std::string& outputFileName, outputFormats format) const noexcept;
     ~PocketsphinxAligner();
 
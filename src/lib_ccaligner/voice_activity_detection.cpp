@@ -6,7 +6,7 @@
 
 #include "voice_activity_detection.h"
 
-void performVAD(std::vector<int16_t>& sample)
+static VadInst* createVAD(int aggressiveness)
 {
     VadInst* vad = WebRtcVad_Create();  //Creating VAD handle
     if (!vad)
@@ -20,13 +20,20 @@ void performVAD(std::vector<int16_t>& sample)
         throw std::runtime_error("Can't initialize WebRTC VAD handle.");
     }
 
-    const int aggressiveness = 2;       //Aggressiveness : 1/2/3 . Higher means higher cut-off.
+    //Aggressiveness : 1/2/3 . Higher means higher cut-off.
     error = WebRtcVad_set_mode(vad, aggressiveness);
     if (error)
     {
         throw std::runtime_error("Can't set WebRTC VAD aggressiveness.");
     }
 
+    return vad;
+}
+
+void performVAD(std::vector<int16_t>& sample)
+{
+    VadInst* vad = createVAD(2);
+
     const int16_t * temp = sample.data();   //16 bit ,16KHz, mono PCM samples
 
     for(int i=0, ms =0;i<sample.size();i+=160, ms+=10)  // currently checking in 10ms frames, most likely to change
@@ -40,3 +47,88 @@ void performVAD(std::vector<int16_t>& sample)
     WebRtcVad_Free(vad);
 
 }
+
+std::vector<char> getSpeechActivity(const std::vector<int16_t>& sample, int aggressiveness)
+{
+    VadInst* vad = createVAD(aggressiveness);
+
+    std::vector<char> speechActivity(sample.size() / vadFrameSize);
+    const int16_t * temp = sample.data();
+
+    for(size_t frame = 0; frame < speechActivity.size(); frame++)
+    {
+        //a failed frame (-1) is treated as non speech
+        speechActivity[frame] = WebRtcVad_Process(vad, 16000, temp, vadFrameSize) == 1;
+        temp += vadFrameSize;
+    }
+
+    WebRtcVad_Free(vad);
+
+    return speechActivity;
+}
+
+std::vector<char> getSpeechActivity(const AudioSource& audio, int aggressiveness)
+{
+    VadInst* vad = createVAD(aggressiveness);
+
+    std::vector<char> speechActivity(audio.getNumberOfSamples() / vadFrameSize);
+    std::vector<int16_t> block(audioBlockSize);     //a whole number of frames, the VAD keeps its state across blocks
+    const int16_t * temp = block.data() + audioBlockSize;
+
+    for(size_t frame = 0; frame < speechActivity.size(); frame++)
+    {
+        if(temp == block.data() + audioBlockSize)
+        {
+            audio.read(frame * vadFrameSize, audioBlockSize, block.data());
+            temp = block.data();
+        }
+
+        speechActivity[frame] = WebRtcVad_Process(vad, 16000, temp, vadFrameSize) == 1;
+        temp += vadFrameSize;
+    }
+
+    WebRtcVad_Free(vad);
+
+    return speechActivity;
+}
+
+SpeechSegment::SpeechSegment(long int start, long int end) noexcept :
+    startTime(start),
+    endTime(end)
+{
+}
+
+std::vector<SpeechSegment> splitAtSilences(const std::vector<char>& speechActivity, long int minimumSilence)
+{
+    const long int numberOfFrames = speechActivity.size();
+    const long int minimumFrames = std::max(1L, minimumSilence / 10);
+    std::vector<SpeechSegment> segments;
+    long int segmentStartsAt = 0, frame = 0;
+
+    //silences before the first speech and after the last one are left in the segments they end and start
+    while (frame < numberOfFrames && !speechActivity[frame])
+        frame++;
+
+    while (frame < numberOfFrames)
+    {
+        long int silenceStartsAt = frame;
+
+        while (frame < numberOfFrames && !speechActivity[frame])
+            frame++;
+
+        if (frame < numberOfFrames && frame - silenceStartsAt >= minimumFrames)
+        {
+            long int cut = (silenceStartsAt + frame) / 2;
+
+            segments.emplace_back(segmentStartsAt * 10, cut * 10);
+            segmentStartsAt = cut;
+        }
+
+        while (frame < numberOfFrames && speechActivity[frame])
+            frame++;
+    }
+
+    segments.emplace_back(segmentStartsAt * 10, numberOfFrames * 10);
+
+    return segments;
+}
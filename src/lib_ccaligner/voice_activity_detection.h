@@ -5,9 +5,24 @@
 #ifndef VOICE_ACTIVITY_DETECTION_H
 #define VOICE_ACTIVITY_DETECTION_H
 
-#include "read_wav_file.h"
+#include "audio_source.h"
 #include <webrtc/common_audio/vad/include/webrtc_vad.h>
 
+constexpr int vadFrameSize = 160;   //10 ms of 16KHz audio, the unit of all speech activity signals
+
 void performVAD(std::vector<int16_t>& sample);  //use webRTC's VAD to check if a window of sample has voice.
+std::vector<char> getSpeechActivity(const std::vector<int16_t>& sample, int aggressiveness = 2); //1 per 10 ms frame containing voice, 0 otherwise
+std::vector<char> getSpeechActivity(const AudioSource& audio, int aggressiveness = 2);            //same, reading the audio block by block
+
+class SpeechSegment     //audio between two long silences, in ms
+{
+public:
+    long int startTime, endTime;
+
+    SpeechSegment(long int start, long int end) noexcept;
+};
+
+//the audio cut in the middle of every silence of at least minimumSilence ms, silence at either end isn't cut off
+std::vector<SpeechSegment> splitAtSilences(const std::vector<char>& speechActivity, long int minimumSilence);
 
 #endif //VOICE_ACTIVITY_DETECTION_H
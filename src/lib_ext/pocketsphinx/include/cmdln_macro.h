@@ -174,7 +174,11 @@
 { "-fwdflatsfwin",                                                                              \
       ARG_INT32,                                                                                \
       "25",                                                                    	                \
-      "Window of frames in lattice to search for successor words in fwdflat search " }
+      "Window of frames in lattice to search for successor words in fwdflat search " },         \
+{ "-hmm_simd",                                                                                  \
+      ARG_STRING,                                                                               \
+      "auto",                                                                                   \
+      "Instruction set for HMM evaluation: auto, none, sse4, avx2 or avx512" }
 
 /** Command-line options for keyphrase spotting */
 #define POCKETSPHINX_KWS_OPTIONS \
@@ -244,6 +248,10 @@
       ARG_STRING,									\
       NULL,									\
       "Which language model in -lmctl to use by default"},				\
+{ "-lm_threads",									\
+      ARG_INT32,									\
+      "0",										\
+      "Number of threads parsing the n-grams of an ARPA model, 0 for one per processor" },	\
 { "-lw",										\
       ARG_FLOAT32,									\
       "6.5",										\
@@ -374,10 +382,26 @@
       ARG_STRING,                                                               \
       "0",                                                                     \
       "Beam width used to determine top-N Gaussians (or a list, per-feature)" },\
+{ "-gmm_simd",                                                                  \
+      ARG_STRING,                                                               \
+      "auto",                                                                   \
+      "Instruction set for Gaussian evaluation: auto, none, sse4, avx2 or avx512" },\
+{ "-score_threads",                                                             \
+      ARG_INT32,                                                                \
+      "1",                                                                      \
+      "Number of threads sharing the Gaussian evaluation of each frame" },      \
+{ "-frame_block",                                                               \
+      ARG_INT32,                                                                \
+      "1",                                                                      \
+      "Number of frames whose Gaussian densities are computed together (PTM models only)" },\
 { "-logbase",                                                                   \
       ARG_FLOAT32,                                                              \
       "1.0001",                                                                 \
-      "Base in which all log-likelihoods calculated" }
+      "Base in which all log-likelihoods calculated" },                         \
+{ "-logadd",                                                                    \
+      ARG_STRING,                                                               \
+      "table",                                                                  \
+      "Log-add table: table (one entry per difference) or compact (interpolated, fits in the L1 cache)" }
 
 #define CMDLN_EMPTY_OPTION { NULL, 0, NULL, NULL }
 
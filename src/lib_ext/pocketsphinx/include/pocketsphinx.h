@@ -397,6 +397,21 @@ int ps_get_n_frames(ps_decoder_t *ps);
 POCKETSPHINX_EXPORT
 int ps_end_utt(ps_decoder_t *ps);
 
+/**
+ * End processing of an utterance decoded with ps_process_cep().
+ *
+ * The last frame returned by fe_end_utt() is processed along with the
+ * end of the utterance, giving the same result as decoding the audio
+ * with ps_process_raw() and ending it with ps_end_utt().
+ *
+ * @param ps Decoder.
+ * @param final_cep Frame returned by fe_end_utt(), or NULL if it
+ *                  returned none.
+ * @return 0 for success, <0 on error
+ */
+POCKETSPHINX_EXPORT
+int ps_end_utt_cep(ps_decoder_t *ps, mfcc_t const *final_cep);
+
 /**
  * Get hypothesis string and path score.
  *
@@ -450,6 +465,19 @@ ps_lattice_t *ps_get_lattice(ps_decoder_t *ps);
 POCKETSPHINX_EXPORT
 ps_seg_t *ps_seg_iter(ps_decoder_t *ps);
 
+/**
+ * Get an iterator over the phones of a forced alignment.
+ *
+ * Works like ps_seg_iter(), with ps_seg_word() returning the name of
+ * the phone.
+ *
+ * @param ps Decoder.
+ * @return Iterator over the phones, or NULL if the active search is
+ *         not a forced alignment (see ps_set_align()) or has no result.
+ */
+POCKETSPHINX_EXPORT
+ps_seg_t *ps_seg_phone_iter(ps_decoder_t *ps);
+
 /**
  * Get the next segment in a word segmentation.
  *
@@ -283,6 +283,21 @@ int ps_set_keyphrase(ps_decoder_t *ps, const char *name, const char *keyphrase);
 POCKETSPHINX_EXPORT
 int ps_set_allphone(ps_decoder_t *ps, const char *name, ngram_model_t *lm);
 
+/**
+ * Adds new search which forces an alignment to a known word sequence.
+ *
+ * The words, separated by whitespace, must all be in the dictionary.
+ * They are aligned in order between the silences which start and
+ * finish the utterance. Word boundaries are returned by ps_seg_iter()
+ * and phone boundaries by ps_seg_phone_iter() once the utterance has
+ * ended. The search can be activated using ps_set_search().
+ *
+ * @return 0 on success, -1 if a word is not in the dictionary.
+ * @see ps_set_search
+ */
+POCKETSPHINX_EXPORT
+int ps_set_align(ps_decoder_t *ps, const char *name, const char *words);
+
 /**
  * Adds new search based on phone N-gram language model.
  *
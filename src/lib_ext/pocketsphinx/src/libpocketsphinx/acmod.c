@@ -288,6 +288,15 @@ acmod_init(cmd_ln_t *config, logmath_t *lmath, fe_t *fe, feat_t *fcb)
                                                      sizeof(*acmod->senone_active));
     acmod->log_zero = logmath_get_zero(acmod->lmath);
     acmod->compallsen = cmd_ln_boolean_r(config, "-compallsen");
+    acmod->frame_block = cmd_ln_int32_r(config, "-frame_block");
+    if (acmod->frame_block > 1 && acmod->mgau->vt->frame_eval_block == NULL) {
+        E_INFO("%s computation scores one frame at a time, ignoring -frame_block\n",
+               acmod->mgau->vt->name);
+        acmod->frame_block = 1;
+    }
+    if (acmod->frame_block > 1)
+        acmod->block_feat = ckd_calloc(acmod->frame_block,
+                                       sizeof(*acmod->block_feat));
     return acmod;
 
 error_out:
@@ -321,6 +330,7 @@ acmod_free(acmod_t *acmod)
     ckd_free(acmod->senone_scores);
     ckd_free(acmod->senone_active_vec);
     ckd_free(acmod->senone_active);
+    ckd_free(acmod->block_feat);
     ckd_free(acmod->rawdata);
 
     if (acmod->mdef)
@@ -432,13 +442,14 @@ acmod_start_utt(acmod_t *acmod)
     acmod->senscr_frame = -1;
     acmod->n_senone_active = 0;
     acmod->mgau->frame_idx = 0;
+    acmod->mgau->block_end = 0;
     acmod->rawdata_pos = 0;
 
     return 0;
 }
 
-int
-acmod_end_utt(acmod_t *acmod)
+static int
+acmod_finish_utt(acmod_t *acmod, mfcc_t const *final_cep, int from_fe)
 {
     int32 nfr = 0;
 
@@ -448,7 +459,13 @@ acmod_end_utt(acmod_t *acmod)
         /* Where to start writing them (circular buffer) */
         inptr = (acmod->mfc_outidx + acmod->n_mfc_frame) % acmod->n_mfc_alloc;
         /* nfr is always either zero or one. */
-        fe_end_utt(acmod->fe, acmod->mfc_buf[inptr], &nfr);
+        if (from_fe)
+            fe_end_utt(acmod->fe, acmod->mfc_buf[inptr], &nfr);
+        else if (final_cep) {
+            memcpy(acmod->mfc_buf[inptr], final_cep,
+                   fe_get_output_size(acmod->fe) * sizeof(mfcc_t));
+            nfr = 1;
+        }
         acmod->n_mfc_frame += nfr;
         
         /* Process whatever's left, and any leadout or update stats if needed. */
@@ -481,6 +498,18 @@ acmod_end_utt(acmod_t *acmod)
     return nfr;
 }
 
+int
+acmod_end_utt(acmod_t *acmod)
+{
+    return acmod_finish_utt(acmod, NULL, TRUE);
+}
+
+int
+acmod_end_utt_cep(acmod_t *acmod, mfcc_t const *final_cep)
+{
+    return acmod_finish_utt(acmod, final_cep, FALSE);
+}
+
 static int
 acmod_log_mfc(acmod_t *acmod,
               mfcc_t **cep, int n_frames)
@@ -891,6 +920,7 @@ acmod_rewind(acmod_t *acmod)
     acmod->output_frame = 0;
     acmod->senscr_frame = -1;
     acmod->mgau->frame_idx = 0;
+    acmod->mgau->block_end = 0;
 
     return 0;
 }
@@ -1084,6 +1114,24 @@ calc_feat_idx(acmod_t *acmod, int frame_idx)
     return feat_idx;
 }
 
+static void
+acmod_eval_block(acmod_t *acmod, int frame_idx)
+{
+    int n_frame, i;
+
+    /* Only the frames already in the feature buffer. */
+    n_frame = acmod->output_frame + acmod->n_feat_frame - frame_idx;
+    if (n_frame > acmod->frame_block)
+        n_frame = acmod->frame_block;
+    if (n_frame < 2)
+        return;
+
+    for (i = 0; i < n_frame; ++i)
+        acmod->block_feat[i] = acmod->feat_buf[calc_feat_idx(acmod, frame_idx + i)];
+    ps_mgau_frame_eval_block(acmod->mgau, acmod->block_feat, frame_idx, n_frame);
+    acmod->mgau->block_end = frame_idx + n_frame;
+}
+
 mfcc_t **
 acmod_get_frame(acmod_t *acmod, int *inout_frame_idx)
 {
@@ -1136,6 +1184,13 @@ acmod_score(acmod_t *acmod, int *inout_frame_idx)
         /* Build active senone list. */
         acmod_flags2list(acmod);
 
+        /* Compute the densities of the following frames along with
+         * this one, while the model parameters are in the cache. */
+        if (acmod->frame_block > 1
+            && frame_idx >= acmod->mgau->frame_idx
+            && frame_idx >= acmod->mgau->block_end)
+            acmod_eval_block(acmod, frame_idx);
+
         /* Generate scores for the next available frame */
         ps_mgau_frame_eval(acmod->mgau,
                            acmod->senone_scores,
@@ -108,11 +108,20 @@ typedef struct ps_mgaufuncs_s {
     int (*transform)(ps_mgau_t *mgau,
                      ps_mllr_t *mllr);
     void (*free)(ps_mgau_t *mgau);
+    /**
+     * Compute the densities of n_frame frames at once, ahead of their
+     * frame_eval(), or NULL if the model evaluates one frame at a time.
+     */
+    int (*frame_eval_block)(ps_mgau_t *mgau,
+                            mfcc_t *** feat,
+                            int32 frame,
+                            int32 n_frame);
 } ps_mgaufuncs_t;    
 
 struct ps_mgau_s {
     ps_mgaufuncs_t *vt;  /**< vtable of mgau functions. */
     int frame_idx;       /**< frame counter. */
+    int block_end;       /**< New frames before this one were computed by frame_eval_block. */
 };
 
 #define ps_mgau_base(mg) ((ps_mgau_t *)(mg))
@@ -123,6 +132,8 @@ struct ps_mgau_s {
     (*ps_mgau_base(mg)->vt->transform)(mg, mllr)
 #define ps_mgau_free(mg)                                  \
     (*ps_mgau_base(mg)->vt->free)(mg)
+#define ps_mgau_frame_eval_block(mg,feat,frame,n_frame)                 \
+    (*ps_mgau_base(mg)->vt->frame_eval_block)(mg, feat, frame, n_frame)
 
 /**
  * Acoustic model structure.
@@ -166,6 +177,8 @@ struct acmod_s {
     bitvec_t *senone_active_vec; /**< Active GMMs in current frame. */
     uint8 *senone_active;      /**< Array of deltas to active GMMs. */
     int senscr_frame;          /**< Frame index for senone_scores. */
+    int frame_block;           /**< Frames whose densities are computed together. */
+    mfcc_t ***block_feat;      /**< Features of the frames of a block. */
     int n_senone_active;       /**< Number of active GMMs. */
     int log_zero;              /**< Zero log-probability value. */
 
@@ -274,6 +287,14 @@ int acmod_start_utt(acmod_t *acmod);
  */
 int acmod_end_utt(acmod_t *acmod);
 
+/**
+ * Mark the end of an utterance which was given as cepstra.
+ *
+ * @param final_cep Last frame returned by fe_end_utt() for this
+ *                  utterance, or NULL if it returned none.
+ */
+int acmod_end_utt_cep(acmod_t *acmod, mfcc_t const *final_cep);
+
 /**
  * Rewind the current utterance, allowing it to be rescored.
  *
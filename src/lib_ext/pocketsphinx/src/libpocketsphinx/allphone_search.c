@@ -66,7 +66,7 @@ allphone_backtrace(allphone_search_t * allphs, int32 f, int32 *out_score);
 static void
 allphone_search_seg_free(ps_seg_t * seg)
 {
-    ckd_free(seg);
+    ps_seg_release(seg);
 }
 
 static void
@@ -113,7 +113,8 @@ allphone_search_seg_iter(ps_search_t * search)
     if (allphs->segments == NULL)
         return NULL;
     
-    iter = ckd_calloc(1, sizeof(phseg_iter_t));
+    iter = (phseg_iter_t *) ps_seg_alloc(ps_search_arena(search),
+                                         sizeof(phseg_iter_t));
 
     iter->base.vt = &fsg_segfuncs;
     iter->base.search = search;
@@ -398,7 +399,8 @@ phmm_exit(allphone_search_t * allphs, int32 best)
 
                 if (hmm_bestscore(&(p->hmm)) >= th) {
 
-                    h = (history_t *) ckd_calloc(1, sizeof(*h));
+                    h = (history_t *) arena_calloc(ps_search_arena(allphs),
+                                                   1, sizeof(*h));
                     h->ef = curfrm;
                     h->phmm = p;
                     h->hist = hmm_out_history(&(p->hmm));
@@ -654,8 +656,11 @@ allphone_search_free(ps_search_t * search)
         ngram_model_free(allphs->lm);
     if (allphs->ci2lmwid)
         ckd_free(allphs->ci2lmwid);
-    if (allphs->history)
+    if (allphs->history) {
+        /* The history nodes went with the arena. */
+        blkarray_list_clear(allphs->history);
         blkarray_list_free(allphs->history);
+    }
 
     ckd_free(allphs);
 }
@@ -681,8 +686,8 @@ allphone_search_start(ps_search_t * search)
     allphs->n_hmm_eval = 0;
     allphs->n_sen_eval = 0;
 
-    /* Free history nodes, if any */
-    blkarray_list_reset(allphs->history);
+    /* Forget history nodes, if any, they went with the arena */
+    blkarray_list_clear(allphs->history);
 
     /* Initialize start state of the SILENCE PHMM */
     allphs->frame = 0;
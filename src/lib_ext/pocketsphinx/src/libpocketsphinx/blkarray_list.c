@@ -113,10 +113,10 @@ blkarray_list_append(blkarray_list_t * bl, void *data)
             return -1;
         }
 
-        /* Allocate the new row */
-        assert(bl->ptr[bl->cur_row] == NULL);
-        bl->ptr[bl->cur_row] = (void **) ckd_malloc(bl->blksize *
-                                                    sizeof(void *));
+        /* Allocate the new row, unless it was kept by a clear */
+        if (bl->ptr[bl->cur_row] == NULL)
+            bl->ptr[bl->cur_row] = (void **) ckd_malloc(bl->blksize *
+                                                        sizeof(void *));
 
         bl->cur_row_free = 0;
     }
@@ -136,18 +136,18 @@ blkarray_list_reset(blkarray_list_t * bl)
 {
     int32 i, j;
 
-    /* Free all the allocated elements as well as the blocks */
+    /* Free all the allocated elements */
     for (i = 0; i < bl->cur_row; i++) {
         for (j = 0; j < bl->blksize; j++)
             ckd_free(bl->ptr[i][j]);
-
-        ckd_free(bl->ptr[i]);
-        bl->ptr[i] = NULL;
     }
     if (i == bl->cur_row) {     /* NEED THIS! (in case cur_row < 0) */
         for (j = 0; j < bl->cur_row_free; j++)
             ckd_free(bl->ptr[i][j]);
+    }
 
+    /* As well as the blocks, including any kept by a clear */
+    for (i = 0; i < bl->maxblks && bl->ptr[i]; i++) {
         ckd_free(bl->ptr[i]);
         bl->ptr[i] = NULL;
     }
@@ -157,6 +157,14 @@ blkarray_list_reset(blkarray_list_t * bl)
     bl->cur_row_free = bl->blksize;
 }
 
+void
+blkarray_list_clear(blkarray_list_t * bl)
+{
+    bl->n_valid = 0;
+    bl->cur_row = -1;
+    bl->cur_row_free = bl->blksize;
+}
+
 void *
 blkarray_list_get(blkarray_list_t *list, int32 n)
 {
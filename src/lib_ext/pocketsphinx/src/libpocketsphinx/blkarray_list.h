@@ -133,6 +133,13 @@ int32 blkarray_list_append (blkarray_list_t *, void *data);
 void blkarray_list_reset (blkarray_list_t *);
 
 
+/*
+ * Reset the list length to 0 without freeing the entries, as when they
+ * are drawn from an arena.  The blocks are kept for the next entries.
+ */
+void blkarray_list_clear (blkarray_list_t *);
+
+
 /* Gets n-th element of the array list */
 void * blkarray_list_get(blkarray_list_t *, int32 n);
 
@@ -97,13 +97,14 @@ dict_add_word(dict_t * d, char const *word, s3cipid_t const * p, int32 np)
     wordp = d->word + d->n_word;
     wordp->word = (char *) ckd_salloc(word);    /* Freed in dict_free */
 
-    /* Determine base/alt wids */
-    wword = ckd_salloc(word);
-    if ((len = dict_word2basestr(wword)) > 0) {
+    /* Determine base/alt wids, only alternates end with ')' */
+    len = strlen(word);
+    wword = (len > 0 && word[len - 1] == ')') ? ckd_salloc(word) : NULL;
+    if (wword && (len = dict_word2basestr(wword)) > 0) {
         int32 w;
 
         /* Truncated to a baseword string; find its ID */
-        if (hash_table_lookup_int32(d->ht, wword, &w) < 0) {
+        if (word_hash_lookup(d->ht, wword, &w) < 0) {
             E_ERROR("Missing base word for: %s\n", word);
             ckd_free(wword);
             ckd_free(wordp->word);
@@ -122,7 +123,7 @@ dict_add_word(dict_t * d, char const *word, s3cipid_t const * p, int32 np)
     ckd_free(wword);
 
     /* Associate word string with d->n_word in hash table */
-    if (hash_table_enter_int32(d->ht, wordp->word, d->n_word) != d->n_word) {
+    if (word_hash_enter(d->ht, wordp->word, d->n_word) != d->n_word) {
         ckd_free(wordp->word);
         wordp->word = NULL;
         return BAD_S3WID;
@@ -145,6 +146,64 @@ dict_add_word(dict_t * d, char const *word, s3cipid_t const * p, int32 np)
 }
 
 
+/*
+ * Phones of a dictionary are a few dozen strings repeated millions of
+ * times, their ids are kept by their first (up to) four characters.
+ */
+#define PHONE_CACHE_SIZE 256
+
+typedef struct phone_cache_s {
+    uint32 key[PHONE_CACHE_SIZE];
+    s3cipid_t id[PHONE_CACHE_SIZE];
+} phone_cache_t;
+
+static s3cipid_t
+dict_cached_ciphone_id(dict_t * d, phone_cache_t * cache, const char *str)
+{
+    uint32 key = 0, slot;
+    int32 i, probe;
+
+    for (i = 0; i < 4 && str[i]; i++)
+        key = (key << 8) | (unsigned char) str[i];
+    if (str[i] != '\0' || key == 0)
+        return dict_ciphone_id(d, str);
+
+    slot = (key * 2654435761U) >> 24;
+    for (probe = 0; probe < PHONE_CACHE_SIZE; probe++) {
+        if (cache->key[slot] == key)
+            return cache->id[slot];
+        if (cache->key[slot] == 0) {
+            cache->key[slot] = key;
+            cache->id[slot] = dict_ciphone_id(d, str);
+            return cache->id[slot];
+        }
+        slot = (slot + 1) % PHONE_CACHE_SIZE;
+    }
+
+    /* Full, with as many different (mostly bad) phones as slots */
+    return dict_ciphone_id(d, str);
+}
+
+/* Upper bound of the number of words in a dictionary file */
+static int32
+dict_count_lines(FILE * fp)
+{
+    char buf[65536];
+    size_t n, i;
+    int32 n_line = 0;
+    char last = '\n';
+
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        for (i = 0; i < n; i++)
+            n_line += buf[i] == '\n';
+        last = buf[n - 1];
+    }
+    if (last != '\n')
+        n_line++;
+    fseek(fp, 0L, SEEK_SET);
+    return n_line;
+}
+
 static int32
 dict_read(FILE * fp, dict_t * d)
 {
@@ -155,8 +214,10 @@ dict_read(FILE * fp, dict_t * d)
     s3wid_t w;
     int32 i, maxwd;
     size_t stralloc, phnalloc;
+    phone_cache_t *cache;
 
     maxwd = 512;
+    cache = (phone_cache_t *) ckd_calloc(1, sizeof(*cache));
     p = (s3cipid_t *) ckd_calloc(maxwd + 4, sizeof(*p));
     wptr = (char **) ckd_calloc(maxwd, sizeof(char *)); /* Freed below */
 
@@ -189,7 +250,7 @@ dict_read(FILE * fp, dict_t * d)
 
         /* Convert pronunciation string to CI-phone-ids */
         for (i = 1; i < nwd; i++) {
-            p[i - 1] = dict_ciphone_id(d, wptr[i]);
+            p[i - 1] = dict_cached_ciphone_id(d, cache, wptr[i]);
             if (NOT_S3CIPID(p[i - 1])) {
                 E_ERROR("Line %d: Phone '%s' is mising in the acoustic model; word '%s' ignored\n",
                         lineno, wptr[i], wptr[0]);
@@ -213,6 +274,7 @@ dict_read(FILE * fp, dict_t * d)
            dict_size(d), (int)stralloc / 1024, (int)phnalloc / 1024);
     ckd_free(p);
     ckd_free(wptr);
+    ckd_free(cache);
 
     return 0;
 }
@@ -253,7 +315,6 @@ dict_init(cmd_ln_t *config, bin_mdef_t * mdef)
 {
     FILE *fp, *fp2;
     int32 n;
-    lineiter_t *li;
     dict_t *d;
     s3cipid_t sil;
     char const *dictfile = NULL, *fillerfile = NULL;
@@ -275,12 +336,7 @@ dict_init(cmd_ln_t *config, bin_mdef_t * mdef)
             E_ERROR_SYSTEM("Failed to open dictionary file '%s' for reading", dictfile);
             return NULL;
         }
-        for (li = lineiter_start(fp); li; li = lineiter_next(li)) {
-            if (0 != strncmp(li->buf, "##", 2)
-                && 0 != strncmp(li->buf, ";;", 2))
-                n++;
-        }
-	fseek(fp, 0L, SEEK_SET);
+        n += dict_count_lines(fp);
     }
 
     fp2 = NULL;
@@ -290,12 +346,7 @@ dict_init(cmd_ln_t *config, bin_mdef_t * mdef)
             fclose(fp);
             return NULL;
 	}
-        for (li = lineiter_start(fp2); li; li = lineiter_next(li)) {
-	    if (0 != strncmp(li->buf, "##", 2)
-    	        && 0 != strncmp(li->buf, ";;", 2))
-                n++;
-        }
-        fseek(fp2, 0L, SEEK_SET);
+        n += dict_count_lines(fp2);
     }
 
     /*
@@ -326,7 +377,7 @@ dict_init(cmd_ln_t *config, bin_mdef_t * mdef)
     /* Create new hash table for word strings; case-insensitive word strings */
     if (config && cmd_ln_exists_r(config, "-dictcase"))
         d->nocase = cmd_ln_boolean_r(config, "-dictcase");
-    d->ht = hash_table_new(d->max_words, d->nocase);
+    d->ht = word_hash_new(d->max_words, d->nocase);
 
     /* Digest main dictionary file */
     if (fp) {
@@ -403,7 +454,7 @@ dict_wordid(dict_t *d, const char *word)
     assert(d);
     assert(word);
 
-    if (hash_table_lookup_int32(d->ht, word, &w) < 0)
+    if (word_hash_lookup(d->ht, word, &w) < 0)
         return (BAD_S3WID);
     return w;
 }
@@ -487,7 +538,7 @@ dict_free(dict_t * d)
     if (d->word)
         ckd_free((void *) d->word);
     if (d->ht)
-        hash_table_free(d->ht);
+        word_hash_free(d->ht);
     if (d->mdef)
         bin_mdef_free(d->mdef);
     ckd_free((void *) d);
@@ -44,6 +44,7 @@
 
 /* SphinxBase headers. */
 #include <sphinxbase/hash_table.h>
+#include <sphinxbase/word_hash.h>
 
 /* Local headers. */
 #include "s3types.h"
@@ -77,7 +78,7 @@ typedef struct {
     int refcnt;
     bin_mdef_t *mdef;	/**< Model definition used for phone IDs; NULL if none used */
     dictword_t *word;	/**< Array of entries in dictionary */
-    hash_table_t *ht;	/**< Hash table for mapping word strings to word ids */
+    word_hash_t *ht;	/**< Hash table for mapping word strings to word ids */
     int32 max_words;	/**< #Entries allocated in dict, including empty slots */
     int32 n_word;	/**< #Occupied entries in dict; ie, excluding empty slots */
     int32 filler_start;	/**< First filler word id (read from filler dict) */
@@ -90,23 +90,9 @@ fsg_history_init(fsg_model_t * fsg, dict_t *dict)
 void
 fsg_history_free(fsg_history_t *h)
 {
-    int32 s, lc, ns, np;
-    gnode_t *gn;
-
-    if (h->fsg) {
-        ns = fsg_model_n_state(h->fsg);
-        np = h->n_ciphone;
-
-        for (s = 0; s < ns; s++) {
-            for (lc = 0; lc < np; lc++) {
-                for (gn = h->frame_entries[s][lc]; gn; gn = gnode_next(gn)) {
-                    ckd_free(gnode_ptr(gn));
-                }
-                glist_free(h->frame_entries[s][lc]);
-            }
-        }
-    }
+    /* The entries and their lists went with the arena. */
     ckd_free_2d(h->frame_entries);
+    blkarray_list_clear(h->entries);
     blkarray_list_free(h->entries);
     ckd_free(h);
 }
@@ -117,7 +103,7 @@ fsg_history_set_fsg(fsg_history_t *h, fsg_model_t *fsg, dict_t *dict)
 {
     if (blkarray_list_n_valid(h->entries) != 0) {
         E_WARN("Switching FSG while history not empty; history cleared\n");
-        blkarray_list_reset(h->entries);
+        blkarray_list_clear(h->entries);
     }
 
     if (h->frame_entries)
@@ -143,12 +129,13 @@ fsg_history_entry_add(fsg_history_t * h,
 {
     fsg_hist_entry_t *entry, *new_entry;
     int32 s;
-    gnode_t *gn, *prev_gn;
+    gnode_t *gn, *prev_gn, *new_gn;
 
     /* Skip the optimization for the initial dummy entries; always enter them */
     if (frame < 0) {
         new_entry =
-            (fsg_hist_entry_t *) ckd_calloc(1, sizeof(fsg_hist_entry_t));
+            (fsg_hist_entry_t *) arena_calloc(h->arena, 1,
+                                          sizeof(fsg_hist_entry_t));
         new_entry->fsglink = link;
         new_entry->frame = frame;
         new_entry->score = score;
@@ -179,7 +166,8 @@ fsg_history_entry_add(fsg_history_t * h,
 
     /* Create new entry after prev_gn (if prev_gn is NULL, at head) */
     new_entry =
-        (fsg_hist_entry_t *) ckd_calloc(1, sizeof(fsg_hist_entry_t));
+        (fsg_hist_entry_t *) arena_calloc(h->arena, 1,
+                                          sizeof(fsg_hist_entry_t));
     new_entry->fsglink = link;
     new_entry->frame = frame;
     new_entry->score = score;
@@ -187,13 +175,18 @@ fsg_history_entry_add(fsg_history_t * h,
     new_entry->lc = lc;
     new_entry->rc = rc;         /* Note: rc set must be non-empty at this point */
 
+    /* Its list node is drawn from the arena as well. */
+    new_gn = (gnode_t *) arena_calloc(h->arena, 1, sizeof(gnode_t));
+    gnode_ptr(new_gn) = (void *) new_entry;
     if (!prev_gn) {
-        h->frame_entries[s][lc] = glist_add_ptr(h->frame_entries[s][lc],
-                                                (void *) new_entry);
-        prev_gn = h->frame_entries[s][lc];
+        new_gn->next = h->frame_entries[s][lc];
+        h->frame_entries[s][lc] = new_gn;
     }
-    else
-        prev_gn = glist_insert_ptr(prev_gn, (void *) new_entry);
+    else {
+        new_gn->next = prev_gn->next;
+        prev_gn->next = new_gn;
+    }
+    prev_gn = new_gn;
 
     /*
      * Update the rc set of all the remaining entries in the list.  At this
@@ -204,8 +197,7 @@ fsg_history_entry_add(fsg_history_t * h,
 
         if (FSG_PNODE_CTXT_SUB(&(entry->rc), &rc) == 0) {
             /* rc set of entry reduced to 0; can prune this entry */
-            ckd_free((void *) entry);
-            gn = gnode_free(gn, prev_gn);
+            gn = prev_gn->next = gn->next;
         }
         else {
             prev_gn = gn;
@@ -236,7 +228,6 @@ fsg_history_end_frame(fsg_history_t * h)
                 blkarray_list_append(h->entries, (void *) entry);
             }
 
-            glist_free(h->frame_entries[s][lc]);
             h->frame_entries[s][lc] = NULL;
         }
     }
@@ -253,7 +244,7 @@ fsg_history_entry_get(fsg_history_t * h, int32 id)
 void
 fsg_history_reset(fsg_history_t * h)
 {
-    blkarray_list_reset(h->entries);
+    blkarray_list_clear(h->entries);
 }
 
 
@@ -264,10 +255,12 @@ fsg_history_n_entries(fsg_history_t * h)
 }
 
 void
-fsg_history_utt_start(fsg_history_t * h)
+fsg_history_utt_start(fsg_history_t * h, arena_t *arena)
 {
     int32 s, lc, ns, np;
 
+    h->arena = arena;
+
     assert(blkarray_list_n_valid(h->entries) == 0);
     assert(h->frame_entries);
 
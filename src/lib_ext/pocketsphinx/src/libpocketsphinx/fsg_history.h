@@ -76,6 +76,7 @@
 
 
 /* SphinxBase headers. */
+#include <sphinxbase/arena.h>
 #include <sphinxbase/prim_type.h>
 #include <sphinxbase/fsg_model.h>
 
@@ -146,6 +147,8 @@ typedef struct fsg_history_s {
 				   entry is the first element of the list */
     glist_t **frame_entries;
     int n_ciphone;
+    arena_t *arena;		/* Where the entries of the utterance are
+				   drawn from */
 } fsg_history_t;
 
 
@@ -155,7 +158,11 @@ typedef struct fsg_history_s {
  */
 fsg_history_t *fsg_history_init(fsg_model_t *fsg, dict_t *dict);
 
-void fsg_history_utt_start(fsg_history_t *h);
+/*
+ * Start an utterance, whose entries are drawn from the given arena and
+ * released with it.
+ */
+void fsg_history_utt_start(fsg_history_t *h, arena_t *arena);
 
 void fsg_history_utt_end(fsg_history_t *h);
 
@@ -186,7 +193,7 @@ void fsg_history_entry_add (fsg_history_t *h,
 void fsg_history_end_frame (fsg_history_t *h);
 
 
-/* Clear the hitory table */
+/* Clear the hitory table, whose entries went with the arena */
 void fsg_history_reset (fsg_history_t *h);
 
 
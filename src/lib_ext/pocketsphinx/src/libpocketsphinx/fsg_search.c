@@ -65,6 +65,7 @@
 #include "fsg_search_internal.h"
 #include "fsg_history.h"
 #include "fsg_lextree.h"
+#include "hmm_simd.h"
 
 /* Turn this on for detailed debugging dump */
 #define __FSG_DBG__		0
@@ -193,6 +194,7 @@ fsg_search_init(const char *name,
         ps_search_free(ps_search_base(fsgs));
         return NULL;
     }
+    hmm_simd_init(fsgs->hmmctx, acmod->tmat->n_tmat, config);
 
     /* Intialize the search history object */
     fsgs->history = fsg_history_init(NULL, dict);
@@ -334,19 +336,17 @@ fsg_search_hmm_eval(fsg_search_t *fsgs)
     gnode_t *gn;
     fsg_pnode_t *pnode;
     hmm_t *hmm;
+    hmm_batch_t batch;
     int32 bestscore;
     int32 n, maxhmmpf;
 
-    bestscore = WORST_SCORE;
-
     if (!fsgs->pnode_active) {
         E_ERROR("Frame %d: No active HMM!!\n", fsgs->frame);
         return;
     }
 
+    hmm_batch_init(&batch, fsgs->hmmctx);
     for (n = 0, gn = fsgs->pnode_active; gn; gn = gnode_next(gn), n++) {
-        int32 score;
-
         pnode = (fsg_pnode_t *) gnode_ptr(gn);
         hmm = fsg_pnode_hmmptr(pnode);
         assert(hmm_frame(hmm) == fsgs->frame);
@@ -356,16 +356,9 @@ fsg_search_hmm_eval(fsg_search_t *fsgs)
                fsgs->frame);
         hmm_dump(hmm, stdout);
 #endif
-        score = hmm_vit_eval(hmm);
-#if __FSG_DBG_CHAN__
-        E_INFO("pnode(%08x) after eval @frm %5d\n",
-               (int32) pnode, fsgs->frame);
-        hmm_dump(hmm, stdout);
-#endif
-
-        if (score BETTER_THAN bestscore)
-            bestscore = score;
+        hmm_batch_add(&batch, hmm);
     }
+    bestscore = hmm_batch_finish(&batch);
 
 #if __FSG_DBG__
     E_INFO("[%5d] %6d HMM; bestscr: %11d\n", fsgs->frame, n, bestscore);
@@ -786,7 +779,7 @@ fsg_search_start(ps_search_t *search)
     assert(fsgs->pnode_active_next == NULL);
 
     fsg_history_reset(fsgs->history);
-    fsg_history_utt_start(fsgs->history);
+    fsg_history_utt_start(fsgs->history, ps_search_arena(fsgs));
     fsgs->final = FALSE;
 
     /* Dummy context structure that allows all right contexts to use this entry */
@@ -1083,9 +1076,7 @@ fsg_seg_bp2itor(ps_seg_t *seg, fsg_hist_entry_t *hist_entry)
 static void
 fsg_seg_free(ps_seg_t *seg)
 {
-    fsg_seg_t *itor = (fsg_seg_t *)seg;
-    ckd_free(itor->hist);
-    ckd_free(itor);
+    ps_seg_release(seg);
 }
 
 static ps_seg_t *
@@ -1136,7 +1127,7 @@ fsg_search_seg_iter(ps_search_t *search)
      * to get the entire backtrace in order to produce it.  On the
      * other hand, all we actually need is the bptbl IDs, and we can
      * allocate a fixed-size array of them. */
-    itor = ckd_calloc(1, sizeof(*itor));
+    itor = (fsg_seg_t *)ps_seg_alloc(ps_search_arena(search), sizeof(*itor));
     itor->base.vt = &fsg_segfuncs;
     itor->base.search = search;
     itor->base.lwf = 1.0;
@@ -1148,10 +1139,10 @@ fsg_search_seg_iter(ps_search_t *search)
         ++itor->n_hist;
     }
     if (itor->n_hist == 0) {
-        ckd_free(itor);
+        ps_seg_release((ps_seg_t *)itor);
         return NULL;
     }
-    itor->hist = ckd_calloc(itor->n_hist, sizeof(*itor->hist));
+    itor->hist = arena_calloc(itor->base.arena, itor->n_hist, sizeof(*itor->hist));
     cur = itor->n_hist - 1;
     bp = bpidx;
     while (bp > 0) {
@@ -1219,7 +1210,7 @@ new_node(ps_lattice_t *dag, fsg_model_t *fsg, int sf, int ef, int32 wid, int32 n
     }
     else {
         /* New node; link to head of list */
-        node = listelem_malloc(dag->latnode_alloc);
+        node = arena_calloc(dag->arena, 1, sizeof(*node));
         node->wid = wid;
         node->sf = sf;
         node->fef = node->lef = ef;
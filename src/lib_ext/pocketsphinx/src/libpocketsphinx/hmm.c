@@ -82,6 +82,7 @@ hmm_context_free(hmm_context_t *ctx)
     if (ctx == NULL)
         return;
     ckd_free(ctx->st_sen_scr);
+    ckd_free(ctx->batch_tp);
     ckd_free(ctx);
 }
 
@@ -806,6 +807,47 @@ hmm_vit_eval(hmm_t * hmm)
     }
 }
 
+void
+hmm_batch_init(hmm_batch_t *batch, hmm_context_t *ctx)
+{
+    batch->ctx = ctx;
+    batch->n_hmm = 0;
+    batch->bestscore = WORST_SCORE;
+}
+
+void
+hmm_batch_add(hmm_batch_t *batch, hmm_t *hmm)
+{
+    int32 score;
+
+    if (batch->ctx->batch_eval == NULL || hmm_is_mpx(hmm)) {
+        score = hmm_vit_eval(hmm);
+    }
+    else {
+        batch->hmm[batch->n_hmm++] = hmm;
+        if (batch->n_hmm < batch->ctx->batch_size)
+            return;
+        score = batch->ctx->batch_eval(batch->ctx, batch->hmm, batch->n_hmm);
+        batch->n_hmm = 0;
+    }
+    if (score BETTER_THAN batch->bestscore)
+        batch->bestscore = score;
+}
+
+int32
+hmm_batch_finish(hmm_batch_t *batch)
+{
+    int32 score;
+
+    if (batch->n_hmm > 0) {
+        score = batch->ctx->batch_eval(batch->ctx, batch->hmm, batch->n_hmm);
+        if (score BETTER_THAN batch->bestscore)
+            batch->bestscore = score;
+        batch->n_hmm = 0;
+    }
+    return batch->bestscore;
+}
+
 int32
 hmm_dump_vit_eval(hmm_t * hmm, FILE * fp)
 {
@@ -134,6 +134,18 @@ typedef int32 frame_idx_t;
  * 3-state topologies that contain a subset of the above transitions should work as well. 
  */
 
+struct hmm_s;
+struct hmm_context_s;
+
+/**
+ * Viterbi evaluation of n_hmm (at most the context's batch_size)
+ * non-multiplex HMMs at once, see hmm_simd.h.
+ *
+ * @return the best score of them all.
+ */
+typedef int32 (*hmm_batch_eval_t)(struct hmm_context_s const *ctx,
+                                  struct hmm_s * const *hmm, int32 n_hmm);
+
 /**
  * @struct hmm_context_t
  * @brief Shared information between a set of HMMs.
@@ -152,6 +164,10 @@ typedef struct hmm_context_s {
     int32 *st_sen_scr;      /**< Temporary array of senone scores (for some topologies). */
     listelem_alloc_t *mpx_ssid_alloc; /**< Allocator for senone sequence ID arrays. */
     void *udata;            /**< Whatever you feel like, gosh. */
+    hmm_batch_eval_t batch_eval; /**< Evaluation of several non-multiplex HMMs
+                                    at once, NULL to evaluate them one by one. */
+    int32 batch_size;       /**< Number of HMMs batch_eval takes at once. */
+    int32 *batch_tp;        /**< Transition scores of every matrix, as batch_eval takes them. */
 } hmm_context_t;
 
 /**
@@ -159,6 +175,12 @@ typedef struct hmm_context_s {
  */
 #define HMM_MAX_NSTATE 5
 
+/**
+ * Largest batch of HMMs evaluated at once, an AVX-512 register of
+ * scores.
+ */
+#define HMM_MAX_BATCH 16
+
 /**
  * @struct hmm_t
  * @brief An individual HMM among the HMM search space.
@@ -281,7 +303,43 @@ void hmm_enter(hmm_t *h, int32 score,
  * well.
 */
 int32 hmm_vit_eval(hmm_t *hmm);
-  
+
+/**
+ * @struct hmm_batch_t
+ * @brief HMMs waiting to be evaluated together.
+ *
+ * A search adds the HMMs active in a frame with hmm_batch_add()
+ * instead of calling hmm_vit_eval() on each, then takes the best
+ * score of them all from hmm_batch_finish().  The scores of an HMM
+ * are only up to date after the batch is finished.
+ */
+typedef struct hmm_batch_s {
+    hmm_context_t *ctx;
+    int32 n_hmm;                /**< HMMs waiting in hmm. */
+    int32 bestscore;            /**< Best score of the HMMs evaluated so far. */
+    hmm_t *hmm[HMM_MAX_BATCH];
+} hmm_batch_t;
+
+/**
+ * Start a batch of the HMMs of a context.
+ */
+void hmm_batch_init(hmm_batch_t *batch, hmm_context_t *ctx);
+
+/**
+ * Viterbi evaluation of an HMM, along with the others of the batch.
+ *
+ * Multiplex HMMs and contexts without batch_eval are evaluated at
+ * once by hmm_vit_eval().
+ */
+void hmm_batch_add(hmm_batch_t *batch, hmm_t *hmm);
+
+/**
+ * Evaluate the HMMs still waiting.
+ *
+ * @return the best score of all the HMMs of the batch.
+ */
+int32 hmm_batch_finish(hmm_batch_t *batch);
+
 
 /**
  * Like hmm_vit_eval, but dump HMM state and relevant senscr to fp first, for debugging;.
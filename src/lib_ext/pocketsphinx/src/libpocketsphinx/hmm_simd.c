@@ -0,0 +1,239 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file hmm_simd.c Vectorised Viterbi evaluation of batches of HMMs.
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+
+/* SphinxBase headers */
+#include <sphinx_config.h>
+#include <sphinxbase/ckd_alloc.h>
+#include <sphinxbase/err.h>
+
+/* Local headers */
+#include "hmm_simd.h"
+
+#ifdef MGAU_HAVE_SIMD
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+#define HMM_TARGET(isa) __attribute__((target(isa)))
+#else
+#define HMM_TARGET(isa)
+#endif
+
+#define HMM_SIMD_CONCAT(name, isa) name ## _ ## isa
+#define HMM_SIMD_EXPAND(name, isa) HMM_SIMD_CONCAT(name, isa)
+#define HMM_SIMD_NAME(name) HMM_SIMD_EXPAND(name, HMM_SIMD_ISA)
+
+/* Transitions of the left-to-right topologies, in the order the
+ * kernels copy them, and where they are in the transition matrices
+ * of 5 and 3-state HMMs. */
+enum { T00, T01, T02, T11, T12, T13, T22, T23, T24, T33, T34, T35, T44, T45,
+       N_TP_5ST, N_TP_3ST = T24 };
+static const uint8 tp_5st[N_TP_5ST] = { 0, 1, 2, 7, 8, 9, 14, 15, 16, 21, 22, 23, 28, 29 };
+static const uint8 tp_3st[N_TP_3ST] = { 0, 1, 2, 5, 6, 7, 10, 11 };
+#define HMM_SIMD_TP_ROW 16
+
+/* The kernels move score[], history[], out_score and out_history of
+ * an HMM, which follow each other, as three rows of four, and the
+ * transition scores of its matrix in ctx->batch_tp as four more. */
+#define HMM_STATES(h) ((int32 *)((char *)(h) + offsetof(hmm_t, score)))
+typedef char hmm_simd_states_follow[offsetof(hmm_t, out_history)
+                                    == offsetof(hmm_t, score) + 11 * sizeof(int32) ? 1 : -1];
+#define ROW(p) _mm_loadu_si128((__m128i const *)(p))
+
+/* Senone score of a state of the HMM in a lane, built into a vector
+ * in registers by VSET_LANES(). */
+#define SENSCR(l, st) (-ctx->senscore[lane[l]->senid[st]])
+
+/* SSE4.1, four HMMs at a time. */
+#define HMM_SIMD_ISA sse4
+#define HMM_SIMD_TARGET HMM_TARGET("sse4.1")
+#define VEC __m128i
+#define VMASK __m128i
+#define VW 4
+#define VSTORE(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define VSET1(x) _mm_set1_epi32(x)
+#define VADD(a, b) _mm_add_epi32(a, b)
+#define VMAX(a, b) _mm_max_epi32(a, b)
+#define VGT(a, b) _mm_cmpgt_epi32(a, b)
+#define VSEL(m, a, b) _mm_blendv_epi8(b, a, m)
+#define VUNPACKLO32(a, b) _mm_unpacklo_epi32(a, b)
+#define VUNPACKHI32(a, b) _mm_unpackhi_epi32(a, b)
+#define VUNPACKLO64(a, b) _mm_unpacklo_epi64(a, b)
+#define VUNPACKHI64(a, b) _mm_unpackhi_epi64(a, b)
+#define VLOAD_ROW(p, r, off) ROW(p[r] + (off))
+#define VSET_LANES(f, a) _mm_setr_epi32(f(0, a), f(1, a), f(2, a), f(3, a))
+
+#include "hmm_simd_kernels.h"
+
+#undef HMM_SIMD_ISA
+#undef HMM_SIMD_TARGET
+#undef VEC
+#undef VMASK
+#undef VW
+#undef VSTORE
+#undef VSET1
+#undef VADD
+#undef VMAX
+#undef VGT
+#undef VSEL
+#undef VUNPACKLO32
+#undef VUNPACKHI32
+#undef VUNPACKLO64
+#undef VUNPACKHI64
+#undef VLOAD_ROW
+#undef VSET_LANES
+
+/* AVX2, eight at a time. */
+#define HMM_SIMD_ISA avx2
+#define HMM_SIMD_TARGET HMM_TARGET("avx2")
+#define VEC __m256i
+#define VMASK __m256i
+#define VW 8
+#define VSTORE(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define VSET1(x) _mm256_set1_epi32(x)
+#define VADD(a, b) _mm256_add_epi32(a, b)
+#define VMAX(a, b) _mm256_max_epi32(a, b)
+#define VGT(a, b) _mm256_cmpgt_epi32(a, b)
+#define VSEL(m, a, b) _mm256_blendv_epi8(b, a, m)
+#define VUNPACKLO32(a, b) _mm256_unpacklo_epi32(a, b)
+#define VUNPACKHI32(a, b) _mm256_unpackhi_epi32(a, b)
+#define VUNPACKLO64(a, b) _mm256_unpacklo_epi64(a, b)
+#define VUNPACKHI64(a, b) _mm256_unpackhi_epi64(a, b)
+#define VLOAD_ROW(p, r, off) \
+    _mm256_inserti128_si256(_mm256_castsi128_si256(ROW(p[r] + (off))), ROW(p[(r) + 4] + (off)), 1)
+#define VSET_LANES(f, a) _mm256_setr_epi32(f(0, a), f(1, a), f(2, a), f(3, a), \
+                                           f(4, a), f(5, a), f(6, a), f(7, a))
+
+#include "hmm_simd_kernels.h"
+
+#undef HMM_SIMD_ISA
+#undef HMM_SIMD_TARGET
+#undef VEC
+#undef VMASK
+#undef VW
+#undef VSTORE
+#undef VSET1
+#undef VADD
+#undef VMAX
+#undef VGT
+#undef VSEL
+#undef VUNPACKLO32
+#undef VUNPACKHI32
+#undef VUNPACKLO64
+#undef VUNPACKHI64
+#undef VLOAD_ROW
+#undef VSET_LANES
+
+/* AVX-512, sixteen at a time, comparisons give bit masks. */
+#define HMM_SIMD_ISA avx512
+#define HMM_SIMD_TARGET HMM_TARGET("avx512f")
+#define VEC __m512i
+#define VMASK __mmask16
+#define VW 16
+#define VSTORE(p, v) _mm512_storeu_si512((void *)(p), v)
+#define VSET1(x) _mm512_set1_epi32(x)
+#define VADD(a, b) _mm512_add_epi32(a, b)
+#define VMAX(a, b) _mm512_max_epi32(a, b)
+#define VGT(a, b) _mm512_cmpgt_epi32_mask(a, b)
+#define VSEL(m, a, b) _mm512_mask_blend_epi32(m, b, a)
+#define VUNPACKLO32(a, b) _mm512_unpacklo_epi32(a, b)
+#define VUNPACKHI32(a, b) _mm512_unpackhi_epi32(a, b)
+#define VUNPACKLO64(a, b) _mm512_unpacklo_epi64(a, b)
+#define VUNPACKHI64(a, b) _mm512_unpackhi_epi64(a, b)
+#define VLOAD_ROW(p, r, off) \
+    _mm512_inserti32x4(_mm512_inserti32x4(_mm512_inserti32x4( \
+        _mm512_castsi128_si512(ROW(p[r] + (off))), ROW(p[(r) + 4] + (off)), 1), \
+        ROW(p[(r) + 8] + (off)), 2), ROW(p[(r) + 12] + (off)), 3)
+#define VSET_LANES(f, a) _mm512_setr_epi32(f(0, a), f(1, a), f(2, a), f(3, a), \
+                                           f(4, a), f(5, a), f(6, a), f(7, a), \
+                                           f(8, a), f(9, a), f(10, a), f(11, a), \
+                                           f(12, a), f(13, a), f(14, a), f(15, a))
+
+#include "hmm_simd_kernels.h"
+
+#endif /* MGAU_HAVE_SIMD */
+
+mgau_simd_t
+hmm_simd_init(hmm_context_t *ctx, int32 n_tmat, cmd_ln_t *config)
+{
+    mgau_simd_t simd = MGAU_SIMD_NONE;
+
+    ctx->batch_eval = NULL;
+    ctx->batch_size = 1;
+    if (ctx->n_emit_state == 3 || ctx->n_emit_state == 5)
+        simd = mgau_simd_choose(config, "-hmm_simd");
+#ifdef MGAU_HAVE_SIMD
+    if (simd != MGAU_SIMD_NONE) {
+        uint8 const *tp_idx = ctx->n_emit_state == 5 ? tp_5st : tp_3st;
+        int32 n_tp = ctx->n_emit_state == 5 ? N_TP_5ST : N_TP_3ST;
+        int32 i, j;
+
+        ckd_free(ctx->batch_tp);
+        ctx->batch_tp = ckd_calloc(n_tmat * HMM_SIMD_TP_ROW, sizeof(*ctx->batch_tp));
+        for (i = 0; i < n_tmat; ++i)
+            for (j = 0; j < n_tp; ++j)
+                ctx->batch_tp[i * HMM_SIMD_TP_ROW + j] = -ctx->tp[i][0][tp_idx[j]];
+    }
+    switch (simd) {
+    case MGAU_SIMD_AVX512:
+        ctx->batch_eval = ctx->n_emit_state == 5 ? eval_5st_avx512 : eval_3st_avx512;
+        ctx->batch_size = 16;
+        break;
+    case MGAU_SIMD_AVX2:
+        ctx->batch_eval = ctx->n_emit_state == 5 ? eval_5st_avx2 : eval_3st_avx2;
+        ctx->batch_size = 8;
+        break;
+    case MGAU_SIMD_SSE4:
+        ctx->batch_eval = ctx->n_emit_state == 5 ? eval_5st_sse4 : eval_3st_sse4;
+        ctx->batch_size = 4;
+        break;
+    default:
+        break;
+    }
+#endif
+    return simd;
+}
@@ -0,0 +1,71 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file hmm_simd.h Vectorised Viterbi evaluation of batches of HMMs.
+ *
+ * The non-multiplex 3 and 5-state left-to-right HMMs of a batch
+ * (hmm_batch_t) are evaluated one per lane of a vector register: their
+ * scores and histories, which follow each other in hmm_t, are loaded
+ * four at a time and transposed into one register per state, as are
+ * the transition scores of a copy of the matrices, then evaluated with
+ * the same additions and comparisons as hmm_vit_eval() but without a
+ * branch, and transposed back.  Scores and histories are the same as
+ * those of hmm_vit_eval().
+ */
+
+#ifndef __HMM_SIMD_H__
+#define __HMM_SIMD_H__
+
+/* SphinxBase headers. */
+#include <sphinxbase/cmd_ln.h>
+
+/* Local headers. */
+#include "hmm.h"
+#include "mgau_simd.h"
+
+/**
+ * Choose the instruction set from -hmm_simd (auto, none, sse4, avx2
+ * or avx512), falling back to the best one below it the CPU
+ * supports, and set the batch evaluation of the context, with a copy
+ * of its n_tmat transition matrices.  Contexts of other topologies
+ * keep evaluating one HMM at a time.
+ *
+ * @return the instruction set chosen.
+ */
+mgau_simd_t hmm_simd_init(hmm_context_t *ctx, int32 n_tmat, cmd_ln_t *config);
+
+#endif /* __HMM_SIMD_H__ */
@@ -0,0 +1,258 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file hmm_simd_kernels.h Kernels of hmm_simd.c.
+ *
+ * Written once in terms of the vector macros hmm_simd.c defines and
+ * included once for each instruction set: VEC holds VW scores, VMASK
+ * the result of a comparison, HMM_SIMD_NAME() names the functions and
+ * HMM_SIMD_TARGET lets the compiler use the instructions in them.
+ *
+ * As in hmm_vit_eval(), every new score comes from the scores and
+ * histories of the previous frame, a state is only entered when the
+ * one two before it is active, and ties go to the self-transition,
+ * then to the nearest state.
+ */
+
+/* Best of three transitions into a state and the history it brings. */
+HMM_SIMD_TARGET static inline VEC
+HMM_SIMD_NAME(best3)(VEC t0, VEC t1, VEC t2, VEC h0, VEC h1, VEC h2, VEC *h)
+{
+    VMASK c = VGT(t0, t1);
+    VEC t = VSEL(c, t0, t1);
+
+    *h = VSEL(c, h0, h1);
+    c = VGT(t2, t);
+    *h = VSEL(c, h2, *h);
+    return VSEL(c, t2, t);
+}
+
+/* 4x4 transposes within each 128 bits, rows of four fields of four
+ * HMMs into four fields of the HMMs in lanes, and back. */
+HMM_SIMD_TARGET static inline void
+HMM_SIMD_NAME(transpose)(VEC const *in, VEC *out)
+{
+    VEC t0 = VUNPACKLO32(in[0], in[1]);
+    VEC t1 = VUNPACKLO32(in[2], in[3]);
+    VEC t2 = VUNPACKHI32(in[0], in[1]);
+    VEC t3 = VUNPACKHI32(in[2], in[3]);
+
+    out[0] = VUNPACKLO64(t0, t1);
+    out[1] = VUNPACKHI64(t0, t1);
+    out[2] = VUNPACKLO64(t2, t3);
+    out[3] = VUNPACKHI64(t2, t3);
+}
+
+/* The scores and histories of the HMMs into lanes, state[] in the
+ * order of HMM_STATES(), the first HMM again in the lanes past
+ * n_hmm, along with their transition scores. */
+HMM_SIMD_TARGET static inline void
+HMM_SIMD_NAME(gather)(hmm_context_t const *ctx, hmm_t * const *hmm, int32 n_hmm,
+                      int32 n_state, hmm_t **lane, VEC *state, VEC *tp)
+{
+    int32 const *states[VW], *tmat[VW];
+    VEC row[4];
+    int32 i, l, q;
+
+    for (l = 0; l < VW; ++l) {
+        hmm_t *h = lane[l] = hmm[l < n_hmm ? l : 0];
+
+        states[l] = HMM_STATES(h);
+        tmat[l] = ctx->batch_tp + h->tmatid * HMM_SIMD_TP_ROW;
+    }
+    for (q = 0; q < 3; ++q) {
+        for (i = 0; i < 4; ++i)
+            row[i] = VLOAD_ROW(states, i, 4 * q);
+        HMM_SIMD_NAME(transpose)(row, state + 4 * q);
+    }
+    for (q = 0; q < (n_state == 5 ? N_TP_5ST : N_TP_3ST); q += 4) {
+        for (i = 0; i < 4; ++i)
+            row[i] = VLOAD_ROW(tmat, i, q);
+        HMM_SIMD_NAME(transpose)(row, tp + q);
+    }
+}
+
+/* The lanes back into the first n_hmm HMMs, returning their best
+ * score. */
+HMM_SIMD_TARGET static inline int32
+HMM_SIMD_NAME(scatter)(hmm_t * const *lane, int32 n_hmm, VEC const *state, VEC best)
+{
+    VEC row[4];
+    int32 buf[VW];
+    int32 i, l, q, bestscore = WORST_SCORE;
+
+    for (q = 0; q < 3; ++q) {
+        HMM_SIMD_NAME(transpose)(state + 4 * q, row);
+        for (i = 0; i < 4; ++i) {
+            VSTORE(buf, row[i]);
+            for (l = i; l < n_hmm; l += 4)
+                memcpy(HMM_STATES(lane[l]) + 4 * q, buf + l - i, 4 * sizeof(int32));
+        }
+    }
+    VSTORE(buf, best);
+    for (l = 0; l < n_hmm; ++l) {
+        lane[l]->bestscore = buf[l];
+        if (buf[l] BETTER_THAN bestscore)
+            bestscore = buf[l];
+    }
+    return bestscore;
+}
+
+HMM_SIMD_TARGET static int32
+HMM_SIMD_NAME(eval_5st)(hmm_context_t const *ctx, hmm_t * const *hmm, int32 n_hmm)
+{
+    hmm_t *lane[VW];
+    VEC state[12], tp[HMM_SIMD_TP_ROW];
+    VEC worst = VSET1(WORST_SCORE);
+    VEC s0, s1, s2, s3, s4, h0, h1, h2, h3, h4, t0, t1, v, h, bestv;
+    VMASK g, c;
+
+    HMM_SIMD_NAME(gather)(ctx, hmm, n_hmm, 5, lane, state, tp);
+    s0 = VADD(state[0], VSET_LANES(SENSCR, 0));
+    s1 = VADD(state[1], VSET_LANES(SENSCR, 1));
+    s2 = VADD(state[2], VSET_LANES(SENSCR, 2));
+    s3 = VADD(state[3], VSET_LANES(SENSCR, 3));
+    s4 = VADD(state[4], VSET_LANES(SENSCR, 4));
+    h0 = state[5];
+    h1 = state[6];
+    h2 = state[7];
+    h3 = state[8];
+    h4 = state[9];
+
+    /* Exit state, if state 3 is active. */
+    g = VGT(s3, worst);
+    t0 = VADD(s4, tp[T45]);
+    t1 = VADD(s3, tp[T35]);
+    c = VGT(t0, t1);
+    v = VMAX(VSEL(c, t0, t1), worst);
+    state[10] = VSEL(g, v, state[10]);
+    state[11] = VSEL(g, VSEL(c, h4, h3), state[11]);
+    bestv = VSEL(g, v, worst);
+
+    /* State 4, if state 2 is active. */
+    g = VGT(s2, worst);
+    v = HMM_SIMD_NAME(best3)(VADD(s4, tp[T44]), VADD(s3, tp[T34]),
+                             VADD(s2, tp[T24]), h4, h3, h2, &h);
+    v = VMAX(v, worst);
+    state[4] = VSEL(g, v, state[4]);
+    state[9] = VSEL(g, h, h4);
+    bestv = VSEL(g, VMAX(bestv, v), bestv);
+
+    /* State 3, if state 1 is active. */
+    g = VGT(s1, worst);
+    v = HMM_SIMD_NAME(best3)(VADD(s3, tp[T33]), VADD(s2, tp[T23]),
+                             VADD(s1, tp[T13]), h3, h2, h1, &h);
+    v = VMAX(v, worst);
+    state[3] = VSEL(g, v, state[3]);
+    state[8] = VSEL(g, h, h3);
+    bestv = VSEL(g, VMAX(bestv, v), bestv);
+
+    /* States 2, 1 and 0 are always active. */
+    v = HMM_SIMD_NAME(best3)(VADD(s2, tp[T22]), VADD(s1, tp[T12]),
+                             VADD(s0, tp[T02]), h2, h1, h0, &h);
+    v = VMAX(v, worst);
+    state[2] = v;
+    state[7] = h;
+    bestv = VMAX(bestv, v);
+
+    t0 = VADD(s1, tp[T11]);
+    t1 = VADD(s0, tp[T01]);
+    c = VGT(t0, t1);
+    v = VMAX(VSEL(c, t0, t1), worst);
+    state[1] = v;
+    state[6] = VSEL(c, h1, h0);
+    bestv = VMAX(bestv, v);
+
+    v = VMAX(VADD(s0, tp[T00]), worst);
+    state[0] = v;
+
+    return HMM_SIMD_NAME(scatter)(lane, n_hmm, state, VMAX(bestv, v));
+}
+
+HMM_SIMD_TARGET static int32
+HMM_SIMD_NAME(eval_3st)(hmm_context_t const *ctx, hmm_t * const *hmm, int32 n_hmm)
+{
+    hmm_t *lane[VW];
+    VEC state[12], tp[HMM_SIMD_TP_ROW];
+    VEC worst = VSET1(WORST_SCORE), tmat_worst = VSET1(TMAT_WORST_SCORE);
+    VEC unused = VSET1(INT_MIN);
+    VEC s0, s1, s2, h0, h1, h2, t0, t1, t2, v, h, bestv;
+    VMASK g, c;
+
+    HMM_SIMD_NAME(gather)(ctx, hmm, n_hmm, 3, lane, state, tp);
+    s0 = VADD(state[0], VSET_LANES(SENSCR, 0));
+    s1 = VADD(state[1], VSET_LANES(SENSCR, 1));
+    s2 = VADD(state[2], VSET_LANES(SENSCR, 2));
+    h0 = state[5];
+    h1 = state[6];
+    h2 = state[7];
+
+    /* Exit state, if state 1 is active.  Skipping state 2 is only
+     * allowed if its transition has a score, and that transition
+     * carries over into state 2 as it does in hmm_vit_eval(). */
+    g = VGT(s1, worst);
+    t1 = VADD(s2, tp[T23]);
+    t2 = VSEL(VGT(tp[T13], tmat_worst), VADD(s1, tp[T13]), unused);
+    c = VGT(t1, t2);
+    v = VMAX(VSEL(c, t1, t2), worst);
+    state[10] = VSEL(g, v, state[10]);
+    state[11] = VSEL(g, VSEL(c, h2, h1), state[11]);
+    bestv = VSEL(g, v, worst);
+    t2 = VSEL(g, t2, unused);
+
+    /* States 2, 1 and 0 are always active. */
+    t2 = VSEL(VGT(tp[T02], tmat_worst), VADD(s0, tp[T02]), t2);
+    v = HMM_SIMD_NAME(best3)(VADD(s2, tp[T22]), VADD(s1, tp[T12]),
+                             t2, h2, h1, h0, &h);
+    v = VMAX(v, worst);
+    state[2] = v;
+    state[7] = h;
+    bestv = VMAX(bestv, v);
+
+    t0 = VADD(s1, tp[T11]);
+    t1 = VADD(s0, tp[T01]);
+    c = VGT(t0, t1);
+    v = VMAX(VSEL(c, t0, t1), worst);
+    state[1] = v;
+    state[6] = VSEL(c, h1, h0);
+    bestv = VMAX(bestv, v);
+
+    v = VMAX(VADD(s0, tp[T00]), worst);
+    state[0] = v;
+
+    return HMM_SIMD_NAME(scatter)(lane, n_hmm, state, VMAX(bestv, v));
+}
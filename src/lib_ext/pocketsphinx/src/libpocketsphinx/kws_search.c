@@ -74,8 +74,7 @@ kws_search_prob(ps_search_t * search)
 static void
 kws_seg_free(ps_seg_t *seg)
 {
-    kws_seg_t *itor = (kws_seg_t *)seg;
-    ckd_free(itor);
+    ps_seg_release(seg);
 }
 
 static void
@@ -129,7 +128,7 @@ kws_search_seg_iter(ps_search_t * search)
     if (!detect_head)
         return NULL;
 
-    itor = (kws_seg_t *)ckd_calloc(1, sizeof(*itor));
+    itor = (kws_seg_t *)ps_seg_alloc(ps_search_arena(search), sizeof(*itor));
     itor->base.vt = &kws_segfuncs;
     itor->base.search = search;
     itor->base.lwf = 1.0;
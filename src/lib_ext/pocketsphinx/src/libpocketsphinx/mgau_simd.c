@@ -0,0 +1,288 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file mgau_simd.c Vectorised evaluation of tied Gaussian codebooks.
+ */
+
+#include <string.h>
+#include <float.h>
+
+/* SphinxBase headers */
+#include <sphinx_config.h>
+#include <sphinxbase/ckd_alloc.h>
+#include <sphinxbase/err.h>
+
+/* Local headers */
+#include "mgau_simd.h"
+
+#ifdef MGAU_HAVE_SIMD
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+
+/* GCC and Clang only use the instructions of a function's target, the
+ * Microsoft compiler any of them.  Products and differences must not
+ * be fused into FMA instructions, which would round them differently
+ * from the portable code. */
+#if defined(__GNUC__) && !defined(__clang__)
+#define MGAU_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#elif defined(__GNUC__)
+#define MGAU_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MGAU_TARGET(isa)
+#endif
+
+#define MGAU_SIMD_CONCAT(name, isa) name ## _ ## isa
+#define MGAU_SIMD_EXPAND(name, isa) MGAU_SIMD_CONCAT(name, isa)
+#define MGAU_SIMD_NAME(name) MGAU_SIMD_EXPAND(name, MGAU_SIMD_ISA)
+
+/* SSE4.1, four Gaussians at a time. */
+#define MGAU_SIMD_ISA sse4
+#define MGAU_SIMD_TARGET MGAU_TARGET("sse4.1")
+#define VEC __m128
+#define VW 4
+#define VLOAD(p) _mm_loadu_ps(p)
+#define VSTORE(p, v) _mm_storeu_ps(p, v)
+#define VSET1(x) _mm_set1_ps(x)
+#define VSUB(a, b) _mm_sub_ps(a, b)
+#define VMUL(a, b) _mm_mul_ps(a, b)
+#define VANY_GE(a, b) _mm_movemask_ps(_mm_cmpge_ps(a, b))
+
+#include "mgau_simd_kernels.h"
+
+#undef MGAU_SIMD_ISA
+#undef MGAU_SIMD_TARGET
+#undef VEC
+#undef VW
+#undef VLOAD
+#undef VSTORE
+#undef VSET1
+#undef VSUB
+#undef VMUL
+#undef VANY_GE
+
+/* AVX2, eight at a time. */
+#define MGAU_SIMD_ISA avx2
+#define MGAU_SIMD_TARGET MGAU_TARGET("avx2")
+#define VEC __m256
+#define VW 8
+#define VLOAD(p) _mm256_loadu_ps(p)
+#define VSTORE(p, v) _mm256_storeu_ps(p, v)
+#define VSET1(x) _mm256_set1_ps(x)
+#define VSUB(a, b) _mm256_sub_ps(a, b)
+#define VMUL(a, b) _mm256_mul_ps(a, b)
+#define VANY_GE(a, b) _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ))
+
+#include "mgau_simd_kernels.h"
+
+#undef MGAU_SIMD_ISA
+#undef MGAU_SIMD_TARGET
+#undef VEC
+#undef VW
+#undef VLOAD
+#undef VSTORE
+#undef VSET1
+#undef VSUB
+#undef VMUL
+#undef VANY_GE
+
+/* AVX-512, the whole block at once. */
+#define MGAU_SIMD_ISA avx512
+#define MGAU_SIMD_TARGET MGAU_TARGET("avx512f")
+#define VEC __m512
+#define VW 16
+#define VLOAD(p) _mm512_loadu_ps(p)
+#define VSTORE(p, v) _mm512_storeu_ps(p, v)
+#define VSET1(x) _mm512_set1_ps(x)
+#define VSUB(a, b) _mm512_sub_ps(a, b)
+#define VMUL(a, b) _mm512_mul_ps(a, b)
+#define VANY_GE(a, b) _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ)
+
+#include "mgau_simd_kernels.h"
+
+int
+mgau_simd_supported(mgau_simd_t simd)
+{
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    switch (simd) {
+    case MGAU_SIMD_SSE4:
+        return __builtin_cpu_supports("sse4.1");
+    case MGAU_SIMD_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case MGAU_SIMD_AVX512:
+        return __builtin_cpu_supports("avx512f");
+    default:
+        return TRUE;
+    }
+#else
+    int info[4];
+    unsigned __int64 xcr0;
+
+    if (simd == MGAU_SIMD_NONE)
+        return TRUE;
+    __cpuid(info, 1);
+    if (simd == MGAU_SIMD_SSE4)
+        return (info[2] & (1 << 19)) != 0;
+    /* The OS has to save the wider registers too. */
+    if (!(info[2] & (1 << 27)))
+        return FALSE;
+    xcr0 = _xgetbv(0);
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return FALSE;
+    __cpuidex(info, 7, 0);
+    if (simd == MGAU_SIMD_AVX2)
+        return (xcr0 & 6) == 6 && (info[1] & (1 << 5)) != 0;
+    return (xcr0 & 0xe6) == 0xe6 && (info[1] & (1 << 16)) != 0;
+#endif
+}
+
+#else /* !MGAU_HAVE_SIMD */
+
+int
+mgau_simd_supported(mgau_simd_t simd)
+{
+    return simd == MGAU_SIMD_NONE;
+}
+
+#endif /* MGAU_HAVE_SIMD */
+
+static char const *mgau_simd_names[] = { "none", "sse4", "avx2", "avx512" };
+
+char const *
+mgau_simd_name(mgau_simd_t simd)
+{
+    return mgau_simd_names[simd];
+}
+
+mgau_simd_t
+mgau_simd_choose(cmd_ln_t *config, char const *option)
+{
+    char const *name = cmd_ln_str_r(config, option);
+    int simd;
+
+    if (name == NULL || 0 == strcmp(name, "auto"))
+        simd = MGAU_SIMD_AVX512;
+    else {
+        for (simd = MGAU_SIMD_AVX512; simd > MGAU_SIMD_NONE; --simd)
+            if (0 == strcmp(name, mgau_simd_names[simd]))
+                break;
+        if (simd == MGAU_SIMD_NONE && 0 != strcmp(name, "none"))
+            E_WARN("Unknown %s %s, using the portable code\n", option, name);
+    }
+
+    for (; simd > MGAU_SIMD_NONE; --simd)
+        if (mgau_simd_supported((mgau_simd_t)simd))
+            break;
+    return (mgau_simd_t)simd;
+}
+
+mgau_simd_eval_t
+mgau_simd_init(cmd_ln_t *config, mgau_simd_t *out_simd)
+{
+    *out_simd = mgau_simd_choose(config, "-gmm_simd");
+#ifdef MGAU_HAVE_SIMD
+    switch (*out_simd) {
+    case MGAU_SIMD_AVX512:
+        return eval_avx512;
+    case MGAU_SIMD_AVX2:
+        return eval_avx2;
+    case MGAU_SIMD_SSE4:
+        return eval_sse4;
+    default:
+        break;
+    }
+#endif
+    return NULL;
+}
+
+void
+mgau_simd_cb_update(mgau_simd_cb_t *cb, gauden_t const *g,
+                    int32 mgau, int32 feat)
+{
+    int32 cw, j;
+
+    for (cw = 0; cw < cb->n_block * MGAU_SIMD_BLOCK; ++cw) {
+        int32 block = cw / MGAU_SIMD_BLOCK, lane = cw % MGAU_SIMD_BLOCK;
+        mfcc_t *mean = cb->mean + (size_t)block * cb->ceplen * MGAU_SIMD_BLOCK + lane;
+        mfcc_t *var = cb->var + (size_t)block * cb->ceplen * MGAU_SIMD_BLOCK + lane;
+
+        /* Padding has no mean and no precision, so it keeps its
+         * hopeless determinant. */
+        for (j = 0; j < cb->ceplen; ++j) {
+            mean[j * MGAU_SIMD_BLOCK] = cw < cb->n_density ? g->mean[mgau][feat][cw][j] : 0;
+            var[j * MGAU_SIMD_BLOCK] = cw < cb->n_density ? g->var[mgau][feat][cw][j] : 0;
+        }
+        cb->det[cw] = cw < cb->n_density ? g->det[mgau][feat][cw] : -FLT_MAX;
+    }
+}
+
+mgau_simd_cb_t *
+mgau_simd_cb_init(gauden_t const *g, int32 mgau, int32 feat)
+{
+    mgau_simd_cb_t *cb;
+    size_t n_values;
+    char *aligned;
+
+    cb = ckd_calloc(1, sizeof(*cb));
+    cb->n_density = g->n_density;
+    cb->n_block = (g->n_density + MGAU_SIMD_BLOCK - 1) / MGAU_SIMD_BLOCK;
+    cb->ceplen = g->featlen[feat];
+
+    /* Blocks start on a cache line, 64 bytes. */
+    n_values = (size_t)cb->n_block * MGAU_SIMD_BLOCK * (2 * cb->ceplen + 1);
+    cb->buf = ckd_calloc(n_values * sizeof(mfcc_t) + 64, 1);
+    aligned = (char *)cb->buf + (64 - ((size_t)cb->buf & 63)) % 64;
+    cb->mean = (mfcc_t *)aligned;
+    cb->var = cb->mean + (size_t)cb->n_block * MGAU_SIMD_BLOCK * cb->ceplen;
+    cb->det = cb->var + (size_t)cb->n_block * MGAU_SIMD_BLOCK * cb->ceplen;
+
+    mgau_simd_cb_update(cb, g, mgau, feat);
+    return cb;
+}
+
+void
+mgau_simd_cb_free(mgau_simd_cb_t *cb)
+{
+    if (cb == NULL)
+        return;
+    ckd_free(cb->buf);
+    ckd_free(cb);
+}
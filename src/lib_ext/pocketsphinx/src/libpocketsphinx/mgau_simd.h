@@ -0,0 +1,128 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file mgau_simd.h Vectorised evaluation of tied Gaussian codebooks.
+ *
+ * The Gaussians of a codebook are copied into blocks of
+ * MGAU_SIMD_BLOCK, stored dimension by dimension, so that one
+ * instruction evaluates a dimension of several Gaussians.  Each one
+ * is computed with the same operations in the same order as in
+ * ptm_mgau.c and s2_semi_mgau.c, so the scores are the same to the
+ * bit.
+ */
+
+#ifndef __MGAU_SIMD_H__
+#define __MGAU_SIMD_H__
+
+/* SphinxBase headers. */
+#include <sphinxbase/fe.h>
+#include <sphinxbase/cmd_ln.h>
+
+/* Local headers. */
+#include "ms_gauden.h"
+
+#if !defined(FIXED_POINT) \
+    && (defined(__GNUC__) || defined(_MSC_VER)) \
+    && (defined(__x86_64__) || defined(__i386__) \
+        || defined(_M_X64) || defined(_M_IX86))
+#define MGAU_HAVE_SIMD 1
+#endif
+
+/** Gaussians evaluated together, the width of an AVX-512 register. */
+#define MGAU_SIMD_BLOCK 16
+
+typedef enum mgau_simd_e {
+    MGAU_SIMD_NONE = 0,
+    MGAU_SIMD_SSE4 = 1,
+    MGAU_SIMD_AVX2 = 2,
+    MGAU_SIMD_AVX512 = 3
+} mgau_simd_t;
+
+/**
+ * One codebook and feature stream, transposed.
+ */
+typedef struct mgau_simd_cb_s {
+    int32 n_density;
+    int32 n_block;
+    int32 ceplen;
+    mfcc_t *mean;  /**< mean[block][dim][MGAU_SIMD_BLOCK] */
+    mfcc_t *var;   /**< Precisions, like mean. */
+    mfcc_t *det;   /**< det[block][MGAU_SIMD_BLOCK], padding never scores */
+    void *buf;     /**< Allocation the above are aligned in. */
+} mgau_simd_cb_t;
+
+/**
+ * Evaluate a block of Gaussians against an observation.
+ *
+ * @return 0 if all of them fell below thresh, in which case d is
+ * not set, otherwise 1 with their scores in d.
+ */
+typedef int (*mgau_simd_eval_t)(mgau_simd_cb_t const *cb, int32 block,
+                                mfcc_t const *obs, mfcc_t thresh,
+                                mfcc_t *d);
+
+/**
+ * Choose the instruction set from -gmm_simd (auto, none, sse4, avx2
+ * or avx512), falling back to the best one below it the CPU
+ * supports.
+ *
+ * @return the evaluation function, or NULL for the portable code.
+ */
+mgau_simd_eval_t mgau_simd_init(cmd_ln_t *config, mgau_simd_t *out_simd);
+
+/**
+ * Best instruction set the CPU supports up to the one named by the
+ * option (auto, none, sse4, avx2 or avx512).
+ */
+mgau_simd_t mgau_simd_choose(cmd_ln_t *config, char const *option);
+
+/** Can this CPU (and OS) run the instructions of simd? */
+int mgau_simd_supported(mgau_simd_t simd);
+
+/** Name of an instruction set, for logging. */
+char const *mgau_simd_name(mgau_simd_t simd);
+
+/** Transposed copy of a codebook and feature stream of g. */
+mgau_simd_cb_t *mgau_simd_cb_init(gauden_t const *g, int32 mgau, int32 feat);
+
+/** Copy the codebook again, after g was transformed. */
+void mgau_simd_cb_update(mgau_simd_cb_t *cb, gauden_t const *g,
+                         int32 mgau, int32 feat);
+
+void mgau_simd_cb_free(mgau_simd_cb_t *cb);
+
+#endif /* __MGAU_SIMD_H__ */
@@ -0,0 +1,90 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file mgau_simd_kernels.h Kernel of mgau_simd.c.
+ *
+ * Written once in terms of the vector macros mgau_simd.c defines and
+ * included once for each instruction set: VEC holds VW floats,
+ * MGAU_SIMD_NAME() names the functions and MGAU_SIMD_TARGET lets the
+ * compiler use the instructions in them.
+ */
+
+#define NV (MGAU_SIMD_BLOCK / VW)
+
+MGAU_SIMD_TARGET static int
+MGAU_SIMD_NAME(eval)(mgau_simd_cb_t const *cb, int32 block,
+                     mfcc_t const *obs, mfcc_t thresh, mfcc_t *d)
+{
+    VEC dv[NV];
+    VEC t = VSET1(thresh);
+    mfcc_t const *mean, *var;
+    int32 j, k;
+
+    mean = cb->mean + (size_t)block * cb->ceplen * MGAU_SIMD_BLOCK;
+    var = cb->var + (size_t)block * cb->ceplen * MGAU_SIMD_BLOCK;
+    for (k = 0; k < NV; ++k)
+        dv[k] = VLOAD(cb->det + block * MGAU_SIMD_BLOCK + k * VW);
+
+    for (j = 0; j < cb->ceplen; ++j) {
+        VEC o = VSET1(obs[j]);
+
+        /* diff, diff^2, component likelihood, as in COMPUTE_GMM_MAP */
+        for (k = 0; k < NV; ++k) {
+            VEC diff = VSUB(o, VLOAD(mean + k * VW));
+            dv[k] = VSUB(dv[k], VMUL(VMUL(diff, diff), VLOAD(var + k * VW)));
+        }
+        mean += MGAU_SIMD_BLOCK;
+        var += MGAU_SIMD_BLOCK;
+
+        /* Give up once they all fell below the threshold, checking
+         * every four dimensions but never after the last one, where
+         * the callers make the final decision themselves. */
+        if ((j & 3) == 3 && j + 1 < cb->ceplen) {
+            int any = 0;
+            for (k = 0; k < NV; ++k)
+                any |= VANY_GE(dv[k], t);
+            if (!any)
+                return 0;
+        }
+    }
+
+    for (k = 0; k < NV; ++k)
+        VSTORE(d + k * VW, dv[k]);
+    return 1;
+}
+
+#undef NV
@@ -0,0 +1,166 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file mgau_team.c Threads sharing the Gaussian evaluation of a frame.
+ */
+
+/* SphinxBase headers */
+#include <sphinxbase/ckd_alloc.h>
+#include <sphinxbase/err.h>
+#include <sphinxbase/sbthread.h>
+
+/* Local headers */
+#include "mgau_team.h"
+
+typedef struct mgau_worker_s {
+    mgau_team_t *team;
+    int32 idx;
+    sbthread_t *thread;
+    sbevent_t *start;  /**< Signalled when there is work for this thread. */
+    sbevent_t *done;   /**< Signalled when it is finished. */
+} mgau_worker_t;
+
+struct mgau_team_s {
+    int32 n_worker;
+    mgau_worker_t *workers; /**< Members 1 to n_worker - 1. */
+    mgau_team_func_t func;
+    void *arg;
+    int quit;
+};
+
+static int
+worker_main(sbthread_t *th)
+{
+    mgau_worker_t *w = sbthread_arg(th);
+    mgau_team_t *team = w->team;
+
+    /* The events lock a mutex, which makes what the other side wrote
+     * before signalling them visible here. */
+    while (sbevent_wait(w->start, -1, 0) == 0 && !team->quit) {
+        (*team->func)(team->arg, w->idx, team->n_worker);
+        sbevent_signal(w->done);
+    }
+    return 0;
+}
+
+static void
+team_stop(mgau_team_t *team, int32 n_started)
+{
+    int32 i;
+
+    team->quit = TRUE;
+    for (i = 1; i < n_started; ++i) {
+        sbevent_signal(team->workers[i].start);
+        sbthread_wait(team->workers[i].thread);
+        sbthread_free(team->workers[i].thread);
+    }
+    for (i = 1; i < team->n_worker; ++i) {
+        if (team->workers[i].start)
+            sbevent_free(team->workers[i].start);
+        if (team->workers[i].done)
+            sbevent_free(team->workers[i].done);
+    }
+    ckd_free(team->workers);
+    ckd_free(team);
+}
+
+mgau_team_t *
+mgau_team_init(cmd_ln_t *config)
+{
+    mgau_team_t *team;
+    int32 n_thread, i;
+
+    n_thread = cmd_ln_int32_r(config, "-score_threads");
+    if (n_thread <= 1)
+        return NULL;
+
+    team = ckd_calloc(1, sizeof(*team));
+    team->n_worker = n_thread;
+    team->workers = ckd_calloc(n_thread, sizeof(*team->workers));
+    for (i = 1; i < n_thread; ++i) {
+        mgau_worker_t *w = team->workers + i;
+
+        w->team = team;
+        w->idx = i;
+        if ((w->start = sbevent_init()) == NULL
+            || (w->done = sbevent_init()) == NULL)
+            break;
+        if ((w->thread = sbthread_start(config, worker_main, w)) == NULL)
+            break;
+    }
+    if (i < n_thread) {
+        E_ERROR("Failed to start %d scoring threads, scoring in one\n",
+                n_thread);
+        team_stop(team, i);
+        return NULL;
+    }
+
+    return team;
+}
+
+int32
+mgau_team_size(mgau_team_t *team)
+{
+    return team ? team->n_worker : 1;
+}
+
+void
+mgau_team_run(mgau_team_t *team, mgau_team_func_t func, void *arg)
+{
+    int32 i;
+
+    if (team == NULL) {
+        (*func)(arg, 0, 1);
+        return;
+    }
+
+    team->func = func;
+    team->arg = arg;
+    for (i = 1; i < team->n_worker; ++i)
+        sbevent_signal(team->workers[i].start);
+    (*func)(arg, 0, team->n_worker);
+    for (i = 1; i < team->n_worker; ++i)
+        sbevent_wait(team->workers[i].done, -1, 0);
+}
+
+void
+mgau_team_free(mgau_team_t *team)
+{
+    if (team == NULL)
+        return;
+    team_stop(team, team->n_worker);
+}
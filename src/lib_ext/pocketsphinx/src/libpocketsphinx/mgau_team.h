@@ -0,0 +1,84 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 1999-2010 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+/**
+ * @file mgau_team.h Threads sharing the Gaussian evaluation of a frame.
+ *
+ * A team is started once with the acoustic model and kept for its
+ * lifetime; every call to mgau_team_run() hands the same function to
+ * all of its members, each one doing its share of the work, and
+ * returns when they are all done.
+ */
+
+#ifndef __MGAU_TEAM_H__
+#define __MGAU_TEAM_H__
+
+/* SphinxBase headers. */
+#include <sphinxbase/cmd_ln.h>
+
+typedef struct mgau_team_s mgau_team_t;
+
+/**
+ * Share of the work of one member of the team, numbered from 0 to
+ * n_worker - 1.
+ */
+typedef void (*mgau_team_func_t)(void *arg, int32 worker, int32 n_worker);
+
+/**
+ * Start a team of -score_threads members.
+ *
+ * @return NULL if there is only one thread, in which case the caller
+ * does all the work, or if the threads could not be started.
+ */
+mgau_team_t *mgau_team_init(cmd_ln_t *config);
+
+/**
+ * Number of members, the calling thread included.
+ */
+int32 mgau_team_size(mgau_team_t *team);
+
+/**
+ * Run func on every member of the team, the calling thread being
+ * member 0, and wait for all of them to finish.
+ */
+void mgau_team_run(mgau_team_t *team, mgau_team_func_t func, void *arg);
+
+/**
+ * Stop the threads and release the team.
+ */
+void mgau_team_free(mgau_team_t *team);
+
+#endif /* __MGAU_TEAM_H__ */
@@ -75,7 +75,8 @@ static ps_mgaufuncs_t ms_mgau_funcs = {
     "ms",
     ms_cont_mgau_frame_eval, /* frame_eval */
     ms_mgau_mllr_transform,  /* transform */
-    ms_mgau_free             /* free */
+    ms_mgau_free,            /* free */
+    NULL                     /* frame_eval_block */
 };
 
 ps_mgau_t *
@@ -54,6 +54,7 @@
 #include "ngram_search.h"
 #include "ngram_search_fwdtree.h"
 #include "ngram_search_fwdflat.h"
+#include "hmm_simd.h"
 
 static int ngram_search_start(ps_search_t *search);
 static int ngram_search_step(ps_search_t *search, int frame_idx);
@@ -161,6 +162,8 @@ ngram_search_init(const char *name,
         ps_search_free(ps_search_base(ngs));
         return NULL;
     }
+    E_INFO("HMM evaluation instruction set: %s\n",
+           mgau_simd_name(hmm_simd_init(ngs->hmmctx, acmod->tmat->n_tmat, config)));
     ngs->chan_alloc = listelem_alloc_init(sizeof(chan_t));
     ngs->root_chan_alloc = listelem_alloc_init(sizeof(root_chan_t));
     ngs->latnode_alloc = listelem_alloc_init(sizeof(ps_latnode_t));
@@ -933,10 +936,7 @@ ngram_search_bp2itor(ps_seg_t *seg, int bp)
 static void
 ngram_bp_seg_free(ps_seg_t *seg)
 {
-    bptbl_seg_t *itor = (bptbl_seg_t *)seg;
-
-    ckd_free(itor->bpidx);
-    ckd_free(itor);
+    ps_seg_release(seg);
 }
 
 static ps_seg_t *
@@ -968,7 +968,7 @@ ngram_search_bp_iter(ngram_search_t *ngs, int bpidx, float32 lwf)
      * to get the entire backtrace in order to produce it.  On the
      * other hand, all we actually need is the bptbl IDs, and we can
      * allocate a fixed-size array of them. */
-    itor = ckd_calloc(1, sizeof(*itor));
+    itor = (bptbl_seg_t *)ps_seg_alloc(ps_search_arena(ngs), sizeof(*itor));
     itor->base.vt = &ngram_bp_segfuncs;
     itor->base.search = ps_search_base(ngs);
     itor->base.lwf = lwf;
@@ -980,10 +980,10 @@ ngram_search_bp_iter(ngram_search_t *ngs, int bpidx, float32 lwf)
         ++itor->n_bpidx;
     }
     if (itor->n_bpidx == 0) {
-        ckd_free(itor);
+        ps_seg_release((ps_seg_t *)itor);
         return NULL;
     }
-    itor->bpidx = ckd_calloc(itor->n_bpidx, sizeof(*itor->bpidx));
+    itor->bpidx = arena_calloc(itor->base.arena, itor->n_bpidx, sizeof(*itor->bpidx));
     cur = itor->n_bpidx - 1;
     bp = bpidx;
     while (bp != NO_BP) {
@@ -1106,7 +1106,7 @@ create_dag_nodes(ngram_search_t *ngs, ps_lattice_t *dag)
             node->lef = i;
         else {
             /* New node; link to head of list */
-            node = listelem_malloc(dag->latnode_alloc);
+            node = arena_calloc(dag->arena, 1, sizeof(*node));
             node->wid = wid;
             node->sf = sf; /* This is a frame index. */
             node->fef = node->lef = i; /* These are backpointer indices (argh) */
@@ -1268,9 +1268,7 @@ ngram_search_lattice(ps_search_t *search)
      */
     i = 0;
     while (dag->nodes && dag->nodes != dag->end) {
-        ps_latnode_t *next = dag->nodes->next;
-        listelem_free(dag->latnode_alloc, dag->nodes);
-        dag->nodes = next;
+        dag->nodes = dag->nodes->next;
         ++i;
     }
     E_INFO("Eliminated %d nodes before end node\n", i);
@@ -625,21 +625,20 @@ static int32
 eval_nonroot_chan(ngram_search_t *ngs, int frame_idx)
 {
     chan_t *hmm, **acl;
-    int32 i, bestscore;
+    hmm_batch_t batch;
+    int32 i;
 
     i = ngs->n_active_chan[frame_idx & 0x1];
     acl = ngs->active_chan_list[frame_idx & 0x1];
-    bestscore = WORST_SCORE;
+    hmm_batch_init(&batch, ngs->hmmctx);
     ngs->st.n_nonroot_chan_eval += i;
 
     for (hmm = *(acl++); i > 0; --i, hmm = *(acl++)) {
-        int32 score = chan_v_eval(hmm);
         assert(hmm_frame(&hmm->hmm) == frame_idx);
-        if (score BETTER_THAN bestscore)
-            bestscore = score;
+        hmm_batch_add(&batch, &hmm->hmm);
     }
 
-    return bestscore;
+    return hmm_batch_finish(&batch);
 }
 
 static int32
@@ -647,10 +646,11 @@ eval_word_chan(ngram_search_t *ngs, int frame_idx)
 {
     root_chan_t *rhmm;
     chan_t *hmm;
+    hmm_batch_t batch;
     int32 i, w, bestscore, *awl, j, k;
 
     k = 0;
-    bestscore = WORST_SCORE;
+    hmm_batch_init(&batch, ngs->hmmctx);
     awl = ngs->active_word_list[frame_idx & 0x1];
 
     i = ngs->n_active_word[frame_idx & 0x1];
@@ -660,18 +660,12 @@ eval_word_chan(ngram_search_t *ngs, int frame_idx)
         assert(ngs->word_chan[w] != NULL);
 
         for (hmm = ngs->word_chan[w]; hmm; hmm = hmm->next) {
-            int32 score;
-
             assert(hmm_frame(&hmm->hmm) == frame_idx);
-            score = chan_v_eval(hmm);
-            /*printf("eval word chan %d score %d\n", w, score); */
-
-            if (score BETTER_THAN bestscore)
-                bestscore = score;
-
+            hmm_batch_add(&batch, &hmm->hmm);
             k++;
         }
     }
+    bestscore = hmm_batch_finish(&batch);
 
     /* Similarly for statically allocated single-phone words */
     j = 0;
@@ -63,6 +63,7 @@
 #include "ngram_search_fwdtree.h"
 #include "ngram_search_fwdflat.h"
 #include "allphone_search.h"
+#include "state_align_search.h"
 
 static const arg_t ps_args_def[] = {
     POCKETSPHINX_OPTIONS,
@@ -219,7 +220,8 @@ ps_reinit(ps_decoder_t *ps, cmd_ln_t *config)
 {
     const char *path;
     const char *keyphrase;
-    int32 lw;
+    const char *logadd;
+    int32 lw, compact;
 
     if (config && config != ps->config) {
         cmd_ln_free_r(ps->config);
@@ -259,14 +261,29 @@ ps_reinit(ps_decoder_t *ps, cmd_ln_t *config)
     ps->d2p = NULL;
 
     /* Logmath computation (used in acmod and search) */
+    logadd = cmd_ln_str_r(ps->config, "-logadd");
+    if (0 == strcmp(logadd, "compact"))
+        compact = TRUE;
+    else if (0 == strcmp(logadd, "table"))
+        compact = FALSE;
+    else {
+        E_ERROR("Unknown log-add table '%s', expected table or compact\n", logadd);
+        return -1;
+    }
     if (ps->lmath == NULL
         || (logmath_get_base(ps->lmath) !=
-            (float64)cmd_ln_float32_r(ps->config, "-logbase"))) {
+            (float64)cmd_ln_float32_r(ps->config, "-logbase"))
+        || logmath_is_compact(ps->lmath) != compact) {
         if (ps->lmath)
             logmath_free(ps->lmath);
-        ps->lmath = logmath_init
-            ((float64)cmd_ln_float32_r(ps->config, "-logbase"), 0,
-             cmd_ln_boolean_r(ps->config, "-bestpath"));
+        /* The compact table is small enough to have without -bestpath. */
+        if (compact)
+            ps->lmath = logmath_init_compact
+                ((float64)cmd_ln_float32_r(ps->config, "-logbase"), 0);
+        else
+            ps->lmath = logmath_init
+                ((float64)cmd_ln_float32_r(ps->config, "-logbase"), 0,
+                 cmd_ln_boolean_r(ps->config, "-bestpath"));
     }
 
     /* Acoustic model (this is basically everything that
@@ -496,6 +513,7 @@ ps_get_search(ps_decoder_t *ps)
         search_it = hash_table_iter_next(search_it)) {
         if (hash_entry_val(search_it->ent) == ps->search) {
             name = hash_entry_key(search_it->ent);
+            hash_table_iter_free(search_it);
             break;
         }
     }
@@ -575,6 +593,9 @@ set_search_internal(ps_decoder_t *ps, ps_search_t *search)
 
     search->pls = ps->phone_loop;
     old_search = (ps_search_t *) hash_table_replace(ps->searches, ps_search_name(search), search);
+    /* Replacing the active search keeps it active. */
+    if (old_search && ps->search == old_search)
+        ps->search = search;
     if (old_search != search)
         ps_search_free(old_search);
 
@@ -612,6 +633,47 @@ ps_set_allphone(ps_decoder_t *ps, const char *name, ngram_model_t *lm)
     return set_search_internal(ps, search);
 }
 
+int
+ps_set_align(ps_decoder_t *ps, const char *name, const char *words)
+{
+    ps_search_t *search;
+    ps_alignment_t *al;
+    char *text, **wptr;
+    int32 i, n_words;
+
+    text = ckd_salloc(words);
+    n_words = str2words(text, NULL, 0);
+    wptr = ckd_calloc(n_words > 0 ? n_words : 1, sizeof(*wptr));
+    str2words(text, wptr, n_words);
+
+    al = ps_alignment_init(ps->d2p);
+    ps_alignment_add_word(al, dict_startwid(ps->dict), 0);
+    for (i = 0; i < n_words; ++i) {
+        s3wid_t wid = dict_wordid(ps->dict, wptr[i]);
+        if (wid == BAD_S3WID) {
+            E_ERROR("Unknown word %s, can not align\n", wptr[i]);
+            ps_alignment_free(al);
+            ckd_free(wptr);
+            ckd_free(text);
+            return -1;
+        }
+        ps_alignment_add_word(al, wid, 0);
+    }
+    ps_alignment_add_word(al, dict_finishwid(ps->dict), 0);
+    ckd_free(wptr);
+    ckd_free(text);
+
+    if (ps_alignment_populate(al) < 0) {
+        ps_alignment_free(al);
+        return -1;
+    }
+
+    /* The search keeps its own reference to the alignment. */
+    search = state_align_search_init(name, ps->config, ps->acmod, al);
+    ps_alignment_free(al);
+    return set_search_internal(ps, search);
+}
+
 int
 ps_set_allphone_file(ps_decoder_t *ps, const char *name, const char *path)
 {
@@ -961,6 +1023,8 @@ ps_start_utt(ps_decoder_t *ps)
     ps->search->post = 0;
     ckd_free(ps->search->hyp_str);
     ps->search->hyp_str = NULL;
+    /* And everything else the last utterance drew from the arena. */
+    ps->search->arena = arena_reset(ps->search->arena);
     if ((rv = acmod_start_utt(ps->acmod)) < 0)
         return rv;
 
@@ -1122,17 +1186,11 @@ ps_process_cep(ps_decoder_t *ps,
     return n_searchfr;
 }
 
-int
-ps_end_utt(ps_decoder_t *ps)
+static int
+ps_finish_utt(ps_decoder_t *ps)
 {
     int rv, i;
 
-    if (ps->acmod->state == ACMOD_ENDED || ps->acmod->state == ACMOD_IDLE) {
-	E_ERROR("Utterance is not started\n");
-	return -1;
-    }
-    acmod_end_utt(ps->acmod);
-
     /* Search any remaining frames. */
     if ((rv = ps_search_forward(ps)) < 0) {
         ptmr_stop(&ps->perf);
@@ -1188,6 +1246,30 @@ ps_end_utt(ps_decoder_t *ps)
     return rv;
 }
 
+int
+ps_end_utt(ps_decoder_t *ps)
+{
+    if (ps->acmod->state == ACMOD_ENDED || ps->acmod->state == ACMOD_IDLE) {
+	E_ERROR("Utterance is not started\n");
+	return -1;
+    }
+    acmod_end_utt(ps->acmod);
+
+    return ps_finish_utt(ps);
+}
+
+int
+ps_end_utt_cep(ps_decoder_t *ps, mfcc_t const *final_cep)
+{
+    if (ps->acmod->state == ACMOD_ENDED || ps->acmod->state == ACMOD_IDLE) {
+	E_ERROR("Utterance is not started\n");
+	return -1;
+    }
+    acmod_end_utt_cep(ps->acmod, final_cep);
+
+    return ps_finish_utt(ps);
+}
+
 char const *
 ps_get_hyp(ps_decoder_t *ps, int32 *out_best_score)
 {
@@ -1221,6 +1303,21 @@ ps_seg_iter(ps_decoder_t *ps)
     return itor;
 }
 
+ps_seg_t *
+ps_seg_phone_iter(ps_decoder_t *ps)
+{
+    ps_seg_t *itor;
+
+    if (ps->search == NULL
+        || 0 != strcmp(ps_search_type(ps->search), PS_SEARCH_TYPE_STATE_ALIGN))
+        return NULL;
+
+    ptmr_start(&ps->perf);
+    itor = state_align_search_phone_iter(ps->search);
+    ptmr_stop(&ps->perf);
+    return itor;
+}
+
 ps_seg_t *
 ps_seg_next(ps_seg_t *seg)
 {
@@ -1382,6 +1479,7 @@ ps_search_init(ps_search_t *search, ps_searchfuncs_t *vt,
 
     search->config = config;
     search->acmod = acmod;
+    search->arena = arena_init(0);
     if (d2p)
         search->d2p = dict2pid_retain(d2p);
     else
@@ -1411,6 +1509,7 @@ ps_search_base_free(ps_search_t *search)
     dict2pid_free(search->d2p);
     ckd_free(search->hyp_str);
     ps_lattice_free(search->dag);
+    arena_free(search->arena);
 }
 
 void
@@ -1438,6 +1537,22 @@ ps_search_base_reinit(ps_search_t *search, dict_t *dict,
         search->d2p = NULL;
 }
 
+ps_seg_t *
+ps_seg_alloc(arena_t *arena, size_t size)
+{
+    ps_seg_t *seg;
+
+    seg = arena_calloc(arena, 1, size);
+    seg->arena = arena_retain(arena);
+    return seg;
+}
+
+void
+ps_seg_release(ps_seg_t *seg)
+{
+    arena_free(seg->arena);
+}
+
 void
 ps_set_rawdata_size(ps_decoder_t *ps, int32 size) 
 {
@@ -45,6 +45,7 @@
 #define __POCKETSPHINX_INTERNAL_H__
 
 /* SphinxBase headers. */
+#include <sphinxbase/arena.h>
 #include <sphinxbase/cmd_ln.h>
 #include <sphinxbase/fe.h>
 #include <sphinxbase/feat.h>
@@ -110,6 +111,8 @@ struct ps_search_s {
     ps_lattice_t *dag;	   /**< Current hypothesis word graph. */
     ps_latlink_t *last_link; /**< Final link in best path. */
     int32 post;            /**< Utterance posterior probability. */
+    arena_t *arena;        /**< Memory of the current utterance, released
+                              when the next one starts. */
     int32 n_words;         /**< Number of words known to search (may
                               be less than in the dictionary) */
 
@@ -129,6 +132,7 @@ struct ps_search_s {
 #define ps_search_post(s) ps_search_base(s)->post
 #define ps_search_lookahead(s) ps_search_base(s)->pls
 #define ps_search_n_words(s) ps_search_base(s)->n_words
+#define ps_search_arena(s) ps_search_base(s)->arena
 
 #define ps_search_type(s) ps_search_base(s)->type
 #define ps_search_name(s) ps_search_base(s)->name
@@ -178,6 +182,7 @@ typedef struct ps_segfuncs_s {
 struct ps_seg_s {
     ps_segfuncs_t *vt;     /**< V-table of seg methods */
     ps_search_t *search;   /**< Search object from whence this came */
+    arena_t *arena;        /**< Arena this came from, held until it is freed */
     char const *word;      /**< Word string (pointer into dictionary hash) */
     frame_idx_t sf;        /**< Start frame. */
     frame_idx_t ef;        /**< End frame. */
@@ -194,6 +199,18 @@ struct ps_seg_s {
 #define ps_search_seg_next(seg) (*(seg->vt->seg_next))(seg)
 #define ps_search_seg_free(s) (*(seg->vt->seg_free))(seg)
 
+/**
+ * Allocate a zeroed segmentation iterator of the given size from an
+ * arena, and retain the arena, as the iterator may be freed after the
+ * utterance it came from.
+ */
+ps_seg_t *ps_seg_alloc(arena_t *arena, size_t size);
+
+/**
+ * Release the arena of a segmentation iterator, which goes with it.
+ */
+void ps_seg_release(ps_seg_t *seg);
+
 
 /**
  * Decoder object.
@@ -78,6 +78,7 @@ struct ps_alignment_vector_s {
 typedef struct ps_alignment_vector_s ps_alignment_vector_t;
 
 struct ps_alignment_s {
+    int refcount;
     dict2pid_t *d2p;
     ps_alignment_vector_t word;
     ps_alignment_vector_t sseq;
@@ -97,6 +98,11 @@ typedef struct ps_alignment_iter_s ps_alignment_iter_t;
  */
 ps_alignment_t *ps_alignment_init(dict2pid_t *d2p);
 
+/**
+ * Retain an alignment
+ */
+ps_alignment_t *ps_alignment_retain(ps_alignment_t *al);
+
 /**
  * Release an alignment
  */
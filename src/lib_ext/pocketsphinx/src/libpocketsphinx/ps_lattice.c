@@ -77,9 +77,7 @@ ps_lattice_link(ps_lattice_t *dag, ps_latnode_t *from, ps_latnode_t *to,
         ps_latlink_t *link;
 
         /* No link between the two nodes; create a new one */
-        link = listelem_malloc(dag->latlink_alloc);
-        fwdlink = listelem_malloc(dag->latlink_list_alloc);
-        revlink = listelem_malloc(dag->latlink_list_alloc);
+        link = arena_calloc(dag->arena, 1, sizeof(*link));
 
         link->from = from;
         link->to = to;
@@ -87,10 +85,9 @@ ps_lattice_link(ps_lattice_t *dag, ps_latnode_t *from, ps_latnode_t *to,
         link->ef = ef;
         link->best_prev = NULL;
 
-        fwdlink->link = revlink->link = link;
-        fwdlink->next = from->exits;
+        fwdlink = latlink_list_new(dag, link, from->exits);
         from->exits = fwdlink;
-        revlink->next = to->entries;
+        revlink = latlink_list_new(dag, link, to->entries);
         to->entries = revlink;
     }
     else {
@@ -124,14 +121,14 @@ delete_node(ps_lattice_t *dag, ps_latnode_t *node)
     for (x = node->exits; x; x = next_x) {
         next_x = x->next;
         x->link->from = NULL;
-        listelem_free(dag->latlink_list_alloc, x);
+        latlink_list_free(dag, x);
     }
     for (x = node->entries; x; x = next_x) {
         next_x = x->next;
         x->link->to = NULL;
-        listelem_free(dag->latlink_list_alloc, x);
+        latlink_list_free(dag, x);
     }
-    listelem_free(dag->latnode_alloc, node);
+    /* The node itself goes with the arena. */
 }
 
 
@@ -148,8 +145,7 @@ remove_dangling_links(ps_lattice_t *dag, ps_latnode_t *node)
                 prev_x->next = next_x;
             else
                 node->exits = next_x;
-            listelem_free(dag->latlink_alloc, x->link);
-            listelem_free(dag->latlink_list_alloc, x);
+            latlink_list_free(dag, x);
         }
         else
             prev_x = x;
@@ -162,8 +158,7 @@ remove_dangling_links(ps_lattice_t *dag, ps_latnode_t *node)
                 prev_x->next = next_x;
             else
                 node->entries = next_x;
-            listelem_free(dag->latlink_alloc, x->link);
-            listelem_free(dag->latlink_list_alloc, x);
+            latlink_list_free(dag, x);
         }
         else
             prev_x = x;
@@ -395,10 +390,14 @@ ps_lattice_read(ps_decoder_t *ps,
     ps_latnode_t *tail;
     ps_latnode_t **darray;
     ps_lattice_t *dag;
+    arena_t *arena;
     int i, k, n_nodes;
     int32 pip, silpen, fillpen;
 
-    dag = ckd_calloc(1, sizeof(*dag));
+    /* Not a lattice of the current utterance, so it has an arena of its own. */
+    arena = arena_init(0);
+    dag = arena_calloc(arena, 1, sizeof(*dag));
+    dag->arena = arena;
 
     if (ps) {
         dag->search = ps->search;
@@ -412,9 +411,6 @@ ps_lattice_read(ps_decoder_t *ps,
         dag->frate = 100;
     }
     dag->silence = dict_silwid(dag->dict);
-    dag->latnode_alloc = listelem_alloc_init(sizeof(ps_latnode_t));
-    dag->latlink_alloc = listelem_alloc_init(sizeof(ps_latlink_t));
-    dag->latlink_list_alloc = listelem_alloc_init(sizeof(latlink_list_t));
     dag->refcount = 1;
 
     tail = NULL;
@@ -511,7 +507,7 @@ ps_lattice_read(ps_decoder_t *ps,
             goto load_error;
         }
 
-        d = listelem_malloc(dag->latnode_alloc);
+        d = arena_calloc(dag->arena, 1, sizeof(*d));
         darray[i] = d;
         d->wid = w;
         d->basewid = dict_basewid(dag->dict, w);
@@ -640,16 +636,14 @@ ps_lattice_init_search(ps_search_t *search, int n_frame)
 {
     ps_lattice_t *dag;
 
-    dag = ckd_calloc(1, sizeof(*dag));
+    dag = arena_calloc(search->arena, 1, sizeof(*dag));
+    dag->arena = arena_retain(search->arena);
     dag->search = search;
     dag->dict = dict_retain(search->dict);
     dag->lmath = logmath_retain(search->acmod->lmath);
     dag->frate = cmd_ln_int32_r(dag->search->config, "-frate");
     dag->silence = dict_silwid(dag->dict);
     dag->n_frames = n_frame;
-    dag->latnode_alloc = listelem_alloc_init(sizeof(ps_latnode_t));
-    dag->latlink_alloc = listelem_alloc_init(sizeof(ps_latlink_t));
-    dag->latlink_list_alloc = listelem_alloc_init(sizeof(latlink_list_t));
     dag->refcount = 1;
     return dag;
 }
@@ -670,11 +664,9 @@ ps_lattice_free(ps_lattice_t *dag)
         return dag->refcount;
     logmath_free(dag->lmath);
     dict_free(dag->dict);
-    listelem_alloc_free(dag->latnode_alloc);
-    listelem_alloc_free(dag->latlink_alloc);
-    listelem_alloc_free(dag->latlink_list_alloc);    
     ckd_free(dag->hyp_str);
-    ckd_free(dag);
+    /* Along with the DAG itself, unless the utterance is still on. */
+    arena_free(dag->arena);
     return 0;
 }
 
@@ -970,10 +962,7 @@ ps_lattice_link2itor(ps_seg_t *seg, ps_latlink_t *link, int to)
 static void
 ps_lattice_seg_free(ps_seg_t *seg)
 {
-    dag_seg_t *itor = (dag_seg_t *)seg;
-    
-    ckd_free(itor->links);
-    ckd_free(itor);
+    ps_seg_release(seg);
 }
 
 static ps_seg_t *
@@ -1012,7 +1001,7 @@ ps_lattice_seg_iter(ps_lattice_t *dag, ps_latlink_t *link, float32 lwf)
     /* Calling this an "iterator" is a bit of a misnomer since we have
      * to get the entire backtrace in order to produce it.
      */
-    itor = ckd_calloc(1, sizeof(*itor));
+    itor = (dag_seg_t *)ps_seg_alloc(dag->arena, sizeof(*itor));
     itor->base.vt = &ps_lattice_segfuncs;
     itor->base.search = dag->search;
     itor->base.lwf = lwf;
@@ -1023,11 +1012,11 @@ ps_lattice_seg_iter(ps_lattice_t *dag, ps_latlink_t *link, float32 lwf)
         ++itor->n_links;
     }
     if (itor->n_links == 0) {
-        ckd_free(itor);
+        ps_seg_release((ps_seg_t *)itor);
         return NULL;
     }
 
-    itor->links = ckd_calloc(itor->n_links, sizeof(*itor->links));
+    itor->links = arena_calloc(dag->arena, itor->n_links, sizeof(*itor->links));
     cur = itor->n_links - 1;
     for (l = link; l; l = l->best_prev) {
         itor->links[cur] = l;
@@ -1043,13 +1032,25 @@ latlink_list_new(ps_lattice_t *dag, ps_latlink_t *link, latlink_list_t *next)
 {
     latlink_list_t *ll;
 
-    ll = listelem_malloc(dag->latlink_list_alloc);
+    if (dag->spare_lists) {
+        ll = dag->spare_lists;
+        dag->spare_lists = ll->next;
+    }
+    else
+        ll = arena_calloc(dag->arena, 1, sizeof(*ll));
     ll->link = link;
     ll->next = next;
 
     return ll;
 }
 
+void
+latlink_list_free(ps_lattice_t *dag, latlink_list_t *ll)
+{
+    ll->next = dag->spare_lists;
+    dag->spare_lists = ll;
+}
+
 void
 ps_lattice_pushq(ps_lattice_t *dag, ps_latlink_t *link)
 {
@@ -1072,7 +1073,7 @@ ps_lattice_popq(ps_lattice_t *dag)
         return NULL;
     link = dag->q_head->link;
     x = dag->q_head->next;
-    listelem_free(dag->latlink_list_alloc, dag->q_head);
+    latlink_list_free(dag, dag->q_head);
     dag->q_head = x;
     if (dag->q_head == NULL)
         dag->q_tail = NULL;
@@ -1442,6 +1443,31 @@ ps_lattice_joint(ps_lattice_t *dag, ps_latlink_t *link, float32 ascale)
     return jprob;
 }
 
+/*
+ * Sum of the backward probabilities of the links leaving a node,
+ * adding the two halves of the array until one is left, so that
+ * logmath_add_array() can add several at a time.
+ */
+static int32
+ps_lattice_exit_beta(logmath_t *lmath, ps_latnode_t *node, float32 ascale,
+                     int *beta)
+{
+    latlink_list_t *x;
+    size_t n;
+
+    n = 0;
+    for (x = node->exits; x; x = x->next)
+        beta[n++] = x->link->beta + (x->link->ascr << SENSCR_SHIFT) * ascale;
+    if (n == 0)
+        return logmath_get_zero(lmath);
+    while (n > 1) {
+        size_t half = n / 2;
+        logmath_add_array(lmath, beta, beta + n - half, half);
+        n -= half;
+    }
+    return beta[0];
+}
+
 int32
 ps_lattice_posterior(ps_lattice_t *dag, ngram_model_t *lmset,
                      float32 ascale)
@@ -1451,16 +1477,29 @@ ps_lattice_posterior(ps_lattice_t *dag, ngram_model_t *lmset,
     ps_latlink_t *link;
     latlink_list_t *x;
     ps_latlink_t *bestend;
-    int32 bestescr;
+    int32 bestescr, n_exits;
+    int *exit_beta;
 
     lmath = dag->lmath;
 
     /* Reset all betas to zero. */
+    n_exits = 0;
     for (node = dag->nodes; node; node = node->next) {
+        int32 n = 0;
         for (x = node->exits; x; x = x->next) {
             x->link->beta = logmath_get_zero(lmath);
+            ++n;
         }
+        node->exit_beta = MAX_NEG_INT32;
+        if (n > n_exits)
+            n_exits = n;
     }
+    /* With a compact log-add table, which is approximate anyway, the
+     * outgoing betas of a node are summed once for all the links
+     * entering it, rather than once per link. */
+    exit_beta = NULL;
+    if (logmath_is_compact(lmath))
+        exit_beta = ckd_calloc(n_exits + 1, sizeof(*exit_beta));
 
     bestend = NULL;
     bestescr = MAX_NEG_INT32;
@@ -1506,6 +1545,13 @@ ps_lattice_posterior(ps_lattice_t *dag, ngram_model_t *lmset,
             /* Imaginary exit link from final node has beta = 1.0 */
             link->beta = bprob + (dag->final_node_ascr << SENSCR_SHIFT) * ascale;
         }
+        else if (exit_beta) {
+            if (link->to->exit_beta == MAX_NEG_INT32)
+                link->to->exit_beta = ps_lattice_exit_beta(lmath, link->to,
+                                                           ascale, exit_beta);
+            link->beta = logmath_add(lmath, link->beta,
+                                     link->to->exit_beta + bprob);
+        }
         else {
             /* Update beta from all outgoing betas. */
             for (x = link->to->exits; x; x = x->next) {
@@ -1515,6 +1561,7 @@ ps_lattice_posterior(ps_lattice_t *dag, ngram_model_t *lmset,
             }
         }
     }
+    ckd_free(exit_beta);
 
     /* Return P(S|O) = P(O,S)/P(O) */
     return ps_lattice_joint(dag, bestend, ascale) - dag->norm;
@@ -1535,7 +1582,7 @@ ps_lattice_posterior_prune(ps_lattice_t *dag, int32 beam)
             for (x = link->from->exits; x; x = next) {
                 next = x->next;
                 if (x->link == link) {
-                    listelem_free(dag->latlink_list_alloc, x);
+                    latlink_list_free(dag, x);
                 }
                 else {
                     x->next = tmp;
@@ -1547,7 +1594,7 @@ ps_lattice_posterior_prune(ps_lattice_t *dag, int32 beam)
             for (x = link->to->entries; x; x = next) {
                 next = x->next;
                 if (x->link == link) {
-                    listelem_free(dag->latlink_list_alloc, x);
+                    latlink_list_free(dag, x);
                 }
                 else {
                     x->next = tmp;
@@ -1555,7 +1602,6 @@ ps_lattice_posterior_prune(ps_lattice_t *dag, int32 beam)
                 }
             }
             link->to->entries = tmp;
-            listelem_free(dag->latlink_alloc, link);
             ++npruned;
         }
     }
@@ -1867,9 +1913,7 @@ ps_astar_node2itor(astar_seg_t *itor)
 static void
 ps_astar_seg_free(ps_seg_t *seg)
 {
-    astar_seg_t *itor = (astar_seg_t *)seg;
-    ckd_free(itor->nodes);
-    ckd_free(itor);
+    ps_seg_release(seg);
 }
 
 static ps_seg_t *
@@ -1902,7 +1946,7 @@ ps_astar_seg_iter(ps_astar_t *astar, ps_latpath_t *path, float32 lwf)
     int cur;
 
     /* Backtrace and make an iterator, this should look familiar by now. */
-    itor = ckd_calloc(1, sizeof(*itor));
+    itor = (astar_seg_t *)ps_seg_alloc(astar->dag->arena, sizeof(*itor));
     itor->base.vt = &ps_astar_segfuncs;
     itor->base.search = astar->dag->search;
     itor->base.lwf = lwf;
@@ -1910,7 +1954,7 @@ ps_astar_seg_iter(ps_astar_t *astar, ps_latpath_t *path, float32 lwf)
     for (p = path; p; p = p->parent) {
         ++itor->n_nodes;
     }
-    itor->nodes = ckd_calloc(itor->n_nodes, sizeof(*itor->nodes));
+    itor->nodes = arena_calloc(astar->dag->arena, itor->n_nodes, sizeof(*itor->nodes));
     cur = itor->n_nodes - 1;
     for (p = path; p; p = p->parent) {
         itor->nodes[cur] = p->node;
@@ -77,9 +77,8 @@ struct ps_lattice_s {
     int32 norm;        /**< Normalizer for posterior probabilities. */
     char *hyp_str;     /**< Current hypothesis string. */
 
-    listelem_alloc_t *latnode_alloc;     /**< Node allocator for this DAG. */
-    listelem_alloc_t *latlink_alloc;     /**< Link allocator for this DAG. */
-    listelem_alloc_t *latlink_list_alloc; /**< List element allocator for this DAG. */
+    arena_t *arena;    /**< Arena the DAG, its nodes and links are drawn from. */
+    latlink_list_t *spare_lists; /**< List elements released, to reuse first. */
 
     /* This will probably be replaced with a heap. */
     latlink_list_t *q_head; /**< Queue of links for traversal. */
@@ -120,6 +119,7 @@ struct ps_latnode_s {
     frame_idx_t sf;			/**< Start frame */
     int16 reachable;		/**< From \verbatim </s> \endverbatim or \verbatim <s> \endverbatim */
     int32 node_id;		/**< Node from fsg model, used to map lattice back to model */
+    int32 exit_beta;            /**< Sum of the backward probabilities of the exits (compact log-add only) */
     union {
         glist_t velist;         /**< List of history entries with different lmstate (tst only) */
 	int32 fanin;		/**< Number nodes with links to this node */
@@ -230,6 +230,11 @@ void ps_lattice_delq(ps_lattice_t *dag);
 latlink_list_t *latlink_list_new(ps_lattice_t *dag, ps_latlink_t *link,
                                  latlink_list_t *next);
 
+/**
+ * Release a lattice link element, to be reused by latlink_list_new().
+ */
+void latlink_list_free(ps_lattice_t *dag, latlink_list_t *ll);
+
 /**
  * Get hypothesis string after bestpath search.
  */
@@ -64,7 +64,8 @@ static ps_mgaufuncs_t ptm_mgau_funcs = {
     "ptm",
     ptm_mgau_frame_eval,      /* frame_eval */
     ptm_mgau_mllr_transform,  /* transform */
-    ptm_mgau_free             /* free */
+    ptm_mgau_free,            /* free */
+    ptm_mgau_frame_eval_block /* frame_eval_block */
 };
 
 #define COMPUTE_GMM_MAP(_idx)                           \
@@ -91,12 +92,12 @@ insertion_sort_topn(ptm_topn_t *topn, int i, int32 d)
 }
 
 static int
-eval_topn(ptm_mgau_t *s, int cb, int feat, mfcc_t *z)
+eval_topn(ptm_mgau_t *s, ptm_fast_eval_t *f, int cb, int feat, mfcc_t *z)
 {
     ptm_topn_t *topn;
     int i, ceplen;
 
-    topn = s->f->topn[cb][feat];
+    topn = f->topn[cb][feat];
     ceplen = s->g->featlen[feat];
 
     for (i = 0; i < s->max_topn; i++) {
@@ -151,15 +152,57 @@ insertion_sort_cb(ptm_topn_t **cur, ptm_topn_t *worst, ptm_topn_t *best,
     (*cur)->score = intd;
 }
 
+/* Same as eval_cb() below, a block of codewords at a time. */
 static int
-eval_cb(ptm_mgau_t *s, int cb, int feat, mfcc_t *z)
+eval_cb_simd(ptm_mgau_t *s, ptm_fast_eval_t *f, int cb, int feat, mfcc_t *z)
+{
+    ptm_topn_t *worst, *best, *topn;
+    mgau_simd_cb_t *simd_cb;
+    int32 block, i, j;
+
+    best = topn = f->topn[cb][feat];
+    worst = topn + (s->max_topn - 1);
+    simd_cb = s->simd_cb[cb * s->g->n_feat + feat];
+
+    for (block = 0; block < simd_cb->n_block; ++block) {
+        mfcc_t d[MGAU_SIMD_BLOCK];
+
+        if (!s->simd_eval(simd_cb, block, z, (mfcc_t) worst->score, d))
+            continue;
+        for (j = 0; j < MGAU_SIMD_BLOCK; ++j) {
+            ptm_topn_t *cur;
+            int32 cw = block * MGAU_SIMD_BLOCK + j;
+
+            if (cw >= simd_cb->n_density)
+                break;
+            if (d[j] < (mfcc_t) worst->score)
+                continue;
+            for (i = 0; i < s->max_topn; i++) {
+                /* already there, so don't need to insert */
+                if (topn[i].cw == cw)
+                    break;
+            }
+            if (i < s->max_topn)
+                continue;       /* already there.  Don't insert */
+            insertion_sort_cb(&cur, worst, best, cw, (int32)d[j]);
+        }
+    }
+
+    return best->score;
+}
+
+static int
+eval_cb(ptm_mgau_t *s, ptm_fast_eval_t *f, int cb, int feat, mfcc_t *z)
 {
     ptm_topn_t *worst, *best, *topn;
     mfcc_t *mean;
     mfcc_t *var, *det, *detP, *detE;
     int32 i, ceplen;
 
-    best = topn = s->f->topn[cb][feat];
+    if (s->simd_eval)
+        return eval_cb_simd(s, f, cb, feat, z);
+
+    best = topn = f->topn[cb][feat];
     worst = topn + (s->max_topn - 1);
     mean = s->g->mean[cb][feat][0];
     var = s->g->var[cb][feat][0];
@@ -226,31 +269,73 @@ eval_cb(ptm_mgau_t *s, int cb, int feat, mfcc_t *z)
 }
 
 /**
- * Compute top-N densities for active codebooks (and prune)
+ * Arguments of the evaluation of a frame, shared by all the threads.
  */
-static int
-ptm_mgau_codebook_eval(ptm_mgau_t *s, mfcc_t **z, int frame)
+typedef struct ptm_mgau_job_s {
+    ptm_mgau_t *s;
+    mfcc_t ***z;        /**< Features of each frame. */
+    int frame;          /**< First frame. */
+    int n_frame;        /**< Number of frames whose densities are computed. */
+    int16 *senone_scores;
+    uint8 *senone_active;
+    int32 n_senone_active;
+    int compall;
+} ptm_mgau_job_t;
+
+static ptm_fast_eval_t *
+ptm_mgau_hist(ptm_mgau_t *s, int frame)
 {
-    int i, j;
-
-    /* First evaluate top-N from previous frame. */
-    for (i = 0; i < s->g->n_mgau; ++i)
-        for (j = 0; j < s->g->n_feat; ++j)
-            eval_topn(s, i, j, z[j]);
+    /* Find the appropriate frame in the rotating history buffer
+     * corresponding to the requested input frame.  No bounds checking
+     * is done here, which just means you'll get semi-random crap if
+     * you request a frame in the future or one that's too far in the
+     * past.  Since the history buffer is just used for fast match
+     * that might not be fatal. */
+    return s->hist + (frame + s->n_fast_hist) % s->n_fast_hist;
+}
 
-    /* If frame downsampling is in effect, possibly do nothing else. */
-    if (frame % s->ds_ratio)
-        return 0;
+/**
+ * Compute top-N densities for active codebooks (and prune)
+ *
+ * Every thread takes one codebook out of n_worker, they only write
+ * their own top-N.  The frames of a block are evaluated one after the
+ * other for each codebook, while its parameters are in the cache.
+ */
+static void
+ptm_mgau_codebook_eval(void *arg, int32 worker, int32 n_worker)
+{
+    ptm_mgau_job_t *job = (ptm_mgau_job_t *)arg;
+    ptm_mgau_t *s = job->s;
+    int i, j, k;
+
+    for (i = worker; i < s->g->n_mgau; i += n_worker) {
+        for (k = 0; k < job->n_frame; ++k) {
+            ptm_fast_eval_t *f = ptm_mgau_hist(s, job->frame + k);
+            ptm_fast_eval_t *lastf = ptm_mgau_hist(s, job->frame + k - 1);
+            mfcc_t **z = job->z[k];
+
+            /* Get the previous frame's top-N information (on the
+             * first frame of the input this is just all WORST_DIST,
+             * no harm in that) */
+            memcpy(f->topn[i][0], lastf->topn[i][0],
+                   s->g->n_feat * s->max_topn * sizeof(ptm_topn_t));
+
+            /* First evaluate top-N from previous frame. */
+            for (j = 0; j < s->g->n_feat; ++j)
+                eval_topn(s, f, i, j, z[j]);
+
+            /* If frame downsampling is in effect, possibly do nothing else. */
+            if ((job->frame + k) % s->ds_ratio)
+                continue;
 
-    /* Evaluate remaining codebooks. */
-    for (i = 0; i < s->g->n_mgau; ++i) {
-        if (bitvec_is_clear(s->f->mgau_active, i))
-            continue;
-        for (j = 0; j < s->g->n_feat; ++j) {
-            eval_cb(s, i, j, z[j]);
+            /* Evaluate remaining codebooks. */
+            if (bitvec_is_clear(f->mgau_active, i))
+                continue;
+            for (j = 0; j < s->g->n_feat; ++j) {
+                eval_cb(s, f, i, j, z[j]);
+            }
         }
     }
-    return 0;
 }
 
 /**
@@ -320,37 +405,24 @@ ptm_mgau_calc_cb_active(ptm_mgau_t *s, uint8 *senone_active,
 }
 
 /**
- * Compute senone scores from top-N densities for active codebooks.
+ * Give the senones of pruned codebooks the worst scores.
+ *
+ * With -compallsen no codebook is pruned.
  */
-static int
-ptm_mgau_senone_eval(ptm_mgau_t *s, int16 *senone_scores,
-                     uint8 *senone_active, int32 n_senone_active,
-                     int compall)
+static void
+ptm_mgau_clear_inactive(ptm_mgau_t *s, uint8 *senone_active,
+                        int32 n_senone_active)
 {
-    int i, lastsen, bestscore;
+    int i, lastsen;
 
-    memset(senone_scores, 0, s->n_sen * sizeof(*senone_scores));
-    /* FIXME: This is the non-cache-efficient way to do this.  We want
-     * to evaluate one codeword at a time but this requires us to have
-     * a reverse codebook to senone mapping, which we don't have
-     * (yet), since different codebooks have different top-N
-     * codewords. */
-    if (compall)
-        n_senone_active = s->n_sen;
-    bestscore = 0x7fffffff;
     for (lastsen = i = 0; i < n_senone_active; ++i) {
-        int sen, f, cb;
-        int ascore;
+        int sen, f, j, cb;
 
-        if (compall)
-            sen = i;
-        else
-            sen = senone_active[i] + lastsen;
+        sen = senone_active[i] + lastsen;
         lastsen = sen;
         cb = s->sen2cb[sen];
 
         if (bitvec_is_clear(s->f->mgau_active, cb)) {
-            int j;
             /* Because senone_active is deltas we can't really "knock
              * out" senones from pruned codebooks, and in any case,
              * it wouldn't make any difference to the search code,
@@ -361,6 +433,52 @@ ptm_mgau_senone_eval(ptm_mgau_t *s, int16 *senone_scores,
                 }
             }
         }
+    }
+}
+
+/**
+ * Compute senone scores from top-N densities for active codebooks.
+ *
+ * Every thread scores a contiguous range of senone IDs and keeps the
+ * best score of its range in s->team_best.
+ */
+static void
+ptm_mgau_senone_eval(void *arg, int32 worker, int32 n_worker)
+{
+    ptm_mgau_job_t *job = (ptm_mgau_job_t *)arg;
+    ptm_mgau_t *s = job->s;
+    int16 *senone_scores = job->senone_scores;
+    int32 n_senone_active;
+    int i, lastsen, bestscore, first, last;
+
+    first = (int)((int64)s->n_sen * worker / n_worker);
+    last = (int)((int64)s->n_sen * (worker + 1) / n_worker);
+    memset(senone_scores + first, 0, (last - first) * sizeof(*senone_scores));
+    /* FIXME: This is the non-cache-efficient way to do this.  We want
+     * to evaluate one codeword at a time but this requires us to have
+     * a reverse codebook to senone mapping, which we don't have
+     * (yet), since different codebooks have different top-N
+     * codewords. */
+    if (job->compall)
+        n_senone_active = last;
+    else
+        n_senone_active = job->n_senone_active;
+    bestscore = 0x7fffffff;
+    for (lastsen = 0, i = job->compall ? first : 0; i < n_senone_active; ++i) {
+        int sen, f, cb;
+        int ascore;
+
+        if (job->compall)
+            sen = i;
+        else
+            sen = job->senone_active[i] + lastsen;
+        lastsen = sen;
+        if (sen < first)
+            continue;
+        if (sen >= last)
+            break;
+        cb = s->sen2cb[sen];
+
         /* For each feature, log-sum codeword scores + mixw to get
          * feature density, then sum (multiply) to get ascore */
         ascore = 0;
@@ -392,13 +510,7 @@ ptm_mgau_senone_eval(ptm_mgau_t *s, int16 *senone_scores,
         if (ascore < bestscore) bestscore = ascore;
         senone_scores[sen] = ascore;
     }
-    /* Normalize the scores again (finishing the job we started above
-     * in ptm_mgau_codebook_eval...) */
-    for (i = 0; i < s->n_sen; ++i) {
-        senone_scores[i] -= bestscore;
-    }
-
-    return 0;
+    s->team_best[worker] = bestscore;
 }
 
 /**
@@ -413,41 +525,78 @@ ptm_mgau_frame_eval(ps_mgau_t *ps,
                     int32 compallsen)
 {
     ptm_mgau_t *s = (ptm_mgau_t *)ps;
-    int fast_eval_idx;
-
-    /* Find the appropriate frame in the rotating history buffer
-     * corresponding to the requested input frame.  No bounds checking
-     * is done here, which just means you'll get semi-random crap if
-     * you request a frame in the future or one that's too far in the
-     * past.  Since the history buffer is just used for fast match
-     * that might not be fatal. */
-    fast_eval_idx = frame % s->n_fast_hist;
-    s->f = s->hist + fast_eval_idx;
+    ptm_mgau_job_t job;
+    int bestscore, i;
+
+    job.s = s;
+    job.z = &featbuf;
+    job.frame = frame;
+    job.n_frame = 1;
+    job.senone_scores = senone_scores;
+    job.senone_active = senone_active;
+    job.n_senone_active = n_senone_active;
+    job.compall = compallsen;
+
+    s->f = ptm_mgau_hist(s, frame);
     /* Compute the top-N codewords for every codebook, unless this
      * is a past frame, in which case we already have them (we
-     * hope!) */
-    if (frame >= ps_mgau_base(ps)->frame_idx) {
-        ptm_fast_eval_t *lastf;
-        /* Get the previous frame's top-N information (on the
-         * first frame of the input this is just all WORST_DIST,
-         * no harm in that) */
-        if (fast_eval_idx == 0)
-            lastf = s->hist + s->n_fast_hist - 1;
-        else
-            lastf = s->hist + fast_eval_idx - 1;
-        /* Copy in initial top-N info */
-        memcpy(s->f->topn[0][0], lastf->topn[0][0],
-               s->g->n_mgau * s->g->n_feat * s->max_topn * sizeof(ptm_topn_t));
+     * hope!), or they were computed ahead with the frames after the
+     * last one scored. */
+    if (frame >= ps_mgau_base(ps)->frame_idx
+        && frame >= ps_mgau_base(ps)->block_end) {
         /* Generate initial active codebook list (this might not be
          * necessary) */
         ptm_mgau_calc_cb_active(s, senone_active, n_senone_active, compallsen);
         /* Now evaluate top-N, prune, and evaluate remaining codebooks. */
-        ptm_mgau_codebook_eval(s, featbuf, frame);
+        mgau_team_run(s->team, ptm_mgau_codebook_eval, &job);
         ptm_mgau_codebook_norm(s, featbuf, frame);
     }
     /* Evaluate intersection of active senones and active codebooks. */
-    ptm_mgau_senone_eval(s, senone_scores, senone_active,
-                         n_senone_active, compallsen);
+    if (!compallsen)
+        ptm_mgau_clear_inactive(s, senone_active, n_senone_active);
+    mgau_team_run(s->team, ptm_mgau_senone_eval, &job);
+
+    /* Normalize the scores again (finishing the job we started above
+     * in ptm_mgau_codebook_eval...) */
+    bestscore = s->team_best[0];
+    for (i = 1; i < mgau_team_size(s->team); ++i)
+        if (s->team_best[i] < bestscore)
+            bestscore = s->team_best[i];
+    for (i = 0; i < s->n_sen; ++i) {
+        senone_scores[i] -= bestscore;
+    }
+
+    return 0;
+}
+
+/**
+ * Compute the top-N codewords of every codebook in a block of frames
+ * ahead of their senone scores.  The active senones of these frames
+ * aren't known yet, so no codebook is pruned.
+ */
+int32
+ptm_mgau_frame_eval_block(ps_mgau_t *ps,
+                          mfcc_t *** featbuf, int32 frame,
+                          int32 n_frame)
+{
+    ptm_mgau_t *s = (ptm_mgau_t *)ps;
+    ptm_mgau_job_t job;
+    int k;
+
+    memset(&job, 0, sizeof(job));
+    job.s = s;
+    job.z = featbuf;
+    job.frame = frame;
+    job.n_frame = n_frame;
+
+    for (k = 0; k < n_frame; ++k)
+        bitvec_set_all(ptm_mgau_hist(s, frame + k)->mgau_active,
+                       s->g->n_mgau);
+    mgau_team_run(s->team, ptm_mgau_codebook_eval, &job);
+    for (k = 0; k < n_frame; ++k) {
+        s->f = ptm_mgau_hist(s, frame + k);
+        ptm_mgau_codebook_norm(s, featbuf[k], frame + k);
+    }
 
     return 0;
 }
@@ -836,6 +985,26 @@ ptm_mgau_init(acmod_t *acmod, bin_mdef_t *mdef)
     s->max_topn = cmd_ln_int32_r(s->config, "-topn");
     E_INFO("Maximum top-N: %d\n", s->max_topn);
 
+    /* Transposed codebooks for the vectorised evaluation. */
+    {
+        mgau_simd_t simd;
+
+        s->simd_eval = mgau_simd_init(s->config, &simd);
+        E_INFO("Gaussian evaluation instruction set: %s\n", mgau_simd_name(simd));
+        if (s->simd_eval) {
+            s->simd_cb = ckd_calloc(s->g->n_mgau * s->g->n_feat, sizeof(*s->simd_cb));
+            for (i = 0; i < s->g->n_mgau * s->g->n_feat; ++i)
+                s->simd_cb[i] = mgau_simd_cb_init(s->g, i / s->g->n_feat,
+                                                  i % s->g->n_feat);
+        }
+    }
+
+    /* Threads sharing the evaluation of every frame. */
+    s->team = mgau_team_init(s->config);
+    s->team_best = ckd_calloc(mgau_team_size(s->team), sizeof(*s->team_best));
+    if (s->team)
+        E_INFO("Scoring senones in %d threads\n", mgau_team_size(s->team));
+
     /* Assume mapping of senones to their base phones, though this
      * will become more flexible in the future. */
     s->sen2cb = ckd_calloc(s->n_sen, sizeof(*s->sen2cb));
@@ -844,8 +1013,11 @@ ptm_mgau_init(acmod_t *acmod, bin_mdef_t *mdef)
 
     /* Allocate fast-match history buffers.  We need enough for the
      * phoneme lookahead window, plus the current frame, plus one for
-     * good measure? (FIXME: I don't remember why) */
+     * good measure? (FIXME: I don't remember why), plus the frames
+     * computed ahead with -frame_block. */
     s->n_fast_hist = cmd_ln_int32_r(s->config, "-pl_window") + 2;
+    if (cmd_ln_int32_r(s->config, "-frame_block") > 1)
+        s->n_fast_hist += cmd_ln_int32_r(s->config, "-frame_block");
     s->hist = ckd_calloc(s->n_fast_hist, sizeof(*s->hist));
     /* s->f will be a rotating pointer into s->hist. */
     s->f = s->hist;
@@ -883,7 +1055,15 @@ ptm_mgau_mllr_transform(ps_mgau_t *ps,
                             ps_mllr_t *mllr)
 {
     ptm_mgau_t *s = (ptm_mgau_t *)ps;
-    return gauden_mllr_transform(s->g, mllr, s->config);
+    int i, rv;
+
+    rv = gauden_mllr_transform(s->g, mllr, s->config);
+    if (s->simd_cb) {
+        for (i = 0; i < s->g->n_mgau * s->g->n_feat; ++i)
+            mgau_simd_cb_update(s->simd_cb[i], s->g, i / s->g->n_feat,
+                                i % s->g->n_feat);
+    }
+    return rv;
 }
 
 void
@@ -908,6 +1088,14 @@ ptm_mgau_free(ps_mgau_t *ps)
 	bitvec_free(s->hist[i].mgau_active);
     }
     ckd_free(s->hist);
+
+    if (s->simd_cb) {
+        for (i = 0; i < s->g->n_mgau * s->g->n_feat; i++)
+            mgau_simd_cb_free(s->simd_cb[i]);
+        ckd_free(s->simd_cb);
+    }
+    mgau_team_free(s->team);
+    ckd_free(s->team_best);
     
     gauden_free(s->g);
     ckd_free(s);
@@ -52,6 +52,8 @@
 #include "hmm.h"
 #include "bin_mdef.h"
 #include "ms_gauden.h"
+#include "mgau_simd.h"
+#include "mgau_team.h"
 
 typedef struct ptm_mgau_s ptm_mgau_t;
 
@@ -77,6 +79,12 @@ struct ptm_mgau_s {
     int16 max_topn;
     int16 ds_ratio;
 
+    mgau_simd_eval_t simd_eval; /**< Vectorised evaluation, NULL if none. */
+    mgau_simd_cb_t **simd_cb;   /**< Transposed codebooks (mgau x feature) */
+
+    mgau_team_t *team;       /**< Threads sharing each frame, NULL if none. */
+    int32 *team_best;        /**< Best senone score found by each thread. */
+
     ptm_fast_eval_t *hist;   /**< Fast evaluation info for past frames. */
     ptm_fast_eval_t *f;      /**< Fast eval info for current frame. */
     int n_fast_hist;         /**< Number of past frames tracked. */
@@ -96,6 +104,10 @@ int ptm_mgau_frame_eval(ps_mgau_t *s,
                         mfcc_t **featbuf,
                         int32 frame,
                         int32 compallsen);
+int ptm_mgau_frame_eval_block(ps_mgau_t *s,
+                              mfcc_t ***featbuf,
+                              int32 frame,
+                              int32 n_frame);
 int ptm_mgau_mllr_transform(ps_mgau_t *s,
                             ps_mllr_t *mllr);
 
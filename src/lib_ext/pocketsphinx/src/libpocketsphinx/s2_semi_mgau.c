@@ -64,7 +64,8 @@ static ps_mgaufuncs_t s2_semi_mgau_funcs = {
     "s2_semi",
     s2_semi_mgau_frame_eval,      /* frame_eval */
     s2_semi_mgau_mllr_transform,  /* transform */
-    s2_semi_mgau_free             /* free */
+    s2_semi_mgau_free,            /* free */
+    NULL                          /* frame_eval_block */
 };
 
 struct vqFeature_s {
@@ -111,6 +112,81 @@ eval_topn(s2_semi_mgau_t *s, int32 feat, mfcc_t *z)
     }
 }
 
+/* Whether eval_cb() below gives up on codeword cw before its last
+ * dimension, for scores the vectorised one can't decide alone. */
+static int
+eval_cb_gives_up(s2_semi_mgau_t *s, int32 feat, mfcc_t *z, int32 cw,
+                 int32 worst_score)
+{
+    mfcc_t *mean, *var, *obs, d;
+    int32 j, ceplen;
+
+    ceplen = s->g->featlen[feat];
+    mean = s->g->mean[0][feat][0] + cw * ceplen;
+    var = s->g->var[0][feat][0] + cw * ceplen;
+    d = s->g->det[0][feat][cw];
+    obs = z;
+    for (j = 0; j < ceplen; j++) {
+        mfcc_t diff, sqdiff, compl;
+
+        if (d < worst_score)
+            return TRUE;
+        diff = *obs++ - *mean++;
+        sqdiff = MFCCMUL(diff, diff);
+        compl = MFCCMUL(sqdiff, *var);
+        d = GMMSUB(d, compl);
+        ++var;
+    }
+    return FALSE;
+}
+
+/* Same as eval_cb() below, a block of codewords at a time. */
+static void
+eval_cb_simd(s2_semi_mgau_t *s, int32 feat, mfcc_t *z)
+{
+    vqFeature_t *worst, *best, *topn;
+    mgau_simd_cb_t *simd_cb;
+    int32 block, i, j;
+
+    best = topn = s->f[feat];
+    worst = topn + (s->max_topn - 1);
+    simd_cb = s->simd_cb[feat];
+
+    for (block = 0; block < simd_cb->n_block; ++block) {
+        mfcc_t d[MGAU_SIMD_BLOCK];
+
+        if (!s->simd_eval(simd_cb, block, z, (mfcc_t) worst->score, d))
+            continue;
+        for (j = 0; j < MGAU_SIMD_BLOCK; ++j) {
+            vqFeature_t *cur;
+            int32 cw = block * MGAU_SIMD_BLOCK + j;
+
+            if (cw >= simd_cb->n_density)
+                break;
+            if ((int32)d[j] < worst->score)
+                continue;
+            /* Truncation may round a score just below the worst one
+             * up to it, then it counts only if the loop in eval_cb()
+             * would have got to the end. */
+            if (d[j] < worst->score
+                && eval_cb_gives_up(s, feat, z, cw, worst->score))
+                continue;
+            for (i = 0; i < s->max_topn; i++) {
+                /* already there, so don't need to insert */
+                if (topn[i].codeword == cw)
+                    break;
+            }
+            if (i < s->max_topn)
+                continue;       /* already there.  Don't insert */
+            for (cur = worst - 1; cur >= best && (int32)d[j] >= cur->score; --cur)
+                memcpy(cur + 1, cur, sizeof(vqFeature_t));
+            ++cur;
+            cur->codeword = cw;
+            cur->score = (int32)d[j];
+        }
+    }
+}
+
 static void
 eval_cb(s2_semi_mgau_t *s, int32 feat, mfcc_t *z)
 {
@@ -119,6 +195,11 @@ eval_cb(s2_semi_mgau_t *s, int32 feat, mfcc_t *z)
     mfcc_t *var, *det, *detP, *detE;
     int32 i, ceplen;
 
+    if (s->simd_eval) {
+        eval_cb_simd(s, feat, z);
+        return;
+    }
+
     best = topn = s->f[feat];
     worst = topn + (s->max_topn - 1);
     mean = s->g->mean[0][feat][0];
@@ -1301,6 +1382,19 @@ s2_semi_mgau_init(acmod_t *acmod)
     }
     E_INFOCONT("\n");
 
+    /* Transposed codebook for the vectorised evaluation. */
+    {
+        mgau_simd_t simd;
+
+        s->simd_eval = mgau_simd_init(s->config, &simd);
+        E_INFO("Gaussian evaluation instruction set: %s\n", mgau_simd_name(simd));
+        if (s->simd_eval) {
+            s->simd_cb = ckd_calloc(n_feat, sizeof(*s->simd_cb));
+            for (i = 0; i < n_feat; ++i)
+                s->simd_cb[i] = mgau_simd_cb_init(s->g, 0, i);
+        }
+    }
+
     /* Top-N scores from recent frames */
     s->n_topn_hist = cmd_ln_int32_r(s->config, "-pl_window") + 2;
     s->topn_hist = (vqFeature_t ***)
@@ -1332,7 +1426,14 @@ s2_semi_mgau_mllr_transform(ps_mgau_t *ps,
                             ps_mllr_t *mllr)
 {
     s2_semi_mgau_t *s = (s2_semi_mgau_t *)ps;
-    return gauden_mllr_transform(s->g, mllr, s->config);
+    int i, rv;
+
+    rv = gauden_mllr_transform(s->g, mllr, s->config);
+    if (s->simd_cb) {
+        for (i = 0; i < s->g->n_feat; ++i)
+            mgau_simd_cb_update(s->simd_cb[i], s->g, 0, i);
+    }
+    return rv;
 }
 
 void
@@ -1351,6 +1452,12 @@ s2_semi_mgau_free(ps_mgau_t *ps)
         if (s->mixw_cb)
             ckd_free(s->mixw_cb);
     }
+    if (s->simd_cb) {
+        int i;
+        for (i = 0; i < s->g->n_feat; ++i)
+            mgau_simd_cb_free(s->simd_cb[i]);
+        ckd_free(s->simd_cb);
+    }
     gauden_free(s->g);
     ckd_free(s->topn_beam);
     ckd_free_2d(s->topn_hist_n);
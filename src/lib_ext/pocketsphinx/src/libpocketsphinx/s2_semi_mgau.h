@@ -52,6 +52,7 @@
 #include "hmm.h"
 #include "bin_mdef.h"
 #include "ms_gauden.h"
+#include "mgau_simd.h"
 
 typedef struct vqFeature_s vqFeature_t;
 
@@ -71,6 +72,9 @@ struct s2_semi_mgau_s {
     int16 max_topn;
     int16 ds_ratio;
 
+    mgau_simd_eval_t simd_eval; /**< Vectorised evaluation, NULL if none. */
+    mgau_simd_cb_t **simd_cb;   /**< Transposed codebook, for each feature */
+
     vqFeature_t ***topn_hist; /**< Top-N scores and codewords for past frames. */
     uint8 **topn_hist_n;      /**< Variable top-N for past frames. */
     vqFeature_t **f;          /**< Topn-N for currently scoring frame. */
@@ -45,6 +45,13 @@ static int
 state_align_search_start(ps_search_t *search)
 {
     state_align_search_t *sas = (state_align_search_t *)search;
+    int i;
+
+    /* Clear anything left over from the previous utterance. */
+    for (i = 0; i < sas->n_phones; ++i)
+        hmm_clear(sas->hmms + i);
+    sas->best_score = 0;
+    sas->aligned = FALSE;
 
     /* Activate the initial state. */
     hmm_enter(sas->hmms, 0, 0, 0);
@@ -246,6 +253,7 @@ state_align_search_finish(ps_search_t *search)
             ent->start, last_frame);
     ps_alignment_iter_free(itor);
     ps_alignment_propagate(sas->al);
+    sas->aligned = TRUE;
 
     return 0;
 }
@@ -265,9 +273,152 @@ state_align_search_free(ps_search_t *search)
     ckd_free(sas->hmms);
     ckd_free(sas->tokens);
     hmm_context_free(sas->hmmctx);
+    ps_alignment_free(sas->al);
     ckd_free(sas);
 }
 
+static char const *
+state_align_search_hyp(ps_search_t *search, int32 *out_score)
+{
+    state_align_search_t *sas = (state_align_search_t *)search;
+    dict_t *dict = ps_search_dict(search);
+    ps_alignment_iter_t *itor;
+    size_t len;
+    char *c;
+
+    ckd_free(search->hyp_str);
+    search->hyp_str = NULL;
+    if (!sas->aligned)
+        return NULL;
+
+    len = 0;
+    for (itor = ps_alignment_words(sas->al); itor;
+         itor = ps_alignment_iter_next(itor)) {
+        ps_alignment_entry_t *ent = ps_alignment_iter_get(itor);
+        if (dict_real_word(dict, ent->id.wid))
+            len += strlen(dict_basestr(dict, ent->id.wid)) + 1;
+    }
+    search->hyp_str = ckd_calloc(1, len + 1);
+
+    c = search->hyp_str;
+    for (itor = ps_alignment_words(sas->al); itor;
+         itor = ps_alignment_iter_next(itor)) {
+        ps_alignment_entry_t *ent = ps_alignment_iter_get(itor);
+        if (dict_real_word(dict, ent->id.wid)) {
+            strcpy(c, dict_basestr(dict, ent->id.wid));
+            c += strlen(c);
+            *c++ = ' ';
+        }
+    }
+    if (c > search->hyp_str)
+        *--c = '\0';
+
+    if (out_score)
+        *out_score = hmm_out_score(sas->hmms + sas->n_phones - 1);
+    return search->hyp_str;
+}
+
+static int32
+state_align_search_prob(ps_search_t *search)
+{
+    /* Forced alignment has no competing hypotheses. */
+    return 0;
+}
+
+/**
+ * Segmentation iterator over one level of the alignment.
+ */
+typedef struct state_align_seg_s {
+    ps_seg_t base;
+    ps_alignment_iter_t *itor;
+} state_align_seg_t;
+
+static void
+state_align_search_fill_iter(ps_seg_t *seg)
+{
+    state_align_seg_t *itor = (state_align_seg_t *)seg;
+    state_align_search_t *sas = (state_align_search_t *)seg->search;
+    ps_alignment_entry_t *ent = ps_alignment_iter_get(itor->itor);
+
+    seg->sf = ent->start;
+    seg->ef = ent->start + ent->duration - 1;
+    seg->ascr = ent->score;
+    seg->lscr = 0;
+    seg->lback = 0;
+    seg->prob = 0;
+    if (itor->itor->vec == &sas->al->word)
+        seg->word = dict_wordstr(ps_search_dict(seg->search), ent->id.wid);
+    else
+        seg->word = bin_mdef_ciphone_str(ps_search_acmod(seg->search)->mdef,
+                                         ent->id.pid.cipid);
+}
+
+static void
+state_align_search_seg_free(ps_seg_t *seg)
+{
+    state_align_seg_t *itor = (state_align_seg_t *)seg;
+
+    ps_alignment_iter_free(itor->itor);
+    ps_seg_release(seg);
+}
+
+static ps_seg_t *
+state_align_search_seg_next(ps_seg_t *seg)
+{
+    state_align_seg_t *itor = (state_align_seg_t *)seg;
+
+    /* The alignment iterator frees itself at the end. */
+    itor->itor = ps_alignment_iter_next(itor->itor);
+    if (itor->itor == NULL) {
+        ps_seg_release(seg);
+        return NULL;
+    }
+    state_align_search_fill_iter(seg);
+    return seg;
+}
+
+static ps_segfuncs_t state_align_segfuncs = {
+    /* seg_next */ state_align_search_seg_next,
+    /* seg_free */ state_align_search_seg_free
+};
+
+static ps_seg_t *
+state_align_search_make_iter(ps_search_t *search, ps_alignment_iter_t *al_itor)
+{
+    state_align_seg_t *itor;
+
+    if (al_itor == NULL)
+        return NULL;
+    itor = (state_align_seg_t *)ps_seg_alloc(ps_search_arena(search),
+                                             sizeof(*itor));
+    itor->base.vt = &state_align_segfuncs;
+    itor->base.search = search;
+    itor->base.lwf = 1.0;
+    itor->itor = al_itor;
+    state_align_search_fill_iter((ps_seg_t *)itor);
+    return (ps_seg_t *)itor;
+}
+
+static ps_seg_t *
+state_align_search_seg_iter(ps_search_t *search)
+{
+    state_align_search_t *sas = (state_align_search_t *)search;
+
+    if (!sas->aligned)
+        return NULL;
+    return state_align_search_make_iter(search, ps_alignment_words(sas->al));
+}
+
+ps_seg_t *
+state_align_search_phone_iter(ps_search_t *search)
+{
+    state_align_search_t *sas = (state_align_search_t *)search;
+
+    if (!sas->aligned)
+        return NULL;
+    return state_align_search_make_iter(search, ps_alignment_phones(sas->al));
+}
+
 static ps_searchfuncs_t state_align_search_funcs = {
     /* start: */  state_align_search_start,
     /* step: */   state_align_search_step,
@@ -275,9 +426,9 @@ static ps_searchfuncs_t state_align_search_funcs = {
     /* reinit: */ state_align_search_reinit,
     /* free: */   state_align_search_free,
     /* lattice: */  NULL,
-    /* hyp: */      NULL,
-    /* prob: */     NULL,
-    /* seg_iter: */ NULL,
+    /* hyp: */      state_align_search_hyp,
+    /* prob: */     state_align_search_prob,
+    /* seg_iter: */ state_align_search_seg_iter,
 };
 
 ps_search_t *
@@ -300,7 +451,7 @@ state_align_search_init(const char *name,
         ckd_free(sas);
         return NULL;
     }
-    sas->al = al;
+    sas->al = ps_alignment_retain(al);
 
     /* Generate HMM vector from phone level of alignment. */
     sas->n_phones = ps_alignment_n_phones(al);
@@ -76,6 +76,7 @@ struct state_align_search_s {
     int n_emit_state;       /**< Number of emitting states (tokens per frame) */
     state_align_hist_t *tokens;         /**< Tokens (backpointers) for state alignment. */
     int n_fr_alloc;         /**< Number of frames of tokens allocated. */
+    int aligned;            /**< Whether the alignment holds the result of the last utterance. */
 };
 typedef struct state_align_search_s state_align_search_t;
 
@@ -84,4 +85,9 @@ ps_search_t *state_align_search_init(const char *name,
                                      acmod_t *acmod,
                                      ps_alignment_t *al);
 
+/**
+ * Iterate over the phones of the last alignment, NULL if there is none.
+ */
+ps_seg_t *state_align_search_phone_iter(ps_search_t *search);
+
 #endif /* __STATE_ALIGN_SEARCH_H__ */
@@ -49,6 +49,24 @@ main(int argc, char *argv[])
 	TEST_ASSERT(!dict_real_word(dict, dict_wordid(dict, "</s>")));
 	dict_free(dict);
 
+	/* More distinct (bad) phones than the phone id cache has slots. */
+	{
+		FILE *fh;
+
+		TEST_ASSERT(fh = fopen("_badphones.dic", "w"));
+		for (i = 0; i < 300; i++)
+			fprintf(fh, "bad_%d Q%03d\n", i, i);
+		fprintf(fh, "carnegie K AA R N IH G IY\n");
+		fclose(fh);
+		cmd_ln_set_str_r(config, "-dict", "_badphones.dic");
+		TEST_ASSERT(mdef = bin_mdef_read(NULL, MODELDIR "/en-us/en-us/mdef"));
+		TEST_ASSERT(dict = dict_init(config, mdef));
+		TEST_EQUAL(BAD_S3WID, dict_wordid(dict, "bad_299"));
+		TEST_ASSERT(BAD_S3WID != dict_wordid(dict, "carnegie"));
+		dict_free(dict);
+		bin_mdef_free(mdef);
+	}
+
 	/* Test to add 500k words. */
 	TEST_ASSERT(dict = dict_init(NULL, NULL));
 	for (i = 0; i < 5000; i++) {
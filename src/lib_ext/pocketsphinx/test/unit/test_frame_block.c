@@ -0,0 +1,29 @@
+#include "test_score.c"
+
+int
+main(int argc, char *argv[])
+{
+	char const *frame_blocks[] = { "2", "5", "16" };
+	char const *decode_frame_blocks[] = { "1", "4" };
+	int16 *single, *scores;
+	int32 n_frame, n_sen, block_n_frame, block_n_sen;
+	int i;
+
+	single = score_utt("-frame_block", "1", NULL, NULL, "ptm", &n_frame, &n_sen);
+	for (i = 0; i < 3; ++i) {
+		/* Every codebook is active, the densities are computed
+		 * the same way a block at a time. */
+		scores = score_utt("-frame_block", frame_blocks[i], NULL, NULL, "ptm",
+				   &block_n_frame, &block_n_sen);
+		test_scores_match(single, n_frame, n_sen, scores, block_n_frame, block_n_sen);
+		printf("blocks of %s frames: %d frames, %d senones match\n",
+		       frame_blocks[i], n_frame, n_sen);
+		ckd_free(scores);
+	}
+	ckd_free(single);
+
+	/* Only the active senones, from codebooks evaluated ahead. */
+	test_decode_values("-frame_block", decode_frame_blocks, 2);
+
+	return 0;
+}
@@ -0,0 +1,151 @@
+#include <pocketsphinx.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sphinxbase/ckd_alloc.h>
+
+#include "hmm_simd.h"
+#include "test_macros.h"
+
+#define N_TMAT 4
+#define N_SSID 8
+#define N_SEN 64
+#define N_HMM 203
+
+static uint32 seed = 12345;
+
+static int32
+rand_int(int32 n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % n;
+}
+
+/* A score as found in a search: mostly reasonable, sometimes never
+ * reached, sometimes just above the worst. */
+static int32
+rand_score(void)
+{
+	switch (rand_int(8)) {
+	case 0:
+		return WORST_SCORE;
+	case 1:
+		return WORST_SCORE + rand_int(2000);
+	default:
+		return -rand_int(200000);
+	}
+}
+
+/* Evaluates random HMMs of a topology one frame after another, one at
+ * a time and in batches, which must give the same scores. */
+static void
+compare(int32 n_emit_state, char const *simd)
+{
+	uint8 ***tp;
+	uint16 **sseq;
+	int16 senscore[N_SEN];
+	hmm_context_t *ctx, *batch_ctx;
+	hmm_t *hmm, *batch_hmm;
+	cmd_ln_t *config;
+	int32 i, j, k, frame;
+
+	tp = (uint8 ***) ckd_calloc_3d(N_TMAT, n_emit_state, n_emit_state + 1, 1);
+	for (i = 0; i < N_TMAT; ++i)
+		for (j = 0; j < n_emit_state; ++j)
+			for (k = j; k <= j + 2 && k <= n_emit_state; ++k)
+				tp[i][j][k] = rand_int(4) == 0 ? 255 : rand_int(255);
+	sseq = (uint16 **) ckd_calloc_2d(N_SSID, n_emit_state, sizeof(uint16));
+	for (i = 0; i < N_SSID; ++i)
+		for (j = 0; j < n_emit_state; ++j)
+			sseq[i][j] = rand_int(N_SEN);
+
+	config = cmd_ln_init(NULL, ps_args(), TRUE, "-hmm_simd", simd, NULL);
+	ctx = hmm_context_init(n_emit_state, (uint8 ** const *) tp, senscore, sseq);
+	batch_ctx = hmm_context_init(n_emit_state, (uint8 ** const *) tp, senscore, sseq);
+	hmm_simd_init(batch_ctx, N_TMAT, config);
+	TEST_ASSERT(batch_ctx->batch_eval != NULL);
+
+	hmm = ckd_calloc(N_HMM, sizeof(*hmm));
+	batch_hmm = ckd_calloc(N_HMM, sizeof(*batch_hmm));
+	for (i = 0; i < N_HMM; ++i) {
+		int32 ssid = rand_int(N_SSID), tmatid = rand_int(N_TMAT);
+
+		hmm_init(ctx, &hmm[i], FALSE, ssid, tmatid);
+		hmm_init(batch_ctx, &batch_hmm[i], FALSE, ssid, tmatid);
+	}
+
+	for (frame = 0; frame < 50; ++frame) {
+		hmm_batch_t batch;
+		int32 n_hmm, bestscore, batch_bestscore;
+
+		for (i = 0; i < N_SEN; ++i)
+			senscore[i] = rand_int(8000);
+		/* New scores enter some HMMs, not always enough to fill
+		 * the last batch. */
+		for (i = 0; i < N_HMM; ++i) {
+			if (frame == 0 || rand_int(4) == 0) {
+				int32 score = rand_score(), hist = rand_int(1000);
+
+				for (j = 0; j < n_emit_state; ++j) {
+					hmm[i].score[j] = j == 0 ? score : rand_score();
+					hmm[i].history[j] = hist + j;
+				}
+				hmm[i].out_score = rand_score();
+				hmm[i].out_history = -1;
+				memcpy(batch_hmm[i].score, hmm[i].score, sizeof(hmm[i].score));
+				memcpy(batch_hmm[i].history, hmm[i].history, sizeof(hmm[i].history));
+				batch_hmm[i].out_score = hmm[i].out_score;
+				batch_hmm[i].out_history = hmm[i].out_history;
+			}
+		}
+		n_hmm = 1 + rand_int(N_HMM);
+
+		bestscore = WORST_SCORE;
+		for (i = 0; i < n_hmm; ++i) {
+			int32 score = hmm_vit_eval(&hmm[i]);
+			if (score BETTER_THAN bestscore)
+				bestscore = score;
+		}
+		hmm_batch_init(&batch, batch_ctx);
+		for (i = 0; i < n_hmm; ++i)
+			hmm_batch_add(&batch, &batch_hmm[i]);
+		batch_bestscore = hmm_batch_finish(&batch);
+
+		TEST_EQUAL(bestscore, batch_bestscore);
+		for (i = 0; i < N_HMM; ++i) {
+			TEST_EQUAL(0, memcmp(hmm[i].score, batch_hmm[i].score, sizeof(hmm[i].score)));
+			TEST_EQUAL(0, memcmp(hmm[i].history, batch_hmm[i].history, sizeof(hmm[i].history)));
+			TEST_EQUAL(hmm[i].out_score, batch_hmm[i].out_score);
+			TEST_EQUAL(hmm[i].out_history, batch_hmm[i].out_history);
+			TEST_EQUAL(hmm[i].bestscore, batch_hmm[i].bestscore);
+		}
+	}
+	printf("%s: %d-state HMMs match\n", simd, n_emit_state);
+
+	ckd_free(hmm);
+	ckd_free(batch_hmm);
+	hmm_context_free(ctx);
+	hmm_context_free(batch_ctx);
+	cmd_ln_free_r(config);
+	ckd_free_2d(sseq);
+	ckd_free_3d(tp);
+}
+
+int
+main(int argc, char *argv[])
+{
+	char const *levels[] = { "sse4", "avx2", "avx512" };
+	int i;
+
+	for (i = 0; i < 3; ++i) {
+		/* Skip instruction sets this CPU doesn't have. */
+		if (!mgau_simd_supported((mgau_simd_t)(MGAU_SIMD_SSE4 + i))) {
+			printf("%s: not supported\n", levels[i]);
+			continue;
+		}
+		compare(5, levels[i]);
+		compare(3, levels[i]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,50 @@
+#include "test_score.c"
+#include "mgau_simd.h"
+
+/* Checks the scores of every supported instruction set against portable C. */
+static void
+test_levels(char const *mean, char const *var, char const *mgau)
+{
+	char const *levels[] = { "sse4", "avx2", "avx512" };
+	int16 *portable, *scores;
+	int32 n_frame, n_sen, simd_n_frame, simd_n_sen;
+	int i;
+
+	portable = score_utt("-gmm_simd", "none", mean, var, mgau, &n_frame, &n_sen);
+	for (i = 0; i < 3; ++i) {
+		cmd_ln_t *config;
+		mgau_simd_t simd;
+
+		/* Skip instruction sets this CPU doesn't have. */
+		config = cmd_ln_init(NULL, ps_args(), TRUE,
+				     "-gmm_simd", levels[i], NULL);
+		mgau_simd_init(config, &simd);
+		cmd_ln_free_r(config);
+		if (simd != (mgau_simd_t)(MGAU_SIMD_SSE4 + i)) {
+			printf("%s: not supported\n", levels[i]);
+			continue;
+		}
+
+		/* The same sums are evaluated in the same order. */
+		scores = score_utt("-gmm_simd", levels[i], mean, var, mgau,
+				   &simd_n_frame, &simd_n_sen);
+		test_scores_match(portable, n_frame, n_sen, scores, simd_n_frame, simd_n_sen);
+		printf("%s %s: %d frames, %d senones match\n",
+		       mgau, levels[i], n_frame, n_sen);
+		ckd_free(scores);
+	}
+	ckd_free(portable);
+}
+
+int
+main(int argc, char *argv[])
+{
+	test_levels(NULL, NULL, "ptm");
+
+	/* A single codebook, which is scored by s2_semi instead. */
+	write_first_codebook(MODELDIR "/en-us/en-us/means", "_semi.means");
+	write_first_codebook(MODELDIR "/en-us/en-us/variances", "_semi.variances");
+	test_levels("_semi.means", "_semi.variances", "s2_semi");
+
+	return 0;
+}
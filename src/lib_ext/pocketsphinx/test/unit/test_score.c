@@ -0,0 +1,234 @@
+/*
+ * Fixtures of the tests of the options which change how the senones are
+ * scored but must not change the scores: the scores of every senone, and
+ * a normal decode, in which only the active senones are scored.  Included
+ * by the tests, like test_ps.c.
+ */
+
+#include <pocketsphinx.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sphinxbase/bio.h>
+
+#include "pocketsphinx_internal.h"
+#include "test_macros.h"
+
+#define MAX_SEG 32
+
+int16 *
+read_goforward(size_t *out_nsamps)
+{
+	FILE *rawfh;
+	int16 *buf;
+	size_t nsamps;
+
+	TEST_ASSERT(rawfh = fopen(DATADIR "/goforward.raw", "rb"));
+	fseek(rawfh, 0, SEEK_END);
+	nsamps = ftell(rawfh) / sizeof(*buf);
+	fseek(rawfh, 0, SEEK_SET);
+	buf = ckd_calloc(nsamps, sizeof(*buf));
+	TEST_EQUAL(nsamps, fread(buf, sizeof(*buf), nsamps, rawfh));
+	fclose(rawfh);
+
+	*out_nsamps = nsamps;
+	return buf;
+}
+
+/*
+ * Scores of every senone in every frame of goforward.raw, with the
+ * option name set to value.  The means and variances are those of the
+ * en-us model unless others are given, mgau is the computation module
+ * they have to be scored with.
+ */
+int16 *
+score_utt(char const *name, char const *value, char const *mean,
+	  char const *var, char const *mgau,
+	  int32 *out_n_frame, int32 *out_n_sen)
+{
+	logmath_t *lmath;
+	cmd_ln_t *config;
+	acmod_t *acmod;
+	int16 *buf, *scores;
+	int16 const *bptr;
+	size_t nsamps;
+	int32 n_frame, n_sen;
+
+	lmath = logmath_init(1.0001, 0, 0);
+	config = cmd_ln_init(NULL, ps_args(), TRUE,
+	     "-compallsen", "yes",
+	     name, value,
+	     NULL);
+	cmd_ln_parse_file_r(config, ps_args(), MODELDIR "/en-us/en-us/feat.params", FALSE);
+
+	cmd_ln_set_str_extra_r(config, "_mdef", MODELDIR "/en-us/en-us/mdef");
+	cmd_ln_set_str_extra_r(config, "_mean", mean ? mean : MODELDIR "/en-us/en-us/means");
+	cmd_ln_set_str_extra_r(config, "_var", var ? var : MODELDIR "/en-us/en-us/variances");
+	cmd_ln_set_str_extra_r(config, "_tmat", MODELDIR "/en-us/en-us/transition_matrices");
+	cmd_ln_set_str_extra_r(config, "_sendump", MODELDIR "/en-us/en-us/sendump");
+	cmd_ln_set_str_extra_r(config, "_mixw", NULL);
+	cmd_ln_set_str_extra_r(config, "_lda", NULL);
+	cmd_ln_set_str_extra_r(config, "_senmgau", NULL);
+
+	TEST_ASSERT(config);
+	TEST_ASSERT((acmod = acmod_init(config, lmath, NULL, NULL)));
+	TEST_EQUAL(0, strcmp(acmod->mgau->vt->name, mgau));
+
+	buf = read_goforward(&nsamps);
+	acmod_set_grow(acmod, TRUE);
+	TEST_EQUAL(0, acmod_start_utt(acmod));
+	bptr = buf;
+	acmod_process_raw(acmod, &bptr, &nsamps, TRUE);
+	TEST_EQUAL(0, acmod_end_utt(acmod));
+
+	n_sen = bin_mdef_n_sen(acmod->mdef);
+	scores = ckd_calloc(acmod->n_feat_frame * n_sen, sizeof(*scores));
+	n_frame = 0;
+	while (acmod->n_feat_frame > 0) {
+		memcpy(scores + n_frame * n_sen, acmod_score(acmod, NULL),
+		       n_sen * sizeof(*scores));
+		acmod_advance(acmod);
+		++n_frame;
+	}
+	TEST_ASSERT(n_frame > 0);
+
+	ckd_free(buf);
+	acmod_free(acmod);
+	logmath_free(lmath);
+	cmd_ln_free_r(config);
+
+	*out_n_frame = n_frame;
+	*out_n_sen = n_sen;
+	return scores;
+}
+
+/* Checks that scores are those of reference, frame by frame. */
+void
+test_scores_match(int16 const *reference, int32 n_frame, int32 n_sen,
+		  int16 const *scores, int32 scores_n_frame, int32 scores_n_sen)
+{
+	TEST_EQUAL(n_frame, scores_n_frame);
+	TEST_EQUAL(n_sen, scores_n_sen);
+	TEST_EQUAL(0, memcmp(reference, scores,
+			     n_frame * n_sen * sizeof(*scores)));
+}
+
+/*
+ * Hypothesis of goforward.raw decoded with the turtle language model and
+ * the option name set to value, and the acoustic score of every segment
+ * of it.
+ */
+char *
+decode_utt(char const *name, char const *value,
+	   int32 *ascr, int32 *out_n_seg)
+{
+	cmd_ln_t *config;
+	ps_decoder_t *ps;
+	ps_seg_t *seg;
+	int16 *buf;
+	size_t nsamps;
+	char *hyp;
+	int32 n_seg, lscr, lback;
+
+	TEST_ASSERT(config = cmd_ln_init(NULL, ps_args(), TRUE,
+		"-hmm", MODELDIR "/en-us/en-us",
+		"-lm", DATADIR "/turtle.lm.bin",
+		"-dict", DATADIR "/turtle.dic",
+		name, value,
+		NULL));
+	TEST_ASSERT(ps = ps_init(config));
+
+	buf = read_goforward(&nsamps);
+	TEST_EQUAL(0, ps_start_utt(ps));
+	TEST_ASSERT(ps_process_raw(ps, buf, nsamps, FALSE, TRUE) > 0);
+	TEST_EQUAL(0, ps_end_utt(ps));
+
+	TEST_ASSERT(ps_get_hyp(ps, NULL));
+	hyp = ckd_salloc(ps_get_hyp(ps, NULL));
+	n_seg = 0;
+	for (seg = ps_seg_iter(ps); seg; seg = ps_seg_next(seg)) {
+		if (n_seg == MAX_SEG) {
+			ps_seg_free(seg);
+			break;
+		}
+		ps_seg_prob(seg, &ascr[n_seg++], &lscr, &lback);
+	}
+
+	ckd_free(buf);
+	ps_free(ps);
+	cmd_ln_free_r(config);
+
+	*out_n_seg = n_seg;
+	return hyp;
+}
+
+/*
+ * Checks that a normal decode, in which only the senones of the active
+ * HMMs are scored, gives the same hypothesis and acoustic scores with
+ * every value of name as with the first one.
+ */
+void
+test_decode_values(char const *name, char const * const *values, int n_values)
+{
+	int32 ascr[MAX_SEG], value_ascr[MAX_SEG];
+	int32 n_seg, value_n_seg;
+	char *hyp, *value_hyp;
+	int i;
+
+	hyp = decode_utt(name, values[0], ascr, &n_seg);
+	TEST_ASSERT(n_seg > 0);
+	for (i = 1; i < n_values; ++i) {
+		value_hyp = decode_utt(name, values[i], value_ascr, &value_n_seg);
+		printf("%s %s: %s\n", name, values[i], value_hyp);
+		TEST_EQUAL(0, strcmp(hyp, value_hyp));
+		TEST_EQUAL(n_seg, value_n_seg);
+		TEST_EQUAL(0, memcmp(ascr, value_ascr, n_seg * sizeof(*ascr)));
+		ckd_free(value_hyp);
+	}
+	ckd_free(hyp);
+}
+
+/*
+ * Writes the first codebook of the means or variances of the en-us model
+ * alone, which makes a semi-continuous model of it: the weights of every
+ * senone in the sendump are for as many densities.  Its scores mean
+ * nothing, but they go through the semi-continuous computation.
+ */
+void
+write_first_codebook(char const *infile, char const *outfile)
+{
+	FILE *in, *out;
+	char **argname, **argval;
+	int32 byteswap, n_mgau, n_feat, n_density, veclen[4], n, blk, i;
+	uint32 chksum = 0;
+	float32 *codebook;
+
+	TEST_ASSERT(in = fopen(infile, "rb"));
+	TEST_EQUAL(0, bio_readhdr(in, &argname, &argval, &byteswap));
+	bio_hdrarg_free(argname, argval);
+	TEST_EQUAL(1, bio_fread(&n_mgau, sizeof(int32), 1, in, byteswap, &chksum));
+	TEST_EQUAL(1, bio_fread(&n_feat, sizeof(int32), 1, in, byteswap, &chksum));
+	TEST_EQUAL(1, bio_fread(&n_density, sizeof(int32), 1, in, byteswap, &chksum));
+	TEST_ASSERT(n_feat <= 4);
+	TEST_EQUAL(n_feat, bio_fread(veclen, sizeof(int32), n_feat, in, byteswap, &chksum));
+	TEST_EQUAL(1, bio_fread(&n, sizeof(int32), 1, in, byteswap, &chksum));
+	for (blk = i = 0; i < n_feat; ++i)
+		blk += veclen[i];
+	codebook = ckd_calloc(n_density * blk, sizeof(*codebook));
+	TEST_EQUAL(n_density * blk, bio_fread(codebook, sizeof(float32),
+					      n_density * blk, in, byteswap, &chksum));
+	fclose(in);
+
+	n_mgau = 1;
+	n = n_density * blk;
+	TEST_ASSERT(out = fopen(outfile, "wb"));
+	TEST_EQUAL(0, bio_writehdr(out, "version", "1.0", NULL));
+	TEST_EQUAL(1, fwrite(&n_mgau, sizeof(int32), 1, out));
+	TEST_EQUAL(1, fwrite(&n_feat, sizeof(int32), 1, out));
+	TEST_EQUAL(1, fwrite(&n_density, sizeof(int32), 1, out));
+	TEST_EQUAL(n_feat, fwrite(veclen, sizeof(int32), n_feat, out));
+	TEST_EQUAL(1, fwrite(&n, sizeof(int32), 1, out));
+	TEST_EQUAL(n, fwrite(codebook, sizeof(float32), n, out));
+	fclose(out);
+	ckd_free(codebook);
+}
@@ -0,0 +1,28 @@
+#include "test_score.c"
+
+int
+main(int argc, char *argv[])
+{
+	char const *n_threads[] = { "2", "3", "8" };
+	char const *decode_n_threads[] = { "1", "3", "4" };
+	int16 *single, *scores;
+	int32 n_frame, n_sen, team_n_frame, team_n_sen;
+	int i;
+
+	single = score_utt("-score_threads", "1", NULL, NULL, "ptm", &n_frame, &n_sen);
+	for (i = 0; i < 3; ++i) {
+		/* Every senone is scored by one thread, as it would be alone. */
+		scores = score_utt("-score_threads", n_threads[i], NULL, NULL, "ptm",
+				   &team_n_frame, &team_n_sen);
+		test_scores_match(single, n_frame, n_sen, scores, team_n_frame, team_n_sen);
+		printf("%s threads: %d frames, %d senones match\n",
+		       n_threads[i], n_frame, n_sen);
+		ckd_free(scores);
+	}
+	ckd_free(single);
+
+	/* Only the active senones, split between the threads. */
+	test_decode_values("-score_threads", decode_n_threads, 3);
+
+	return 0;
+}
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include <pocketsphinx.h>
 
 #include "ps_alignment.h"
@@ -110,6 +112,49 @@ main(int argc, char *argv[])
     ps_search_free(search);
     ps_alignment_free(al);
 
+    /* Test alignment through the decoder */
+
+    TEST_EQUAL(-1, ps_set_align(ps, "align", "go forward ten zzyzxmeters"));
+    TEST_EQUAL(0, ps_set_align(ps, "align", "go forward ten meters"));
+    TEST_EQUAL(0, ps_set_search(ps, "align"));
+    {
+        FILE *rawfh;
+        int16 buf[2048];
+        size_t nread;
+        ps_seg_t *seg;
+        char const *words[] = { "<s>", "go", "forward", "ten", "meters", "</s>" };
+        int32 sf, ef, last_ef;
+
+        TEST_ASSERT(rawfh = fopen(DATADIR "/goforward.raw", "rb"));
+        ps_start_stream(ps);
+        TEST_EQUAL(0, ps_start_utt(ps));
+        while (!feof(rawfh)) {
+            nread = fread(buf, sizeof(*buf), 2048, rawfh);
+            ps_process_raw(ps, buf, nread, FALSE, FALSE);
+        }
+        TEST_ASSERT(ps_end_utt(ps) >= 0);
+        fclose(rawfh);
+
+        TEST_EQUAL(0, strcmp("go forward ten meters", ps_get_hyp(ps, NULL)));
+
+        last_ef = -1;
+        for (i = 0, seg = ps_seg_iter(ps); seg; seg = ps_seg_next(seg), ++i) {
+            ps_seg_frames(seg, &sf, &ef);
+            TEST_EQUAL(0, strcmp(words[i], ps_seg_word(seg)));
+            TEST_EQUAL(last_ef + 1, sf);
+            last_ef = ef;
+        }
+        TEST_EQUAL(6, i);
+
+        /* Phones cover the same frames as the words. */
+        TEST_ASSERT(seg = ps_seg_phone_iter(ps));
+        ps_seg_frames(seg, &sf, &ef);
+        TEST_EQUAL(0, sf);
+        for (; seg; seg = ps_seg_next(seg))
+            ps_seg_frames(seg, &sf, &ef);
+        TEST_EQUAL(last_ef, ef);
+    }
+
     ps_free(ps);
     cmd_ln_free_r(config);
     return 0;
@@ -0,0 +1,141 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2026 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+/**
+ * @file arena.h
+ * @brief Region allocator for objects which are all released together.
+ *
+ * An arena hands out memory from large blocks by moving a cursor, and
+ * never releases an object by itself. The decoder draws the objects
+ * of an utterance from one arena (history entries, lattice nodes and
+ * links, segmentation iterators) and releases them at once when the
+ * next utterance starts, keeping the blocks for it, instead of making
+ * a call to malloc() and free() for each of them.
+ *
+ * Arenas are reference counted. An object which outlives the
+ * utterance, such as a lattice the caller retained, holds a reference
+ * to the arena it came from; arena_reset() then leaves that arena to
+ * it and starts a new one.
+ */
+
+#ifndef _LIBUTIL_ARENA_H_
+#define _LIBUTIL_ARENA_H_
+
+#include <stddef.h>
+
+/* Win32/WinCE DLL gunk */
+#include <sphinxbase/sphinxbase_export.h>
+#include <sphinxbase/prim_type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+/* Fool Emacs. */
+}
+#endif
+
+/** Alignment of every allocation, enough for any type. */
+#define ARENA_ALIGN 16
+
+/** Size of the blocks, unless arena_init() is given another one. */
+#define ARENA_DEFAULT_BLKSIZE (64 * 1024)
+
+/**
+ * Arena object.
+ */
+typedef struct arena_s arena_t;
+
+/**
+ * Create an empty arena, with no block until the first allocation.
+ *
+ * @param blksize Size in bytes of the blocks, 0 for
+ * ARENA_DEFAULT_BLKSIZE. Larger allocations get a block of their own.
+ */
+SPHINXBASE_EXPORT
+arena_t *arena_init(size_t blksize);
+
+/**
+ * Retain a reference to an arena.
+ */
+SPHINXBASE_EXPORT
+arena_t *arena_retain(arena_t *a);
+
+/**
+ * Release a reference to an arena, and all its memory with the last
+ * one.
+ *
+ * @return the remaining number of references.
+ */
+SPHINXBASE_EXPORT
+int arena_free(arena_t *a);
+
+/**
+ * Release everything allocated from an arena, keeping its blocks for
+ * the next allocations.
+ *
+ * If something else holds a reference to the arena, its memory is
+ * left to it: the caller's reference is released and a new arena
+ * with the same block size is returned instead.
+ *
+ * @return the arena to allocate from from now on.
+ */
+SPHINXBASE_EXPORT
+arena_t *arena_reset(arena_t *a);
+
+SPHINXBASE_EXPORT
+void *__arena_calloc__(arena_t *a, size_t n_elem, size_t elem_size,
+                       const char *file, int line);
+
+/**
+ * Allocate a zeroed array of n_elem elements of elem_size bytes. It
+ * is released by arena_reset() or arena_free(), never by itself.
+ */
+#define arena_calloc(a, n, sz)	__arena_calloc__((a),(n),(sz),__FILE__,__LINE__)
+
+/**
+ * Number of bytes allocated since the arena was created or reset,
+ * alignment included.
+ */
+SPHINXBASE_EXPORT
+size_t arena_used(arena_t *a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
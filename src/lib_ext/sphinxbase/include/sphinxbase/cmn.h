@@ -110,7 +110,8 @@ extern "C" {
 typedef enum cmn_type_e {
     CMN_NONE = 0,
     CMN_BATCH,
-    CMN_LIVE
+    CMN_LIVE,
+    CMN_FIXED
 } cmn_type_t;
 
 /** String representations of cmn_type_t values. */
@@ -162,6 +163,27 @@ void cmn_live(cmn_t *cmn,        /**< In/Out: cmn normalization, which contains
 	       int32 nfr         /**< Number of incoming frames */
     );
 
+/**
+ * CMN for one block of data, using the current mean without updating
+ * it, e.g. one computed beforehand over a whole recording.
+ */
+SPHINXBASE_EXPORT
+void cmn_fixed(cmn_t *cmn,       /**< In: cmn normalization, with the mean in cmn_mean */
+               mfcc_t **incep,   /**< In/Out: mfc[f] = mfc vector in frame f */
+               int32 nfr         /**< Number of incoming frames */
+    );
+
+/**
+ * Accumulate frames into the sum of a cmn normalization without
+ * normalizing them.  cmn_live_update() then sets the mean to that of
+ * all the frames accumulated.
+ */
+SPHINXBASE_EXPORT
+void cmn_accum(cmn_t *cmn,       /**< In/Out: cmn normalization */
+               mfcc_t **incep,   /**< In: mfc[f] = mfc vector in frame f */
+               int32 nfr         /**< Number of frames */
+    );
+
 /**
  * Update live mean based on observed data
  */
@@ -620,6 +620,33 @@ int fe_mfcc_dct3(fe_t *fe,  /**< A fe structure */
                  mfcc_t *fr_spec /**< One frame of spectrum */
         );
 
+/**
+ * Instruction sets the front end can process frames with.
+ **/
+typedef enum fe_simd_e {
+    FE_SIMD_NONE = 0, /**< Portable C */
+    FE_SIMD_SSE2 = 1,
+    FE_SIMD_AVX2 = 2
+} fe_simd_t;
+
+/**
+ * Get the instruction set frames are processed with.  Unless
+ * fe_set_simd() was called, it is the best one the CPU supports.
+ **/
+SPHINXBASE_EXPORT
+fe_simd_t fe_get_simd(void);
+
+/**
+ * Choose the instruction set frames are processed with, by every
+ * front end.  If the CPU doesn't support it, the best one below it
+ * which it supports is used.  The vectorised sums round differently,
+ * so features differ from the ones of FE_SIMD_NONE in the last bits.
+ *
+ * @return the instruction set now in use.
+ **/
+SPHINXBASE_EXPORT
+fe_simd_t fe_set_simd(fe_simd_t simd);
+
 #ifdef __cplusplus
 }
 #endif
@@ -77,11 +77,11 @@ extern "C" {
 { "-cmn",                                                               \
       ARG_STRING,                                                       \
       "live",                                                        \
-      "Cepstral mean normalization scheme ('live', 'batch', or 'none')" }, \
+      "Cepstral mean normalization scheme ('live', 'batch', 'fixed' or 'none')" }, \
 { "-cmninit",                                                           \
       ARG_STRING,                                                       \
       "40,3,-1",                                                        \
-      "Initial values (comma-separated) for cepstral mean when 'live' is used" }, \
+      "Initial values (comma-separated) for cepstral mean when 'live' or 'fixed' is used" }, \
 { "-varnorm",                                                           \
       ARG_BOOLEAN,                                                      \
       "no",                                                             \
@@ -57,6 +57,7 @@
 #include <sphinxbase/logmath.h>
 #include <sphinxbase/bitvec.h>
 #include <sphinxbase/hash_table.h>
+#include <sphinxbase/word_hash.h>
 #include <sphinxbase/listelem_alloc.h>
 #include <sphinxbase/sphinxbase_export.h>
 
@@ -112,6 +113,7 @@ typedef struct fsg_model_s {
 			   logprobs */
     trans_list_t *trans; /**< Transitions out of each state, if any. */
     listelem_alloc_t *link_alloc; /**< Allocator for FSG links. */
+    word_hash_t *wid;   /**< Mapping of the vocabulary to word ids. */
 } fsg_model_t;
 
 /* Access macros */
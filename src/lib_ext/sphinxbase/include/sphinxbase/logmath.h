@@ -122,6 +122,23 @@ typedef struct logmath_s logmath_t;
 SPHINXBASE_EXPORT
 logmath_t *logmath_init(float64 base, int shift, int use_table);
 
+/**
+ * Initialize a log math computation with a compact add table.
+ *
+ * Instead of one entry for every difference of the operands, the
+ * table holds fixed point values every few entries, between which
+ * logmath_add() interpolates linearly.  They are spaced so that the
+ * sum is never more than one off that of the full table, which takes
+ * about 2 kB for base 1.0001 instead of about 200 kB, small enough to
+ * stay in the L1 cache.  It cannot be written with logmath_write().
+ *
+ * @param base The base B in which computation is to be done.
+ * @param shift Log values are shifted right by this many bits.
+ * @return The newly created log math table.
+ */
+SPHINXBASE_EXPORT
+logmath_t *logmath_init_compact(float64 base, int shift);
+
 /**
  * Memory-map (or read) a log table from a file.
  */
@@ -136,6 +153,8 @@ int32 logmath_write(logmath_t *lmath, const char *filename);
 
 /**
  * Get the log table size and dimensions.
+ *
+ * For a compact table, these are the number and width of its values.
  */
 SPHINXBASE_EXPORT
 int32 logmath_get_table_shape(logmath_t *lmath, uint32 *out_size,
@@ -165,6 +184,12 @@ int logmath_get_width(logmath_t *lmath);
 SPHINXBASE_EXPORT
 int logmath_get_shift(logmath_t *lmath);
 
+/**
+ * Was this created by logmath_init_compact()?
+ */
+SPHINXBASE_EXPORT
+int logmath_is_compact(logmath_t *lmath);
+
 /**
  * Retain ownership of a log table.
  *
@@ -193,6 +218,15 @@ int logmath_add_exact(logmath_t *lmath, int logb_p, int logb_q);
 SPHINXBASE_EXPORT
 int logmath_add(logmath_t *lmath, int logb_p, int logb_q);
 
+/**
+ * Add arrays of values in log space, logb_x[i] = logmath_add(lmath,
+ * logb_x[i], logb_y[i]) for i < n.  With a compact table, eight at a
+ * time if the CPU has AVX2, with the same results.
+ */
+SPHINXBASE_EXPORT
+void logmath_add_array(logmath_t *lmath, int *logb_x, int const *logb_y,
+                       size_t n);
+
 /**
  * Convert linear floating point number to integer log in base B.
  */
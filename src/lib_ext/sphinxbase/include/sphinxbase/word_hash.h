@@ -0,0 +1,158 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2026 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+/**
+ * @file word_hash.h
+ * @brief Open addressing hash table of word ids.
+ *
+ * Maps C-style strings to 32-bit ids, as hash_table_t does with
+ * hash_table_enter_int32() and hash_table_lookup_int32(), for the
+ * vocabularies of dictionaries and language models, which are looked
+ * up far more often than they change.
+ *
+ * All the entries are in one array, with the hash of every key and its
+ * first bytes, so most keys are told apart without following their
+ * pointers. A separate control byte per slot holds 7 bits of the hash;
+ * they are probed 16 at a time, with SSE2 where it is available, and a
+ * lookup stops at the first group with an empty slot. The table is
+ * sized for 7 entries in 8 slots and grows by moving the entries with
+ * their stored hashes; entries can only be removed all at once. As
+ * with hash_table_t, the keys belong to the caller and must not change
+ * while they are in the table.
+ */
+
+#ifndef _LIBUTIL_WORD_HASH_H_
+#define _LIBUTIL_WORD_HASH_H_
+
+#include <stddef.h>
+
+/* Win32/WinCE DLL gunk */
+#include <sphinxbase/sphinxbase_export.h>
+#include <sphinxbase/prim_type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+/* Fool Emacs. */
+}
+#endif
+
+/** Slots probed together, one control byte each. */
+#define WORD_HASH_GROUP 16
+
+/** Bytes of every key kept in its slot. */
+#define WORD_HASH_PREFIX 12
+
+typedef struct word_hash_slot_s {
+    uint32 hash;        /**< Hash of the key */
+    int32 val;          /**< Value associated with the key */
+    const char *key;    /**< The key itself, owned by the caller */
+    uint32 len;         /**< Length of the key */
+    uint32 prefix[WORD_HASH_PREFIX / 4]; /**< First bytes of the key, 4 in
+                                              every word, upper case if
+                                              the table ignores case,
+                                              padded with zeros */
+} word_hash_slot_t;
+
+typedef struct word_hash_s {
+    uint8 *ctrl;        /**< Control byte of every slot, 7 bits of its
+                             hash or WORD_HASH_EMPTY */
+    word_hash_slot_t *slot;
+    uint32 n_group;     /**< Number of groups of slots */
+    int32 inuse;        /**< Number of entries */
+    int32 nocase;       /**< Whether case insensitive for key comparisons */
+} word_hash_t;
+
+#define word_hash_inuse(h)	((h)->inuse)
+
+/**
+ * Allocate a new table for a given expected number of entries.
+ *
+ * @param size Expected number of entries, the table grows beyond it.
+ * @param casearg HASH_CASE_NO to ignore the case of 7-bit ASCII
+ * characters, HASH_CASE_YES otherwise, as for hash_table_new().
+ */
+SPHINXBASE_EXPORT
+word_hash_t *word_hash_new(int32 size, int32 casearg);
+
+/**
+ * Free the table, not its keys.
+ */
+SPHINXBASE_EXPORT
+void word_hash_free(word_hash_t *h);
+
+/**
+ * Add an entry, unless the key is there already. Returns val if it
+ * was added, otherwise the value of the existing entry, which is left
+ * as it is.
+ */
+SPHINXBASE_EXPORT
+int32 word_hash_enter(word_hash_t *h, const char *key, int32 val);
+
+/**
+ * Add an entry or replace the key and value of the existing one.
+ * Returns the previous value, or val if the key wasn't there.
+ */
+SPHINXBASE_EXPORT
+int32 word_hash_replace(word_hash_t *h, const char *key, int32 val);
+
+/**
+ * Look up a key. Returns 0 and sets *val (if val isn't NULL) if it is
+ * there, -1 if it isn't.
+ */
+SPHINXBASE_EXPORT
+int32 word_hash_lookup(word_hash_t *h, const char *key, int32 *val);
+
+/**
+ * Look up a key which isn't NUL terminated.
+ */
+SPHINXBASE_EXPORT
+int32 word_hash_lookup_bkey(word_hash_t *h, const char *key, size_t len,
+                            int32 *val);
+
+/**
+ * Remove all the entries, keeping the memory of the table.
+ */
+SPHINXBASE_EXPORT
+void word_hash_empty(word_hash_t *h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
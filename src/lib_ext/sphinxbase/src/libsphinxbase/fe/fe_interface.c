@@ -295,6 +295,8 @@ fe_init_auto_r(cmd_ln_t *config)
     /* create twiddle factors */
     fe->ccc = ckd_calloc(fe->fft_size / 4, sizeof(*fe->ccc));
     fe->sss = ckd_calloc(fe->fft_size / 4, sizeof(*fe->sss));
+    fe->fft_ccc = ckd_calloc(fe->fft_size / 2, sizeof(*fe->fft_ccc));
+    fe->fft_sss = ckd_calloc(fe->fft_size / 2, sizeof(*fe->fft_sss));
     fe_create_twiddle(fe);
 
     if (cmd_ln_boolean_r(config, "-verbose")) {
@@ -652,6 +654,8 @@ fe_free(fe_t * fe)
     ckd_free(fe->frame);
     ckd_free(fe->ccc);
     ckd_free(fe->sss);
+    ckd_free(fe->fft_ccc);
+    ckd_free(fe->fft_sss);
     ckd_free(fe->spec);
     ckd_free(fe->mfspec);
     ckd_free(fe->overflow_samps);
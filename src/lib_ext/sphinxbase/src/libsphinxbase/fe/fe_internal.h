@@ -146,6 +146,8 @@ struct fe_s {
 
     /* Twiddle factors for FFT. */
     frame_t *ccc, *sss;
+    /* The same, stage after stage, for the vectorised butterflies. */
+    frame_t *fft_ccc, *fft_sss;
     /* Mel filter parameters. */
     melfb_t *mel_fb;
     /* Half of a Hamming Window. */
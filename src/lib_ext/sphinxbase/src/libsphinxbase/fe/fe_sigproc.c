@@ -66,6 +66,7 @@
 
 #include "fe_internal.h"
 #include "fe_warp.h"
+#include "fe_simd.h"
 
 /* Use extra precision for cosines, Hamming window, pre-emphasis
  * coefficient, twiddle factors. */
@@ -737,6 +738,13 @@ fe_pre_emphasis(int16 const *in, frame_t * out, int32 len,
         out[i] = ((fixed32) in[i] << DEFAULT_RADIX)
             - (fixed32) in[i - 1] * fxd_alpha;
 #else
+    fe_simd_ops_t const *simd = fe_simd_ops();
+
+    if (simd) {
+        simd->pre_emphasis(in, out, len, factor, prior);
+        return;
+    }
+
     out[0] = (frame_t) in[0] - (frame_t) prior *factor;
     for (i = 1; i < len; i++)
         out[i] = (frame_t) in[i] - (frame_t) in[i - 1] * factor;
@@ -777,6 +785,15 @@ fe_hamming_window(frame_t * in, window_t * window, int32 in_len,
 {
     int i;
 
+#ifndef FIXED_POINT
+    fe_simd_ops_t const *simd = fe_simd_ops();
+
+    if (simd) {
+        simd->hamming_window(in, window, in_len, remove_dc);
+        return;
+    }
+#endif
+
     if (remove_dc) {
         frame_t mean = 0;
 
@@ -870,7 +887,7 @@ fe_shift_frame(fe_t * fe, int16 const *in, int32 len)
 void
 fe_create_twiddle(fe_t * fe)
 {
-    int i;
+    int i, j, k;
 
     for (i = 0; i < fe->fft_size / 4; ++i) {
         float64 a = 2 * M_PI * i / fe->fft_size;
@@ -882,6 +899,14 @@ fe_create_twiddle(fe_t * fe)
         fe->sss[i] = sin(a);
 #endif
     }
+
+    /* The butterflies of stage k use every (1<<(m-k-1))th of them. */
+    for (k = 1, i = 0; k < fe->fft_order; ++k) {
+        for (j = 0; j < (1 << (k - 1)); ++j, ++i) {
+            fe->fft_ccc[i] = fe->ccc[j << (fe->fft_order - k - 1)];
+            fe->fft_sss[i] = fe->sss[j << (fe->fft_order - k - 1)];
+        }
+    }
 }
 
 
@@ -911,6 +936,17 @@ fe_fft_real(fe_t * fe)
         j += k;
     }
 
+#ifndef FIXED_POINT
+    {
+        fe_simd_ops_t const *simd = fe_simd_ops();
+
+        if (simd) {
+            simd->fft_butterflies(x, fe->fft_ccc, fe->fft_sss, m);
+            return m;
+        }
+    }
+#endif
+
     /* Basic butterflies (2-point FFT, real twiddle factors):
      * x[i]   = x[i] +  1 * x[i+1]
      * x[i+1] = x[i] + -1 * x[i+1]
@@ -1007,6 +1043,13 @@ fe_spec_magnitude(fe_t * fe)
 #if defined(FIXED_POINT)
         spec[0] = FIXLN(abs(fft[0]) << scale) * 2;
 #else
+        fe_simd_ops_t const *simd = fe_simd_ops();
+
+        if (simd) {
+            simd->spec_magnitude(fft, spec, fftsize);
+            return;
+        }
+
         spec[0] = fft[0] * fft[0];
 #endif
     }
@@ -1027,6 +1070,9 @@ fe_mel_spec(fe_t * fe)
 {
     int whichfilt;
     powspec_t *spec, *mfspec;
+#ifndef FIXED_POINT
+    fe_simd_ops_t const *simd = fe_simd_ops();
+#endif
 
     /* Convenience poitners. */
     spec = fe->spec;
@@ -1047,6 +1093,14 @@ fe_mel_spec(fe_t * fe)
                                            filt_coeffs[filt_start + i]);
         }
 #else                           /* !FIXED_POINT */
+        if (simd) {
+            mfspec[whichfilt] =
+                simd->dot(spec + spec_start,
+                          fe->mel_fb->filt_coeffs + filt_start,
+                          fe->mel_fb->filt_width[whichfilt]);
+            continue;
+        }
+
         mfspec[whichfilt] = 0;
         for (i = 0; i < fe->mel_fb->filt_width[whichfilt]; i++)
             mfspec[whichfilt] +=
@@ -1103,6 +1157,9 @@ void
 fe_spec2cep(fe_t * fe, const powspec_t * mflogspec, mfcc_t * mfcep)
 {
     int32 i, j, beta;
+#ifndef FIXED_POINT
+    fe_simd_ops_t const *simd = fe_simd_ops();
+#endif
 
     /* Compute C0 separately (its basis vector is 1) to avoid
      * costly multiplications. */
@@ -1112,6 +1169,16 @@ fe_spec2cep(fe_t * fe, const powspec_t * mflogspec, mfcc_t * mfcep)
     mfcep[0] /= (frame_t) fe->mel_fb->num_filters;
 
     for (i = 1; i < fe->num_cepstra; ++i) {
+#ifndef FIXED_POINT
+        if (simd) {
+            mfcep[i] = (mflogspec[0] * fe->mel_fb->mel_cosine[i][0]
+                        + simd->dot(mflogspec + 1,
+                                    fe->mel_fb->mel_cosine[i] + 1,
+                                    fe->mel_fb->num_filters - 1) * 2)
+                / ((frame_t) fe->mel_fb->num_filters * 2);
+            continue;
+        }
+#endif
         mfcep[i] = 0;
         for (j = 0; j < fe->mel_fb->num_filters; j++) {
             if (j == 0)
@@ -1132,6 +1199,9 @@ void
 fe_dct2(fe_t * fe, const powspec_t * mflogspec, mfcc_t * mfcep, int htk)
 {
     int32 i, j;
+#ifndef FIXED_POINT
+    fe_simd_ops_t const *simd = fe_simd_ops();
+#endif
 
     /* Compute C0 separately (its basis vector is 1) to avoid
      * costly multiplications. */
@@ -1144,6 +1214,14 @@ fe_dct2(fe_t * fe, const powspec_t * mflogspec, mfcc_t * mfcep, int htk)
         mfcep[0] = COSMUL(mfcep[0], fe->mel_fb->sqrt_inv_n);
 
     for (i = 1; i < fe->num_cepstra; ++i) {
+#ifndef FIXED_POINT
+        if (simd) {
+            mfcep[i] = simd->dot(mflogspec, fe->mel_fb->mel_cosine[i],
+                                 fe->mel_fb->num_filters)
+                * fe->mel_fb->sqrt_inv_2n;
+            continue;
+        }
+#endif
         mfcep[i] = 0;
         for (j = 0; j < fe->mel_fb->num_filters; j++) {
             mfcep[i] += COSMUL(mflogspec[j], fe->mel_fb->mel_cosine[i][j]);
@@ -0,0 +1,200 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2013 Carnegie Mellon University.  All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "sphinxbase/prim_type.h"
+#include "sphinxbase/err.h"
+#include "sphinxbase/fe.h"
+
+#include "fe_simd.h"
+
+#ifdef FE_HAVE_SIMD
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+
+/* GCC and Clang only use the instructions of a function's target, the
+ * Microsoft compiler any of them. */
+#if defined(__GNUC__)
+#define FE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define FE_TARGET(isa)
+#endif
+
+#define FE_SIMD_CONCAT(name, isa) name ## _ ## isa
+#define FE_SIMD_EXPAND(name, isa) FE_SIMD_CONCAT(name, isa)
+#define FE_SIMD_NAME(name) FE_SIMD_EXPAND(name, FE_SIMD_ISA)
+
+/* SSE2, two doubles at a time. */
+#define FE_SIMD_ISA sse2
+#define FE_SIMD_LEVEL FE_SIMD_SSE2
+#define FE_SIMD_TARGET FE_TARGET("sse2")
+#define VEC __m128d
+#define VW 2
+#define VLOAD(p) _mm_loadu_pd(p)
+#define VSTORE(p, v) _mm_storeu_pd(p, v)
+#define VSET1(x) _mm_set1_pd(x)
+#define VZERO() _mm_setzero_pd()
+#define VADD(a, b) _mm_add_pd(a, b)
+#define VSUB(a, b) _mm_sub_pd(a, b)
+#define VMUL(a, b) _mm_mul_pd(a, b)
+#define VNEG(a) _mm_xor_pd(a, _mm_set1_pd(-0.0))
+#define VREVERSE(a) _mm_shuffle_pd(a, a, 1)
+#define VLOAD_I16(p) _mm_set_pd((p)[1], (p)[0])
+#define VLOAD_F32(p) _mm_cvtps_pd(_mm_castsi128_ps( \
+            _mm_loadl_epi64((__m128i const *) (p))))
+
+#include "fe_simd_kernels.h"
+
+#undef FE_SIMD_ISA
+#undef FE_SIMD_LEVEL
+#undef FE_SIMD_TARGET
+#undef VEC
+#undef VW
+#undef VLOAD
+#undef VSTORE
+#undef VSET1
+#undef VZERO
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VNEG
+#undef VREVERSE
+#undef VLOAD_I16
+#undef VLOAD_F32
+
+/* AVX2, four doubles at a time.  FMA is left out on purpose, fusing
+ * the products and sums would round them differently. */
+#define FE_SIMD_ISA avx2
+#define FE_SIMD_LEVEL FE_SIMD_AVX2
+#define FE_SIMD_TARGET FE_TARGET("avx2")
+#define VEC __m256d
+#define VW 4
+#define VLOAD(p) _mm256_loadu_pd(p)
+#define VSTORE(p, v) _mm256_storeu_pd(p, v)
+#define VSET1(x) _mm256_set1_pd(x)
+#define VZERO() _mm256_setzero_pd()
+#define VADD(a, b) _mm256_add_pd(a, b)
+#define VSUB(a, b) _mm256_sub_pd(a, b)
+#define VMUL(a, b) _mm256_mul_pd(a, b)
+#define VNEG(a) _mm256_xor_pd(a, _mm256_set1_pd(-0.0))
+#define VREVERSE(a) _mm256_permute4x64_pd(a, 0x1B)
+#define VLOAD_I16(p) _mm256_cvtepi32_pd(_mm_cvtepi16_epi32( \
+            _mm_loadl_epi64((__m128i const *) (p))))
+#define VLOAD_F32(p) _mm256_cvtps_pd(_mm_loadu_ps(p))
+
+#include "fe_simd_kernels.h"
+
+static int
+fe_cpu_supports(fe_simd_t simd)
+{
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    if (simd == FE_SIMD_AVX2)
+        return __builtin_cpu_supports("avx2");
+    if (simd == FE_SIMD_SSE2)
+        return __builtin_cpu_supports("sse2");
+#else
+    int info[4];
+
+    if (simd == FE_SIMD_SSE2) {
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+    }
+    if (simd == FE_SIMD_AVX2) {
+        /* The OS has to save the AVX registers too. */
+        __cpuid(info, 1);
+        if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6)
+            return FALSE;
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return FALSE;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+#endif
+    return simd == FE_SIMD_NONE;
+}
+
+#endif /* FE_HAVE_SIMD */
+
+static int fe_simd_chosen = FALSE;
+static fe_simd_ops_t const *fe_simd_active = NULL;
+
+fe_simd_t
+fe_set_simd(fe_simd_t simd)
+{
+    fe_simd_ops_t const *ops = NULL;
+
+#ifdef FE_HAVE_SIMD
+    if (simd >= FE_SIMD_AVX2 && fe_cpu_supports(FE_SIMD_AVX2))
+        ops = &ops_avx2;
+    else if (simd >= FE_SIMD_SSE2 && fe_cpu_supports(FE_SIMD_SSE2))
+        ops = &ops_sse2;
+#endif
+
+    fe_simd_active = ops;
+    fe_simd_chosen = TRUE;
+    return ops ? ops->simd : FE_SIMD_NONE;
+}
+
+fe_simd_t
+fe_get_simd(void)
+{
+    fe_simd_ops_t const *ops = fe_simd_ops();
+
+    return ops ? ops->simd : FE_SIMD_NONE;
+}
+
+fe_simd_ops_t const *
+fe_simd_ops(void)
+{
+    /* Choosing is idempotent, so it doesn't matter if two threads
+     * happen to do it at once. */
+    if (!fe_simd_chosen) {
+        fe_set_simd(FE_SIMD_AVX2);
+        E_INFO("Front end uses %s\n",
+               fe_simd_active ? (fe_simd_active->simd == FE_SIMD_AVX2
+                                 ? "AVX2" : "SSE2") : "no SIMD");
+    }
+    return fe_simd_active;
+}
@@ -0,0 +1,88 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2013 Carnegie Mellon University.  All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+#ifndef FE_SIMD_H
+#define FE_SIMD_H
+
+#include "sphinxbase/fe.h"
+#include "fe_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+/* Fool Emacs. */
+}
+#endif
+
+/*
+ * Vectorised versions of the per-frame signal processing in
+ * fe_sigproc.c.  They are only built for floating point on x86, and
+ * chosen at run time according to what the CPU supports.  Anything
+ * not done in order (the sums) rounds differently from the portable
+ * code; the rest gives the same result to the bit.
+ */
+#if !defined(FIXED_POINT) \
+    && (defined(__GNUC__) || defined(_MSC_VER)) \
+    && (defined(__x86_64__) || defined(__i386__) \
+        || defined(_M_X64) || defined(_M_IX86))
+#define FE_HAVE_SIMD 1
+#endif
+
+typedef struct fe_simd_ops_s {
+    fe_simd_t simd;
+    void (*pre_emphasis)(int16 const *in, frame_t *out, int32 len,
+                         float32 factor, int16 prior);
+    void (*hamming_window)(frame_t *in, window_t const *window,
+                           int32 in_len, int32 remove_dc);
+    /* Butterflies of a bit-reversed frame, using the twiddle factors
+     * of each stage from fe->fft_ccc and fe->fft_sss. */
+    void (*fft_butterflies)(frame_t *x, frame_t const *ccc,
+                            frame_t const *sss, int32 m);
+    void (*spec_magnitude)(frame_t const *fft, powspec_t *spec,
+                           int32 fftsize);
+    /* Sum of x[i] * y[i], for the mel filters and the DCT. */
+    float64 (*dot)(powspec_t const *x, mfcc_t const *y, int32 len);
+} fe_simd_ops_t;
+
+/* The functions in use, NULL for the portable code. */
+fe_simd_ops_t const *fe_simd_ops(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FE_SIMD_H */
@@ -0,0 +1,224 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2013 Carnegie Mellon University.  All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+/*
+ * Kernels of fe_simd.c, written once in terms of the vector macros it
+ * defines and included once for each instruction set: VEC holds VW
+ * doubles, FE_SIMD_NAME() names the functions, FE_SIMD_TARGET lets
+ * the compiler use the instructions in them and FE_SIMD_LEVEL is the
+ * fe_simd_t they need.
+ *
+ * The order of the operations on each element is the one of the
+ * portable code in fe_sigproc.c, so only the sums differ from it.
+ */
+
+FE_SIMD_TARGET static inline float64
+FE_SIMD_NAME(hsum)(VEC v)
+{
+    float64 lanes[VW], sum;
+    int i;
+
+    VSTORE(lanes, v);
+    sum = lanes[0];
+    for (i = 1; i < VW; ++i)
+        sum += lanes[i];
+    return sum;
+}
+
+FE_SIMD_TARGET static void
+FE_SIMD_NAME(pre_emphasis)(int16 const *in, frame_t * out, int32 len,
+                           float32 factor, int16 prior)
+{
+    VEC alpha = VSET1((frame_t) factor);
+    int i;
+
+    out[0] = (frame_t) in[0] - (frame_t) prior *factor;
+    for (i = 1; i + VW <= len; i += VW)
+        VSTORE(out + i, VSUB(VLOAD_I16(in + i),
+                             VMUL(VLOAD_I16(in + i - 1), alpha)));
+    for (; i < len; i++)
+        out[i] = (frame_t) in[i] - (frame_t) in[i - 1] * factor;
+}
+
+FE_SIMD_TARGET static void
+FE_SIMD_NAME(hamming_window)(frame_t * in, window_t const *window,
+                             int32 in_len, int32 remove_dc)
+{
+    int i;
+
+    if (remove_dc) {
+        VEC sum = VZERO(), mean;
+        frame_t total;
+
+        for (i = 0; i + VW <= in_len; i += VW)
+            sum = VADD(sum, VLOAD(in + i));
+        total = FE_SIMD_NAME(hsum)(sum);
+        for (; i < in_len; i++)
+            total += in[i];
+
+        total /= in_len;
+        mean = VSET1(total);
+        for (i = 0; i + VW <= in_len; i += VW)
+            VSTORE(in + i, VSUB(VLOAD(in + i), mean));
+        for (; i < in_len; i++)
+            in[i] -= total;
+    }
+
+    /* The second half is the first one backwards. */
+    for (i = 0; i + VW <= in_len / 2; i += VW) {
+        VEC w = VLOAD(window + i);
+        frame_t *back = in + in_len - i - VW;
+
+        VSTORE(in + i, VMUL(VLOAD(in + i), w));
+        VSTORE(back, VMUL(VLOAD(back), VREVERSE(w)));
+    }
+    for (; i < in_len / 2; i++) {
+        in[i] = in[i] * window[i];
+        in[in_len - 1 - i] = in[in_len - 1 - i] * window[i];
+    }
+}
+
+FE_SIMD_TARGET static void
+FE_SIMD_NAME(fft_butterflies)(frame_t * x, frame_t const *ccc,
+                              frame_t const *sss, int32 m)
+{
+    int i, j, k, n;
+    frame_t xt;
+
+    n = 1 << m;
+
+    for (i = 0; i < n; i += 2) {
+        xt = x[i];
+        x[i] = (xt + x[i + 1]);
+        x[i + 1] = (xt - x[i + 1]);
+    }
+
+    for (k = 1; k < m; ++k) {
+        int n1, n2, n4;
+        /* Twiddle factors of this stage, j = 0 .. (1<<(k-1)) - 1 */
+        frame_t const *cc = ccc + (1 << (k - 1)) - 1;
+        frame_t const *ss = sss + (1 << (k - 1)) - 1;
+
+        n4 = k - 1;
+        n2 = k;
+        n1 = k + 1;
+        for (i = 0; i < n; i += (1 << n1)) {
+            xt = x[i];
+            x[i] = (xt + x[i + (1 << n2)]);
+            x[i + (1 << n2)] = (xt - x[i + (1 << n2)]);
+            x[i + (1 << n2) + (1 << n4)] = -x[i + (1 << n2) + (1 << n4)];
+
+            /* x[i1] and x[i3] go up with j while x[i2] and x[i4] go
+             * down, so those are read and written backwards.  No
+             * butterfly touches the points of another one. */
+            for (j = 1; j + VW <= (1 << n4); j += VW) {
+                frame_t *p1 = x + i + j;
+                frame_t *p2 = x + i + (1 << n2) - j - (VW - 1);
+                frame_t *p3 = x + i + (1 << n2) + j;
+                frame_t *p4 = x + i + (1 << n2) + (1 << n2) - j - (VW - 1);
+                VEC c = VLOAD(cc + j), s = VLOAD(ss + j);
+                VEC x1 = VLOAD(p1), x2 = VREVERSE(VLOAD(p2));
+                VEC x3 = VLOAD(p3), x4 = VREVERSE(VLOAD(p4));
+                VEC t1 = VADD(VMUL(x3, c), VMUL(x4, s));
+                VEC t2 = VSUB(VMUL(x3, s), VMUL(x4, c));
+
+                VSTORE(p4, VREVERSE(VSUB(x2, t2)));
+                VSTORE(p3, VSUB(VNEG(x2), t2));
+                VSTORE(p2, VREVERSE(VSUB(x1, t1)));
+                VSTORE(p1, VADD(x1, t1));
+            }
+            for (; j < (1 << n4); ++j) {
+                frame_t t1, t2;
+                int i1, i2, i3, i4;
+
+                i1 = i + j;
+                i2 = i + (1 << n2) - j;
+                i3 = i + (1 << n2) + j;
+                i4 = i + (1 << n2) + (1 << n2) - j;
+
+                t1 = x[i3] * cc[j] + x[i4] * ss[j];
+                t2 = x[i3] * ss[j] - x[i4] * cc[j];
+
+                x[i4] = (x[i2] - t2);
+                x[i3] = (-x[i2] - t2);
+                x[i2] = (x[i1] - t1);
+                x[i1] = (x[i1] + t1);
+            }
+        }
+    }
+}
+
+FE_SIMD_TARGET static void
+FE_SIMD_NAME(spec_magnitude)(frame_t const *fft, powspec_t * spec,
+                             int32 fftsize)
+{
+    int32 j;
+
+    spec[0] = fft[0] * fft[0];
+    for (j = 1; j + VW - 1 <= fftsize / 2; j += VW) {
+        VEC re = VLOAD(fft + j);
+        VEC im = VREVERSE(VLOAD(fft + fftsize - j - (VW - 1)));
+
+        VSTORE(spec + j, VADD(VMUL(re, re), VMUL(im, im)));
+    }
+    for (; j <= fftsize / 2; j++)
+        spec[j] = fft[j] * fft[j] + fft[fftsize - j] * fft[fftsize - j];
+}
+
+FE_SIMD_TARGET static float64
+FE_SIMD_NAME(dot)(powspec_t const *x, mfcc_t const *y, int32 len)
+{
+    VEC sum = VZERO();
+    float64 total;
+    int32 i;
+
+    for (i = 0; i + VW <= len; i += VW)
+        sum = VADD(sum, VMUL(VLOAD(x + i), VLOAD_F32(y + i)));
+    total = FE_SIMD_NAME(hsum)(sum);
+    for (; i < len; i++)
+        total += x[i] * y[i];
+    return total;
+}
+
+static fe_simd_ops_t const FE_SIMD_NAME(ops) = {
+    FE_SIMD_LEVEL,
+    FE_SIMD_NAME(pre_emphasis),
+    FE_SIMD_NAME(hamming_window),
+    FE_SIMD_NAME(fft_butterflies),
+    FE_SIMD_NAME(spec_magnitude),
+    FE_SIMD_NAME(dot)
+};
@@ -59,12 +59,14 @@
 const char *cmn_type_str[] = {
     "none",
     "batch",
-    "live"
+    "live",
+    "fixed"
 };
 const char *cmn_alt_type_str[] = {
     "none",
     "current",
-    "prior"
+    "prior",
+    "fixed"
 };
 static const int n_cmn_type_str = sizeof(cmn_type_str)/sizeof(cmn_type_str[0]);
 
@@ -141,6 +141,38 @@ cmn_live_update(cmn_t *cmn)
     E_INFOCONT(">\n");
 }
 
+void
+cmn_fixed(cmn_t *cmn, mfcc_t **incep, int32 nfr)
+{
+    int32 i, j;
+
+    for (i = 0; i < nfr; i++) {
+	/* Skip zero energy frames, as live CMN does */
+	if (incep[i][0] < 0)
+	    continue;
+
+        for (j = 0; j < cmn->veclen; j++)
+            incep[i][j] -= cmn->cmn_mean[j];
+    }
+}
+
+void
+cmn_accum(cmn_t *cmn, mfcc_t **incep, int32 nfr)
+{
+    int32 i, j;
+
+    for (i = 0; i < nfr; i++) {
+	/* Skip zero energy frames */
+	if (incep[i][0] < 0)
+	    continue;
+
+        for (j = 0; j < cmn->veclen; j++)
+            cmn->sum[j] += incep[i][j];
+
+        ++cmn->nframe;
+    }
+}
+
 void
 cmn_live(cmn_t *cmn, mfcc_t **incep, int32 varnorm, int32 nfr)
 {
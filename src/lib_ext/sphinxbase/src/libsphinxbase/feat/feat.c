@@ -918,7 +918,8 @@ feat_cmn(feat_t *fcb, mfcc_t **mfc, int32 nfr, int32 beginutt, int32 endutt)
     cmn_type_t cmn_type = fcb->cmn;
 
     if (!(beginutt && endutt)
-        && cmn_type != CMN_NONE) /* Only cmn_prior in block computation mode. */
+        && cmn_type != CMN_NONE
+        && cmn_type != CMN_FIXED) /* Only cmn_prior in block computation mode. */
         fcb->cmn = cmn_type = CMN_LIVE;
 
     switch (cmn_type) {
@@ -930,6 +931,9 @@ feat_cmn(feat_t *fcb, mfcc_t **mfc, int32 nfr, int32 beginutt, int32 endutt)
         if (endutt)
             cmn_live_update(fcb->cmn_struct);
         break;
+    case CMN_FIXED:
+        cmn_fixed(fcb->cmn_struct, mfc, nfr);
+        break;
     default:
         ;
     }
@@ -0,0 +1,266 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2026 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+
+/**
+ * @file arpa_text.c
+ * @brief Lines and fields of an ARPA file read in one go.
+ */
+
+#include <string.h>
+#include <stdio.h>
+
+#if (defined(_WIN32) || defined(__CYGWIN__)) && !defined(__SYMBIAN32__)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <sphinxbase/err.h>
+#include <sphinxbase/pio.h>
+#include <sphinxbase/strfuncs.h>
+#include <sphinxbase/ckd_alloc.h>
+
+#include "arpa_text.h"
+
+static int
+is_space(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\f';
+}
+
+static char *
+read_all(FILE * fp, size_t * size)
+{
+    size_t alloc = 1 << 20, n;
+    char *buf = ckd_malloc(alloc);
+
+    *size = 0;
+    while ((n = fread(buf + *size, 1, alloc - *size, fp)) > 0) {
+        *size += n;
+        if (*size == alloc) {
+            alloc *= 2;
+            buf = ckd_realloc(buf, alloc);
+        }
+    }
+    return buf;
+}
+
+arpa_text_t *
+arpa_text_open(const char *path)
+{
+    arpa_text_t *text;
+    const char *start;
+    FILE *fp;
+    int32 is_pipe;
+    long size = 0;
+
+    /* Compressed files are read through a pipe, which only takes "r" */
+    if ((fp = fopen_comp(path, "r", &is_pipe)) == NULL)
+        return NULL;
+
+    text = ckd_calloc(1, sizeof(*text));
+    if (!is_pipe && fseek(fp, 0, SEEK_END) == 0)
+        size = ftell(fp);
+    if (size > 0 && (text->mf = mmio_file_read(path)) != NULL) {
+        start = mmio_file_ptr(text->mf);
+    }
+    else {
+        size_t n;
+        if (!is_pipe)
+            fseek(fp, 0, SEEK_SET);
+        text->buf = read_all(fp, &n);
+        start = text->buf;
+        size = (long) n;
+    }
+    fclose_comp(fp, is_pipe);
+
+    text->end = start + size;
+    /* Strip the UTF-8 BOM */
+    if (size >= 3 && 0 == memcmp(start, "\xef\xbb\xbf", 3))
+        start += 3;
+    text->next = start;
+    arpa_text_next(text);
+
+    return text;
+}
+
+const char *
+arpa_text_next(arpa_text_t * text)
+{
+    const char *line, *line_end;
+
+    while (text->next < text->end) {
+        line = text->next;
+        line_end = memchr(line, '\n', text->end - line);
+        if (line_end == NULL)
+            line_end = text->end;
+        text->next = line_end < text->end ? line_end + 1 : line_end;
+
+        while (line < line_end && is_space(*line))
+            ++line;
+        while (line_end > line && is_space(line_end[-1]))
+            --line_end;
+        if (line < line_end && *line != '#') {
+            text->line = line;
+            text->line_end = line_end;
+            return line;
+        }
+    }
+    text->line = text->line_end = NULL;
+    return NULL;
+}
+
+int
+arpa_text_is(arpa_text_t * text, const char *str)
+{
+    size_t len = strlen(str);
+
+    return text->line && (size_t) (text->line_end - text->line) == len
+        && 0 == memcmp(text->line, str, len);
+}
+
+void
+arpa_text_free(arpa_text_t * text)
+{
+    if (text == NULL)
+        return;
+    if (text->mf)
+        mmio_file_unmap(text->mf);
+    ckd_free(text->buf);
+    ckd_free(text);
+}
+
+int32
+arpa_split(const char *line, const char *line_end,
+           const char **fields, const char **field_ends, int32 max_fields)
+{
+    int32 n = 0;
+
+    while (1) {
+        while (line < line_end && is_space(*line))
+            ++line;
+        if (line == line_end)
+            return n;
+        if (n >= max_fields)
+            return -1;
+        fields[n] = line;
+        while (line < line_end && !is_space(*line))
+            ++line;
+        field_ends[n++] = line;
+    }
+}
+
+double
+arpa_atof(const char *str, const char *str_end)
+{
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *p = str;
+    uint64 mantissa = 0;
+    int n_digit = 0, exponent = 0, negative = 0, has_digit = 0;
+    char tmp[64];
+
+    if (p < str_end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    while (p < str_end && *p >= '0' && *p <= '9' && n_digit < 19) {
+        mantissa = mantissa * 10 + (*p++ - '0');
+        if (mantissa)
+            ++n_digit;
+        has_digit = 1;
+    }
+    if (p < str_end && *p == '.') {
+        for (++p; p < str_end && *p >= '0' && *p <= '9' && n_digit < 19; ++p) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa)
+                ++n_digit;
+            --exponent;
+            has_digit = 1;
+        }
+    }
+    if (p < str_end && (*p == 'e' || *p == 'E')) {
+        const char *e = p + 1;
+        int exp_negative = 0, value = 0;
+
+        if (e < str_end && (*e == '-' || *e == '+'))
+            exp_negative = *e++ == '-';
+        if (e < str_end && *e >= '0' && *e <= '9') {
+            for (; e < str_end && *e >= '0' && *e <= '9' && value < 1000; ++e)
+                value = value * 10 + (*e - '0');
+            exponent += exp_negative ? -value : value;
+            p = e;
+        }
+    }
+
+    /* Both the mantissa and the power of ten are exact doubles, so one
+     * division or product is rounded correctly (Clinger's fast path) */
+    if (p == str_end && has_digit && n_digit <= 15
+        && exponent >= -22 && exponent <= 22) {
+        double value = exponent < 0 ? (double) mantissa / pow10[-exponent]
+            : (double) mantissa * pow10[exponent];
+        return negative ? -value : value;
+    }
+
+    if ((size_t) (str_end - str) >= sizeof(tmp))
+        str_end = str + sizeof(tmp) - 1;
+    memcpy(tmp, str, str_end - str);
+    tmp[str_end - str] = '\0';
+    return atof_c(tmp);
+}
+
+int32
+arpa_n_thread(cmd_ln_t * config)
+{
+    int32 n_thread = 0;
+
+    if (config && cmd_ln_exists_r(config, "-lm_threads"))
+        n_thread = cmd_ln_int32_r(config, "-lm_threads");
+    if (n_thread <= 0) {
+#if (defined(_WIN32) || defined(__CYGWIN__)) && !defined(__SYMBIAN32__)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        n_thread = (int32) info.dwNumberOfProcessors;
+#else
+        n_thread = (int32) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    if (n_thread < 1)
+        n_thread = 1;
+    return n_thread < ARPA_MAX_THREADS ? n_thread : ARPA_MAX_THREADS;
+}
@@ -0,0 +1,109 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2026 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+
+/**
+ * @file arpa_text.h
+ * @brief Lines and fields of an ARPA file read in one go.
+ *
+ * The whole file is memory mapped, or read into memory if it is
+ * compressed, and its lines are walked without copying them, skipping
+ * empty lines and comments as lineiter_start_clean() does. Fields are
+ * split on whitespace as str2words() does and numbers parsed by
+ * arpa_atof(), whose result is the same as atof_c().
+ */
+
+#ifndef __ARPA_TEXT_H__
+#define __ARPA_TEXT_H__
+
+#include <sphinxbase/prim_type.h>
+#include <sphinxbase/cmd_ln.h>
+#include <sphinxbase/mmio.h>
+
+/* No more threads than this, finding the lines is sequential anyway */
+#define ARPA_MAX_THREADS 16
+
+typedef struct arpa_text_s {
+    mmio_file_t *mf;    /**< Mapping of an uncompressed file */
+    char *buf;          /**< Contents of a compressed or unmappable file */
+    const char *next;   /**< Start of the line after the current one */
+    const char *end;    /**< End of the file */
+    const char *line;   /**< Current line, trimmed, NULL at the end */
+    const char *line_end;
+} arpa_text_t;
+
+/**
+ * Open a file and move to its first line. Returns NULL if it can't be
+ * opened.
+ */
+arpa_text_t *arpa_text_open(const char *path);
+
+/**
+ * Move to the next line which is not empty nor a comment. Returns
+ * the line, NULL at the end of the file.
+ */
+const char *arpa_text_next(arpa_text_t * text);
+
+/**
+ * Whether the current line is exactly str.
+ */
+int arpa_text_is(arpa_text_t * text, const char *str);
+
+void arpa_text_free(arpa_text_t * text);
+
+/**
+ * Split a line in at most max_fields fields, as str2words() does.
+ * Returns the number of fields, -1 if there are more than max_fields.
+ */
+int32 arpa_split(const char *line, const char *line_end,
+                 const char **fields, const char **field_ends,
+                 int32 max_fields);
+
+/**
+ * Number of a field, as atof_c() reads it. Decimals of up to 15
+ * significant digits are converted directly, exactly as strtod() does,
+ * anything else by atof_c().
+ */
+double arpa_atof(const char *str, const char *str_end);
+
+/**
+ * Number of threads parsing n-grams, -lm_threads if config has it,
+ * else or if 0 the number of processors.
+ */
+int32 arpa_n_thread(cmd_ln_t * config);
+
+#endif                          /* __ARPA_TEXT_H__ */
@@ -43,6 +43,7 @@
 #include "sphinxbase/prim_type.h"
 #include "sphinxbase/strfuncs.h"
 #include "sphinxbase/hash_table.h"
+#include "sphinxbase/word_hash.h"
 #include "sphinxbase/fsg_model.h"
 #include "sphinxbase/bitvec.h"
 
@@ -369,15 +370,9 @@ fsg_arciter_free(fsg_arciter_t * itor)
 int
 fsg_model_word_id(fsg_model_t * fsg, char const *word)
 {
-    int wid;
+    int32 wid;
 
-    /* Search for an existing word matching this. */
-    for (wid = 0; wid < fsg->n_word; ++wid) {
-        if (0 == strcmp(fsg->vocab[wid], word))
-            break;
-    }
-    /* If not found, add this to the vocab. */
-    if (wid == fsg->n_word)
+    if (word_hash_lookup(fsg->wid, word, &wid) < 0)
         return -1;
     return wid;
 }
@@ -409,6 +404,7 @@ fsg_model_word_add(fsg_model_t * fsg, char const *word)
         }
         ++fsg->n_word;
         fsg->vocab[wid] = ckd_salloc(word);
+        word_hash_enter(fsg->wid, fsg->vocab[wid], wid);
     }
     return wid;
 }
@@ -451,11 +447,8 @@ fsg_model_add_alt(fsg_model_t * fsg, char const *baseword,
     int i, basewid, altwid;
     int ntrans;
 
-    /* FIXME: This will get slow, eventually... */
-    for (basewid = 0; basewid < fsg->n_word; ++basewid)
-        if (0 == strcmp(fsg->vocab[basewid], baseword))
-            break;
-    if (basewid == fsg->n_word) {
+    basewid = fsg_model_word_id(fsg, baseword);
+    if (basewid == -1) {
         E_ERROR("Base word %s not present in FSG vocabulary!\n", baseword);
         return -1;
     }
@@ -526,6 +519,7 @@ fsg_model_init(char const *name, logmath_t * lmath, float32 lw,
     fsg->lw = lw;
 
     fsg->trans = ckd_calloc(fsg->n_state, sizeof(*fsg->trans));
+    fsg->wid = word_hash_new(0, HASH_CASE_YES);
 
     return fsg;
 }
@@ -709,6 +703,7 @@ fsg_model_read(FILE * fp, logmath_t * lmath, float32 lw)
         char const *word = hash_entry_key(itor->ent);
         int32 wid = (int32) (long) hash_entry_val(itor->ent);
         fsg->vocab[wid] = (char *) word;
+        word_hash_enter(fsg->wid, fsg->vocab[wid], wid);
     }
     hash_table_free(vocab);
 
@@ -793,6 +788,7 @@ fsg_model_free(fsg_model_t * fsg)
         trans_list_free(fsg, i);
     ckd_free(fsg->trans);
     ckd_free(fsg->vocab);
+    word_hash_free(fsg->wid);
     listelem_alloc_free(fsg->link_alloc);
     bitvec_free(fsg->silwords);
     bitvec_free(fsg->altwords);
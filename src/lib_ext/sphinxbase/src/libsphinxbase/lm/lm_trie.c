@@ -48,6 +48,8 @@
 #include "lm_trie_quant.h"
 
 static void lm_trie_alloc_ngram(lm_trie_t * trie, uint32 * counts, int order);
+static void lm_trie_layout_ngram(lm_trie_t * trie, uint32 * counts, int order,
+                                 uint8 * mapped_mem);
 
 static uint32
 base_size(uint32 entries, uint32 max_vocab, uint8 remaining_bits)
@@ -351,16 +353,21 @@ recursive_insert(lm_trie_t * trie, ngram_raw_t ** raw_ngrams,
 }
 
 static lm_trie_t *
-lm_trie_init(uint32 unigram_count)
+lm_trie_init(uint32 unigram_count, unigram_t * mapped_unigrams)
 {
     lm_trie_t *trie;
 
     trie = (lm_trie_t *) ckd_calloc(1, sizeof(*trie));
     memset(trie->hist_cache, -1, sizeof(trie->hist_cache)); /* prepare request history */
     memset(trie->backoff_cache, 0, sizeof(trie->backoff_cache));
-    trie->unigrams =
-        (unigram_t *) ckd_calloc((unigram_count + 1),
-                                 sizeof(*trie->unigrams));
+    if (mapped_unigrams) {
+        trie->unigrams = mapped_unigrams;
+        trie->is_mapped = TRUE;
+    }
+    else
+        trie->unigrams =
+            (unigram_t *) ckd_calloc((unigram_count + 1),
+                                     sizeof(*trie->unigrams));
     trie->ngram_mem = NULL;
     return trie;
 }
@@ -368,7 +375,7 @@ lm_trie_init(uint32 unigram_count)
 lm_trie_t *
 lm_trie_create(uint32 unigram_count, int order)
 {
-    lm_trie_t *trie = lm_trie_init(unigram_count);
+    lm_trie_t *trie = lm_trie_init(unigram_count, NULL);
     trie->quant =
         (order > 1) ? lm_trie_quant_create(order) : 0;
     return trie;
@@ -377,7 +384,7 @@ lm_trie_create(uint32 unigram_count, int order)
 lm_trie_t *
 lm_trie_read_bin(uint32 * counts, int order, FILE * fp)
 {
-    lm_trie_t *trie = lm_trie_init(counts[0]);
+    lm_trie_t *trie = lm_trie_init(counts[0], NULL);
     trie->quant = (order > 1) ? lm_trie_quant_read_bin(fp, order) : NULL;
     fread(trie->unigrams, sizeof(*trie->unigrams), (counts[0] + 1), fp);
     if (order > 1) {
@@ -387,6 +394,38 @@ lm_trie_read_bin(uint32 * counts, int order, FILE * fp)
     return trie;
 }
 
+lm_trie_t *
+lm_trie_map_bin(uint32 * counts, int order, uint8 ** ptr,
+                const uint8 * end)
+{
+    lm_trie_t *trie;
+    lm_trie_quant_t *quant = NULL;
+    unigram_t *unigrams;
+
+    /* Same layout as lm_trie_read_bin() reads */
+    if (order > 1 && (quant = lm_trie_quant_map_bin(ptr, end, order)) == NULL)
+        return NULL;
+    if ((size_t) (end - *ptr) < (counts[0] + 1) * sizeof(*unigrams)) {
+        if (quant)
+            lm_trie_quant_free(quant);
+        return NULL;
+    }
+    unigrams = (unigram_t *) *ptr;
+    *ptr += (counts[0] + 1) * sizeof(*unigrams);
+
+    trie = lm_trie_init(counts[0], unigrams);
+    trie->quant = quant;
+    if (order > 1) {
+        lm_trie_layout_ngram(trie, counts, order, *ptr);
+        if ((size_t) (end - *ptr) < trie->ngram_mem_size) {
+            lm_trie_free(trie);
+            return NULL;
+        }
+        *ptr += trie->ngram_mem_size;
+    }
+    return trie;
+}
+
 void
 lm_trie_write_bin(lm_trie_t * trie, uint32 unigram_count, FILE * fp)
 {
@@ -403,18 +442,27 @@ void
 lm_trie_free(lm_trie_t * trie)
 {
     if (trie->ngram_mem) {
-        ckd_free(trie->ngram_mem);
+        if (!trie->is_mapped)
+            ckd_free(trie->ngram_mem);
         ckd_free(trie->middle_begin);
         ckd_free(trie->longest);
     }
     if (trie->quant)
         lm_trie_quant_free(trie->quant);
-    ckd_free(trie->unigrams);
+    if (!trie->is_mapped)
+        ckd_free(trie->unigrams);
     ckd_free(trie);
 }
 
 static void
 lm_trie_alloc_ngram(lm_trie_t * trie, uint32 * counts, int order)
+{
+    lm_trie_layout_ngram(trie, counts, order, NULL);
+}
+
+static void
+lm_trie_layout_ngram(lm_trie_t * trie, uint32 * counts, int order,
+                     uint8 * mapped_mem)
 {
     int i;
     uint8 *mem_ptr;
@@ -429,7 +477,9 @@ lm_trie_alloc_ngram(lm_trie_t * trie, uint32 * counts, int order)
     trie->ngram_mem_size +=
         longest_size(lm_trie_quant_lsize(trie->quant), counts[order - 1],
                      counts[0]);
-    trie->ngram_mem =
+    /* A mapped trie is only checked against the file size afterwards, its
+     * layout doesn't touch the memory */
+    trie->ngram_mem = mapped_mem ? mapped_mem :
         (uint8 *) ckd_calloc(trie->ngram_mem_size,
                              sizeof(*trie->ngram_mem));
     mem_ptr = trie->ngram_mem;
@@ -84,6 +84,7 @@ typedef struct lm_trie_s {
     middle_t *middle_end;
     longest_t *longest;
     lm_trie_quant_t *quant;
+    uint8 is_mapped;    /**< unigrams and ngram_mem point into a memory mapped file */
 
     float backoff_cache[NGRAM_MAX_ORDER];
     uint32 hist_cache[NGRAM_MAX_ORDER - 1];
@@ -96,6 +97,14 @@ lm_trie_t *lm_trie_create(uint32 unigram_count, int order);
 
 lm_trie_t *lm_trie_read_bin(uint32 * counts, int order, FILE * fp);
 
+/**
+ * Uses the trie of a memory mapped binary file in place, without copying it.
+ * ptr points past the counts and is advanced past the trie. Returns NULL if
+ * the trie would go beyond end.
+ */
+lm_trie_t *lm_trie_map_bin(uint32 * counts, int order, uint8 ** ptr,
+                           const uint8 * end);
+
 void lm_trie_write_bin(lm_trie_t * trie, uint32 unigram_count, FILE * fp);
 
 void lm_trie_free(lm_trie_t * trie);
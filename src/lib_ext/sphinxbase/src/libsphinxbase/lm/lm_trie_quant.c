@@ -56,6 +56,7 @@ struct lm_trie_quant_s {
     bins_t *longest;
     uint8 *mem;
     size_t mem_size;
+    uint8 is_mapped;    /**< mem points into a memory mapped file */
     uint8 prob_bits;
     uint8 bo_bits;
     uint32 prob_mask;
@@ -119,16 +120,15 @@ quant_size(int order)
     return (order - 2) * middle_table + longest_table;
 }
 
-lm_trie_quant_t *
-lm_trie_quant_create(int order)
+static lm_trie_quant_t *
+quant_init(int order, uint8 * mem)
 {
     float *start;
     int i;
     lm_trie_quant_t *quant =
         (lm_trie_quant_t *) ckd_calloc(1, sizeof(*quant));
     quant->mem_size = quant_size(order);
-    quant->mem =
-        (uint8 *) ckd_calloc(quant->mem_size, sizeof(*quant->mem));
+    quant->mem = mem;
 
     quant->prob_bits = 16;
     quant->bo_bits = 16;
@@ -147,6 +147,13 @@ lm_trie_quant_create(int order)
     return quant;
 }
 
+lm_trie_quant_t *
+lm_trie_quant_create(int order)
+{
+    return quant_init(order,
+                      (uint8 *) ckd_calloc(quant_size(order), sizeof(uint8)));
+}
+
 
 lm_trie_quant_t *
 lm_trie_quant_read_bin(FILE * fp, int order)
@@ -161,6 +168,22 @@ lm_trie_quant_read_bin(FILE * fp, int order)
     return quant;
 }
 
+lm_trie_quant_t *
+lm_trie_quant_map_bin(uint8 ** ptr, const uint8 * end, int order)
+{
+    lm_trie_quant_t *quant;
+
+    /* Skip what was the quantization type, as in lm_trie_quant_read_bin() */
+    if ((size_t) (end - *ptr) < sizeof(int) + quant_size(order))
+        return NULL;
+    *ptr += sizeof(int);
+    quant = quant_init(order, *ptr);
+    quant->is_mapped = TRUE;
+    *ptr += quant->mem_size;
+
+    return quant;
+}
+
 void
 lm_trie_quant_write_bin(lm_trie_quant_t * quant, FILE * fp)
 {
@@ -173,7 +196,7 @@ lm_trie_quant_write_bin(lm_trie_quant_t * quant, FILE * fp)
 void
 lm_trie_quant_free(lm_trie_quant_t * quant)
 {
-    if (quant->mem)
+    if (quant->mem && !quant->is_mapped)
         ckd_free(quant->mem);
     ckd_free(quant);
 }
@@ -53,6 +53,13 @@ lm_trie_quant_t *lm_trie_quant_create(int order);
  */
 lm_trie_quant_t *lm_trie_quant_read_bin(FILE * fp, int order);
 
+/**
+ * Use quant data of a memory mapped binary file in place.
+ * Advances ptr past it, returns NULL if it would go beyond end.
+ */
+lm_trie_quant_t *lm_trie_quant_map_bin(uint8 ** ptr, const uint8 * end,
+                                       int order);
+
 /**
  * Write quant data to binary file
  */
@@ -237,9 +237,9 @@ ngram_model_init(ngram_model_t * base,
     /* NOTE: They are no longer case-insensitive since we are allowing
      * other encodings for word strings.  Beware. */
     if (base->wid)
-        hash_table_empty(base->wid);
+        word_hash_empty(base->wid);
     else
-        base->wid = hash_table_new(n_unigram, FALSE);
+        base->wid = word_hash_new(n_unigram, HASH_CASE_YES);
     base->n_counts[0] = base->n_1g_alloc = base->n_words = n_unigram;
 
     return 0;
@@ -297,7 +297,7 @@ ngram_model_free(ngram_model_t * model)
         ngram_class_free(model->classes[i]);
     }
     ckd_free(model->classes);
-    hash_table_free(model->wid);
+    word_hash_free(model->wid);
     ckd_free(model->word_str);
     ckd_free(model->n_counts);
     ckd_free(model);
@@ -308,7 +308,7 @@ int
 ngram_model_casefold(ngram_model_t * model, int kase)
 {
     int writable, i;
-    hash_table_t *new_wid;
+    word_hash_t *new_wid;
 
     /* Were word strings already allocated? */
     writable = model->writable;
@@ -317,7 +317,7 @@ ngram_model_casefold(ngram_model_t * model, int kase)
 
     /* And, don't forget, we need to rebuild the word to unigram ID
      * mapping. */
-    new_wid = hash_table_new(model->n_words, FALSE);
+    new_wid = word_hash_new(model->n_words, HASH_CASE_YES);
     for (i = 0; i < model->n_words; ++i) {
         char *outstr;
         if (writable) {
@@ -345,13 +345,13 @@ ngram_model_casefold(ngram_model_t * model, int kase)
 
         /* Now update the hash table.  We might have terrible
          * collisions here, so warn about them. */
-        if (hash_table_enter_int32(new_wid, model->word_str[i], i) != i) {
+        if (word_hash_enter(new_wid, model->word_str[i], i) != i) {
             E_WARN("Duplicate word in dictionary after conversion: %s\n",
                    model->word_str[i]);
         }
     }
     /* Swap out the hash table. */
-    hash_table_free(model->wid);
+    word_hash_free(model->wid);
     model->wid = new_wid;
     return 0;
 }
@@ -553,7 +553,7 @@ ngram_unknown_wid(ngram_model_t * model)
 
     /* FIXME: This could be memoized for speed if necessary. */
     /* Look up <UNK>, if not found return NGRAM_INVALID_WID. */
-    if (hash_table_lookup_int32(model->wid, "<UNK>", &val) == -1)
+    if (word_hash_lookup(model->wid, "<UNK>", &val) == -1)
         return NGRAM_INVALID_WID;
     else
         return val;
@@ -586,7 +586,7 @@ ngram_wid(ngram_model_t * model, const char *word)
 {
     int32 val;
 
-    if (hash_table_lookup_int32(model->wid, word, &val) == -1)
+    if (word_hash_lookup(model->wid, word, &val) == -1)
         return ngram_unknown_wid(model);
     else
         return val;
@@ -612,7 +612,7 @@ ngram_add_word_internal(ngram_model_t * model,
 
     /* Check for hash collisions. */
     int32 wid;
-    if (hash_table_lookup_int32(model->wid, word, &wid) == 0) {
+    if (word_hash_lookup(model->wid, word, &wid) == 0) {
         E_WARN("Omit duplicate word '%s'\n", word);
         return wid;
     }
@@ -634,7 +634,7 @@ ngram_add_word_internal(ngram_model_t * model,
     /* Class words are always dynamically allocated. */
     model->word_str[model->n_words] = ckd_salloc(word);
     /* Now enter it into the hash table. */
-    if (hash_table_enter_int32
+    if (word_hash_enter
         (model->wid, model->word_str[model->n_words], wid) != wid) {
         E_ERROR
             ("Hash insertion failed for word %s => %p (should not happen)\n",
@@ -45,6 +45,7 @@
 
 #include "sphinxbase/ngram_model.h"
 #include "sphinxbase/hash_table.h"
+#include "sphinxbase/word_hash.h"
 
 /**
  * Common implementation of ngram_model_t.
@@ -69,7 +70,7 @@ struct ngram_model_s {
     int32 log_wip;      /**< Log of word insertion penalty */
     int32 log_zero;     /**< Zero probability, cached here for quick lookup */
     char **word_str;    /**< Unigram names */
-    hash_table_t *wid;  /**< Mapping of unigram names to word IDs. */
+    word_hash_t *wid;   /**< Mapping of unigram names to word IDs. */
     int32 *tmp_wids;    /**< Temporary array of word IDs for ngram_model_get_ngram() */
     struct ngram_class_s **classes; /**< Word class definitions. */
     struct ngram_funcs_s *funcs;   /**< Implementation-specific methods. */
@@ -109,7 +109,7 @@ build_widmap(ngram_model_t * base, logmath_t * lmath, int32 n)
     for (i = 0; i < base->n_words; ++i) {
         int32 j;
         /* Also create the master wid mapping. */
-        (void) hash_table_enter_int32(base->wid, base->word_str[i], i);
+        (void) word_hash_enter(base->wid, base->word_str[i], i);
         /* printf("%s: %d => ", base->word_str[i], i); */
         for (j = 0; j < set->n_models; ++j) {
             set->widmap[i][j] = ngram_wid(models[j], base->word_str[i]);
@@ -656,11 +656,11 @@ ngram_model_set_map_words(ngram_model_t * base,
     set->widmap =
         (int32 **) ckd_calloc_2d(n_words, set->n_models,
                                  sizeof(**set->widmap));
-    hash_table_empty(base->wid);
+    word_hash_empty(base->wid);
     for (i = 0; i < n_words; ++i) {
         int32 j;
         base->word_str[i] = ckd_salloc(words[i]);
-        (void) hash_table_enter_int32(base->wid, base->word_str[i], i);
+        (void) word_hash_enter(base->wid, base->word_str[i], i);
         for (j = 0; j < set->n_models; ++j) {
             set->widmap[i][j] = ngram_wid(set->lms[j], base->word_str[i]);
         }
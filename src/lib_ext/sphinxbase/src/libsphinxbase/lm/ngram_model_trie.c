@@ -37,44 +37,137 @@
 
 #include <string.h>
 #include <assert.h>
+#include <sys/stat.h>
 
 #include <sphinxbase/err.h>
 #include <sphinxbase/pio.h>
 #include <sphinxbase/strfuncs.h>
 #include <sphinxbase/ckd_alloc.h>
 #include <sphinxbase/byteorder.h>
+#include <sphinxbase/mmio.h>
 
 #include "ngram_model_trie.h"
 
+#if (defined(_WIN32) || defined(__CYGWIN__)) && !defined(__SYMBIAN32__)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 static const char trie_hdr[] = "Trie Language Model";
 static const char dmp_hdr[] = "Darpa Trigram LM";
 static ngram_funcs_t ngram_model_trie_funcs;
 
+/*
+ * Binary files mapped with -mmap yes. Every model read from the same file
+ * uses the same mapping, so decoders of one process don't keep one copy of
+ * the language model each. A file replaced under the same name has another
+ * inode, size or time and gets its own mapping, the models still using the
+ * old one keep it until they are freed.
+ */
+struct trie_map_s {
+    char *path;
+    mmio_file_t *mf;
+    size_t size;
+    time_t mtime;
+    long ino;
+    int refcount;
+    struct trie_map_s *next;
+};
+
+static struct trie_map_s *trie_maps;
+#if (defined(_WIN32) || defined(__CYGWIN__)) && !defined(__SYMBIAN32__)
+static SRWLOCK trie_maps_lock = SRWLOCK_INIT;
+#define trie_maps_acquire() AcquireSRWLockExclusive(&trie_maps_lock)
+#define trie_maps_release() ReleaseSRWLockExclusive(&trie_maps_lock)
+#else
+static pthread_mutex_t trie_maps_lock = PTHREAD_MUTEX_INITIALIZER;
+#define trie_maps_acquire() pthread_mutex_lock(&trie_maps_lock)
+#define trie_maps_release() pthread_mutex_unlock(&trie_maps_lock)
+#endif
+
+static struct trie_map_s *
+trie_map_retain(const char *path)
+{
+    struct stat st;
+    struct trie_map_s *map;
+
+    if (stat(path, &st) < 0 || st.st_size <= 0)
+        return NULL;
+
+    trie_maps_acquire();
+    for (map = trie_maps; map; map = map->next) {
+        if (map->size == (size_t) st.st_size && map->mtime == st.st_mtime
+            && map->ino == (long) st.st_ino && 0 == strcmp(map->path, path))
+            break;
+    }
+    if (map)
+        ++map->refcount;
+    else {
+        mmio_file_t *mf = mmio_file_read(path);
+        if (mf) {
+            map = (struct trie_map_s *) ckd_calloc(1, sizeof(*map));
+            map->path = ckd_salloc(path);
+            map->mf = mf;
+            map->size = (size_t) st.st_size;
+            map->mtime = st.st_mtime;
+            map->ino = (long) st.st_ino;
+            map->refcount = 1;
+            map->next = trie_maps;
+            trie_maps = map;
+        }
+    }
+    trie_maps_release();
+    return map;
+}
+
+static void
+trie_map_free(struct trie_map_s *map)
+{
+    struct trie_map_s **prev;
+
+    trie_maps_acquire();
+    if (--map->refcount == 0) {
+        for (prev = &trie_maps; *prev != map; prev = &(*prev)->next);
+        *prev = map->next;
+        mmio_file_unmap(map->mf);
+        ckd_free(map->path);
+        ckd_free(map);
+    }
+    trie_maps_release();
+}
+
 /*
  * Read and return #unigrams, #bigrams, #trigrams as stated in input file.
  */
 static int
-read_counts_arpa(lineiter_t ** li, uint32 * counts, int *order)
+read_counts_arpa(arpa_text_t * text, uint32 * counts, int *order)
 {
     int32 ngram, prev_ngram;
     uint32 ngram_cnt;
+    char line[64];
 
     /* skip file until past the '\data\' marker */
-    while (*li) {
-        if (strcmp((*li)->buf, "\\data\\") == 0)
+    while (text->line) {
+        if (arpa_text_is(text, "\\data\\"))
             break;
-        *li = lineiter_next(*li);
+        arpa_text_next(text);
     }
 
-    if (*li == NULL || strcmp((*li)->buf, "\\data\\") != 0) {
+    if (text->line == NULL) {
         E_INFO("No \\data\\ mark in LM file\n");
         return -1;
     }
 
     prev_ngram = 0;
     *order = 0;
-    while ((*li = lineiter_next(*li))) {
-        if (sscanf((*li)->buf, "ngram %d=%d", &ngram, &ngram_cnt) != 2)
+    while (arpa_text_next(text)) {
+        size_t len = text->line_end - text->line;
+        if (len >= sizeof(line))
+            break;
+        memcpy(line, text->line, len);
+        line[len] = '\0';
+        if (sscanf(line, "ngram %d=%d", &ngram, &ngram_cnt) != 2)
             break;
         if (ngram != prev_ngram + 1) {
             E_ERROR
@@ -82,12 +175,16 @@ read_counts_arpa(lineiter_t ** li, uint32 * counts, int *order)
                  ngram, prev_ngram);
             return -1;
         }
+        if (*order >= NGRAM_MAX_ORDER) {
+            E_ERROR("Ngram order of LM file is above %d\n", NGRAM_MAX_ORDER);
+            return -1;
+        }
         prev_ngram = ngram;
         counts[*order] = ngram_cnt;
         (*order)++;
     }
 
-    if (*li == NULL) {
+    if (text->line == NULL) {
         E_ERROR("EOF while reading ngram counts\n");
         return -1;
     }
@@ -96,18 +193,18 @@ read_counts_arpa(lineiter_t ** li, uint32 * counts, int *order)
 }
 
 static int
-read_1grams_arpa(lineiter_t ** li, uint32 count, ngram_model_t * base,
+read_1grams_arpa(arpa_text_t * text, uint32 count, ngram_model_t * base,
                  unigram_t * unigrams)
 {
     uint32 i;
     int n;
     int n_parts;
-    char *wptr[3];
+    const char *wptr[3], *wend[3];
 
-    while (*li && strcmp((*li)->buf, "\\1-grams:") != 0) {
-	*li = lineiter_next(*li);
+    while (text->line && !arpa_text_is(text, "\\1-grams:")) {
+	arpa_text_next(text);
     }
-    if (*li == NULL) {
+    if (text->line == NULL) {
         E_ERROR_SYSTEM("Failed to read \\1-grams: mark");
         return -1;
     }
@@ -115,44 +212,48 @@ read_1grams_arpa(lineiter_t ** li, uint32 count, ngram_model_t * base,
     n_parts = 2;
     for (i = 0; i < count; i++) {
         unigram_t *unigram;
+        size_t len;
         
-        *li = lineiter_next(*li);
-        if (*li == NULL) {
+        if (arpa_text_next(text) == NULL) {
             E_ERROR
                 ("Unexpected end of ARPA file. Failed to read %dth unigram\n",
                  i + 1);
             return -1;
         }
-        if ((n = str2words((*li)->buf, wptr, 3)) < n_parts) {
-            E_ERROR("Format error at line %s, Failed to read unigrams\n", (*li)->buf);
+        if ((n = arpa_split(text->line, text->line_end, wptr, wend, 3)) < n_parts) {
+            E_ERROR("Format error at line %.*s, Failed to read unigrams\n",
+                    (int) (text->line_end - text->line), text->line);
             return -1;
         }
 
         unigram = &unigrams[i];
         unigram->prob =
-            logmath_log10_to_log_float(base->lmath, atof_c(wptr[0]));
+            logmath_log10_to_log_float(base->lmath,
+                                       arpa_atof(wptr[0], wend[0]));
         if (unigram->prob > 0) {
-            E_WARN("Unigram '%s' has positive probability\n", wptr[1]);
+            E_WARN("Unigram '%.*s' has positive probability\n",
+                   (int) (wend[1] - wptr[1]), wptr[1]);
             unigram->prob = 0;
         }
         if (n == n_parts + 1) {
             unigram->bo =
                 logmath_log10_to_log_float(base->lmath,
-                                           atof_c(wptr[2]));
+                                           arpa_atof(wptr[2], wend[2]));
         }
         else {
             unigram->bo = 0.0f;
         }
 
         /* TODO: classify float with fpclassify and warn if bad value occurred */
-        base->word_str[i] = ckd_salloc(wptr[1]);
+        len = wend[1] - wptr[1];
+        base->word_str[i] = (char *) ckd_malloc(len + 1);
+        memcpy(base->word_str[i], wptr[1], len);
+        base->word_str[i][len] = '\0';
     }
 
     /* fill hash-table that maps unigram names to their word ids */
     for (i = 0; i < count; i++) {
-        if ((hash_table_enter
-             (base->wid, base->word_str[i],
-              (void *) (long) i)) != (void *) (long) i) {
+        if (word_hash_enter(base->wid, base->word_str[i], i) != i) {
             E_WARN("Duplicate word in dictionary: %s\n",
                    base->word_str[i]);
         }
@@ -164,29 +265,25 @@ ngram_model_t *
 ngram_model_trie_read_arpa(cmd_ln_t * config,
                            const char *path, logmath_t * lmath)
 {
-    FILE *fp;
-    lineiter_t *li;
+    arpa_text_t *text;
     ngram_model_trie_t *model;
     ngram_model_t *base;
     ngram_raw_t **raw_ngrams;
-    int32 is_pipe;
     uint32 counts[NGRAM_MAX_ORDER];
     int order;
     int i;
 
     E_INFO("Trying to read LM in arpa format\n");
-    if ((fp = fopen_comp(path, "r", &is_pipe)) == NULL) {
+    if ((text = arpa_text_open(path)) == NULL) {
         E_ERROR("File %s not found\n", path);
         return NULL;
     }
 
     model = (ngram_model_trie_t *) ckd_calloc(1, sizeof(*model));
-    li = lineiter_start_clean(fp);
     /* Read n-gram counts from file */
-    if (read_counts_arpa(&li, counts, &order) == -1) {
+    if (read_counts_arpa(text, counts, &order) == -1) {
         ckd_free(model);
-        lineiter_free(li);
-        fclose_comp(fp, is_pipe);
+        arpa_text_free(text);
         return NULL;
     }
 
@@ -201,29 +298,26 @@ ngram_model_trie_read_arpa(cmd_ln_t * config,
     base->writable = TRUE;
 
     model->trie = lm_trie_create(counts[0], order);
-    if (read_1grams_arpa(&li, counts[0], base, model->trie->unigrams) < 0) {
+    if (read_1grams_arpa(text, counts[0], base, model->trie->unigrams) < 0) {
 	ngram_model_free(base);
-        lineiter_free(li);
-        fclose_comp(fp, is_pipe);
+        arpa_text_free(text);
         return NULL;
     }
 
     if (order > 1) {
         raw_ngrams =
-            ngrams_raw_read_arpa(&li, base->lmath, counts, order,
-                                 base->wid);
+            ngrams_raw_read_arpa(text, base->lmath, counts, order,
+                                 base->wid, arpa_n_thread(config));
         if (raw_ngrams == NULL) {
             ngram_model_free(base);
-            lineiter_free(li);
-            fclose_comp(fp, is_pipe);
+            arpa_text_free(text);
             return NULL;
         }
         lm_trie_build(model->trie, raw_ngrams, counts, base->n_counts, order);
         ngrams_raw_free(raw_ngrams, counts, order);
     }
 
-    lineiter_free(li);
-    fclose_comp(fp, is_pipe);
+    arpa_text_free(text);
 
     return base;
 }
@@ -327,8 +421,7 @@ read_word_str(ngram_model_t * base, FILE * fp)
     j = 0;
     for (i = 0; i < base->n_counts[0]; i++) {
         base->word_str[i] = ckd_salloc(tmp_word_str + j);
-        if (hash_table_enter(base->wid, base->word_str[i],
-                             (void *) (long) i) != (void *) (long) i) {
+        if (word_hash_enter(base->wid, base->word_str[i], i) != i) {
             E_WARN("Duplicate word in dictionary: %s\n",
                    base->word_str[i]);
         }
@@ -337,6 +430,96 @@ read_word_str(ngram_model_t * base, FILE * fp)
     free(tmp_word_str);
 }
 
+/*
+ * Word strings are used in place too, so the model is not writable.
+ */
+static int
+map_word_str(ngram_model_t * base, uint8 * ptr, const uint8 * end)
+{
+    int32 k;
+    uint32 i;
+    char *str, *str_end, *word_end;
+
+    if ((size_t) (end - ptr) < sizeof(k))
+        return -1;
+    memcpy(&k, ptr, sizeof(k));
+    ptr += sizeof(k);
+    if (k < 0 || end - ptr < k)
+        return -1;
+
+    base->writable = FALSE;
+    str = (char *) ptr;
+    str_end = str + k;
+    for (i = 0; i < base->n_counts[0]; i++) {
+        if ((word_end = memchr(str, '\0', str_end - str)) == NULL)
+            return -1;
+        base->word_str[i] = str;
+        if (word_hash_enter(base->wid, base->word_str[i], i) != i) {
+            E_WARN("Duplicate word in dictionary: %s\n",
+                   base->word_str[i]);
+        }
+        str = word_end + 1;
+    }
+    return 0;
+}
+
+/*
+ * Uses a binary file in place : nothing is parsed or copied but the counts,
+ * and the pages are shared with every other model mapped from it. Returns
+ * NULL without a word if the file is not an uncompressed trie, so that it
+ * is read as usual.
+ */
+static ngram_model_t *
+ngram_model_trie_map_bin(const char *path, logmath_t * lmath)
+{
+    struct trie_map_s *map;
+    uint8 *ptr, *end;
+    size_t hdr_size;
+    uint8 i, order;
+    uint32 counts[NGRAM_MAX_ORDER];
+    ngram_model_trie_t *model;
+    ngram_model_t *base;
+
+    if ((map = trie_map_retain(path)) == NULL)
+        return NULL;
+    ptr = (uint8 *) mmio_file_ptr(map->mf);
+    end = ptr + map->size;
+    hdr_size = strlen(trie_hdr);
+    if (map->size < hdr_size + sizeof(order)
+        || memcmp(ptr, trie_hdr, hdr_size) != 0) {
+        trie_map_free(map);
+        return NULL;
+    }
+    ptr += hdr_size;
+    order = *ptr++;
+    if (order < 1 || order > NGRAM_MAX_ORDER
+        || (size_t) (end - ptr) < order * sizeof(*counts)) {
+        E_ERROR("Binary trie LM %s is corrupted\n", path);
+        trie_map_free(map);
+        return NULL;
+    }
+    memcpy(counts, ptr, order * sizeof(*counts));
+    ptr += order * sizeof(*counts);
+
+    E_INFO("Mapping LM in trie binary format\n");
+    model = (ngram_model_trie_t *) ckd_calloc(1, sizeof(*model));
+    base = &model->base;
+    ngram_model_init(base, &ngram_model_trie_funcs, lmath, order,
+                     (int32) counts[0]);
+    for (i = 0; i < order; i++) {
+        base->n_counts[i] = counts[i];
+    }
+    model->map = map;
+
+    if ((model->trie = lm_trie_map_bin(counts, order, &ptr, end)) == NULL
+        || map_word_str(base, ptr, end) < 0) {
+        E_ERROR("Binary trie LM %s is truncated\n", path);
+        ngram_model_free(base);
+        return NULL;
+    }
+    return base;
+}
+
 ngram_model_t *
 ngram_model_trie_read_bin(cmd_ln_t * config,
                           const char *path, logmath_t * lmath)
@@ -351,6 +534,12 @@ ngram_model_trie_read_bin(cmd_ln_t * config,
     ngram_model_trie_t *model;
     ngram_model_t *base;
 
+    if (config && cmd_ln_exists_r(config, "-mmap")
+        && cmd_ln_boolean_r(config, "-mmap")) {
+        if ((base = ngram_model_trie_map_bin(path, lmath)) != NULL)
+            return base;
+    }
+
     E_INFO("Trying to read LM in trie binary format\n");
     if ((fp = fopen_comp(path, "rb", &is_pipe)) == NULL) {
         E_ERROR("File %s not found\n", path);
@@ -592,7 +781,12 @@ static void
 ngram_model_trie_free(ngram_model_t * base)
 {
     ngram_model_trie_t *model = (ngram_model_trie_t *) base;
-    lm_trie_free(model->trie);
+    if (model->trie)
+        lm_trie_free(model->trie);
+    /* The word strings may point into the mapping too, they are not used
+     * once the model is freed */
+    if (model->map)
+        trie_map_free(model->map);
 }
 
 static int
@@ -46,6 +46,7 @@
 typedef struct ngram_model_trie_s {
     ngram_model_t base;  /**< Base ngram_model_t structure */
     lm_trie_t *trie;     /**< Trie structure that stores ngram relations and weights */
+    struct trie_map_s *map; /**< Memory mapped binary file the trie is in, if any */
 } ngram_model_trie_t;
 
 /**
@@ -61,7 +62,9 @@ ngram_model_t *ngram_model_trie_read_arpa(cmd_ln_t * config,
 int ngram_model_trie_write_arpa(ngram_model_t * base, const char *path);
 
 /**
- * Read N-Gram model from the binary file and arrange it in a trie structure
+ * Read N-Gram model from the binary file and arrange it in a trie structure.
+ * With -mmap yes in config the file is memory mapped and used in place,
+ * models of the same file share the mapping and are not writable.
  */
 ngram_model_t *ngram_model_trie_read_bin(cmd_ln_t * config,
                                          const char *path,
@@ -43,6 +43,8 @@
 #include <sphinxbase/ckd_alloc.h>
 #include <sphinxbase/byteorder.h>
 
+#include <sphinxbase/sbthread.h>
+
 #include "ngram_model_internal.h"
 #include "ngrams_raw.h"
 
@@ -67,38 +69,47 @@ ngram_ord_comparator(const void *a_raw, const void *b_raw)
     return a->order - b->order;
 }
 
+/* Lines of a section parsed together, by as many threads */
+#define ARPA_BATCH_SIZE (1 << 18)
+/* Below this many lines a batch is not worth the threads */
+#define ARPA_BATCH_MIN_PER_THREAD 4096
+
+typedef struct ngram_batch_s {
+    const char **lines;
+    const char **line_ends;
+    ngram_raw_t *raw_ngrams;
+    uint32 count;
+    int order;
+    int order_max;
+    word_hash_t *wid;
+    logmath_t *lmath;
+    uint32 n_read;      /**< Lines before the first malformed one */
+} ngram_batch_t;
+
 static int
-read_ngram_instance(lineiter_t ** li, hash_table_t * wid,
-                    logmath_t * lmath, int order, int order_max,
-                    ngram_raw_t * raw_ngram)
+read_ngram_instance(const char *line, const char *line_end,
+                    word_hash_t * wid, logmath_t * lmath, int order,
+                    int order_max, ngram_raw_t * raw_ngram)
 {
     int n;
     int words_expected;
     int i;
-    char *wptr[NGRAM_MAX_ORDER + 1];
+    const char *wptr[NGRAM_MAX_ORDER + 1];
+    const char *wend[NGRAM_MAX_ORDER + 1];
     uint32 *word_out;
 
-    if (*li) 
-        *li = lineiter_next(*li);
-    if (*li == NULL) {
-        E_ERROR("Unexpected end of ARPA file. Failed to read %d-gram\n",
-                order);
-        return -1;
-    }
     words_expected = order + 1;
-    if ((n =
-         str2words((*li)->buf, wptr,
-                   NGRAM_MAX_ORDER + 1)) < words_expected) {
-        E_ERROR("Format error; %d-gram ignored: %s\n", order, (*li)->buf);
+    if ((n = arpa_split(line, line_end, wptr, wend,
+                        NGRAM_MAX_ORDER + 1)) < words_expected)
         return -1;
-    }
 
     raw_ngram->order = order;
 
     if (order == order_max) {
-        raw_ngram->prob = atof_c(wptr[0]);
+        raw_ngram->prob = arpa_atof(wptr[0], wend[0]);
         if (raw_ngram->prob > 0) {
-            E_WARN("%d-gram '%s' has positive probability\n", order, wptr[1]);
+            E_WARN("%d-gram '%.*s' has positive probability\n", order,
+                   (int) (wend[1] - wptr[1]), wptr[1]);
             raw_ngram->prob = 0.0f;
         }
         raw_ngram->prob =
@@ -107,9 +118,10 @@ read_ngram_instance(lineiter_t ** li, hash_table_t * wid,
     else {
         float weight, backoff;
 
-        weight = atof_c(wptr[0]);
+        weight = arpa_atof(wptr[0], wend[0]);
         if (weight > 0) {
-            E_WARN("%d-gram '%s' has positive probability\n", order, wptr[1]);
+            E_WARN("%d-gram '%.*s' has positive probability\n", order,
+                   (int) (wend[1] - wptr[1]), wptr[1]);
             raw_ngram->prob = 0.0f;
         }
         else {
@@ -121,7 +133,7 @@ read_ngram_instance(lineiter_t ** li, hash_table_t * wid,
             raw_ngram->backoff = 0.0f;
         }
         else {
-            backoff = atof_c(wptr[order + 1]);
+            backoff = arpa_atof(wptr[order + 1], wend[order + 1]);
             raw_ngram->backoff =
                 logmath_log10_to_log_float(lmath, backoff);
         }
@@ -130,43 +142,171 @@ read_ngram_instance(lineiter_t ** li, hash_table_t * wid,
         (uint32 *) ckd_calloc(order, sizeof(*raw_ngram->words));
     for (word_out = raw_ngram->words + order - 1, i = 1;
          word_out >= raw_ngram->words; --word_out, i++) {
-        hash_table_lookup_int32(wid, wptr[i], (int32 *) word_out);
+        word_hash_lookup_bkey(wid, wptr[i], wend[i] - wptr[i],
+                              (int32 *) word_out);
     }
     return 0;
 }
 
+static void
+read_ngram_batch(ngram_batch_t * batch)
+{
+    uint32 i;
+
+    for (i = 0; i < batch->count; i++) {
+        if (read_ngram_instance(batch->lines[i], batch->line_ends[i],
+                                batch->wid, batch->lmath, batch->order,
+                                batch->order_max,
+                                &batch->raw_ngrams[i]) < 0)
+            break;
+    }
+    batch->n_read = i;
+}
+
+static int
+read_ngram_batch_main(sbthread_t * th)
+{
+    read_ngram_batch((ngram_batch_t *) sbthread_arg(th));
+    return 0;
+}
+
+/*
+ * Every line is parsed on its own, into its own place, so the result
+ * doesn't depend on the number of threads.  Returns the number of lines
+ * before the first malformed one, the n-grams after it are freed.
+ */
+static uint32
+read_ngram_batches(ngram_batch_t * batch, int n_thread)
+{
+    ngram_batch_t parts[ARPA_MAX_THREADS];
+    sbthread_t *threads[ARPA_MAX_THREADS];
+    uint32 per_thread, start, j;
+    int i;
+
+    if (n_thread > ARPA_MAX_THREADS)
+        n_thread = ARPA_MAX_THREADS;
+    if ((uint32) n_thread > batch->count / ARPA_BATCH_MIN_PER_THREAD)
+        n_thread = batch->count / ARPA_BATCH_MIN_PER_THREAD;
+    if (n_thread <= 1) {
+        read_ngram_batch(batch);
+        return batch->n_read;
+    }
+
+    per_thread = (batch->count + n_thread - 1) / n_thread;
+    for (i = 0, start = 0; i < n_thread; i++, start += per_thread) {
+        parts[i] = *batch;
+        parts[i].lines += start;
+        parts[i].line_ends += start;
+        parts[i].raw_ngrams += start;
+        parts[i].count = start + per_thread <= batch->count
+            ? per_thread : batch->count - start;
+        threads[i] = i == 0 ? NULL
+            : sbthread_start(NULL, read_ngram_batch_main, &parts[i]);
+    }
+    /* Parts whose thread didn't start are parsed here */
+    for (i = 0; i < n_thread; i++) {
+        if (threads[i] == NULL)
+            read_ngram_batch(&parts[i]);
+    }
+    batch->n_read = batch->count;
+    for (i = 0, start = 0; i < n_thread; i++, start += per_thread) {
+        if (threads[i]) {
+            sbthread_wait(threads[i]);
+            sbthread_free(threads[i]);
+        }
+        if (batch->n_read == batch->count
+            && parts[i].n_read < parts[i].count)
+            batch->n_read = start + parts[i].n_read;
+    }
+    for (j = batch->n_read; j < batch->count; j++) {
+        ckd_free(batch->raw_ngrams[j].words);
+        memset(&batch->raw_ngrams[j], 0, sizeof(batch->raw_ngrams[j]));
+    }
+    return batch->n_read;
+}
+
+/*
+ * Reads the *count n-grams of an order.  A malformed line ends the
+ * order, *count becomes the number of n-grams read before it.
+ */
 static int
-ngrams_raw_read_order(ngram_raw_t ** raw_ngrams, lineiter_t ** li,
-                      hash_table_t * wid, logmath_t * lmath, uint32 count,
-                      int order, int order_max)
+ngrams_raw_read_order(ngram_raw_t ** raw_ngrams, arpa_text_t * text,
+                      word_hash_t * wid, logmath_t * lmath, uint32 * count,
+                      int order, int order_max, uint32 n_words,
+                      int n_thread)
 {
     char expected_header[20];
-    uint32 i;
+    ngram_batch_t batch;
+    uint32 i, j, n, n_read;
 
     sprintf(expected_header, "\\%d-grams:", order);
-    while (*li && strcmp((*li)->buf, expected_header) != 0) {
-	*li = lineiter_next(*li);
+    while (text->line && !arpa_text_is(text, expected_header)) {
+        arpa_text_next(text);
     }
     
-    if (*li == NULL) {
+    if (text->line == NULL) {
 	E_ERROR("Failed to find '%s', language model file truncated\n", expected_header);
 	return -1;
     }
     
-    *raw_ngrams = (ngram_raw_t *) ckd_calloc(count, sizeof(ngram_raw_t));
-    for (i = 0; i < count; i++) {
-        if (read_ngram_instance(li, wid, lmath, order, order_max,
-                            &((*raw_ngrams)[i])) < 0)
+    *raw_ngrams = (ngram_raw_t *) ckd_calloc(*count, sizeof(ngram_raw_t));
+
+    n = *count < ARPA_BATCH_SIZE ? *count : ARPA_BATCH_SIZE;
+    memset(&batch, 0, sizeof(batch));
+    batch.lines = (const char **) ckd_calloc(n, sizeof(*batch.lines));
+    batch.line_ends = (const char **) ckd_calloc(n, sizeof(*batch.line_ends));
+    batch.order = order;
+    batch.order_max = order_max;
+    batch.wid = wid;
+    batch.lmath = lmath;
+
+    /* Finding the lines is sequential, parsing them is not */
+    for (i = 0; i < *count; i += batch.count) {
+        for (j = 0; j < n && i + j < *count; j++) {
+            if (arpa_text_next(text) == NULL)
+                break;
+            batch.lines[j] = text->line;
+            batch.line_ends[j] = text->line_end;
+        }
+        batch.raw_ngrams = *raw_ngrams + i;
+        batch.count = j;
+        n_read = read_ngram_batches(&batch, n_thread);
+        if (n_read < batch.count) {
+            E_WARN("Format error; %d-gram ignored: %.*s\n", order,
+                   (int) (batch.line_ends[n_read] - batch.lines[n_read]),
+                   batch.lines[n_read]);
+            /* Back to the malformed line, which may be the next
+             * header, as if the lines after it had not been read */
+            text->line = batch.lines[n_read];
+            text->line_end = text->next = batch.line_ends[n_read];
+            i += n_read;
+            *count = i;
+            break;
+        }
+        if (j < n && i + j < *count) {
+            E_ERROR("Unexpected end of ARPA file. Failed to read %d-gram\n",
+                    order);
             break;
+        }
+    }
+    ckd_free(batch.lines);
+    ckd_free(batch.line_ends);
+
+    if (i < *count) {
+        for (j = 0; j < *count; j++)
+            ckd_free((*raw_ngrams)[j].words);
+        ckd_free(*raw_ngrams);
+        *raw_ngrams = NULL;
+        return -1;
     }
 
-    qsort(*raw_ngrams, count, sizeof(ngram_raw_t), &ngram_ord_comparator);
+    ngrams_raw_sort(*raw_ngrams, *count, order, n_words);
     return 0;
 }
 
 ngram_raw_t **
-ngrams_raw_read_arpa(lineiter_t ** li, logmath_t * lmath, uint32 * counts,
-                     int order, hash_table_t * wid)
+ngrams_raw_read_arpa(arpa_text_t * text, logmath_t * lmath, uint32 * counts,
+                     int order, word_hash_t * wid, int n_thread)
 {
     ngram_raw_t **raw_ngrams;
     int order_it;
@@ -175,28 +315,78 @@ ngrams_raw_read_arpa(lineiter_t ** li, logmath_t * lmath, uint32 * counts,
         (ngram_raw_t **) ckd_calloc(order - 1, sizeof(*raw_ngrams));
 
     for (order_it = 2; order_it <= order; order_it++) {
-        if (ngrams_raw_read_order(&raw_ngrams[order_it - 2], li, wid, lmath,
-                              counts[order_it - 1], order_it, order) < 0)
-        break;
+        if (ngrams_raw_read_order(&raw_ngrams[order_it - 2], text, wid,
+                                  lmath, &counts[order_it - 1], order_it,
+                                  order, counts[0], n_thread) < 0) {
+            ngrams_raw_free(raw_ngrams, counts, order);
+            return NULL;
+        }
     }
 
     /* Check if we found ARPA end-mark */
-    if (*li == NULL) {
+    if (arpa_text_next(text) == NULL) {
         E_ERROR("ARPA file ends without end-mark\n");
 	ngrams_raw_free(raw_ngrams, counts, order);
         return NULL;
     } else {
-        *li = lineiter_next(*li);
-	if (strcmp((*li)->buf, "\\end\\") != 0) {
+	if (!arpa_text_is(text, "\\end\\")) {
     	    E_WARN
-        	("Finished reading ARPA file. Expecting end mark but found '%s'\n",
-        	 (*li)->buf);
+        	("Finished reading ARPA file. Expecting end mark but found '%.*s'\n",
+        	 (int) (text->line_end - text->line), text->line);
         }
     }
 
     return raw_ngrams;
 }
 
+void
+ngrams_raw_sort(ngram_raw_t * raw_ngrams, uint32 count, int order,
+                uint32 n_words)
+{
+    ngram_raw_t *tmp, *src, *dst, *swap;
+    uint32 *bucket;
+    uint32 i, sum, n;
+    int k;
+
+    /* Word ids out of range can only be sorted by comparison */
+    for (i = 0; i < count; i++) {
+        for (k = 0; k < order; k++) {
+            if (raw_ngrams[i].words == NULL
+                || raw_ngrams[i].words[k] >= n_words) {
+                qsort(raw_ngrams, count, sizeof(*raw_ngrams),
+                      &ngram_ord_comparator);
+                return;
+            }
+        }
+    }
+
+    /* Least significant word first, each pass is a stable counting sort
+     * on the word ids, which ends up in the order of ngram_ord_comparator */
+    tmp = (ngram_raw_t *) ckd_calloc(count, sizeof(*tmp));
+    bucket = (uint32 *) ckd_calloc(n_words, sizeof(*bucket));
+    src = raw_ngrams;
+    dst = tmp;
+    for (k = order - 1; k >= 0; k--) {
+        memset(bucket, 0, n_words * sizeof(*bucket));
+        for (i = 0; i < count; i++)
+            bucket[src[i].words[k]]++;
+        for (i = 0, sum = 0; i < n_words; i++) {
+            n = bucket[i];
+            bucket[i] = sum;
+            sum += n;
+        }
+        for (i = 0; i < count; i++)
+            dst[bucket[src[i].words[k]]++] = src[i];
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != raw_ngrams)
+        memcpy(raw_ngrams, src, count * sizeof(*raw_ngrams));
+    ckd_free(bucket);
+    ckd_free(tmp);
+}
+
 static void
 read_dmp_weight_array(FILE * fp, logmath_t * lmath, uint8 do_swap,
                       int32 counts, ngram_raw_t * raw_ngrams,
@@ -363,11 +553,9 @@ ngrams_raw_read_dmp(FILE * fp, logmath_t * lmath, uint32 * counts,
     ckd_free(bigrams_next);
 
     /* sort raw ngrams for reverse trie */
-    qsort(raw_ngrams[0], (size_t) counts[1], sizeof(*raw_ngrams[0]),
-          &ngram_ord_comparator);
+    ngrams_raw_sort(raw_ngrams[0], counts[1], 2, counts[0]);
     if (order > 2) {
-        qsort(raw_ngrams[1], (size_t) counts[2], sizeof(*raw_ngrams[1]),
-              &ngram_ord_comparator);
+        ngrams_raw_sort(raw_ngrams[1], counts[2], 3, counts[0]);
     }
     return raw_ngrams;
 }
@@ -379,6 +567,8 @@ ngrams_raw_free(ngram_raw_t ** raw_ngrams, uint32 * counts, int order)
     int order_it;
 
     for (order_it = 0; order_it < order - 1; order_it++) {
+        if (raw_ngrams[order_it] == NULL)
+            continue;
         for (num = 0; num < counts[order_it + 1]; num++) {
             ckd_free(raw_ngrams[order_it][num].words);
         }
@@ -38,12 +38,14 @@
 #ifndef __NGRAMS_RAW_H__
 #define __NGRAMS_RAW_H__
 
-#include <sphinxbase/hash_table.h>
+#include <sphinxbase/word_hash.h>
 #include <sphinxbase/logmath.h>
 #include <sphinxbase/prim_type.h>
 #include <sphinxbase/pio.h>
 #include <sphinxbase/err.h>
 
+#include "arpa_text.h"
+
 typedef struct ngram_raw_s {
     uint32 *words;              /* array of word indexes, length corresponds to ngram order */
     float32 prob;
@@ -61,18 +63,28 @@ typedef union {
  */
 int ngram_ord_comparator(const void *a_raw, const void *b_raw);
 
+/**
+ * Sort raw ngrams of one order as ngram_ord_comparator() does, with a
+ * radix sort on the word ids, which must be below n_words.
+ */
+void ngrams_raw_sort(ngram_raw_t * raw_ngrams, uint32 count, int order,
+                     uint32 n_words);
+
 /**
  * Read ngrams of order > 1 from ARPA file
- * @param li     [in] sphinxbase file line iterator that point to bigram description in ARPA file
- * @param wid    [in] hashtable that maps string word representation to id
- * @param lmath  [in] log math used for log convertions
- * @param counts [in] amount of ngrams for each order
- * @param order  [in] maximum order of ngrams
- * @return            raw ngrams of order bigger than 1
+ * @param text     [in] ARPA file, the current line before bigram description
+ * @param lmath    [in] log math used for log convertions
+ * @param counts   [in,out] amount of ngrams for each order, lowered to
+ *                          the ngrams before a malformed line, which
+ *                          ends its order
+ * @param order    [in] maximum order of ngrams
+ * @param wid      [in] hashtable that maps string word representation to id
+ * @param n_thread [in] number of threads parsing the lines of a section
+ * @return              raw ngrams of order bigger than 1, NULL on format error
  */
-ngram_raw_t **ngrams_raw_read_arpa(lineiter_t ** li, logmath_t * lmath,
+ngram_raw_t **ngrams_raw_read_arpa(arpa_text_t * text, logmath_t * lmath,
                                    uint32 * counts, int order,
-                                   hash_table_t * wid);
+                                   word_hash_t * wid, int n_thread);
 
 /**
  * Reads ngrams of order > 1 from DMP file.
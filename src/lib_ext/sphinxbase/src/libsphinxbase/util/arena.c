@@ -0,0 +1,175 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2026 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+#include <string.h>
+
+#include "sphinxbase/arena.h"
+#include "sphinxbase/ckd_alloc.h"
+#include "sphinxbase/err.h"
+
+/*
+ * Blocks are chained in the order they were first used, their memory
+ * following the header. Resetting the arena moves the cursor back to
+ * the first one; the next allocations fill them again in that order,
+ * skipping any too small for a request, and a new block is linked in
+ * after the current one when none is left.
+ */
+typedef struct arena_block_s {
+    struct arena_block_s *next;
+    size_t size;                /**< Bytes of memory in this block */
+} arena_block_t;
+
+/* Header of a block, rounded up so that its memory is aligned */
+#define ARENA_HEADER \
+    ((sizeof(arena_block_t) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+#define ARENA_BLOCK_MEM(b) ((char *)(b) + ARENA_HEADER)
+
+struct arena_s {
+    int refcount;
+    arena_block_t *blocks;      /**< First block */
+    arena_block_t *cur;         /**< Block being filled, NULL before the first */
+    size_t cur_used;            /**< Bytes used in the current block */
+    size_t blksize;             /**< Size of the blocks */
+    size_t used;                /**< Bytes allocated since the last reset */
+};
+
+arena_t *
+arena_init(size_t blksize)
+{
+    arena_t *a;
+
+    a = ckd_calloc(1, sizeof(*a));
+    a->refcount = 1;
+    a->blksize = blksize ? blksize : ARENA_DEFAULT_BLKSIZE;
+    return a;
+}
+
+arena_t *
+arena_retain(arena_t *a)
+{
+    if (a == NULL)
+        return NULL;
+    ++a->refcount;
+    return a;
+}
+
+int
+arena_free(arena_t *a)
+{
+    arena_block_t *b, *next;
+
+    if (a == NULL)
+        return 0;
+    if (--a->refcount > 0)
+        return a->refcount;
+    for (b = a->blocks; b; b = next) {
+        next = b->next;
+        ckd_free(b);
+    }
+    ckd_free(a);
+    return 0;
+}
+
+arena_t *
+arena_reset(arena_t *a)
+{
+    arena_t *fresh;
+
+    if (a == NULL)
+        return NULL;
+    if (a->refcount > 1) {
+        fresh = arena_init(a->blksize);
+        arena_free(a);
+        return fresh;
+    }
+    a->cur = NULL;
+    a->cur_used = 0;
+    a->used = 0;
+    return a;
+}
+
+void *
+__arena_calloc__(arena_t *a, size_t n_elem, size_t elem_size,
+                 const char *caller_file, int caller_line)
+{
+    arena_block_t *b;
+    size_t size;
+    char *mem;
+
+    if (elem_size && n_elem > ((size_t)-1 - ARENA_HEADER - ARENA_ALIGN) / elem_size)
+        E_FATAL("arena_calloc of %lu x %lu bytes failed for caller at %s(%d)\n",
+                (unsigned long)n_elem, (unsigned long)elem_size,
+                caller_file, caller_line);
+    size = (n_elem * elem_size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (a->cur == NULL || a->cur_used + size > a->cur->size) {
+        /* Look for a block used before the reset, else link in a new one. */
+        for (b = a->cur ? a->cur->next : a->blocks; b; b = b->next)
+            if (b->size >= size)
+                break;
+        if (b == NULL) {
+            size_t blksize = size > a->blksize ? size : a->blksize;
+
+            b = __ckd_malloc__(ARENA_HEADER + blksize,
+                               caller_file, caller_line);
+            b->size = blksize;
+            if (a->cur) {
+                b->next = a->cur->next;
+                a->cur->next = b;
+            }
+            else {
+                b->next = a->blocks;
+                a->blocks = b;
+            }
+        }
+        a->cur = b;
+        a->cur_used = 0;
+    }
+
+    mem = ARENA_BLOCK_MEM(a->cur) + a->cur_used;
+    a->cur_used += size;
+    a->used += size;
+    memset(mem, 0, size);
+    return mem;
+}
+
+size_t
+arena_used(arena_t *a)
+{
+    return a->used;
+}
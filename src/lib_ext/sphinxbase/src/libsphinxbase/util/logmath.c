@@ -46,6 +46,17 @@
 #include "sphinxbase/bio.h"
 #include "sphinxbase/strfuncs.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LOGMATH_HAVE_AVX2 1
+#endif
+
+/* Fractional bits of the values of a compact add table. */
+#define LOGMATH_KNOT_FRAC 8
+/* Widest spacing of its values, beyond which the interpolation
+ * would overflow. */
+#define LOGMATH_KNOT_MAX_SHIFT 11
+
 struct logmath_s {
     logadd_t t;
     int refcount;
@@ -56,6 +67,14 @@ struct logmath_s {
     float64 inv_log_of_base;
     float64 inv_log10_of_base;
     int32 zero;
+    /* Compact add table: knots[i] is the full table at i <<
+     * knot_shift, with LOGMATH_KNOT_FRAC fractional bits, up to
+     * knot_max where it is zero (and once more after that). */
+    int32 *knots;
+    uint32 n_knots;
+    int32 knot_shift;
+    int32 knot_max;
+    int use_avx2;
 };
 
 logmath_t *
@@ -160,6 +179,59 @@ logmath_init(float64 base, int shift, int use_table)
     return lmath;
 }
 
+/* Fixed point value of the full add table at a (possibly
+ * fractional) difference. */
+static int32
+logmath_knot_value(logmath_t *lmath, float64 d)
+{
+    float64 scale = lmath->log_of_base * (1 << lmath->t.shift);
+
+    return (int32) (log1p(exp(-d * scale)) / scale
+                    * (1 << LOGMATH_KNOT_FRAC) + 0.5);
+}
+
+logmath_t *
+logmath_init_compact(float64 base, int shift)
+{
+    logmath_t *lmath;
+    float64 scale;
+    uint32 i, n;
+    int32 ks;
+
+    if ((lmath = logmath_init(base, shift, FALSE)) == NULL)
+        return NULL;
+
+    /* The second derivative of the add table is at most
+     * ln(base) * 2^shift / 4, so interpolating between values h
+     * apart is off by at most h^2 ln(base) 2^shift / 32.  Keep that
+     * under a quarter, so that the rounded sum is never more than one
+     * off the full table. */
+    scale = lmath->log_of_base * (1 << shift);
+    for (ks = 0; ks < LOGMATH_KNOT_MAX_SHIFT; ++ks)
+        if ((float64) (1 << (2 * (ks + 1))) * scale > 8.0)
+            break;
+    lmath->knot_shift = ks;
+
+    /* Up to the first value which rounds to zero. */
+    for (n = 0; logmath_knot_value(lmath, (float64) n * (1 << ks)) > 0; ++n)
+        ;
+    lmath->n_knots = n + 1;
+    lmath->knot_max = n << ks;
+    lmath->knots = ckd_calloc(lmath->n_knots + 1, sizeof(*lmath->knots));
+    for (i = 0; i < n; ++i)
+        lmath->knots[i] = logmath_knot_value(lmath, (float64) i * (1 << ks));
+
+#ifdef LOGMATH_HAVE_AVX2
+    __builtin_cpu_init();
+    lmath->use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+    E_INFO("Compact log-add table: %u values every %d (%u bytes)\n",
+           lmath->n_knots, 1 << ks,
+           (uint32) ((lmath->n_knots + 1) * sizeof(*lmath->knots)));
+
+    return lmath;
+}
+
 logmath_t *
 logmath_read(const char *file_name)
 {
@@ -349,6 +421,7 @@ logmath_free(logmath_t *lmath)
         mmio_file_unmap(lmath->filemap);
     else
         ckd_free(lmath->t.table);
+    ckd_free(lmath->knots);
     ckd_free(lmath);
     return 0;
 }
@@ -357,6 +430,12 @@ int32
 logmath_get_table_shape(logmath_t *lmath, uint32 *out_size,
                         uint32 *out_width, uint32 *out_shift)
 {
+    if (lmath->knots) {
+        if (out_size) *out_size = lmath->n_knots + 1;
+        if (out_width) *out_width = sizeof(*lmath->knots);
+        if (out_shift) *out_shift = lmath->t.shift;
+        return (lmath->n_knots + 1) * sizeof(*lmath->knots);
+    }
     if (out_size) *out_size = lmath->t.table_size;
     if (out_width) *out_width = lmath->t.width;
     if (out_shift) *out_shift = lmath->t.shift;
@@ -388,6 +467,28 @@ logmath_get_shift(logmath_t *lmath)
     return lmath->t.shift;
 }
 
+int
+logmath_is_compact(logmath_t *lmath)
+{
+    return lmath->knots != NULL;
+}
+
+/* Interpolate the compact add table at a difference d >= 0. */
+static int
+logmath_knot_add(logmath_t *lmath, int32 d)
+{
+    int32 i, frac, v;
+
+    if (d > lmath->knot_max)
+        d = lmath->knot_max;
+    i = d >> lmath->knot_shift;
+    frac = d & ((1 << lmath->knot_shift) - 1);
+    v = lmath->knots[i]
+        + (((lmath->knots[i + 1] - lmath->knots[i]) * frac)
+           >> lmath->knot_shift);
+    return (v + (1 << (LOGMATH_KNOT_FRAC - 1))) >> LOGMATH_KNOT_FRAC;
+}
+
 int
 logmath_add(logmath_t *lmath, int logb_x, int logb_y)
 {
@@ -400,7 +501,7 @@ logmath_add(logmath_t *lmath, int logb_x, int logb_y)
     if (logb_y <= lmath->zero)
         return logb_x;
 
-    if (t->table == NULL)
+    if (t->table == NULL && lmath->knots == NULL)
         return logmath_add_exact(lmath, logb_x, logb_y);
 
     /* d must be positive, obviously. */
@@ -417,6 +518,8 @@ logmath_add(logmath_t *lmath, int logb_x, int logb_y)
         /* Some kind of overflow has occurred, fail gracefully. */
         return r;
     }
+    if (lmath->knots)
+        return r + logmath_knot_add(lmath, d);
     if ((size_t)d >= t->table_size) {
         /* If this happens, it's not actually an error, because the
          * last entry in the logadd table is guaranteed to be zero.
@@ -435,6 +538,62 @@ logmath_add(logmath_t *lmath, int logb_x, int logb_y)
     return r;
 }
 
+#ifdef LOGMATH_HAVE_AVX2
+/* logmath_knot_add() eight at a time, an overflowing difference
+ * being clamped like any other large one. */
+__attribute__((target("avx2")))
+static void
+logmath_add_array_avx2(logmath_t *lmath, int *logb_x, int const *logb_y,
+                       size_t n)
+{
+    __m256i zero = _mm256_set1_epi32(lmath->zero);
+    __m256i dmax = _mm256_set1_epi32(lmath->knot_max);
+    __m256i fmask = _mm256_set1_epi32((1 << lmath->knot_shift) - 1);
+    __m256i half = _mm256_set1_epi32(1 << (LOGMATH_KNOT_FRAC - 1));
+    __m128i ks = _mm_cvtsi32_si128(lmath->knot_shift);
+    __m128i fbits = _mm_cvtsi32_si128(LOGMATH_KNOT_FRAC);
+    int const *knots = (int const *) lmath->knots;
+    size_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *) (logb_x + i));
+        __m256i y = _mm256_loadu_si256((__m256i const *) (logb_y + i));
+        __m256i r = _mm256_max_epi32(x, y);
+        __m256i d = _mm256_min_epu32(_mm256_sub_epi32(r, _mm256_min_epi32(x, y)), dmax);
+        __m256i idx = _mm256_srl_epi32(d, ks);
+        __m256i frac = _mm256_and_si256(d, fmask);
+        __m256i k0 = _mm256_i32gather_epi32(knots, idx, 4);
+        __m256i k1 = _mm256_i32gather_epi32(knots + 1, idx, 4);
+        __m256i v = _mm256_add_epi32(k0, _mm256_sra_epi32
+                                     (_mm256_mullo_epi32(_mm256_sub_epi32(k1, k0), frac), ks));
+
+        r = _mm256_add_epi32(r, _mm256_sra_epi32(_mm256_add_epi32(v, half), fbits));
+        /* x + 0 = x, 0 + y = y */
+        r = _mm256_blendv_epi8(x, r, _mm256_cmpgt_epi32(y, zero));
+        r = _mm256_blendv_epi8(y, r, _mm256_cmpgt_epi32(x, zero));
+        _mm256_storeu_si256((__m256i *) (logb_x + i), r);
+    }
+    for (; i < n; ++i)
+        logb_x[i] = logmath_add(lmath, logb_x[i], logb_y[i]);
+}
+#endif
+
+void
+logmath_add_array(logmath_t *lmath, int *logb_x, int const *logb_y,
+                  size_t n)
+{
+    size_t i;
+
+#ifdef LOGMATH_HAVE_AVX2
+    if (lmath->use_avx2) {
+        logmath_add_array_avx2(lmath, logb_x, logb_y, n);
+        return;
+    }
+#endif
+    for (i = 0; i < n; ++i)
+        logb_x[i] = logmath_add(lmath, logb_x[i], logb_y[i]);
+}
+
 int
 logmath_add_exact(logmath_t *lmath, int logb_p, int logb_q)
 {
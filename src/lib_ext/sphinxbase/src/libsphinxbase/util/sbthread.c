@@ -655,8 +655,9 @@ sbevent_wait(sbevent_t *evt, int sec, int nsec)
 
     /* Lock the mutex before we check its signalled state. */
     pthread_mutex_lock(&evt->mtx);
-    /* If it's not signalled, then wait until it is. */
-    if (!evt->signalled)
+    /* If it's not signalled, then wait until it is (condition
+     * variables can wake up without being signalled). */
+    while (!evt->signalled && rv == 0)
         rv = cond_timed_wait(&evt->cond, &evt->mtx, sec, nsec);
     /* Set its state to unsignalled if we were successful. */
     if (rv == 0)
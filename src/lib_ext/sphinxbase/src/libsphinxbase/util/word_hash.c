@@ -0,0 +1,348 @@
+/* -*- c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/* ====================================================================
+ * Copyright (c) 2026 Carnegie Mellon University.  All rights
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * This work was supported in part by funding from the Defense Advanced 
+ * Research Projects Agency and the National Science Foundation of the 
+ * United States of America, and the CMU Sphinx Speech Consortium.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CARNEGIE MELLON UNIVERSITY ``AS IS'' AND 
+ * ANY EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL CARNEGIE MELLON UNIVERSITY
+ * NOR ITS EMPLOYEES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT 
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, 
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY 
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT 
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE 
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ====================================================================
+ *
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WORD_HASH_SSE2 1
+#endif
+
+#include "sphinxbase/word_hash.h"
+#include "sphinxbase/hash_table.h"
+#include "sphinxbase/ckd_alloc.h"
+#include "sphinxbase/case.h"
+
+/* Control byte of a free slot, never one of a full one, 0 to 127 */
+#define WORD_HASH_EMPTY 0x80
+
+#define ROTL32(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
+/*
+ * Hash of a key, filling the prefix kept in its slot. The bytes of the
+ * prefix are gathered in registers and hashed 4 at a time as in
+ * MurmurHash3, the rest of a long key a byte at a time, then every bit
+ * is mixed with every other, as the low ones go to the control byte and
+ * the others pick the group.
+ */
+static uint32
+word_hash_key(word_hash_t * h, const char *key, size_t len, uint32 * prefix)
+{
+    uint32 hash = (uint32) len;
+    size_t i, j;
+
+    for (i = 0; i < WORD_HASH_PREFIX / 4; i++) {
+        uint32 k = 0;
+
+        for (j = 0; j < 4 && i * 4 + j < len; j++) {
+            char c = h->nocase ? UPPER_CASE(key[i * 4 + j]) : key[i * 4 + j];
+
+            k |= (uint32) (uint8) c << (j * 8);
+        }
+        prefix[i] = k;
+
+        k *= 0xcc9e2d51u;
+        k = ROTL32(k, 15) * 0x1b873593u;
+        hash ^= k;
+        hash = ROTL32(hash, 13) * 5 + 0xe6546b64u;
+    }
+    for (i = WORD_HASH_PREFIX; i < len; i++) {
+        char c = h->nocase ? UPPER_CASE(key[i]) : key[i];
+
+        hash = (hash ^ (uint8) c) * 16777619u;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/* Bit i is set if control byte i of the group is c */
+static uint32
+group_match(const uint8 * ctrl, uint8 c)
+{
+#ifdef WORD_HASH_SSE2
+    __m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+
+    return (uint32) _mm_movemask_epi8(_mm_cmpeq_epi8(group,
+                                                     _mm_set1_epi8((char) c)));
+#else
+    uint32 match = 0;
+    int i;
+
+    for (i = 0; i < WORD_HASH_GROUP; i++)
+        match |= (uint32) (ctrl[i] == c) << i;
+    return match;
+#endif
+}
+
+static int
+lowest_bit(uint32 match)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(match);
+#else
+    int i = 0;
+
+    while (!(match & 1)) {
+        match >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+static int
+key_equal(word_hash_t * h, const word_hash_slot_t * slot, const char *key,
+          size_t len, uint32 hash, const uint32 * prefix)
+{
+    size_t i;
+
+    if (slot->hash != hash || slot->len != len
+        || slot->prefix[0] != prefix[0] || slot->prefix[1] != prefix[1]
+        || slot->prefix[2] != prefix[2])
+        return FALSE;
+    if (len <= WORD_HASH_PREFIX)
+        return TRUE;
+    if (!h->nocase)
+        return memcmp(slot->key + WORD_HASH_PREFIX, key + WORD_HASH_PREFIX,
+                      len - WORD_HASH_PREFIX) == 0;
+    for (i = WORD_HASH_PREFIX; i < len; i++)
+        if (UPPER_CASE(slot->key[i]) != UPPER_CASE(key[i]))
+            return FALSE;
+    return TRUE;
+}
+
+/* Slots a group can fill before the table grows, 7 in 8 */
+#define WORD_HASH_MAX_LOAD (WORD_HASH_GROUP / 8 * 7)
+
+/*
+ * First group probed for a hash, from the bits above the control byte
+ * scaled to the number of groups, which needn't be a power of 2.
+ */
+static uint32
+first_group(word_hash_t * h, uint32 hash)
+{
+    return (uint32) (((uint64) (hash >> 7) * h->n_group) >> 25);
+}
+
+static uint32
+next_group(word_hash_t * h, uint32 group)
+{
+    return group + 1 == h->n_group ? 0 : group + 1;
+}
+
+/*
+ * Slot of the key, or NULL. The groups are probed one after the other
+ * from the one the hash picks; a key can't be past a group with a free
+ * slot.
+ */
+static word_hash_slot_t *
+word_hash_find(word_hash_t * h, const char *key, size_t len, uint32 hash,
+               const uint32 * prefix)
+{
+    uint32 group = first_group(h, hash);
+
+    for (;;) {
+        const uint8 *ctrl = h->ctrl + group * WORD_HASH_GROUP;
+        uint32 match = group_match(ctrl, hash & 0x7f);
+
+        while (match) {
+            word_hash_slot_t *slot = h->slot + group * WORD_HASH_GROUP
+                + lowest_bit(match);
+
+            if (key_equal(h, slot, key, len, hash, prefix))
+                return slot;
+            match &= match - 1;
+        }
+        if (group_match(ctrl, WORD_HASH_EMPTY))
+            return NULL;
+        group = next_group(h, group);
+    }
+}
+
+/* First free slot for a hash, there is always one */
+static word_hash_slot_t *
+word_hash_free_slot(word_hash_t * h, uint32 hash)
+{
+    uint32 group = first_group(h, hash);
+    uint32 empty;
+
+    while ((empty = group_match(h->ctrl + group * WORD_HASH_GROUP,
+                                WORD_HASH_EMPTY)) == 0)
+        group = next_group(h, group);
+
+    group = group * WORD_HASH_GROUP + lowest_bit(empty);
+    h->ctrl[group] = hash & 0x7f;
+    return h->slot + group;
+}
+
+static void
+word_hash_alloc(word_hash_t * h, uint32 n_group)
+{
+    h->n_group = n_group;
+    h->ctrl = ckd_malloc(n_group * WORD_HASH_GROUP);
+    memset(h->ctrl, WORD_HASH_EMPTY, n_group * WORD_HASH_GROUP);
+    h->slot = ckd_malloc(n_group * WORD_HASH_GROUP * sizeof(*h->slot));
+}
+
+/* Double the number of groups, moving the entries with their hashes */
+static void
+word_hash_grow(word_hash_t * h)
+{
+    uint8 *ctrl = h->ctrl;
+    word_hash_slot_t *slot = h->slot;
+    uint32 n_slot = h->n_group * WORD_HASH_GROUP;
+    uint32 i;
+
+    word_hash_alloc(h, h->n_group * 2);
+    for (i = 0; i < n_slot; i++)
+        if (ctrl[i] != WORD_HASH_EMPTY)
+            *word_hash_free_slot(h, slot[i].hash) = slot[i];
+
+    ckd_free(ctrl);
+    ckd_free(slot);
+}
+
+word_hash_t *
+word_hash_new(int32 size, int32 casearg)
+{
+    word_hash_t *h = ckd_calloc(1, sizeof(*h));
+    uint32 n_group = 1;
+
+    if (size > WORD_HASH_MAX_LOAD)
+        n_group = (size + WORD_HASH_MAX_LOAD - 1) / WORD_HASH_MAX_LOAD;
+
+    h->nocase = (casearg != HASH_CASE_YES);
+    word_hash_alloc(h, n_group);
+    return h;
+}
+
+void
+word_hash_free(word_hash_t * h)
+{
+    if (h == NULL)
+        return;
+    ckd_free(h->ctrl);
+    ckd_free(h->slot);
+    ckd_free(h);
+}
+
+static word_hash_slot_t *
+word_hash_add(word_hash_t * h, const char *key, size_t len, uint32 hash,
+              const uint32 * prefix)
+{
+    word_hash_slot_t *slot;
+
+    if ((uint32) h->inuse + 1 > h->n_group * WORD_HASH_MAX_LOAD)
+        word_hash_grow(h);
+
+    slot = word_hash_free_slot(h, hash);
+    slot->hash = hash;
+    slot->key = key;
+    slot->len = (uint32) len;
+    memcpy(slot->prefix, prefix, sizeof(slot->prefix));
+    h->inuse++;
+    return slot;
+}
+
+int32
+word_hash_enter(word_hash_t * h, const char *key, int32 val)
+{
+    uint32 prefix[WORD_HASH_PREFIX / 4];
+    size_t len = strlen(key);
+    uint32 hash = word_hash_key(h, key, len, prefix);
+    word_hash_slot_t *slot = word_hash_find(h, key, len, hash, prefix);
+
+    if (slot)
+        return slot->val;
+
+    slot = word_hash_add(h, key, len, hash, prefix);
+    slot->val = val;
+    return val;
+}
+
+int32
+word_hash_replace(word_hash_t * h, const char *key, int32 val)
+{
+    uint32 prefix[WORD_HASH_PREFIX / 4];
+    size_t len = strlen(key);
+    uint32 hash = word_hash_key(h, key, len, prefix);
+    word_hash_slot_t *slot = word_hash_find(h, key, len, hash, prefix);
+    int32 prev = val;
+
+    if (slot)
+        prev = slot->val;
+    else
+        slot = word_hash_add(h, key, len, hash, prefix);
+
+    slot->key = key;
+    slot->val = val;
+    return prev;
+}
+
+int32
+word_hash_lookup_bkey(word_hash_t * h, const char *key, size_t len,
+                      int32 * val)
+{
+    uint32 prefix[WORD_HASH_PREFIX / 4];
+    uint32 hash = word_hash_key(h, key, len, prefix);
+    word_hash_slot_t *slot = word_hash_find(h, key, len, hash, prefix);
+
+    if (slot == NULL)
+        return -1;
+    if (val)
+        *val = slot->val;
+    return 0;
+}
+
+int32
+word_hash_lookup(word_hash_t * h, const char *key, int32 * val)
+{
+    return word_hash_lookup_bkey(h, key, strlen(key), val);
+}
+
+void
+word_hash_empty(word_hash_t * h)
+{
+    memset(h->ctrl, WORD_HASH_EMPTY, h->n_group * WORD_HASH_GROUP);
+    h->inuse = 0;
+}
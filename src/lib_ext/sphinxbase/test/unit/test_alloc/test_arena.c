@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <arena.h>
+
+#include "test_macros.h"
+
+struct bogus {
+	char const *str;
+	long foobie;
+};
+
+int
+main(int argc, char *argv[])
+{
+	arena_t *a, *b;
+	struct bogus *bogus1, *bogus2, *first;
+	char *big;
+	int i;
+
+	TEST_ASSERT(a = arena_init(1024));
+	TEST_EQUAL(0, arena_used(a));
+	bogus1 = arena_calloc(a, 1, sizeof(*bogus1));
+	TEST_ASSERT(bogus1->str == NULL && bogus1->foobie == 0);
+	bogus1->str = "hello";
+	bogus1->foobie = 42;
+	bogus2 = arena_calloc(a, 1, sizeof(*bogus2));
+	bogus2->str = "goodbye";
+	bogus2->foobie = 69;
+	TEST_EQUAL(bogus1->foobie, 42);
+	TEST_EQUAL(0, strcmp(bogus1->str, "hello"));
+	TEST_EQUAL(0, ((uintptr_t)bogus2) % ARENA_ALIGN);
+	TEST_EQUAL(2 * ARENA_ALIGN, arena_used(a));
+
+	/* Fill several blocks, with one too large for them. */
+	first = bogus1;
+	for (i = 0; i < 200; ++i) {
+		bogus1 = arena_calloc(a, 3, sizeof(*bogus1));
+		TEST_EQUAL(0, ((uintptr_t)bogus1) % ARENA_ALIGN);
+		bogus1[2].foobie = i;
+	}
+	big = arena_calloc(a, 5000, 1);
+	memset(big, 0xff, 5000);
+	bogus1 = arena_calloc(a, 1, sizeof(*bogus1));
+	TEST_EQUAL(0, bogus1->foobie);
+	TEST_EQUAL(bogus2->foobie, 69);
+
+	/* Nothing else holds it, so the blocks are reused, zeroed. */
+	TEST_ASSERT(arena_reset(a) == a);
+	TEST_EQUAL(0, arena_used(a));
+	bogus1 = arena_calloc(a, 1, sizeof(*bogus1));
+	TEST_ASSERT(bogus1 == first);
+	TEST_ASSERT(bogus1->str == NULL);
+	big = arena_calloc(a, 5000, 1);
+	for (i = 0; i < 5000; ++i)
+		TEST_EQUAL(0, big[i]);
+
+	/* A reference held elsewhere keeps the memory as it is. */
+	bogus1->foobie = 42;
+	b = arena_retain(a);
+	a = arena_reset(a);
+	TEST_ASSERT(a != b);
+	TEST_EQUAL(0, arena_used(a));
+	TEST_EQUAL(bogus1->foobie, 42);
+	bogus2 = arena_calloc(a, 1, sizeof(*bogus2));
+	TEST_ASSERT(bogus2 != bogus1);
+	TEST_EQUAL(0, arena_free(b));
+	TEST_EQUAL(0, arena_free(a));
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "fe.h"
+#include "cmd_ln.h"
+#include "ckd_alloc.h"
+
+#include "test_macros.h"
+
+/* The vectorised sums round differently from the portable code, by
+ * far less than this. */
+#define SIMD_EPSILON 1e-4
+
+static mfcc_t **
+process_file(cmd_ln_t *config, int16 *buf, size_t nsamp, int32 *out_nfr)
+{
+    fe_t *fe;
+    mfcc_t **cepbuf;
+    int16 const *inptr;
+    int32 nfr, total;
+
+    TEST_ASSERT(fe = fe_init_auto_r(config));
+    TEST_ASSERT(fe_process_frames(fe, NULL, &nsamp, NULL, &nfr, NULL) >= 0);
+    cepbuf = ckd_calloc_2d(nfr + 1, fe_get_output_size(fe), sizeof(**cepbuf));
+
+    fe_start_stream(fe);
+    TEST_EQUAL(0, fe_start_utt(fe));
+    inptr = buf;
+    total = nfr;
+    TEST_ASSERT(fe_process_frames(fe, &inptr, &nsamp, cepbuf, &total, NULL) >= 0);
+    TEST_ASSERT(fe_end_utt(fe, cepbuf[total], &nfr) >= 0);
+    *out_nfr = total + nfr;
+
+    fe_free(fe);
+    return cepbuf;
+}
+
+static void
+compare_simd(char const *transform, char const *remove_dc,
+             int16 *buf, size_t nsamp, fe_simd_t simd)
+{
+    static const arg_t fe_args[] = {
+        waveform_to_cepstral_command_line_macro(),
+        { NULL, 0, NULL, NULL }
+    };
+    cmd_ln_t *config;
+    mfcc_t **portable, **vectorised;
+    int32 nfr1, nfr2, i, j, ncep;
+    float64 maxdiff = 0;
+
+    TEST_ASSERT(config = cmd_ln_init(NULL, fe_args, TRUE,
+                                     "-transform", transform,
+                                     "-remove_dc", remove_dc,
+                                     "-remove_silence", "no",
+                                     NULL));
+    ncep = cmd_ln_int32_r(config, "-ncep");
+
+    TEST_EQUAL(FE_SIMD_NONE, fe_set_simd(FE_SIMD_NONE));
+    portable = process_file(config, buf, nsamp, &nfr1);
+    TEST_EQUAL(simd, fe_set_simd(simd));
+    vectorised = process_file(config, buf, nsamp, &nfr2);
+
+    TEST_EQUAL(nfr1, nfr2);
+    for (i = 0; i < nfr1; ++i) {
+        for (j = 0; j < ncep; ++j) {
+            float64 diff = fabs(MFCC2FLOAT(portable[i][j])
+                                - MFCC2FLOAT(vectorised[i][j]));
+            if (diff > maxdiff)
+                maxdiff = diff;
+        }
+    }
+    printf("%s -transform %s -remove_dc %s: %d frames, max difference %g\n",
+           simd == FE_SIMD_AVX2 ? "AVX2" : "SSE2", transform, remove_dc,
+           nfr1, maxdiff);
+    TEST_ASSERT(maxdiff < SIMD_EPSILON);
+
+    ckd_free_2d(portable);
+    ckd_free_2d(vectorised);
+    cmd_ln_free_r(config);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static char const *transforms[] = { "legacy", "dct", "htk" };
+    FILE *raw;
+    int16 *buf;
+    size_t nsamp;
+    fe_simd_t best, simd;
+    int i;
+
+    TEST_ASSERT(raw = fopen(TESTDATADIR "/chan3.raw", "rb"));
+    fseek(raw, 0, SEEK_END);
+    nsamp = ftell(raw) / sizeof(int16);
+    fseek(raw, 0, SEEK_SET);
+    buf = ckd_calloc(nsamp, sizeof(*buf));
+    TEST_EQUAL(nsamp, fread(buf, sizeof(int16), nsamp, raw));
+    fclose(raw);
+
+    best = fe_set_simd(FE_SIMD_AVX2);
+    if (best == FE_SIMD_NONE) {
+        printf("No SIMD instruction set available, nothing to compare\n");
+        ckd_free(buf);
+        return 0;
+    }
+
+    for (simd = FE_SIMD_SSE2; simd <= best; ++simd)
+        for (i = 0; i < 3; ++i) {
+            compare_simd(transforms[i], "no", buf, nsamp, simd);
+            compare_simd(transforms[i], "yes", buf, nsamp, simd);
+        }
+
+    ckd_free(buf);
+    return 0;
+}
@@ -0,0 +1,110 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "feat.h"
+#include "cmn.h"
+#include "ckd_alloc.h"
+#include "test_macros.h"
+
+#define N_FRAME 6
+#define N_CEP 13
+
+static const float64 data[N_FRAME][N_CEP] = {
+	{ 15.114, -1.424, -0.953, 0.186, -0.656, -0.226, -0.105, -0.412, -0.024, -0.091, -0.124, -0.158, -0.197 },
+	{ 14.729, -1.313, -0.892, 0.140, -0.676, -0.089, -0.313, -0.422, -0.058, -0.101, -0.100, -0.128, -0.123 },
+	/* Zero energy frame, skipped. */
+	{ -1.0, 5.0, 5.0, 5.0, 5.0, 5.0, 5.0, 5.0, 5.0, 5.0, 5.0, 5.0, 5.0 },
+	{ 14.557, -1.676, -0.864, 0.118, -0.445, -0.168, -0.069, -0.503, -0.013, 0.007, -0.056, -0.075, -0.237 },
+	{ 14.665, -1.498, -0.582, 0.209, -0.487, -0.247, -0.142, -0.439, 0.059, -0.058, -0.265, -0.109, -0.196 },
+	{ 15.025, -1.199, -0.607, 0.235, -0.499, -0.080, -0.062, -0.554, -0.209, -0.124, -0.445, -0.352, -0.400 },
+};
+
+static mfcc_t **
+frames(void)
+{
+	mfcc_t **mfc = (mfcc_t **)ckd_calloc_2d(N_FRAME, N_CEP, sizeof(mfcc_t));
+	int32 i, j;
+
+	for (i = 0; i < N_FRAME; ++i)
+		for (j = 0; j < N_CEP; ++j)
+			mfc[i][j] = FLOAT2MFCC(data[i][j]);
+	return mfc;
+}
+
+int
+main(int argc, char *argv[])
+{
+	feat_t *fcb;
+	mfcc_t **mfc, **whole;
+	mfcc_t ***whole_feats, ***block_feats;
+	mfcc_t mean[N_CEP];
+	int32 i, j, ncep, nfr;
+
+	/* Accumulating sets the mean of the frames with energy, without
+	 * touching them. */
+	fcb = feat_init("1s_c_d_dd", CMN_FIXED, 0, AGC_NONE, 1, N_CEP);
+	TEST_ASSERT(fcb->cmn_struct);
+	whole_feats = (mfcc_t ***)ckd_calloc_3d(N_FRAME, 1, feat_dimension(fcb), sizeof(mfcc_t));
+	block_feats = (mfcc_t ***)ckd_calloc_3d(N_FRAME, 1, feat_dimension(fcb), sizeof(mfcc_t));
+	mfc = frames();
+	cmn_accum(fcb->cmn_struct, mfc, 2);
+	cmn_accum(fcb->cmn_struct, mfc + 2, N_FRAME - 2);
+	TEST_EQUAL(5, fcb->cmn_struct->nframe);
+	TEST_EQUAL_FLOAT(mfc[2][1], FLOAT2MFCC(5.0));
+	cmn_live_update(fcb->cmn_struct);
+	for (j = 0; j < N_CEP; ++j) {
+		float64 sum = 0;
+
+		for (i = 0; i < N_FRAME; ++i)
+			if (i != 2)
+				sum += data[i][j];
+		TEST_EQUAL_FLOAT(MFCC2FLOAT(fcb->cmn_struct->cmn_mean[j]), sum / 5);
+		mean[j] = fcb->cmn_struct->cmn_mean[j];
+	}
+
+	/* Fixed CMN of blocks normalizes with that mean and never updates
+	 * it, so the features are the same as for the whole utterance at
+	 * once. */
+	whole = frames();
+	ncep = N_FRAME;
+	nfr = feat_s2mfc2feat_live(fcb, whole, &ncep, TRUE, TRUE, whole_feats);
+	TEST_EQUAL(N_FRAME, nfr);
+	TEST_EQUAL(CMN_FIXED, fcb->cmn);
+	nfr = 0;
+	for (i = 0; i < N_FRAME; i += 2) {
+		ncep = 2;
+		nfr += feat_s2mfc2feat_live(fcb, mfc + i, &ncep, i == 0,
+					    i + 2 == N_FRAME, block_feats + nfr);
+		TEST_EQUAL(2, ncep);
+	}
+	feat_update_stats(fcb);
+	TEST_EQUAL(N_FRAME, nfr);
+	TEST_EQUAL(CMN_FIXED, fcb->cmn);
+	for (i = 0; i < N_FRAME; ++i) {
+		for (j = 0; j < N_CEP; ++j) {
+			/* The cepstra are normalized in place. */
+			TEST_EQUAL_FLOAT(MFCC2FLOAT(mfc[i][j]), i == 2 ? data[i][j]
+					 : data[i][j] - MFCC2FLOAT(mean[j]));
+			TEST_EQUAL(whole[i][j], mfc[i][j]);
+		}
+		for (j = 0; j < feat_dimension(fcb); ++j)
+			TEST_EQUAL_FLOAT(MFCC2FLOAT(whole_feats[i][0][j]),
+					 MFCC2FLOAT(block_feats[i][0][j]));
+	}
+	for (j = 0; j < N_CEP; ++j)
+		TEST_EQUAL(mean[j], fcb->cmn_struct->cmn_mean[j]);
+	TEST_EQUAL(0, strcmp("fixed", cmn_type_str[cmn_type_from_str("fixed")]));
+
+	ckd_free_2d(mfc);
+	ckd_free_2d(whole);
+	ckd_free_3d(whole_feats);
+	ckd_free_3d(block_feats);
+	feat_free(fcb);
+
+	return 0;
+}
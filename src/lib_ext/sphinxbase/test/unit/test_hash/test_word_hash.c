@@ -0,0 +1,80 @@
+/**
+ * @file test_word_hash.c Test open addressing tables of word ids
+ */
+
+#include "word_hash.h"
+#include "hash_table.h"
+#include "ckd_alloc.h"
+#include "test_macros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_WORDS 5000
+
+int
+main(int argc, char *argv[])
+{
+	word_hash_t *h;
+	char **words;
+	char *foo2 = ckd_salloc("foo");
+	int32 val;
+	int i;
+
+	/* Insertion and replacement, as with hash_table_t. */
+	TEST_ASSERT(h = word_hash_new(42, HASH_CASE_YES));
+	TEST_EQUAL(1, word_hash_enter(h, "foo", 1));
+	TEST_EQUAL(1, word_hash_enter(h, foo2, 2));
+	TEST_EQUAL(1, word_hash_replace(h, foo2, 3));
+	TEST_EQUAL(4, word_hash_replace(h, "bar", 4));
+	TEST_EQUAL(0, word_hash_lookup(h, "foo", &val));
+	TEST_EQUAL(3, val);
+	TEST_EQUAL(-1, word_hash_lookup(h, "FOO", &val));
+	TEST_EQUAL(0, word_hash_lookup_bkey(h, "barbaz", 3, &val));
+	TEST_EQUAL(4, val);
+	TEST_EQUAL(-1, word_hash_lookup_bkey(h, "barbaz", 4, NULL));
+	TEST_EQUAL(2, word_hash_inuse(h));
+	word_hash_empty(h);
+	TEST_EQUAL(-1, word_hash_lookup(h, "foo", NULL));
+	TEST_EQUAL(0, word_hash_inuse(h));
+	word_hash_free(h);
+
+	/* Case insensitive keys, longer than the prefix kept in the slots. */
+	TEST_ASSERT(h = word_hash_new(0, HASH_CASE_NO));
+	TEST_EQUAL(7, word_hash_enter(h, "Supercalifragilistic", 7));
+	TEST_EQUAL(7, word_hash_enter(h, "SUPERCALIFRAGILISTIC", 8));
+	TEST_EQUAL(0, word_hash_lookup(h, "supercalifragilistic", &val));
+	TEST_EQUAL(7, val);
+	TEST_EQUAL(-1, word_hash_lookup(h, "supercalifragilisticexpialidocious", NULL));
+	TEST_EQUAL(-1, word_hash_lookup(h, "supercalifragilistix", NULL));
+	word_hash_free(h);
+
+	/* Growing well past the expected size keeps every entry. */
+	TEST_ASSERT(h = word_hash_new(10, HASH_CASE_YES));
+	words = ckd_calloc(N_WORDS, sizeof(*words));
+	for (i = 0; i < N_WORDS; i++) {
+		char word[32];
+		sprintf(word, "%s%d", (i % 3) ? "w" : "a-much-longer-word-", i);
+		words[i] = ckd_salloc(word);
+		TEST_EQUAL(i, word_hash_enter(h, words[i], i));
+	}
+	TEST_EQUAL(N_WORDS, word_hash_inuse(h));
+	for (i = 0; i < N_WORDS; i++) {
+		TEST_EQUAL(0, word_hash_lookup(h, words[i], &val));
+		TEST_EQUAL(i, val);
+	}
+	TEST_EQUAL(-1, word_hash_lookup(h, "w0", NULL));
+	TEST_EQUAL(-1, word_hash_lookup(h, "", NULL));
+	TEST_EQUAL(N_WORDS, word_hash_enter(h, "", N_WORDS));
+	TEST_EQUAL(0, word_hash_lookup(h, "", &val));
+	TEST_EQUAL(N_WORDS, val);
+
+	for (i = 0; i < N_WORDS; i++)
+		ckd_free(words[i]);
+	ckd_free(words);
+	word_hash_free(h);
+	ckd_free(foo2);
+
+	return 0;
+}
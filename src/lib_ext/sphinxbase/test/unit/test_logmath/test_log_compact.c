@@ -0,0 +1,112 @@
+#include <logmath.h>
+#include <ckd_alloc.h>
+
+#include "test_macros.h"
+
+#define N_PAIRS 1003
+
+static uint32 seed = 12345;
+
+static int32
+rand_int(int32 n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % n;
+}
+
+/* The compact table must add up to one away from the full one, for
+ * every difference of the operands. */
+static void
+compare(float64 base, int shift)
+{
+	logmath_t *full, *compact;
+	uint32 size, d;
+	int32 worst = 0;
+
+	full = logmath_init(base, shift, 1);
+	compact = logmath_init_compact(base, shift);
+	TEST_ASSERT(full);
+	TEST_ASSERT(compact);
+	TEST_ASSERT(logmath_is_compact(compact));
+	TEST_ASSERT(!logmath_is_compact(full));
+	logmath_get_table_shape(full, &size, NULL, NULL);
+	for (d = 0; d < size + 1000; ++d) {
+		int32 x = -1000000 >> shift;
+		int32 diff = logmath_add(compact, x, x - d)
+			- logmath_add(full, x, x - d);
+
+		TEST_ASSERT(abs(diff) <= 1);
+		if (abs(diff) > worst)
+			worst = abs(diff);
+		TEST_EQUAL(logmath_add(compact, x - d, x),
+			   logmath_add(compact, x, x - d));
+	}
+	printf("base %f shift %d: %d bytes instead of %d, off by %d at most\n",
+	       base, shift, logmath_get_table_shape(compact, NULL, NULL, NULL),
+	       logmath_get_table_shape(full, NULL, NULL, NULL), worst);
+	logmath_free(full);
+	logmath_free(compact);
+}
+
+/* Adding arrays must give the same sums as one pair at a time. */
+static void
+compare_array(logmath_t *lmath)
+{
+	int *x, *y, *sum;
+	int i, n;
+
+	x = ckd_calloc(N_PAIRS, sizeof(*x));
+	y = ckd_calloc(N_PAIRS, sizeof(*y));
+	sum = ckd_calloc(N_PAIRS, sizeof(*sum));
+	for (i = 0; i < N_PAIRS; ++i) {
+		switch (rand_int(6)) {
+		case 0:
+			x[i] = logmath_get_zero(lmath);
+			break;
+		case 1:
+			x[i] = 0x7fffffff - rand_int(1000);
+			break;
+		default:
+			x[i] = -rand_int(500000);
+		}
+		y[i] = rand_int(6) == 0 ? logmath_get_zero(lmath) - rand_int(10)
+			: x[i] - rand_int(200000) + 100000;
+		sum[i] = logmath_add(lmath, x[i], y[i]);
+	}
+	/* Every length, for the elements left over after the vectors. */
+	for (n = 0; n < 20; ++n) {
+		int *z = ckd_calloc(n + 1, sizeof(*z));
+
+		memcpy(z, x, n * sizeof(*z));
+		logmath_add_array(lmath, z, y, n);
+		TEST_EQUAL(0, memcmp(z, sum, n * sizeof(*z)));
+		ckd_free(z);
+	}
+	logmath_add_array(lmath, x, y, N_PAIRS);
+	TEST_EQUAL(0, memcmp(x, sum, N_PAIRS * sizeof(*x)));
+	ckd_free(x);
+	ckd_free(y);
+	ckd_free(sum);
+}
+
+int
+main(int argc, char *argv[])
+{
+	logmath_t *lmath;
+
+	compare(1.0001, 0);
+	compare(1.0001, 8);
+	compare(1.0003, 0);
+	compare(1.01, 2);
+
+	lmath = logmath_init_compact(1.0001, 0);
+	compare_array(lmath);
+	/* No table to write. */
+	TEST_ASSERT(logmath_write(lmath, "tmp.logadd") < 0);
+	logmath_free(lmath);
+	lmath = logmath_init(1.0001, 0, 1);
+	compare_array(lmath);
+	logmath_free(lmath);
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+#include <ngram_model.h>
+#include <logmath.h>
+#include <cmd_ln.h>
+#include <strfuncs.h>
+#include <err.h>
+
+#include "test_macros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const arg_t defn[] = {
+	{ "-mmap", ARG_BOOLEAN, "yes", "Memory map the language model" },
+	{ NULL, 0, NULL, NULL }
+};
+
+static int
+test_lm_vals(ngram_model_t *model)
+{
+	int32 n_used;
+
+	TEST_ASSERT(model);
+	TEST_EQUAL(ngram_wid(model, "<UNK>"), 0);
+	TEST_EQUAL(strcmp(ngram_word(model, 0), "<UNK>"), 0);
+	TEST_EQUAL(ngram_wid(model, "absolute"), 13);
+	TEST_EQUAL(strcmp(ngram_word(model, 13), "absolute"), 0);
+	/* Test unigrams. */
+	TEST_EQUAL_LOG(ngram_score(model, "<UNK>", NULL), -75346);
+	TEST_EQUAL_LOG(ngram_bg_score(model, ngram_wid(model, "sphinxtrain"),
+				  NGRAM_INVALID_WID, &n_used), -64208);
+	TEST_EQUAL(n_used, 1);
+	/* Test bigrams. */
+	TEST_EQUAL_LOG(ngram_score(model, "huggins", "david", NULL), -831);
+	/* Test trigrams. */
+	TEST_EQUAL_LOG(ngram_score(model, "daines", "huggins", "david", NULL), -9450);
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	logmath_t *lmath;
+	cmd_ln_t *config;
+	ngram_model_t *model, *model2;
+
+	lmath = logmath_init(1.0001, 0, 0);
+	config = cmd_ln_init(NULL, defn, TRUE, "-mmap", "yes", NULL);
+
+	/* Without a config, the binary is read as usual */
+	model = ngram_model_read(NULL, LMDIR "/100.lm.bin", NGRAM_BIN, lmath);
+	test_lm_vals(model);
+	TEST_EQUAL(0, ngram_model_write(model, "100.tmp.mmap.lm.bin", NGRAM_BIN));
+	ngram_model_free(model);
+
+	E_INFO("Mapping the same binary twice\n");
+	model = ngram_model_read(config, "100.tmp.mmap.lm.bin", NGRAM_BIN, lmath);
+	test_lm_vals(model);
+	model2 = ngram_model_read(config, "100.tmp.mmap.lm.bin", NGRAM_AUTO, lmath);
+	test_lm_vals(model2);
+	/* Both use the words of the one mapping */
+	TEST_EQUAL(ngram_word(model, 13), ngram_word(model2, 13));
+	/* Mapped models can't be changed */
+	TEST_EQUAL(NGRAM_INVALID_WID, ngram_model_add_word(model, "foobie", 1.0));
+	TEST_EQUAL(0, ngram_model_free(model));
+	/* The mapping stays while a model uses it */
+	test_lm_vals(model2);
+	TEST_EQUAL(0, ngram_model_free(model2));
+
+	E_INFO("Mapping a binary written before\n");
+	model = ngram_model_read(config, LMDIR "/100.lm.bin", NGRAM_BIN, lmath);
+	test_lm_vals(model);
+	TEST_EQUAL(0, ngram_model_free(model));
+
+	E_INFO("Falling back to reading a dump file\n");
+	model = ngram_model_read(config, LMDIR "/turtle.lm.dmp", NGRAM_BIN, lmath);
+	TEST_ASSERT(model);
+	TEST_ASSERT(ngram_model_add_word(model, "foobie", 1.0) != NGRAM_INVALID_WID);
+	TEST_EQUAL(0, ngram_model_free(model));
+
+	cmd_ln_free_r(config);
+	logmath_free(lmath);
+
+	return 0;
+}
@@ -65,6 +65,16 @@ main(int argc, char *argv[])
 	model = ngram_model_read(NULL, LMDIR "/104.lm.gz", NGRAM_ARPA, lmath);
 	TEST_EQUAL(0, ngram_model_free(model));
 
+	/* Read a language model with a malformed bigram, which is
+	 * ignored with the bigrams after it */
+	model = ngram_model_read(NULL, LMDIR "/107.lm", NGRAM_ARPA, lmath);
+	TEST_ASSERT(model);
+	TEST_EQUAL(ngram_model_get_counts(model)[1], 5);
+	TEST_EQUAL(ngram_score(model, "backward", "go", NULL), -13863);
+	TEST_EQUAL(ngram_score(model, "meters", "ten", NULL), -23980);
+	TEST_EQUAL(ngram_score(model, "backward", "go", "<s>", NULL), -6931);
+	TEST_EQUAL(0, ngram_model_free(model));
+
 	/* Read corrupted language model, error expected */
 	model = ngram_model_read(NULL, LMDIR "/105.lm.gz", NGRAM_ARPA, lmath);
 	TEST_EQUAL(NULL, model);